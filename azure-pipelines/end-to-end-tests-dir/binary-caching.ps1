@@ -48,6 +48,31 @@ Require-FileExists "$installRoot/$Triplet/include/hello-1.h"
 Require-FileExists "$buildtreesRoot/vcpkg-hello-world-1/src"
 Require-FileNotExists "$buildtreesRoot/detect_compiler"
 
+# Test pushing with several background threads
+Remove-Item -Recurse -Force $installRoot
+$ThreadedArchiveRoot = Join-Path $TestingRoot 'archives-threaded'
+Run-Vcpkg -TestArgs ($commonArgs + @("install", "vcpkg-hello-world-1", "vcpkg-cmake", "vcpkg-cmake-config", "--x-binarycache-push-threads=2", "--x-binarysource=clear;files,$ThreadedArchiveRoot,write"))
+Throw-IfFailed
+if ((Get-ChildItem $ThreadedArchiveRoot -Recurse -Filter '*.zip' | Measure-Object).Count -ne 3) {
+    throw "In '$CurrentTest': did not push exactly 3 packages"
+}
+
+Run-Vcpkg -TestArgs ($commonArgs + @("install", "vcpkg-hello-world-1", "--x-binarycache-push-threads=0", "--x-binarysource=clear;files,$ThreadedArchiveRoot,write"))
+Throw-IfNotFailed
+
+# Test restoring when an earlier read provider does not have the packages
+Remove-Item -Recurse -Force $installRoot
+Remove-Item -Recurse -Force $buildtreesRoot
+$EmptyArchiveRoot = Join-Path $TestingRoot 'archives-empty'
+New-Item -ItemType Directory -Force $EmptyArchiveRoot | Out-Null
+Run-Vcpkg -TestArgs ($commonArgs + @("install", "vcpkg-hello-world-1", "vcpkg-cmake", "vcpkg-cmake-config", "--x-binarycache-read-threads=2", "--x-binarysource=clear;files,$EmptyArchiveRoot,read;files,$ThreadedArchiveRoot,read"))
+Throw-IfFailed
+Require-FileExists "$installRoot/$Triplet/include/hello-1.h"
+Require-FileNotExists "$buildtreesRoot/vcpkg-hello-world-1/src"
+
+Run-Vcpkg -TestArgs ($commonArgs + @("install", "vcpkg-hello-world-1", "--x-binarycache-read-threads=0", "--x-binarysource=clear;files,$ThreadedArchiveRoot,read"))
+Throw-IfNotFailed
+
 if(-Not $IsLinux -and -Not $IsMacOS) {
     # Test restoring from nuget
     Remove-Item -Recurse -Force $installRoot
@@ -48,3 +48,110 @@ Throw-IfNotFailed
 if (-not ($Output.Contains("vcpkg.json:3:17: error: Trailing comma"))) {
     throw 'malformed overlay port manifest must raise a parsing error'
 }
+
+# test sharding
+$Output = Run-VcpkgAndCaptureOutput ci --dry-run --triplet=$Triplet --x-builtin-ports-root="$PSScriptRoot/../e2e-ports/ci"  --binarysource=clear --x-shard=1/2
+Throw-IfFailed
+if (-not ($Output.Contains("Shard 1/2 will install"))) {
+    throw 'shard 1/2 must report the packages it will install'
+}
+
+$Output = Run-VcpkgAndCaptureOutput ci --dry-run --triplet=$Triplet --x-builtin-ports-root="$PSScriptRoot/../e2e-ports/ci"  --binarysource=clear --x-shard=2/2
+Throw-IfFailed
+if (-not ($Output.Contains("Shard 2/2 will install"))) {
+    throw 'shard 2/2 must report the packages it will install'
+}
+
+$Output = Run-VcpkgAndCaptureOutput ci --dry-run --triplet=$Triplet --x-builtin-ports-root="$PSScriptRoot/../e2e-ports/ci"  --binarysource=clear --x-shard=3/2
+Throw-IfNotFailed
+if (-not ($Output.Contains("invalid --x-shard value '3/2'"))) {
+    throw 'an out of range shard must be rejected'
+}
+
+# test that shards build every port once, restoring the dependencies built by the other shard from the binary cache
+$shardPortsRoot = Join-Path $TestingRoot 'shard-ports'
+$shardCacheRoot = Join-Path $TestingRoot 'shard-cache'
+Remove-Item -Recurse -Force $shardPortsRoot -ErrorAction SilentlyContinue
+Remove-Item -Recurse -Force $shardCacheRoot -ErrorAction SilentlyContinue
+New-Item -ItemType Directory -Force $shardCacheRoot | Out-Null
+$shardPorts = [ordered]@{
+    'shard-base' = @();
+    'shard-a' = @('shard-base');
+    'shard-b' = @('shard-base');
+    'shard-c' = @('shard-base');
+    'shard-d' = @('shard-a');
+}
+foreach ($shardPort in $shardPorts.GetEnumerator()) {
+    $portDir = Join-Path $shardPortsRoot $shardPort.Name
+    New-Item -ItemType Directory -Force $portDir | Out-Null
+    Set-Content -Value "set(VCPKG_POLICY_EMPTY_PACKAGE enabled)" -LiteralPath (Join-Path $portDir 'portfile.cmake') -Encoding Ascii
+    $manifest = @{ 'name' = $shardPort.Name; 'version' = '1'; 'dependencies' = @($shardPort.Value) }
+    Set-Content -Value (ConvertTo-Json $manifest) -LiteralPath (Join-Path $portDir 'vcpkg.json') -Encoding Ascii
+}
+
+function Get-ShardArgs {
+    Param([int]$Index, [string]$Tag = '')
+    $shardRoot = Join-Path $TestingRoot "shard$Tag$Index"
+    return @(
+        'ci',
+        "--triplet=$Triplet",
+        "--x-builtin-ports-root=$shardPortsRoot",
+        "--binarysource=clear;files,$shardCacheRoot$Tag,readwrite",
+        "--x-buildtrees-root=$shardRoot/buildtrees",
+        "--x-install-root=$shardRoot/installed",
+        "--x-packages-root=$shardRoot/packages",
+        "--x-shard=$Index/2",
+        '--x-shard-timeout=600',
+        "--x-shard-status=$TestingRoot/shard-status$Tag",
+        "--x-results-json=$TestingRoot/shard$Tag$Index.json"
+    )
+}
+
+$secondShard = Start-Process -FilePath $VcpkgExe -ArgumentList (Get-ShardArgs 2) -PassThru -NoNewWindow
+$Output = Run-VcpkgAndCaptureOutput @(Get-ShardArgs 1)
+Throw-IfFailed
+$secondShard.WaitForExit()
+if ($secondShard.ExitCode -ne 0) {
+    throw 'shard 2/2 must succeed'
+}
+
+$builtByShard = @{}
+foreach ($index in 1, 2) {
+    $built = @(Get-Content "$TestingRoot/shard$index.json" | ConvertFrom-Json | Where-Object { $_.state -eq '*' } | ForEach-Object { $_.name })
+    if ($built.Length -eq 0) {
+        throw "shard $index/2 must build some of the ports"
+    }
+    $builtByShard[$index] = $built
+}
+
+$allBuilt = @($builtByShard[1] + $builtByShard[2] | Sort-Object)
+Throw-IfNonEqual -Actual ($allBuilt -join ',') -Expected (($shardPorts.Keys | Sort-Object) -join ',')
+
+Run-Vcpkg x-ci-merge-shards "--triplet=$Triplet" "--x-results-json=$TestingRoot/merged.json" "$TestingRoot/shard1.json" "$TestingRoot/shard2.json"
+Throw-IfFailed
+$merged = Get-Content "$TestingRoot/merged.json" | ConvertFrom-Json
+foreach ($shardPort in $shardPorts.Keys) {
+    $result = @($merged | Where-Object { $_.name -eq $shardPort })
+    if ($result.Length -ne 1 -or $result[0].state -ne '*' -or $result[0].result -ne 'SUCCEEDED') {
+        throw "$shardPort must be built exactly once and succeed"
+    }
+}
+
+# test that a failure on one shard stops the other from waiting for the ports depending on it
+Set-Content -Value "message(FATAL_ERROR `"shard-base fails`")" -LiteralPath (Join-Path $shardPortsRoot 'shard-base/portfile.cmake') -Encoding Ascii
+New-Item -ItemType Directory -Force "$shardCacheRoot-failing" | Out-Null
+$failingStart = Get-Date
+$secondShard = Start-Process -FilePath $VcpkgExe -ArgumentList (Get-ShardArgs 2 '-failing') -PassThru -NoNewWindow
+$Output = Run-VcpkgAndCaptureOutput @(Get-ShardArgs 1 '-failing')
+$secondShard.WaitForExit()
+if (((Get-Date) - $failingStart).TotalSeconds -ge 300) {
+    throw 'the shards must stop waiting for ports whose dependencies failed instead of timing out'
+}
+
+Run-Vcpkg x-ci-merge-shards "--triplet=$Triplet" "--x-results-json=$TestingRoot/merged-failing.json" "$TestingRoot/shard-failing1.json" "$TestingRoot/shard-failing2.json"
+Throw-IfFailed
+$merged = Get-Content "$TestingRoot/merged-failing.json" | ConvertFrom-Json
+$result = @($merged | Where-Object { $_.name -eq 'shard-base' })
+if ($result.Length -ne 1 -or $result[0].result -ne 'BUILD_FAILED') {
+    throw 'shard-base must fail to build exactly once'
+}
@@ -0,0 +1,83 @@
+. $PSScriptRoot/../end-to-end-tests-prelude.ps1
+
+$commonArgs += @("--x-builtin-ports-root=$PSScriptRoot/../e2e-ports")
+
+$portsRoot = Join-Path $TestingRoot 'cmake-vars-ports'
+$tripletsRoot = Join-Path $TestingRoot 'cmake-vars-triplets'
+New-Item -ItemType Directory -Force "$portsRoot/vcpkg-static-dependency" | Out-Null
+New-Item -ItemType Directory -Force $tripletsRoot | Out-Null
+Set-Content -Path "$portsRoot/vcpkg-static-dependency/vcpkg.json" -Value @'
+{
+  "name": "vcpkg-static-dependency",
+  "version": "0",
+  "dependencies": [
+    {
+      "name": "vcpkg-empty-port",
+      "platform": "static"
+    }
+  ]
+}
+'@
+
+$tripletFile = Join-Path $tripletsRoot 'cmake-vars-e2e.cmake'
+Set-Content -Path $tripletFile -Value @'
+set(VCPKG_TARGET_ARCHITECTURE x64)
+set(VCPKG_CRT_LINKAGE dynamic)
+if(DEFINED ENV{VCPKG_E2E_DYNAMIC_LINKAGE})
+    set(VCPKG_LIBRARY_LINKAGE dynamic)
+else()
+    set(VCPKG_LIBRARY_LINKAGE static)
+endif()
+'@
+
+$dependInfoArgs = $commonArgs + @("depend-info", "vcpkg-static-dependency:cmake-vars-e2e", "--overlay-ports=$portsRoot", "--overlay-triplets=$tripletsRoot")
+
+# The first run extracts the triplet variables and caches them
+$output = Run-VcpkgAndCaptureOutput -TestArgs $dependInfoArgs
+Throw-IfFailed
+Throw-IfNonContains -Actual $output -Expected "vcpkg-static-dependency: vcpkg-empty-port"
+if ((Get-ChildItem "$buildtreesRoot/cmake-vars-cache" | Measure-Object).Count -eq 0) {
+    throw "In '$CurrentTest': no CMake variables were cached"
+}
+
+# The second run gets the same answer from the cache
+$output = Run-VcpkgAndCaptureOutput -TestArgs $dependInfoArgs
+Throw-IfFailed
+Throw-IfNonContains -Actual $output -Expected "vcpkg-static-dependency: vcpkg-empty-port"
+
+# Environment variables read by the triplet are part of the key
+$env:VCPKG_E2E_DYNAMIC_LINKAGE = "1"
+try {
+    $output = Run-VcpkgAndCaptureOutput -TestArgs $dependInfoArgs
+    Throw-IfFailed
+    Throw-IfContains -Actual $output -Expected "vcpkg-static-dependency: vcpkg-empty-port"
+} finally {
+    Remove-Item env:VCPKG_E2E_DYNAMIC_LINKAGE
+}
+
+# So is the triplet file itself
+Set-Content -Path $tripletFile -Value @'
+set(VCPKG_TARGET_ARCHITECTURE x64)
+set(VCPKG_CRT_LINKAGE dynamic)
+set(VCPKG_LIBRARY_LINKAGE dynamic)
+'@
+$output = Run-VcpkgAndCaptureOutput -TestArgs $dependInfoArgs
+Throw-IfFailed
+Throw-IfContains -Actual $output -Expected "vcpkg-static-dependency: vcpkg-empty-port"
+
+# Triplets that include files from outside of their directory are not cached
+$linkageFile = Join-Path $TestingRoot 'cmake-vars-linkage.cmake'
+Set-Content -Path $linkageFile -Value 'set(VCPKG_LIBRARY_LINKAGE static)'
+Set-Content -Path $tripletFile -Value @"
+set(VCPKG_TARGET_ARCHITECTURE x64)
+set(VCPKG_CRT_LINKAGE dynamic)
+include("$($linkageFile.Replace('\', '/'))")
+"@
+$output = Run-VcpkgAndCaptureOutput -TestArgs $dependInfoArgs
+Throw-IfFailed
+Throw-IfNonContains -Actual $output -Expected "vcpkg-static-dependency: vcpkg-empty-port"
+
+Set-Content -Path $linkageFile -Value 'set(VCPKG_LIBRARY_LINKAGE dynamic)'
+$output = Run-VcpkgAndCaptureOutput -TestArgs $dependInfoArgs
+Throw-IfFailed
+Throw-IfContains -Actual $output -Expected "vcpkg-static-dependency: vcpkg-empty-port"
@@ -0,0 +1,23 @@
+. $PSScriptRoot/../end-to-end-tests-prelude.ps1
+
+$commonArgs += @("--x-builtin-ports-root=$PSScriptRoot/../e2e-ports")
+
+# Independent ports and dependents of ports built in parallel all install
+Run-Vcpkg -TestArgs ($commonArgs + @("install", "vcpkg-internal-e2e-test-port", "vcpkg-internal-e2e-test-port3", "vcpkg-empty-port", "--x-parallel-ports=3"))
+Throw-IfFailed
+Require-FileExists "$installRoot/$Triplet/share/vcpkg-internal-e2e-test-port/copyright"
+Require-FileExists "$installRoot/$Triplet/share/vcpkg-internal-e2e-test-port2/copyright"
+Require-FileExists "$installRoot/$Triplet/share/vcpkg-internal-e2e-test-port3/copyright"
+
+Refresh-TestRoot
+
+# A failed build still cascades to its dependents
+$output = Run-VcpkgAndCaptureOutput -TestArgs ($commonArgs + @("install", "vcpkg-depends-on-fail", "vcpkg-empty-port", "--keep-going", "--x-parallel-ports=2"))
+Throw-IfNotFailed
+Throw-IfNonContains -Actual $output -Expected "vcpkg-depends-on-fail:$($Triplet): CASCADED_DUE_TO_MISSING_DEPENDENCIES"
+Throw-IfNonContains -Actual $output -Expected "vcpkg-empty-port:$($Triplet): SUCCEEDED"
+
+# The value must be a positive integer
+$output = Run-VcpkgAndCaptureOutput -TestArgs ($commonArgs + @("install", "vcpkg-empty-port", "--x-parallel-ports=0"))
+Throw-IfNotFailed
+Throw-IfNonContains -Actual $output -Expected "Value of --x-parallel-ports must be a positive integer."
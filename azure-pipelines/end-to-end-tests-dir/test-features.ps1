@@ -311,3 +311,16 @@ $($ciFeatureBaseline):1:31: error: vcpkg-depends-on-fail-feature[core,x]:$Triple
 $($ciFeatureBaseline):1:31: note: consider changing this to =cascade instead
 "@
 Throw-IfNonContains -Expected $expected -Actual $output
+
+# Parallel tests run in isolated installed trees but report the same diagnostics
+$ciFeatureBaseline = "$PSScriptRoot/../e2e-assets/ci-feature-baseline/unexpected-pass-combo-fail.txt"
+$output = Run-VcpkgAndCaptureOutput x-test-features @commonArgs "--x-builtin-ports-root=$PSScriptRoot/../e2e-ports" vcpkg-empty-featureful-port --ci-feature-baseline $ciFeatureBaseline --x-parallel-tests=3
+Throw-IfNotFailed
+$expected = @"
+$($ciFeatureBaseline):2:29: error: vcpkg-empty-featureful-port[core,a,a-default-feature,b,c]:$Triplet passed but was marked expected to fail
+"@
+Throw-IfNonContains -Expected $expected -Actual $output
+
+$output = Run-VcpkgAndCaptureOutput x-test-features @commonArgs "--x-builtin-ports-root=$PSScriptRoot/../e2e-ports" vcpkg-empty-featureful-port --x-parallel-tests=0
+Throw-IfNotFailed
+Throw-IfNonContains -Expected "Value of --x-parallel-tests must be a positive integer." -Actual $output
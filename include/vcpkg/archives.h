@@ -49,6 +49,19 @@ namespace vcpkg
     void win32_extract_self_extracting_7z(const Filesystem& fs, const Path& archive, const Path& to_path);
 #endif
 
+    struct ZipArchiveExtraction
+    {
+        Path archive;
+        Path destination;
+    };
+
+#if !defined(_WIN32)
+    // Native equivalents of `zip -y -r destination *` run in `source` and `unzip -DD archive -d destination`, which
+    // compress and extract the entries of the archives in parallel.
+    bool zip_directory(DiagnosticContext& context, const Filesystem& fs, const Path& source, const Path& destination);
+    std::vector<ExpectedL<Unit>> unzip_archives(const Filesystem& fs, View<ZipArchiveExtraction> jobs);
+#endif
+
     struct ZipTool
     {
         void setup(const ToolCache& tools, MessageSink& status_sink);
@@ -61,6 +74,10 @@ namespace vcpkg
 
         Command decompress_zip_archive_cmd(const Path& dst, const Path& archive_path) const;
 
+        // Extract each archive to its destination; returns a result for each job.
+        std::vector<ExpectedL<Unit>> decompress_zip_archives(const Filesystem& fs,
+                                                             View<ZipArchiveExtraction> jobs) const;
+
     private:
 #if defined _WIN32
         Optional<Path> seven_zip;
@@ -46,6 +46,13 @@ namespace vcpkg
             return m_cache.emplace_hint(it, k, static_cast<F&&>(f)())->second;
         }
 
+        template<class KeyIsh,
+                 std::enable_if_t<detail::is_callable<Compare&, const Key&, const KeyIsh&>::value, int> = 0>
+        bool contains(const KeyIsh& k) const
+        {
+            return m_cache.find(k) != m_cache.end();
+        }
+
     private:
         mutable std::map<Key, Value, Compare> m_cache;
     };
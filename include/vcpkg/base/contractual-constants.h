@@ -47,6 +47,7 @@ namespace vcpkg
     inline constexpr StringLiteral JsonIdDocumentation = "documentation";
     inline constexpr StringLiteral JsonIdDollarSchema = "$schema";
     inline constexpr StringLiteral JsonIdDownloads = "downloads";
+    inline constexpr StringLiteral JsonIdElapsedSeconds = "elapsed-seconds";
     inline constexpr StringLiteral JsonIdError = "error";
     inline constexpr StringLiteral JsonIdExecutable = "executable";
     inline constexpr StringLiteral JsonIdFeatures = "features";
@@ -90,11 +91,13 @@ namespace vcpkg
     inline constexpr StringLiteral JsonIdRepository = "repository";
     inline constexpr StringLiteral JsonIdRequires = "requires";
     inline constexpr StringLiteral JsonIdResolved = "resolved";
+    inline constexpr StringLiteral JsonIdResult = "result";
     inline constexpr StringLiteral JsonIdScanned = "scanned";
     inline constexpr StringLiteral JsonIdSchemaVersion = "schema-version";
     inline constexpr StringLiteral JsonIdSettings = "settings";
     inline constexpr StringLiteral JsonIdSha = "sha";
     inline constexpr StringLiteral JsonIdSha512 = "sha512";
+    inline constexpr StringLiteral JsonIdStartTime = "start-time";
     inline constexpr StringLiteral JsonIdState = "state";
     inline constexpr StringLiteral JsonIdSummary = "summary";
     inline constexpr StringLiteral JsonIdSupports = "supports";
@@ -187,6 +190,8 @@ namespace vcpkg
     inline constexpr StringLiteral SwitchBaseline = "baseline";
     inline constexpr StringLiteral SwitchBin = "bin";
     inline constexpr StringLiteral SwitchBinarycaching = "binarycaching";
+    inline constexpr StringLiteral SwitchBinaryCachePushThreads = "binarycache-push-threads";
+    inline constexpr StringLiteral SwitchBinaryCacheReadThreads = "binarycache-read-threads";
     inline constexpr StringLiteral SwitchBinarysource = "binarysource";
     inline constexpr StringLiteral SwitchBuildtrees = "buildtrees";
     inline constexpr StringLiteral SwitchBuildtreesRoot = "buildtrees-root";
@@ -311,8 +316,15 @@ namespace vcpkg
     inline constexpr StringLiteral SwitchXInstalled = "x-installed";
     inline constexpr StringLiteral SwitchXJson = "x-json";
     inline constexpr StringLiteral SwitchXNoDefaultFeatures = "x-no-default-features";
+    inline constexpr StringLiteral SwitchXParallelPorts = "x-parallel-ports";
+    inline constexpr StringLiteral SwitchXParallelTests = "x-parallel-tests";
     inline constexpr StringLiteral SwitchXProhibitBackcompatFeatures = "x-prohibit-backcompat-features";
     inline constexpr StringLiteral SwitchXRandomize = "x-randomize";
+    inline constexpr StringLiteral SwitchXResultsJson = "x-results-json";
+    inline constexpr StringLiteral SwitchXShard = "x-shard";
+    inline constexpr StringLiteral SwitchXShardHistory = "x-shard-history";
+    inline constexpr StringLiteral SwitchXShardStatus = "x-shard-status";
+    inline constexpr StringLiteral SwitchXShardTimeout = "x-shard-timeout";
     inline constexpr StringLiteral SwitchXTransitive = "x-transitive";
     inline constexpr StringLiteral SwitchXWriteNuGetPackagesConfig = "x-write-nuget-packages-config";
     inline constexpr StringLiteral SwitchXXUnit = "x-xunit";
@@ -330,6 +342,7 @@ namespace vcpkg
     inline constexpr StringLiteral FileBaselineDotJson = "baseline.json";
     inline constexpr StringLiteral FileBin = "bin";
     inline constexpr StringLiteral FileBuildInfo = "BUILD_INFO";
+    inline constexpr StringLiteral FileCMakeVarsCache = "cmake-vars-cache";
     inline constexpr StringLiteral FileControl = "CONTROL";
     inline constexpr StringLiteral FileCompilerFileHashCacheDotJson = "compiler-file-hash-cache.json";
     inline constexpr StringLiteral FileCopying = "COPYING";
@@ -337,6 +350,8 @@ namespace vcpkg
     inline constexpr StringLiteral FileDebug = "debug";
     inline constexpr StringLiteral FileDetectCompiler = "detect_compiler";
     inline constexpr StringLiteral FileDotDsStore = ".DS_Store";
+    inline constexpr StringLiteral FileFilesIndex = "files-index";
+    inline constexpr StringLiteral FileFilesIndexNew = "files-index-new";
     inline constexpr StringLiteral FileInclude = "include";
     inline constexpr StringLiteral FileIncomplete = "incomplete";
     inline constexpr StringLiteral FileInfo = "info";
@@ -348,7 +363,10 @@ namespace vcpkg
     inline constexpr StringLiteral FileShare = "share";
     inline constexpr StringLiteral FileStatus = "status";
     inline constexpr StringLiteral FileStatusNew = "status-new";
+    inline constexpr StringLiteral FileStatusSnapshot = "status-snapshot";
+    inline constexpr StringLiteral FileStatusSnapshotNew = "status-snapshot-new";
     inline constexpr StringLiteral FileTestedSpecDotTxt = "tested-spec.txt";
+    inline constexpr StringLiteral FileToolVersionsCacheDotJson = "tool-versions-cache.json";
     inline constexpr StringLiteral FileTools = "tools";
     inline constexpr StringLiteral FileUpdates = "updates";
     inline constexpr StringLiteral FileUsage = "usage";
@@ -365,6 +383,7 @@ namespace vcpkg
     inline constexpr StringLiteral FileVcpkgUserProps = "vcpkg.user.props";
     inline constexpr StringLiteral FileVcpkgUserTargets = "vcpkg.user.targets";
     inline constexpr StringLiteral FileVersions = "versions";
+    inline constexpr StringLiteral FileVersionsIndex = "versions-index";
 
     // CMake variables are usually ALL_CAPS_WITH_UNDERSCORES
     inline constexpr StringLiteral CMakeVariableAllFeatures = "ALL_FEATURES";
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace vcpkg
+{
+    // Compresses [data, data + size) as a raw deflate (RFC 1951) stream.
+    std::string deflate_bytes(const unsigned char* data, std::size_t size);
+
+    // Decompresses the raw deflate stream [first, last), which must decompress to exactly `expected_size` bytes.
+    bool inflate_bytes(const unsigned char* first,
+                       const unsigned char* last,
+                       std::size_t expected_size,
+                       std::string& out);
+
+    // Decompresses the zlib (RFC 1950) stream at the beginning of [first, last) and verifies its checksum; fails if
+    // the result would be larger than `max_size` bytes.
+    bool zlib_inflate(const unsigned char* first, const unsigned char* last, std::size_t max_size, std::string& out);
+}
@@ -136,6 +136,9 @@ namespace vcpkg
         virtual std::uint64_t file_size(const Path& file_path, std::error_code& ec) const = 0;
         std::uint64_t file_size(const Path& file_path, LineInfo li) const;
 
+        virtual int64_t last_write_time(const Path& target, std::error_code& ec) const = 0;
+        int64_t last_write_time(const Path& target, LineInfo li) const noexcept;
+
         virtual std::string read_contents(const Path& file_path, std::error_code& ec) const = 0;
         std::string read_contents(const Path& file_path, LineInfo li) const;
 
@@ -317,9 +320,6 @@ namespace vcpkg
 
         virtual int64_t file_time_now() const = 0;
 
-        virtual int64_t last_write_time(const Path& target, std::error_code& ec) const = 0;
-        int64_t last_write_time(const Path& target, LineInfo li) const noexcept;
-
         using ReadOnlyFilesystem::current_path;
         virtual void current_path(const Path& new_current_path, std::error_code&) const = 0;
         void current_path(const Path& new_current_path, LineInfo li) const;
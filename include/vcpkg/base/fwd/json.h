@@ -7,6 +7,7 @@ namespace vcpkg::Json
     struct Value;
     struct Object;
     struct ParsedJson;
+    struct Document;
     struct Array;
     struct Reader;
     template<class Type>
@@ -93,6 +93,16 @@ namespace vcpkg
                           const Path& destination,
                           StringView treeish);
 
+    // These read loose objects and packfiles directly rather than launching git. They return nullopt without
+    // reporting anything when the object can't be read in-process, e.g. because it is missing or `treeish` uses
+    // revision syntax other than "<sha or ref>[:<path>]", so that callers can fall back to running git.
+    Optional<std::string> git_try_read_blob(const Filesystem& fs, const Path& dot_git_dir, StringView treeish);
+    Optional<std::string> git_try_rev_parse(const Filesystem& fs, const Path& dot_git_dir, StringView treeish);
+
+    // Unmaps the packfiles read from `dot_git_dir` so that git commands which may repack it can run; they are
+    // rescanned on next use.
+    void git_release_object_database(const Path& dot_git_dir);
+
     Optional<bool> git_check_is_commit(DiagnosticContext& context,
                                        const Path& git_exe,
                                        GitRepoLocator locator,
@@ -43,6 +43,10 @@ namespace vcpkg::Hash
     };
 
     std::unique_ptr<Hasher> get_hasher_for(Algorithm algo);
+#if !defined(_WIN32)
+    // Returns a hasher which does not use the CPU's SHA instructions even when they are available; for testing.
+    std::unique_ptr<Hasher> get_portable_hasher_for(Algorithm algo);
+#endif
 
     std::string get_bytes_hash(const void* first, const void* last, Algorithm algo);
     std::string get_string_hash(StringView s, Algorithm algo);
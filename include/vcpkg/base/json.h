@@ -4,6 +4,7 @@
 #include <vcpkg/base/fwd/json.h>
 
 #include <vcpkg/base/expected.h>
+#include <vcpkg/base/optional.h>
 #include <vcpkg/base/parse.h>
 #include <vcpkg/base/stringview.h>
 
@@ -13,6 +14,7 @@
 
 #include <memory>
 #include <string>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
@@ -81,6 +83,63 @@ namespace vcpkg::Json
     namespace impl
     {
         struct ValueImpl;
+        struct JsonArena;
+        struct ArenaBuilder;
+
+        struct ValueImplDeleter
+        {
+            void operator()(ValueImpl* ptr) const noexcept;
+        };
+
+        void* arena_allocate(JsonArena* arena, std::size_t size, std::size_t alignment);
+
+        // Allocates from the arena of a Document, or from the heap when there is no arena. Memory allocated from an
+        // arena is reclaimed only when the Document is destroyed, and copies of arena-backed containers allocate from
+        // the heap.
+        template<class T>
+        struct ArenaAllocator
+        {
+            using value_type = T;
+            using propagate_on_container_move_assignment = std::true_type;
+            using propagate_on_container_swap = std::true_type;
+            using is_always_equal = std::false_type;
+
+            ArenaAllocator() noexcept = default;
+            explicit ArenaAllocator(JsonArena* arena) noexcept : arena(arena) { }
+            template<class U>
+            ArenaAllocator(const ArenaAllocator<U>& other) noexcept : arena(other.arena) { }
+
+            T* allocate(std::size_t n)
+            {
+                if (arena)
+                {
+                    return static_cast<T*>(arena_allocate(arena, n * sizeof(T), alignof(T)));
+                }
+
+                return std::allocator<T>().allocate(n);
+            }
+
+            void deallocate(T* ptr, std::size_t n) noexcept
+            {
+                if (!arena)
+                {
+                    std::allocator<T>().deallocate(ptr, n);
+                }
+            }
+
+            ArenaAllocator select_on_container_copy_construction() const noexcept { return ArenaAllocator(); }
+
+            friend bool operator==(const ArenaAllocator& lhs, const ArenaAllocator& rhs) noexcept
+            {
+                return lhs.arena == rhs.arena;
+            }
+            friend bool operator!=(const ArenaAllocator& lhs, const ArenaAllocator& rhs) noexcept
+            {
+                return lhs.arena != rhs.arena;
+            }
+
+            JsonArena* arena = nullptr;
+        };
     }
 
     struct Value
@@ -108,8 +167,7 @@ namespace vcpkg::Json
         int64_t integer(LineInfo li) const noexcept;
         double number(LineInfo li) const noexcept;
         StringView string(LineInfo li) const noexcept;
-        std::string* maybe_string() noexcept;
-        const std::string* maybe_string() const noexcept;
+        Optional<StringView> maybe_string() const noexcept;
 
         const Array& array(LineInfo li) const& noexcept;
         Array& array(LineInfo li) & noexcept;
@@ -146,13 +204,17 @@ namespace vcpkg::Json
 
     private:
         friend struct impl::ValueImpl;
-        std::unique_ptr<impl::ValueImpl> underlying_;
+        friend struct impl::ArenaBuilder;
+        std::unique_ptr<impl::ValueImpl, impl::ValueImplDeleter> underlying_;
     };
 
     struct Array
     {
     private:
-        using underlying_t = std::vector<Value>;
+        using underlying_t = std::vector<Value, impl::ArenaAllocator<Value>>;
+
+        friend struct impl::ArenaBuilder;
+        explicit Array(impl::JsonArena* arena) : underlying_(impl::ArenaAllocator<Value>(arena)) { }
 
     public:
         Array() = default;
@@ -210,9 +272,21 @@ namespace vcpkg::Json
     {
     private:
         using value_type = std::pair<std::string, Value>;
-        using underlying_t = std::vector<value_type>;
+        using underlying_t = std::vector<value_type, impl::ArenaAllocator<value_type>>;
+        // open addressing table of (index into underlying_) + 1, or 0 for empty slots; only maintained for objects
+        // with enough members that a linear search is slower than hashing the key
+        using index_t = std::vector<uint32_t, impl::ArenaAllocator<uint32_t>>;
+
+        friend struct impl::ArenaBuilder;
+        explicit Object(impl::JsonArena* arena)
+            : underlying_(impl::ArenaAllocator<value_type>(arena)), index_(impl::ArenaAllocator<uint32_t>(arena))
+        {
+        }
 
         underlying_t::const_iterator internal_find_key(StringView key) const noexcept;
+        Value& internal_emplace_back(StringView key, Value&& value);
+        void internal_insert_index(std::size_t position) noexcept;
+        void internal_rebuild_index();
 
     public:
         // these are here for better diagnostics
@@ -327,6 +401,7 @@ namespace vcpkg::Json
 
     private:
         underlying_t underlying_;
+        index_t index_;
     };
 
     struct ParsedJson
@@ -335,7 +410,28 @@ namespace vcpkg::Json
         JsonStyle style;
     };
 
+    // A parsed JSON document whose nodes, containers, and strings are allocated from an arena owned by the document,
+    // with strings that need no unescaping referring directly to the document's copy of the text. Values in the
+    // document must not outlive it; copying a value out of the document produces an independent Value.
+    struct Document
+    {
+        Document();
+        Document(Document&&) noexcept;
+        Document& operator=(Document&&) noexcept;
+        ~Document();
+
+    private:
+        friend struct impl::ArenaBuilder;
+        // declared before value so that it is destroyed after it
+        std::unique_ptr<impl::JsonArena> arena_;
+
+    public:
+        Value value;
+        JsonStyle style;
+    };
+
     ExpectedL<ParsedJson> parse(StringView text, StringView origin);
+    ExpectedL<Document> parse_document(std::string&& text, StringView origin);
     ParsedJson parse_file(LineInfo li, const ReadOnlyFilesystem&, const Path&);
     ExpectedL<Json::Object> parse_object(StringView text, StringView origin);
 
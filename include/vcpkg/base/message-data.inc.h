@@ -354,6 +354,15 @@ DECLARE_MESSAGE(BaselineOnlyPlatformExpressionOrTriplet,
                 (),
                 "",
                 "You can not specify a platform expression and a triplet")
+DECLARE_MESSAGE(BinaryCachePushThreadsArg,
+                (),
+                "",
+                "Number of threads used to compress and upload packages to the binary cache (default 1)")
+DECLARE_MESSAGE(BinaryCacheReadThreadsArg,
+                (),
+                "",
+                "Number of requests each remote binary cache source keeps in flight when checking for and downloading "
+                "packages (default 4)")
 DECLARE_MESSAGE(BinarySourcesArg,
                 (),
                 "'vcpkg help binarycaching' is a command line and should not be localized",
@@ -499,6 +508,12 @@ DECLARE_MESSAGE(CiBaselineUnexpectedPass,
                 (msg::spec, msg::path),
                 "",
                 "PASSING, REMOVE FROM FAIL LIST: {spec} ({path}).")
+DECLARE_MESSAGE(CiInvalidResultsFile, (msg::path), "", "{path} is not a valid vcpkg ci results file")
+DECLARE_MESSAGE(CiInvalidShard,
+                (msg::value),
+                "{value} is the text given on the command line, such as 5/4. <index>/<count> should not be localized",
+                "invalid --x-shard value '{value}': expected <index>/<count>, where index is between 1 and count")
+DECLARE_MESSAGE(CiMergedShardResults, (msg::count), "", "Merged the results of {count} shards")
 DECLARE_MESSAGE(CISettingsOptCIBase,
                 (),
                 "",
@@ -512,12 +527,51 @@ DECLARE_MESSAGE(CISettingsOptParentHashes,
                 (),
                 "",
                 "File to read package hashes for a parent CI state, to reduce the set of changed packages")
+DECLARE_MESSAGE(CISettingsOptResultsJson,
+                (),
+                "",
+                "File to output results in JSON format, which x-ci-merge-shards can combine across shards")
+DECLARE_MESSAGE(CISettingsOptShard,
+                (),
+                "<index>/<count> should not be localized",
+                "Builds only shard <index>/<count> of the ports to build, for example 1/4, so that several machines "
+                "sharing a binary cache can divide the work")
+DECLARE_MESSAGE(CISettingsOptShardHistory,
+                (),
+                "",
+                "JSON results file of a previous run, whose build times are used to balance the shards")
+DECLARE_MESSAGE(CISettingsOptShardStatus,
+                (),
+                "",
+                "Directory shared by the shards, in which each reports the packages it failed to build so that the "
+                "shards depending on them stop waiting")
+DECLARE_MESSAGE(CISettingsOptShardTimeout,
+                (),
+                "",
+                "Number of seconds a shard waits for packages built by other shards while none of them reaches the "
+                "binary cache (default 1800)")
 DECLARE_MESSAGE(CISettingsOptXUnit, (), "", "File to output results in XUnit format")
 DECLARE_MESSAGE(CISettingsVerifyGitTree,
                 (),
                 "",
                 "Verifies that each git tree object matches its declared version (this is very slow)")
 DECLARE_MESSAGE(CISettingsVerifyVersion, (), "", "Prints result for each port rather than only just errors")
+DECLARE_MESSAGE(CiShardAssigned,
+                (msg::value, msg::count),
+                "{value} is the shard given on the command line, such as 1/4",
+                "Shard {value} will install {count} packages")
+DECLARE_MESSAGE(CiShardPortFailed,
+                (msg::spec),
+                "",
+                "{spec} failed to build on another shard; the packages which depend on it will not be built")
+DECLARE_MESSAGE(CiShardTimedOut,
+                (msg::spec),
+                "",
+                "{spec} was not built by another shard in time; the packages which depend on it will not be built")
+DECLARE_MESSAGE(CiShardWaiting,
+                (msg::count),
+                "",
+                "Waiting for {count} packages built by other shards to reach the binary cache")
 DECLARE_MESSAGE(CISkipInstallation, (), "", "The following packages are already installed and won't be built again:")
 DECLARE_MESSAGE(CISwitchOptAllowUnexpectedPassing, (), "", "Suppresses 'Passing, remove from fail list' results")
 DECLARE_MESSAGE(CISwitchOptDryRun, (), "", "Prints out plan without execution")
@@ -583,6 +637,10 @@ DECLARE_MESSAGE(CmdCiCleanSynopsis,
                 (),
                 "CI is continuous integration (building everything together)",
                 "Clears all files to prepare for a CI run")
+DECLARE_MESSAGE(CmdCiMergeShardsSynopsis,
+                (),
+                "CI is continuous integration (building everything together)",
+                "Combines the results files written by sharded CI runs")
 DECLARE_MESSAGE(CmdCiSynopsis,
                 (),
                 "CI is continuous integration (building everything together)",
@@ -838,6 +896,11 @@ DECLARE_MESSAGE(CmdTestFeaturesFailingAbis, (), "", "Path to file to which all f
 DECLARE_MESSAGE(CmdTestFeaturesNoCombined, (), "", "Skips testing every feature turned on")
 DECLARE_MESSAGE(CmdTestFeaturesNoCore, (), "", "Skips testing only the 'core' feature turned on")
 DECLARE_MESSAGE(CmdTestFeaturesNoSeparated, (), "", "Skips testing every feature separately")
+DECLARE_MESSAGE(CmdTestFeaturesParallelTests,
+                (),
+                "",
+                "Runs up to this many tests at the same time, each in its own installed, packages, and buildtrees "
+                "directories")
 DECLARE_MESSAGE(CmdTestFeaturesSynopsis, (), "", "Tests the features of a port")
 DECLARE_MESSAGE(CmdUpdateBaselineOptDryRun, (), "", "Prints out plan without execution")
 DECLARE_MESSAGE(CmdUpdateBaselineOptInitial,
@@ -1360,7 +1423,15 @@ DECLARE_MESSAGE(FeatureBaselineExpectedFeatures,
 DECLARE_MESSAGE(FeatureBaselineFormatted, (), "", "Succeeded in formatting the feature baseline file.")
 DECLARE_MESSAGE(FeatureBaselineNoFeaturesForFail, (), "", "When using '= fail' no list of features is allowed.")
 DECLARE_MESSAGE(FeatureBaselineNoFeaturesForPass, (), "", "When using '= pass' no list of features is allowed.")
+DECLARE_MESSAGE(FeatureTestKeepingInstalled,
+                (msg::count, msg::value),
+                "{value} is a number of packages, such as 3",
+                "Keeping {count} installed packages and removing {value} which this test does not use")
 DECLARE_MESSAGE(FeatureTestProblems, (), "", "There are some feature test problems!")
+DECLARE_MESSAGE(FeatureTestsInParallel,
+                (msg::count, msg::path),
+                "",
+                "Running up to {count} feature tests at the same time in {path}")
 DECLARE_MESSAGE(FileIsNotExecutable, (), "", "this file does not appear to be executable")
 DECLARE_MESSAGE(FilesRelativeToTheBuildDirectoryHere, (), "", "the files are relative to the build directory here")
 DECLARE_MESSAGE(FilesRelativeToThePackageDirectoryHere,
@@ -1723,6 +1794,10 @@ DECLARE_MESSAGE(HelpTxtOptNoDownloads, (), "", "Does not download new sources")
 DECLARE_MESSAGE(HelpTxtOptNoUsage, (), "", "Does not print CMake usage information after install")
 DECLARE_MESSAGE(HelpTxtOptOnlyBinCache, (), "", "Fails if cached binaries are not available")
 DECLARE_MESSAGE(HelpTxtOptOnlyDownloads, (), "", "Makes best-effort attempt to download sources without building")
+DECLARE_MESSAGE(HelpTxtOptParallelPorts,
+                (),
+                "",
+                "Builds up to this many ports at the same time, sharing VCPKG_MAX_CONCURRENCY between them")
 DECLARE_MESSAGE(HelpTxtOptRecurse, (), "", "Allows removal of packages as part of installation")
 DECLARE_MESSAGE(HelpTxtOptUseHeadVersion,
                 (),
@@ -2264,6 +2339,7 @@ DECLARE_MESSAGE(OnlySupports,
                 "",
                 "{feature_spec} only supports {supports_expression}")
 DECLARE_MESSAGE(OptionMustBeInteger, (msg::option), "", "Value of --{option} must be an integer.")
+DECLARE_MESSAGE(OptionMustBePositiveInteger, (msg::option), "", "Value of --{option} must be a positive integer.")
 DECLARE_MESSAGE(OptionRequiresAValue, (msg::option), "", "the option '{option}' requires a value")
 DECLARE_MESSAGE(OptionRequiresANonDashesValue,
                 (msg::option, msg::actual, msg::value),
@@ -3348,3 +3424,16 @@ DECLARE_MESSAGE(WhileRunningAssetCacheScriptCommandLine, (), "", "while running
 DECLARE_MESSAGE(WhileValidatingVersion, (msg::version), "", "while validating version: {version}")
 DECLARE_MESSAGE(WindowsOnlyCommand, (), "", "This command only supports Windows.")
 DECLARE_MESSAGE(WroteNuGetPkgConfInfo, (msg::path), "", "Wrote NuGet package config information to {path}")
+DECLARE_MESSAGE(ZipEntryCorrupt,
+                (msg::path, msg::value),
+                "{value} is the name of a file in the zip archive",
+                "The entry {value} in {path} is corrupt")
+DECLARE_MESSAGE(ZipEntryOutsideDestination,
+                (msg::path, msg::value),
+                "{value} is the name of a file in the zip archive",
+                "The entry {value} in {path} would be extracted outside of the destination directory")
+DECLARE_MESSAGE(ZipEntryUnsupported,
+                (msg::path, msg::value),
+                "{value} is the name of a file in the zip archive",
+                "The entry {value} in {path} is encrypted or uses an unsupported compression method")
+DECLARE_MESSAGE(ZipInvalidArchive, (msg::path), "", "{path} is not a valid zip archive")
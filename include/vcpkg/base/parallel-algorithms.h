@@ -68,16 +68,21 @@ namespace vcpkg
     };
 
     template<class F>
-    inline void execute_in_parallel(size_t work_count, F work) noexcept
+    inline void execute_in_parallel(size_t work_count, size_t max_threads, F work) noexcept
     {
         if (work_count == 0)
         {
             return;
         }
 
-        if (work_count == 1)
+        if (work_count == 1 || max_threads <= 1)
         {
-            work(size_t{});
+            for (size_t i = 0; i < work_count; ++i)
+            {
+                work(i);
+            }
+
+            return;
         }
 
         WorkCallbackContext<F> context{work, work_count};
@@ -88,7 +93,7 @@ namespace vcpkg
                          nullptr);
         if (ptp_work)
         {
-            auto max_threads = (std::min)(work_count, static_cast<size_t>(get_concurrency()));
+            max_threads = (std::min)(work_count, max_threads);
             max_threads = (std::min)(max_threads, (SIZE_MAX - work_count) + 1u); // to avoid overflow in fetch_add
             // start at 1 to account for the running thread
             for (size_t i = 1; i < max_threads; ++i)
@@ -119,21 +124,25 @@ namespace vcpkg
     };
 
     template<class F>
-    inline void execute_in_parallel(size_t work_count, F work) noexcept
+    inline void execute_in_parallel(size_t work_count, size_t max_threads, F work) noexcept
     {
         if (work_count == 0)
         {
             return;
         }
 
-        if (work_count == 1)
+        if (work_count == 1 || max_threads <= 1)
         {
-            work(size_t{});
+            for (size_t i = 0; i < work_count; ++i)
+            {
+                work(i);
+            }
+
             return;
         }
 
         WorkCallbackContext<F> context{work, work_count};
-        auto max_threads = std::min(work_count, static_cast<size_t>(get_concurrency()));
+        max_threads = std::min(work_count, max_threads);
         max_threads = std::min(max_threads, (SIZE_MAX - work_count) + 1u); // to avoid overflow in fetch_add
         auto bg_thread_count = max_threads - 1;
         std::vector<JThread> bg_threads;
@@ -156,6 +165,12 @@ namespace vcpkg
     }
 #endif // ^^^ !_WIN32
 
+    template<class F>
+    inline void execute_in_parallel(size_t work_count, F work) noexcept
+    {
+        execute_in_parallel(work_count, static_cast<size_t>(get_concurrency()), std::move(work));
+    }
+
     template<class Container, class F>
     void parallel_for_each(Container&& c, F cb) noexcept
     {
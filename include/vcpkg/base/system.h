@@ -55,6 +55,9 @@ namespace vcpkg
 
     std::string get_host_os_name();
 
+    // The version of the host operating system kernel, or an empty string if it can't be determined
+    std::string get_host_os_version();
+
     std::vector<CPUArchitecture> get_supported_host_architectures();
 
     const Optional<Path>& get_program_files_32_bit();
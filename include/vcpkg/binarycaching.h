@@ -8,7 +8,7 @@
 #include <vcpkg/fwd/tools.h>
 #include <vcpkg/fwd/vcpkgpaths.h>
 
-#include <vcpkg/base/background-work-queue.h>
+#include <vcpkg/base/chrono.h>
 #include <vcpkg/base/downloads.h>
 #include <vcpkg/base/expected.h>
 #include <vcpkg/base/message_sinks.h>
@@ -19,7 +19,10 @@
 #include <vcpkg/versions.h>
 
 #include <chrono>
+#include <condition_variable>
 #include <iterator>
+#include <memory>
+#include <mutex>
 #include <set>
 #include <string>
 #include <thread>
@@ -37,10 +40,13 @@ namespace vcpkg
         const IReadBinaryProvider* get_available_provider() const noexcept;
         bool is_restored() const noexcept;
 
+        // If `sender` was the available provider, the entry goes back to unknown so other providers can be tried.
         void mark_unavailable(const IReadBinaryProvider* sender);
         void mark_available(const IReadBinaryProvider* sender) noexcept;
         void mark_restored() noexcept;
         void mark_unrestored() noexcept;
+        // Forgets which providers lacked the entry, so that they are asked again.
+        void mark_unknown() noexcept;
 
     private:
         CacheStatusState m_status = CacheStatusState::unknown;
@@ -86,19 +92,22 @@ namespace vcpkg
 
         virtual bool needs_nuspec_data() const = 0;
         virtual bool needs_zip_file() const = 0;
+
+        /// Returns true if push_success may be called for different packages from several threads at the same time.
+        virtual bool supports_concurrent_pushes() const = 0;
     };
 
     struct IReadBinaryProvider
     {
         virtual ~IReadBinaryProvider() = default;
 
-        /// Gives the IBinaryProvider an opportunity to batch any downloading or server communication for executing
-        /// `actions`.
+        /// Gives the IBinaryProvider an opportunity to batch any downloading or server communication for restoring
+        /// `packages`.
         ///
         /// IBinaryProvider should set out_status[i] to RestoreResult::restored for each fetched package.
         ///
-        /// Prerequisites: actions[i].package_abi(), out_status.size() == actions.size()
-        virtual void fetch(View<const InstallPlanAction*> actions, Span<RestoreResult> out_status) const = 0;
+        /// Prerequisites: out_status.size() == packages.size()
+        virtual void fetch(View<const BinaryPackageReadInfo*> packages, Span<RestoreResult> out_status) const = 0;
 
         /// Checks whether the `actions` are present in the cache, without restoring them.
         ///
@@ -110,6 +119,9 @@ namespace vcpkg
 
         virtual LocalizedString restored_message(size_t count,
                                                  std::chrono::high_resolution_clock::duration elapsed) const = 0;
+
+        /// Returns true if precheck and fetch may run on another thread at the same time as those of other providers.
+        virtual bool supports_concurrent_reads() const = 0;
     };
 
     struct UrlTemplate
@@ -187,17 +199,23 @@ namespace vcpkg
         NuGetRepoInfo nuget_repo;
     };
 
+    struct BinaryCacheFetchPipeline;
+
     struct ReadOnlyBinaryCache
     {
-        ReadOnlyBinaryCache() = default;
+        ReadOnlyBinaryCache();
         ReadOnlyBinaryCache(const ReadOnlyBinaryCache&) = delete;
         ReadOnlyBinaryCache& operator=(const ReadOnlyBinaryCache&) = delete;
+        ~ReadOnlyBinaryCache();
 
         /// Gives the IBinaryProvider an opportunity to batch any downloading or server communication for
-        /// executing `actions`.
+        /// executing `actions`. The packages are restored on a background thread in batches, in the order of
+        /// `actions`, so the first packages can be installed while later ones are still downloading; asking about
+        /// a package waits for its batch. The background thread uses copies of the actions' ABIs, specs, versions
+        /// and packages directories, so `actions` need not outlive the fetch.
         void fetch(View<InstallPlanAction> actions);
 
-        bool is_restored(const InstallPlanAction& ipa) const;
+        bool is_restored(const InstallPlanAction& ipa);
 
         void install_read_provider(std::unique_ptr<IReadBinaryProvider>&& provider);
 
@@ -210,10 +228,33 @@ namespace vcpkg
         // more than once in a single invocation of vcpkg.
         void mark_all_unrestored();
 
+        // Informs the binary cache that the package of `action` was placed in its packages directory by other means,
+        // such as from a restore shared with other installed trees.
+        void mark_restored(const InstallPlanAction& action);
+
+        // Forgets that the providers lacked the package of `action`, so that the next precheck or fetch asks them
+        // again. Used by CI shards waiting for packages built by other machines.
+        void mark_unknown(const InstallPlanAction& action);
+
     protected:
+        // Waits until the background fetch, if any, has restored the batch containing `abi` and records the outcome
+        // in m_status.
+        void wait_for_fetch(const std::string& abi);
+        // Waits until the background fetch, if any, has finished.
+        void wait_for_fetch();
+        // Stops the background fetch, if any, after the batch it is restoring. The outcome of batches not yet merged
+        // is dropped, so those packages are treated as not restored.
+        void cancel_fetch();
+
         BinaryProviders m_config;
 
         std::unordered_map<std::string, CacheStatus> m_status;
+
+    private:
+        void merge_fetched_batch();
+        void finish_fetch();
+
+        std::unique_ptr<BinaryCacheFetchPipeline> m_fetch;
     };
 
     struct BinaryCacheSyncState;
@@ -251,15 +292,16 @@ namespace vcpkg
         bool submission_complete;
     };
 
-    // compression and upload of binary cache entries happens on a single 'background' thread, `m_push_thread`
+    // compression and upload of binary cache entries happens on 'background' threads, `m_push_threads`, which run
+    // each package through three stages: compressing the packages directory, uploading to each write provider, and
+    // removing the zip file and packages directory.
     // Thread safety is achieved within the binary cache providers by:
-    //   1. Only using one thread in the background for this work.
-    //   2. Forming a queue of work for that thread to consume in `m_actions_to_push`, which maintains its own thread
-    //   safety
-    //   3. Sending any replies from the background thread through `m_bg_msg_sink`
-    //   4. Ensuring any supporting data, such as tool exes, is provided before the background thread is started.
-    //   5. Ensuring that work is not submitted to the background thread until the corresponding `packages` directory to
-    //   upload is no longer being actively written by the foreground thread.
+    //   1. Only calling a provider that does not support concurrent pushes from one background thread at a time.
+    //   2. Forming a queue of work for those threads to consume in `m_push_tasks`, which is guarded by `m_push_mtx`
+    //   3. Sending any replies from the background threads through `m_bg_msg_sink`
+    //   4. Ensuring any supporting data, such as tool exes, is provided before the background threads are started.
+    //   5. Ensuring that work is not submitted to the background threads until the corresponding `packages` directory
+    //   to upload is no longer being actively written by the foreground thread.
     struct BinaryCache : ReadOnlyBinaryCache
     {
         bool install_providers(const VcpkgCmdArguments& args, const VcpkgPaths& paths, MessageSink& status_sink);
@@ -277,8 +319,33 @@ namespace vcpkg
     private:
         struct ActionToPush
         {
+            ActionToPush(BinaryPackageWriteInfo&& request, CleanPackages clean_after_push)
+                : request(std::move(request)), clean_after_push(clean_after_push)
+            {
+            }
+
             BinaryPackageWriteInfo request;
             CleanPackages clean_after_push;
+            // started when compression begins
+            Optional<ElapsedTimer> timer;
+            // guarded by m_push_mtx
+            size_t remaining_uploads = 0;
+            size_t num_destinations = 0;
+        };
+
+        enum class PushStage
+        {
+            Compress,
+            Upload,
+            Clean
+        };
+
+        struct PushTask
+        {
+            PushStage stage;
+            std::shared_ptr<ActionToPush> action;
+            // the index into m_config.write; meaningful iff stage == PushStage::Upload
+            size_t provider;
         };
 
         ZipTool m_zip_tool;
@@ -288,10 +355,21 @@ namespace vcpkg
         const Filesystem& m_fs;
 
         BGMessageSink m_bg_msg_sink;
-        BackgroundWorkQueue<ActionToPush> m_actions_to_push;
         BinaryCacheSynchronizer m_synchronizer;
-        std::thread m_push_thread;
 
+        std::mutex m_push_mtx;
+        std::condition_variable m_push_cv;
+        std::vector<PushTask> m_push_tasks;
+        // whether a background thread is currently calling the corresponding provider in m_config.write
+        std::vector<bool> m_provider_busy;
+        size_t m_push_tasks_running = 0;
+        bool m_push_running = true;
+        std::vector<std::thread> m_push_threads;
+
+        void start_push_threads(size_t count);
+        bool take_push_task(PushTask& task);
+        void run_push_task(PushTask& task);
+        void finish_push_task(const PushTask& task, size_t num_destinations);
         void push_thread_main();
     };
 
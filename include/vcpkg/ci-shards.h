@@ -0,0 +1,137 @@
+#pragma once
+
+#include <vcpkg/base/fwd/json.h>
+
+#include <vcpkg/fwd/build.h>
+#include <vcpkg/fwd/dependencies.h>
+
+#include <vcpkg/base/chrono.h>
+#include <vcpkg/base/expected.h>
+#include <vcpkg/base/optional.h>
+#include <vcpkg/base/span.h>
+#include <vcpkg/base/stringview.h>
+
+#include <vcpkg/packagespec.h>
+
+#include <chrono>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace vcpkg
+{
+    // One of the machines among which `vcpkg ci --x-shard=<index>/<count>` divides the ports to build.
+    struct CiShard
+    {
+        // zero based, unlike the command line
+        size_t index;
+        size_t count;
+    };
+
+    Optional<CiShard> parse_ci_shard(StringView text);
+
+    // Where a port is built in a sharded CI run.
+    struct CiShardTarget
+    {
+        size_t shard;
+        // Every dependency of the port which may have to be built is built in an earlier wave
+        size_t wave;
+    };
+
+    // Divides the actions of action_plan which may have to be built, i.e. those not in known or known to succeed,
+    // among shard_count shards. These are grouped into waves by their longest chain of such dependencies, and each
+    // wave is spread across the shards balanced by estimated build time. A port's estimate is its time in
+    // build_seconds, or for ports without history its weight, one plus the number of ports it depends on, scaled by
+    // the time per weight of the ports with history. action_plan must not yet be reduced to the ports which are not
+    // cached: those depend on when each machine checked the binary cache, and every machine must agree on the shards.
+    std::map<PackageSpec, CiShardTarget> assign_ci_shards(const ActionPlan& action_plan,
+                                                          const std::map<PackageSpec, BuildResult>& known,
+                                                          const std::map<PackageSpec, double>& build_seconds,
+                                                          size_t shard_count);
+
+    // The part of a reduced action plan which one shard installs.
+    struct CiShardPlan
+    {
+        // The wave in which each remaining action is installed; actions are installed after their dependencies
+        std::map<PackageSpec, size_t> waves;
+        size_t wave_count = 0;
+        // The remaining actions which other shards build, to be restored from the binary cache once they are
+        std::set<PackageSpec> built_elsewhere;
+    };
+
+    // Removes the actions of action_plan which this shard neither builds nor depends on. Every action to build, i.e.
+    // not in known, is built by its shard in targets in its wave, and installed by the shards depending on it in the
+    // wave of their first action which does.
+    CiShardPlan shard_action_plan(ActionPlan& action_plan,
+                                  const std::map<PackageSpec, BuildResult>& known,
+                                  const std::map<PackageSpec, CiShardTarget>& targets,
+                                  CiShard shard);
+
+    // The state of a port which another shard builds, as seen by a shard which depends on it.
+    enum class CiShardPortState
+    {
+        Pending,
+        Available,
+        Failed,
+    };
+
+    // How a shard observes the ports which other shards build.
+    struct ICiShardObserver
+    {
+        virtual ~ICiShardObserver() = default;
+
+        // Returns the state of the package of each action.
+        virtual std::vector<CiShardPortState> poll(View<const InstallPlanAction*> actions) = 0;
+        // Waits before polling again.
+        virtual void pause() = 0;
+        // Time since the shard started.
+        virtual std::chrono::seconds elapsed() const = 0;
+    };
+
+    // Waits, before each wave of a shard, for the ports of the wave which other shards build. A port is given up on
+    // once its shard reports that it failed, once it depends on a port given up on, or once none of the ports waited
+    // for has arrived for timeout; the other ports of a shard which timed out aren't waited for at all.
+    struct CiShardWaiter
+    {
+        CiShardWaiter(const std::map<PackageSpec, CiShardTarget>& targets, std::chrono::seconds timeout);
+
+        // Waits for the actions of wave in built_elsewhere, and removes those given up on from wave, so that the ports
+        // of this shard which depend on them cascade.
+        void wait(std::vector<InstallPlanAction>& wave,
+                  const std::set<PackageSpec>& built_elsewhere,
+                  ICiShardObserver& observer);
+        // Records a port of this shard which failed, so that the ports of other shards depending on it are given up on.
+        void record_failure(const PackageSpec& spec);
+
+    private:
+        bool depends_on_failure(const InstallPlanAction& action) const;
+
+        const std::map<PackageSpec, CiShardTarget>& m_targets;
+        std::chrono::seconds m_timeout;
+        std::set<PackageSpec> m_failed;
+        std::set<size_t> m_timed_out_shards;
+    };
+
+    struct CiResult
+    {
+        PackageSpec spec;
+        // the state printed by vcpkg ci for the port, "*" if it had to be built
+        std::string state;
+        BuildResult result;
+        std::string abi;
+        std::vector<std::string> features;
+        ElapsedTime elapsed;
+        std::chrono::system_clock::time_point start_time;
+    };
+
+    Json::Array serialize_ci_results(View<CiResult> results);
+    ExpectedL<std::vector<CiResult>> parse_ci_results(const Json::Value& value, StringView origin);
+
+    // Combines the results written by each shard. Every shard reports the ports whose result was known before
+    // building; the result of the shard which built a port supersedes these.
+    std::vector<CiResult> merge_ci_results(View<std::vector<CiResult>> shard_results);
+
+    // Returns the time it took to build each port which had to be built in a previous run.
+    std::map<PackageSpec, double> get_ci_build_seconds(View<CiResult> results);
+}
@@ -3,6 +3,7 @@
 #include <vcpkg/base/fwd/files.h>
 #include <vcpkg/base/fwd/optional.h>
 #include <vcpkg/base/fwd/span.h>
+#include <vcpkg/base/fwd/stringview.h>
 
 #include <vcpkg/fwd/dependencies.h>
 #include <vcpkg/fwd/packagespec.h>
@@ -10,9 +11,13 @@
 #include <vcpkg/fwd/triplet.h>
 #include <vcpkg/fwd/vcpkgpaths.h>
 
+#include <vcpkg/base/span.h>
+
 #include <memory>
 #include <string>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 namespace vcpkg::CMakeVars
 {
@@ -42,4 +47,31 @@ namespace vcpkg::CMakeVars
     };
 
     std::unique_ptr<CMakeVarProvider> make_triplet_cmake_var_provider(const VcpkgPaths& paths);
+
+    // Splits the console output of a variable extraction script into the variables reported for each port, one line
+    // at a time as the script produces them.
+    struct CMakeVarsOutputParser
+    {
+        explicit CMakeVarsOutputParser(Span<std::vector<std::pair<std::string, std::string>>> port_vars)
+            : m_port_vars(port_vars)
+        {
+        }
+
+        void parse_line(StringView line);
+
+        // Returns true if exactly one complete report was seen for each port.
+        bool is_complete() const;
+
+    private:
+        enum class State
+        {
+            BetweenPorts,
+            InPort,
+            InBlock,
+        };
+
+        Span<std::vector<std::pair<std::string, std::string>>> m_port_vars;
+        size_t m_ports_seen = 0;
+        State m_state = State::BetweenPorts;
+    };
 }
@@ -105,6 +105,12 @@ namespace vcpkg
         CleanDownloads clean_downloads;
         BackcompatFeatures backcompat_features;
         KeepGoing keep_going;
+        // The number of ports install_execute_plan may build at the same time; VCPKG_MAX_CONCURRENCY is divided
+        // between them.
+        size_t parallel_ports = 1;
+        // The number of install_execute_plan calls running at the same time, each into its own installed tree, such
+        // as for x-test-features --x-parallel-tests; VCPKG_MAX_CONCURRENCY is also divided between them.
+        size_t concurrent_plans = 1;
     };
 
     struct BuildResultCounts
@@ -213,6 +219,22 @@ namespace vcpkg
                                       const IBuildLogsRecorder& build_logs_recorder,
                                       const StatusParagraphs& status_db);
 
+    // Returns the dependencies of `action` which are not installed in `status_db`.
+    std::vector<FullPackageSpec> find_missing_build_dependencies(const BuildPackageOptions& build_options,
+                                                                 const InstallPlanAction& action,
+                                                                 const StatusParagraphs& status_db);
+
+    // Like build_package, but the caller is responsible for checking dependencies with
+    // find_missing_build_dependencies. Does not touch the status database, so it may run concurrently with
+    // installs performed by another thread.
+    ExtendedBuildResult build_package_with_checked_dependencies(const VcpkgCmdArguments& args,
+                                                                const VcpkgPaths& paths,
+                                                                Triplet host_triplet,
+                                                                const BuildPackageOptions& build_options,
+                                                                const InstallPlanAction& action,
+                                                                const IBuildLogsRecorder& build_logs_recorder,
+                                                                bool all_dependencies_satisfied);
+
     StringLiteral to_string_view(BuildPolicy policy);
     std::string to_string(BuildPolicy policy);
     StringLiteral to_cmake_variable(BuildPolicy policy);
@@ -0,0 +1,14 @@
+#pragma once
+
+#include <vcpkg/fwd/triplet.h>
+#include <vcpkg/fwd/vcpkgcmdarguments.h>
+#include <vcpkg/fwd/vcpkgpaths.h>
+
+namespace vcpkg
+{
+    extern const CommandMetadata CommandCiMergeShardsMetadata;
+    void command_ci_merge_shards_and_exit(const VcpkgCmdArguments& args,
+                                          const VcpkgPaths& paths,
+                                          Triplet default_triplet,
+                                          Triplet host_triplet);
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <vcpkg/fwd/build.h>
+
+#include <vcpkg/base/optional.h>
+#include <vcpkg/base/span.h>
+
+#include <vcpkg/commands.build.h>
+#include <vcpkg/dependencies.h>
+
+namespace vcpkg
+{
+    // The steps of installing the actions of a plan, which run_parallel_install orders. Actions are identified by
+    // their index in the plan's install actions. Everything but build runs on the thread calling run_parallel_install.
+    struct IParallelInstallSteps
+    {
+        virtual ~IParallelInstallSteps() = default;
+
+        // Whether the action has to be built; the others are installed by install.
+        virtual bool needs_build(size_t install_index) const = 0;
+        // Called once the dependencies of the action have finished, when it starts.
+        virtual void start(size_t install_index) = 0;
+        virtual ExtendedBuildResult install(size_t install_index) = 0;
+        // Returns the result of an action which can't be built, such as one whose dependencies failed.
+        virtual Optional<ExtendedBuildResult> check_build(size_t install_index) = 0;
+        // Runs on a background thread.
+        virtual ExtendedBuildResult build(size_t install_index) = 0;
+        // Installs what build produced.
+        virtual ExtendedBuildResult finish_build(size_t install_index, ExtendedBuildResult&& result) = 0;
+        // Records the result of every action which started.
+        virtual void finish(size_t install_index, ExtendedBuildResult&& result) = 0;
+    };
+
+    // Runs install_actions as a dependency graph: an action starts once its dependencies in the plan have finished,
+    // and up to parallel_ports actions build at the same time. With KeepGoing::No, no action starts after the first
+    // one which fails, whose index is returned once the builds still running have finished.
+    Optional<size_t> run_parallel_install(View<InstallPlanAction> install_actions,
+                                          size_t parallel_ports,
+                                          KeepGoing keep_going,
+                                          IParallelInstallSteps& steps);
+}
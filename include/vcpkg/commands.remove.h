@@ -7,6 +7,7 @@
 #include <vcpkg/fwd/statusparagraphs.h>
 #include <vcpkg/fwd/triplet.h>
 #include <vcpkg/fwd/vcpkgcmdarguments.h>
+#include <vcpkg/fwd/vcpkglib.h>
 #include <vcpkg/fwd/vcpkgpaths.h>
 
 namespace vcpkg
@@ -20,7 +21,8 @@ namespace vcpkg
     void remove_package(const Filesystem& fs,
                         const InstalledPaths& installed,
                         const PackageSpec& spec,
-                        StatusParagraphs& status_db);
+                        StatusParagraphs& status_db,
+                        InstalledFilesIndex& files_index);
 
     extern const CommandMetadata CommandRemoveMetadata;
     void command_remove_and_exit(const VcpkgCmdArguments& args,
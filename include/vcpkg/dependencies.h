@@ -188,6 +188,12 @@ namespace vcpkg
                                            PackagesDirAssigner& packages_dir_assigner,
                                            const CreateInstallPlanOptions& options);
 
+    // Returns the elements of `specs` whose individual install plans would have no unsupported features.
+    std::vector<FullPackageSpec> filter_supported_specs(const PortFileProvider& provider,
+                                                        const CMakeVars::CMakeVarProvider& var_provider,
+                                                        View<FullPackageSpec> specs,
+                                                        const CreateInstallPlanOptions& options);
+
     ActionPlan create_upgrade_plan(const PortFileProvider& provider,
                                    const CMakeVars::CMakeVarProvider& var_provider,
                                    const std::vector<PackageSpec>& specs,
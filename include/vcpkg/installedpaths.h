@@ -19,8 +19,10 @@ namespace vcpkg
 
         Path vcpkg_dir() const { return m_root / FileVcpkg; }
         Path vcpkg_dir_status_file() const { return vcpkg_dir() / FileStatus; }
+        Path vcpkg_dir_status_snapshot() const { return vcpkg_dir() / FileStatusSnapshot; }
         Path vcpkg_dir_info() const { return vcpkg_dir() / FileInfo; }
         Path vcpkg_dir_updates() const { return vcpkg_dir() / FileUpdates; }
+        Path vcpkg_dir_files_index() const { return vcpkg_dir() / FileFilesIndex; }
         Path compiler_hash_cache_file() const { return vcpkg_dir() / FileCompilerFileHashCacheDotJson; }
         Path lockfile_path() const { return vcpkg_dir() / FileVcpkgLock; }
         Path triplet_dir(Triplet t) const { return m_root / t.canonical_name(); }
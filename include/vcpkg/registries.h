@@ -198,6 +198,25 @@ namespace vcpkg
     ExpectedL<FullGitVersionsDatabase> load_all_git_versions_files(const ReadOnlyFilesystem& fs,
                                                                    const Path& registry_versions);
 
+    // A compact binary form of all the versions files in a git registry's versions tree, sorted by port name, so
+    // that ports can be looked up without reparsing every JSON file. Records are kept in versions file order.
+    struct GitVersionsIndex
+    {
+        // Returns nullopt if `contents` is not a well formed index
+        static Optional<GitVersionsIndex> parse(std::string&& contents);
+        // Returns nullopt if any of the versions files failed to load
+        static Optional<std::string> serialize(const std::map<std::string, GitVersionsLoadResult, std::less<>>& db);
+
+        // Returns nullopt if the port has no versions file
+        Optional<std::vector<GitVersionDbEntry>> lookup(StringView port_name) const;
+
+    private:
+        explicit GitVersionsIndex(std::string&& contents, std::size_t port_count);
+
+        std::string m_contents;
+        std::size_t m_port_count;
+    };
+
     struct FilesystemVersionDbEntry
     {
         SchemedVersion version;
@@ -5,6 +5,8 @@
 
 #include <iterator>
 #include <memory>
+#include <unordered_map>
+#include <vector>
 
 namespace vcpkg
 {
@@ -77,7 +79,18 @@ namespace vcpkg
         const_iterator begin() const { return paragraphs.rbegin(); }
 
     private:
+        iterator iterator_at(size_t position) { return iterator(paragraphs.begin() + position + 1); }
+        const_iterator iterator_at(size_t position) const { return const_iterator(paragraphs.begin() + position + 1); }
+        size_t find_position(const std::string& name, Triplet triplet, const std::string& feature) const;
+        std::vector<size_t> find_positions(const std::string& name, Triplet triplet) const;
+        void index_paragraph(size_t position);
+
         std::vector<std::unique_ptr<StatusParagraph>> paragraphs;
+        // Hashes of (name, triplet, feature) and of (name, triplet) to positions in paragraphs. Candidates are
+        // compared against the paragraphs themselves, so the spec and feature of a paragraph must not be changed
+        // through an iterator.
+        std::unordered_multimap<size_t, size_t> feature_index;
+        std::unordered_multimap<size_t, size_t> package_index;
     };
 
     void serialize(const StatusParagraphs& pgh, std::string& out_str);
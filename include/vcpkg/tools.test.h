@@ -1,6 +1,7 @@
 #pragma once
 
 #include <vcpkg/base/fwd/expected.h>
+#include <vcpkg/base/fwd/files.h>
 #include <vcpkg/base/fwd/fmt.h>
 #include <vcpkg/base/fwd/optional.h>
 #include <vcpkg/base/fwd/stringview.h>
@@ -10,6 +11,7 @@
 #include <vcpkg/base/path.h>
 
 #include <array>
+#include <functional>
 #include <string>
 
 namespace vcpkg
@@ -72,6 +74,26 @@ namespace vcpkg
                                            const CPUArchitecture arch,
                                            const ToolOs os);
 
+    // Remembers the versions probed from tools across vcpkg invocations in the file cache_path, keyed by tool name and
+    // path. Only native executables are cached, and only while their size and last write time are unchanged, since
+    // the version reported by a script or shim comes from other files.
+    struct ToolVersionProbeCache
+    {
+        ToolVersionProbeCache(const Filesystem& fs, Path cache_path);
+
+        // Returns the cached version of the tool at exe_path, or runs probe and caches what it returns.
+        ExpectedL<std::string> get_version(StringView tool_name,
+                                           const Path& exe_path,
+                                           const std::function<ExpectedL<std::string>()>& probe);
+
+    private:
+        Json::Object& probes();
+
+        const Filesystem& m_fs;
+        Path m_cache_path;
+        Optional<Json::Object> m_probes;
+    };
+
     struct ToolDataFileDeserializer final : Json::IDeserializer<std::vector<ToolDataEntry>>
     {
         virtual LocalizedString type_name() const override;
@@ -236,6 +236,8 @@ namespace vcpkg
 
         std::vector<std::string> cli_binary_sources;
         Optional<std::string> env_binary_sources;
+        Optional<std::string> binary_cache_push_threads;
+        Optional<std::string> binary_cache_read_threads;
         Optional<std::string> nuget_id_prefix;
         Optional<bool> use_nuget_cache;
         Optional<std::string> vcpkg_nuget_repository;
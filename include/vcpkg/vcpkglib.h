@@ -5,7 +5,9 @@
 #include <vcpkg/fwd/installedpaths.h>
 #include <vcpkg/fwd/statusparagraphs.h>
 
+#include <vcpkg/base/optional.h>
 #include <vcpkg/base/sortedvector.h>
+#include <vcpkg/base/stringview.h>
 
 #include <vcpkg/statusparagraph.h>
 
@@ -13,9 +15,10 @@
 
 namespace vcpkg
 {
-    // Read the status database
+    // Read the status database. The status file is read from installed/vcpkg/status-snapshot, a binary copy of it,
+    // when that snapshot was taken of the status file as it currently is on disk.
     StatusParagraphs database_load(const ReadOnlyFilesystem& fs, const InstalledPaths& installed);
-    // Read the status database, and collapse update records into the current status file
+    // Read the status database, and collapse update records into the current status file, refreshing the snapshot
     StatusParagraphs database_load_collapse(const Filesystem& fs, const InstalledPaths& installed);
 
     // Adds an update record
@@ -29,15 +32,74 @@ namespace vcpkg
 
     std::vector<InstalledPackageView> get_installed_ports(const StatusParagraphs& status_db);
 
-    // Reads the installed files from the status database.
-    std::vector<StatusParagraphAndAssociatedFiles> get_installed_files(const ReadOnlyFilesystem& fs,
-                                                                       const InstalledPaths& installed,
-                                                                       const StatusParagraphs& status_db);
-    // Reads the installed files from the status database, converting installed file lists to the current version if
+    // Maps each file installed by an installed package to the package that installed it. The index is persisted in
+    // installed/vcpkg/files-index and is rebuilt from the listfiles whenever one of them no longer matches it.
+    struct InstalledFilesIndex
+    {
+        // Builds the index from the listfiles of the installed packages.
+        static InstalledFilesIndex from_installed_files(const ReadOnlyFilesystem& fs,
+                                                        const InstalledPaths& installed,
+                                                        const std::vector<StatusParagraphAndAssociatedFiles>& files);
+        static Optional<InstalledFilesIndex> deserialize(StringView data);
+        std::string serialize() const;
+
+        // Returns whether the index describes exactly the listfiles of the installed packages in `status_db`.
+        bool is_current(const ReadOnlyFilesystem& fs,
+                        const InstalledPaths& installed,
+                        const StatusParagraphs& status_db) const;
+        bool is_modified() const { return m_modified; }
+
+        // Returns the installed files that collide case-insensitively with `package_files`, paired with the display
+        // name of the package that installed them. All paths are relative to the directory of `triplet`.
+        std::vector<std::pair<std::string, std::string>> find_conflicts(
+            Triplet triplet, const SortedVector<std::string>& package_files) const;
+        // Returns the display name of the package that installed `file`, which is relative to the installed root.
+        Optional<const std::string&> find_owner(StringView file) const;
+        // Returns the display names of the packages and the files they installed for every file containing
+        // `file_substr`, grouped by package.
+        std::vector<std::pair<std::string, std::string>> search(StringView file_substr) const;
+
+        // Records the files from the listfile of the newly installed package `core`.
+        void add_package(const ReadOnlyFilesystem& fs, const InstalledPaths& installed, const BinaryParagraph& core);
+        // Forgets the files installed by the package `core`.
+        void remove_package(const InstalledPaths& installed, const BinaryParagraph& core);
+
+    private:
+        struct PackageEntry
+        {
+            std::string display_name;
+            std::string listfile;
+            std::uint64_t listfile_size;
+            std::int64_t listfile_write_time;
+        };
+
+        struct FileEntry
+        {
+            std::string path;
+            size_t package;
+        };
+
+        void add_package_files(PackageEntry&& package, std::vector<std::string>&& files);
+
+        std::vector<PackageEntry> m_packages;
+        // sorted case-insensitively by path
+        std::vector<FileEntry> m_files;
+        bool m_modified = false;
+    };
+
+    // Reads the installed files index, rebuilding it in memory if it is missing or stale.
+    InstalledFilesIndex load_installed_files_index(const ReadOnlyFilesystem& fs,
+                                                   const InstalledPaths& installed,
+                                                   const StatusParagraphs& status_db);
+    // Reads the installed files index, rebuilding it and converting installed file lists to the current version if
     // necessary.
-    std::vector<StatusParagraphAndAssociatedFiles> get_installed_files_and_upgrade(const Filesystem& fs,
-                                                                                   const InstalledPaths& installed,
-                                                                                   const StatusParagraphs& status_db);
+    InstalledFilesIndex load_installed_files_index_and_upgrade(const Filesystem& fs,
+                                                               const InstalledPaths& installed,
+                                                               const StatusParagraphs& status_db);
+    // Writes the installed files index if it changed since it was loaded.
+    void save_installed_files_index(const Filesystem& fs,
+                                    const InstalledPaths& installed,
+                                    const InstalledFilesIndex& index);
 
     std::string shorten_text(StringView desc, const size_t length);
 } // namespace vcpkg
@@ -55,6 +55,10 @@ namespace vcpkg
         VcpkgPaths& operator=(const VcpkgPaths&) = delete;
         ~VcpkgPaths();
 
+        // Creates paths which resolve everything as these do, except that ports are built, packaged, and installed
+        // under isolated_root; the vcpkg root lock, if any, stays with these paths.
+        std::unique_ptr<VcpkgPaths> make_isolated(const VcpkgCmdArguments& args, const Path& isolated_root) const;
+
         Path package_dir(const PackageSpec& spec) const;
         Path build_dir(const PackageSpec& spec) const;
         Path build_dir(StringView package_name) const;
@@ -1,5 +1,8 @@
 #include <vcpkg-test/util.h>
 
+#include <vcpkg/base/files.h>
+#include <vcpkg/base/strings.h>
+
 #include <vcpkg/archives.h>
 
 TEST_CASE ("Testing guess_extraction_type", "[z-extract]")
@@ -17,3 +20,185 @@ TEST_CASE ("Testing guess_extraction_type", "[z-extract]")
     REQUIRE(guess_extraction_type(Path("/path/to/archive.unknown")) == ExtractionType::Unknown);
     REQUIRE(guess_extraction_type(Path("/path/to/archive.7z.exe")) == ExtractionType::SelfExtracting7z);
 }
+
+#if !defined(_WIN32)
+#include <sys/stat.h>
+
+namespace
+{
+    // `zip -X -y -r archive.zip *` of a directory containing bin/tool (executable), include/hello.h,
+    // lib/libhello.so.1, the symlink lib/libhello.so -> libhello.so.1, and the empty directory share/empty
+    const unsigned char archive_created_by_zip[] = {
+        0x50, 0x4b, 0x03, 0x04, 0x0a, 0x00, 0x00, 0x00, 0x00, 0x00, 0xd8, 0x20, 0x51, 0x5d, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 0x62, 0x69, 0x6e, 0x2f, 0x50, 0x4b,
+        0x03, 0x04, 0x0a, 0x00, 0x00, 0x00, 0x00, 0x00, 0x83, 0x18, 0x22, 0x58, 0x2f, 0x3a, 0xda, 0xe9, 0x12, 0x00,
+        0x00, 0x00, 0x12, 0x00, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00, 0x62, 0x69, 0x6e, 0x2f, 0x74, 0x6f, 0x6f, 0x6c,
+        0x23, 0x21, 0x2f, 0x62, 0x69, 0x6e, 0x2f, 0x73, 0x68, 0x0a, 0x65, 0x63, 0x68, 0x6f, 0x20, 0x68, 0x69, 0x0a,
+        0x50, 0x4b, 0x03, 0x04, 0x0a, 0x00, 0x00, 0x00, 0x00, 0x00, 0xd8, 0x20, 0x51, 0x5d, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00, 0x69, 0x6e, 0x63, 0x6c, 0x75, 0x64,
+        0x65, 0x2f, 0x50, 0x4b, 0x03, 0x04, 0x14, 0x00, 0x00, 0x00, 0x08, 0x00, 0x83, 0x18, 0x22, 0x58, 0x21, 0x38,
+        0xce, 0x00, 0x7c, 0x00, 0x00, 0x00, 0x5b, 0x02, 0x00, 0x00, 0x0f, 0x00, 0x00, 0x00, 0x69, 0x6e, 0x63, 0x6c,
+        0x75, 0x64, 0x65, 0x2f, 0x68, 0x65, 0x6c, 0x6c, 0x6f, 0x2e, 0x68, 0x5d, 0xd1, 0x31, 0x0a, 0xc2, 0x50, 0x14,
+        0x44, 0xd1, 0xde, 0x55, 0x04, 0x6c, 0xb4, 0x73, 0x66, 0x34, 0x46, 0x5c, 0xcd, 0x47, 0x82, 0x0a, 0x31, 0x09,
+        0x21, 0xfb, 0x27, 0x60, 0x13, 0xee, 0x2f, 0x6f, 0xf5, 0x0e, 0xf3, 0x8e, 0xf3, 0x52, 0xde, 0xbf, 0xd2, 0x4c,
+        0xe3, 0xab, 0x3f, 0x7c, 0xc7, 0xb5, 0xf9, 0xf4, 0xc3, 0x30, 0x5d, 0x4e, 0xe7, 0xe7, 0x5e, 0x42, 0x19, 0x15,
+        0xd4, 0x15, 0x75, 0x43, 0xb5, 0xa8, 0x3b, 0xaa, 0x43, 0x3d, 0x78, 0xbd, 0xc2, 0x50, 0x23, 0x72, 0x44, 0x8f,
+        0x08, 0x12, 0x45, 0x22, 0x49, 0x34, 0x89, 0x28, 0x51, 0x65, 0xaa, 0x5c, 0x6d, 0x44, 0x95, 0xa9, 0x32, 0x55,
+        0xa6, 0xca, 0x54, 0x99, 0x2a, 0x53, 0x65, 0xaa, 0x42, 0x55, 0xa8, 0x4a, 0xf5, 0x3a, 0xaa, 0x42, 0x55, 0xa8,
+        0x0a, 0x55, 0xa1, 0x2a, 0x54, 0xe5, 0xaf, 0xda, 0x00, 0x50, 0x4b, 0x03, 0x04, 0x0a, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0xd8, 0x20, 0x51, 0x5d, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x04,
+        0x00, 0x00, 0x00, 0x6c, 0x69, 0x62, 0x2f, 0x50, 0x4b, 0x03, 0x04, 0x0a, 0x00, 0x00, 0x00, 0x00, 0x00, 0x83,
+        0x18, 0x22, 0x58, 0xde, 0xe9, 0x63, 0xde, 0x0d, 0x00, 0x00, 0x00, 0x0d, 0x00, 0x00, 0x00, 0x0f, 0x00, 0x00,
+        0x00, 0x6c, 0x69, 0x62, 0x2f, 0x6c, 0x69, 0x62, 0x68, 0x65, 0x6c, 0x6c, 0x6f, 0x2e, 0x73, 0x6f, 0x6c, 0x69,
+        0x62, 0x68, 0x65, 0x6c, 0x6c, 0x6f, 0x2e, 0x73, 0x6f, 0x2e, 0x31, 0x50, 0x4b, 0x03, 0x04, 0x0a, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x83, 0x18, 0x22, 0x58, 0xcc, 0x3b, 0x0f, 0xa9, 0x03, 0x00, 0x00, 0x00, 0x03, 0x00, 0x00,
+        0x00, 0x11, 0x00, 0x00, 0x00, 0x6c, 0x69, 0x62, 0x2f, 0x6c, 0x69, 0x62, 0x68, 0x65, 0x6c, 0x6c, 0x6f, 0x2e,
+        0x73, 0x6f, 0x2e, 0x31, 0x6c, 0x69, 0x62, 0x50, 0x4b, 0x03, 0x04, 0x0a, 0x00, 0x00, 0x00, 0x00, 0x00, 0xd8,
+        0x20, 0x51, 0x5d, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x06, 0x00, 0x00,
+        0x00, 0x73, 0x68, 0x61, 0x72, 0x65, 0x2f, 0x50, 0x4b, 0x03, 0x04, 0x0a, 0x00, 0x00, 0x00, 0x00, 0x00, 0x83,
+        0x18, 0x22, 0x58, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0c, 0x00, 0x00,
+        0x00, 0x73, 0x68, 0x61, 0x72, 0x65, 0x2f, 0x65, 0x6d, 0x70, 0x74, 0x79, 0x2f, 0x50, 0x4b, 0x01, 0x02, 0x1e,
+        0x03, 0x0a, 0x00, 0x00, 0x00, 0x00, 0x00, 0xd8, 0x20, 0x51, 0x5d, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x10, 0x00, 0xed,
+        0x41, 0x00, 0x00, 0x00, 0x00, 0x62, 0x69, 0x6e, 0x2f, 0x50, 0x4b, 0x01, 0x02, 0x1e, 0x03, 0x0a, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x83, 0x18, 0x22, 0x58, 0x2f, 0x3a, 0xda, 0xe9, 0x12, 0x00, 0x00, 0x00, 0x12, 0x00, 0x00,
+        0x00, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0xed, 0x81, 0x22, 0x00, 0x00,
+        0x00, 0x62, 0x69, 0x6e, 0x2f, 0x74, 0x6f, 0x6f, 0x6c, 0x50, 0x4b, 0x01, 0x02, 0x1e, 0x03, 0x0a, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0xd8, 0x20, 0x51, 0x5d, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x10, 0x00, 0xed, 0x41, 0x5a, 0x00, 0x00,
+        0x00, 0x69, 0x6e, 0x63, 0x6c, 0x75, 0x64, 0x65, 0x2f, 0x50, 0x4b, 0x01, 0x02, 0x1e, 0x03, 0x14, 0x00, 0x00,
+        0x00, 0x08, 0x00, 0x83, 0x18, 0x22, 0x58, 0x21, 0x38, 0xce, 0x00, 0x7c, 0x00, 0x00, 0x00, 0x5b, 0x02, 0x00,
+        0x00, 0x0f, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0xa4, 0x81, 0x80, 0x00, 0x00,
+        0x00, 0x69, 0x6e, 0x63, 0x6c, 0x75, 0x64, 0x65, 0x2f, 0x68, 0x65, 0x6c, 0x6c, 0x6f, 0x2e, 0x68, 0x50, 0x4b,
+        0x01, 0x02, 0x1e, 0x03, 0x0a, 0x00, 0x00, 0x00, 0x00, 0x00, 0xd8, 0x20, 0x51, 0x5d, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x10, 0x00, 0xed, 0x41, 0x29, 0x01, 0x00, 0x00, 0x6c, 0x69, 0x62, 0x2f, 0x50, 0x4b, 0x01, 0x02, 0x1e, 0x03,
+        0x0a, 0x00, 0x00, 0x00, 0x00, 0x00, 0x83, 0x18, 0x22, 0x58, 0xde, 0xe9, 0x63, 0xde, 0x0d, 0x00, 0x00, 0x00,
+        0x0d, 0x00, 0x00, 0x00, 0x0f, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0xa1,
+        0x4b, 0x01, 0x00, 0x00, 0x6c, 0x69, 0x62, 0x2f, 0x6c, 0x69, 0x62, 0x68, 0x65, 0x6c, 0x6c, 0x6f, 0x2e, 0x73,
+        0x6f, 0x50, 0x4b, 0x01, 0x02, 0x1e, 0x03, 0x0a, 0x00, 0x00, 0x00, 0x00, 0x00, 0x83, 0x18, 0x22, 0x58, 0xcc,
+        0x3b, 0x0f, 0xa9, 0x03, 0x00, 0x00, 0x00, 0x03, 0x00, 0x00, 0x00, 0x11, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x01, 0x00, 0x00, 0x00, 0xa4, 0x81, 0x85, 0x01, 0x00, 0x00, 0x6c, 0x69, 0x62, 0x2f, 0x6c, 0x69, 0x62,
+        0x68, 0x65, 0x6c, 0x6c, 0x6f, 0x2e, 0x73, 0x6f, 0x2e, 0x31, 0x50, 0x4b, 0x01, 0x02, 0x1e, 0x03, 0x0a, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0xd8, 0x20, 0x51, 0x5d, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x06, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x10, 0x00, 0xed, 0x41, 0xb7, 0x01,
+        0x00, 0x00, 0x73, 0x68, 0x61, 0x72, 0x65, 0x2f, 0x50, 0x4b, 0x01, 0x02, 0x1e, 0x03, 0x0a, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x83, 0x18, 0x22, 0x58, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x0c, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x10, 0x00, 0xed, 0x41, 0xdb, 0x01, 0x00, 0x00,
+        0x73, 0x68, 0x61, 0x72, 0x65, 0x2f, 0x65, 0x6d, 0x70, 0x74, 0x79, 0x2f, 0x50, 0x4b, 0x05, 0x06, 0x00, 0x00,
+        0x00, 0x00, 0x09, 0x00, 0x09, 0x00, 0xf7, 0x01, 0x00, 0x00, 0x05, 0x02, 0x00, 0x00, 0x00, 0x00,
+    };
+
+    unsigned int file_mode(const vcpkg::Path& path)
+    {
+        struct stat info;
+        REQUIRE(::lstat(path.c_str(), &info) == 0);
+        return static_cast<unsigned int>(info.st_mode);
+    }
+
+    struct ZipFixture
+    {
+        ZipFixture(vcpkg::StringView name) : root(vcpkg::Test::base_temporary_directory() / name)
+        {
+            vcpkg::real_filesystem.remove_all(root, VCPKG_LINE_INFO);
+            vcpkg::real_filesystem.create_directories(root, VCPKG_LINE_INFO);
+        }
+
+        ~ZipFixture() { vcpkg::real_filesystem.remove_all(root, vcpkg::IgnoreErrors{}); }
+
+        vcpkg::Path root;
+    };
+}
+
+TEST_CASE ("unzip_archives extracts archives created by zip", "[archives]")
+{
+    using namespace vcpkg;
+    ZipFixture fixture("unzip_archives_zip");
+    const auto archive = fixture.root / "archive.zip";
+    const auto destination = fixture.root / "out";
+    real_filesystem.write_contents(
+        archive,
+        StringView{reinterpret_cast<const char*>(archive_created_by_zip), sizeof(archive_created_by_zip)},
+        VCPKG_LINE_INFO);
+
+    ZipArchiveExtraction job{archive, destination};
+    auto results = unzip_archives(real_filesystem, View<ZipArchiveExtraction>{&job, 1});
+    REQUIRE(results.size() == 1);
+    REQUIRE(results[0].has_value());
+
+    auto header = real_filesystem.read_contents(destination / "include/hello.h", VCPKG_LINE_INFO);
+    CHECK(Strings::starts_with(header, "#pragma once\nint hello0();\n"));
+    CHECK(Strings::ends_with(header, "int hello39();\n"));
+    CHECK(real_filesystem.read_contents(destination / "lib/libhello.so.1", VCPKG_LINE_INFO) == "lib");
+    CHECK(real_filesystem.read_contents(destination / "lib/libhello.so", VCPKG_LINE_INFO) == "lib");
+    CHECK(real_filesystem.symlink_status(destination / "lib/libhello.so", IgnoreErrors{}) == FileType::symlink);
+    CHECK((file_mode(destination / "bin/tool") & 0777) == 0755);
+    CHECK(real_filesystem.is_directory(destination / "share/empty"));
+}
+
+TEST_CASE ("zip_directory round trips through unzip_archives", "[archives]")
+{
+    using namespace vcpkg;
+    ZipFixture fixture("zip_directory_round_trip");
+    const auto source = fixture.root / "source";
+    real_filesystem.create_directories(source / "share/empty", VCPKG_LINE_INFO);
+
+    // compressible, incompressible, and empty files
+    std::string text;
+    for (int i = 0; i < 5000; ++i)
+    {
+        text += fmt::format("line {} of a highly repetitive file\n", i % 37);
+    }
+
+    std::string noise;
+    std::uint32_t state = 12345;
+    for (int i = 0; i < 100000; ++i)
+    {
+        state = state * 1103515245u + 12345u;
+        noise.push_back(static_cast<char>(state >> 24));
+    }
+
+    real_filesystem.write_contents_and_dirs(source / "include/text.h", text, VCPKG_LINE_INFO);
+    real_filesystem.write_contents_and_dirs(source / "lib/noise.bin", noise, VCPKG_LINE_INFO);
+    real_filesystem.write_contents_and_dirs(source / "lib/empty.txt", "", VCPKG_LINE_INFO);
+    real_filesystem.write_contents_and_dirs(source / "bin/tool", "#!/bin/sh\n", VCPKG_LINE_INFO);
+    REQUIRE(::chmod((source / "bin/tool").c_str(), 0755) == 0);
+    real_filesystem.create_symlink("noise.bin", source / "lib/noise-link.bin", VCPKG_LINE_INFO);
+
+    const auto archive = fixture.root / "archive.zip";
+    const auto destination = fixture.root / "out";
+    BufferedDiagnosticContext bdc{out_sink};
+    REQUIRE(zip_directory(bdc, real_filesystem, source, archive));
+    CHECK(bdc.empty());
+    CHECK(real_filesystem.file_size(archive, VCPKG_LINE_INFO) < text.size() / 4 + noise.size() + 4096);
+
+    ZipArchiveExtraction job{archive, destination};
+    auto results = unzip_archives(real_filesystem, View<ZipArchiveExtraction>{&job, 1});
+    REQUIRE(results.size() == 1);
+    REQUIRE(results[0].has_value());
+
+    CHECK(real_filesystem.read_contents(destination / "include/text.h", VCPKG_LINE_INFO) == text);
+    CHECK(real_filesystem.read_contents(destination / "lib/noise.bin", VCPKG_LINE_INFO) == noise);
+    CHECK(real_filesystem.read_contents(destination / "lib/empty.txt", VCPKG_LINE_INFO).empty());
+    CHECK(real_filesystem.symlink_status(destination / "lib/noise-link.bin", IgnoreErrors{}) == FileType::symlink);
+    CHECK(real_filesystem.read_contents(destination / "lib/noise-link.bin", VCPKG_LINE_INFO) == noise);
+    CHECK((file_mode(destination / "bin/tool") & 0777) == 0755);
+    CHECK(real_filesystem.is_directory(destination / "share/empty"));
+
+    // corruption is detected rather than extracting garbage
+    auto contents = real_filesystem.read_contents(archive, VCPKG_LINE_INFO);
+    const auto text_offset = contents.find("include/text.h");
+    REQUIRE(text_offset != std::string::npos);
+    contents[text_offset + 40] = static_cast<char>(contents[text_offset + 40] ^ 0x55);
+    real_filesystem.write_contents(archive, contents, VCPKG_LINE_INFO);
+    real_filesystem.remove_all(destination, VCPKG_LINE_INFO);
+    results = unzip_archives(real_filesystem, View<ZipArchiveExtraction>{&job, 1});
+    REQUIRE(results.size() == 1);
+    CHECK(!results[0].has_value());
+
+    real_filesystem.write_contents(archive, "not a zip file", VCPKG_LINE_INFO);
+    results = unzip_archives(real_filesystem, View<ZipArchiveExtraction>{&job, 1});
+    REQUIRE(results.size() == 1);
+    CHECK(!results[0].has_value());
+}
+#endif
@@ -14,12 +14,12 @@ using namespace vcpkg;
 
 struct KnowNothingBinaryProvider : IReadBinaryProvider
 {
-    void fetch(View<const InstallPlanAction*> actions, Span<RestoreResult> out_status) const override
+    void fetch(View<const BinaryPackageReadInfo*> packages, Span<RestoreResult> out_status) const override
     {
-        REQUIRE(actions.size() == out_status.size());
+        REQUIRE(packages.size() == out_status.size());
         for (size_t idx = 0; idx < out_status.size(); ++idx)
         {
-            CHECK(actions[idx]->has_package_abi());
+            CHECK(!packages[idx]->package_abi.empty());
             CHECK(out_status[idx] == RestoreResult::unavailable);
         }
     }
@@ -36,6 +36,99 @@ struct KnowNothingBinaryProvider : IReadBinaryProvider
     {
         return LocalizedString::from_raw("Nothing");
     }
+
+    bool supports_concurrent_reads() const override { return true; }
+};
+
+// Reports the ABIs in `available` during precheck, but can only restore the ABIs in `restorable`.
+struct FakeReadBinaryProvider : IReadBinaryProvider
+{
+    FakeReadBinaryProvider(std::vector<std::string>&& available, std::vector<std::string>&& restorable)
+        : available(std::move(available)), restorable(std::move(restorable))
+    {
+    }
+
+    void fetch(View<const BinaryPackageReadInfo*> packages, Span<RestoreResult> out_status) const override
+    {
+        for (size_t idx = 0; idx < packages.size(); ++idx)
+        {
+            const auto& abi = packages[idx]->package_abi;
+            fetched.push_back(abi);
+            if (Util::Vectors::contains(restorable, abi))
+            {
+                out_status[idx] = RestoreResult::restored;
+            }
+        }
+    }
+
+    void precheck(View<const InstallPlanAction*> actions, Span<CacheAvailability> out_status) const override
+    {
+        for (size_t idx = 0; idx < actions.size(); ++idx)
+        {
+            const auto& abi = *actions[idx]->package_abi().get();
+            prechecked.push_back(abi);
+            out_status[idx] = Util::Vectors::contains(available, abi) ? CacheAvailability::available
+                                                                      : CacheAvailability::unavailable;
+        }
+    }
+
+    LocalizedString restored_message(size_t, std::chrono::high_resolution_clock::duration) const override
+    {
+        return LocalizedString::from_raw("Restored");
+    }
+
+    bool supports_concurrent_reads() const override { return true; }
+
+    std::vector<std::string> available;
+    std::vector<std::string> restorable;
+    // each provider is only ever used from one thread at a time
+    mutable std::vector<std::string> prechecked;
+    mutable std::vector<std::string> fetched;
+};
+
+// An install plan with an action for each of `names`, each using its name as its package ABI
+struct AbiInstallPlan
+{
+    explicit AbiInstallPlan(const std::vector<std::string>& names) : scfl(parse_zlib_control_file())
+    {
+        PackagesDirAssigner packages_dir_assigner{"test_packages_root"};
+        for (auto&& name : names)
+        {
+            actions.emplace_back(PackageSpec{name, Test::X64_WINDOWS},
+                                 scfl,
+                                 packages_dir_assigner,
+                                 RequestType::USER_REQUESTED,
+                                 UseHeadVersion::No,
+                                 Editable::No,
+                                 std::map<std::string, std::vector<FeatureSpec>>{},
+                                 std::vector<LocalizedString>{},
+                                 std::vector<std::string>{});
+            actions.back().abi_info = AbiInfo{};
+            actions.back().abi_info.get()->package_abi = name;
+        }
+    }
+
+    // the actions refer to scfl
+    AbiInstallPlan(const AbiInstallPlan&) = delete;
+    AbiInstallPlan& operator=(const AbiInstallPlan&) = delete;
+
+    SourceControlFileAndLocation scfl;
+    std::vector<InstallPlanAction> actions;
+
+private:
+    static SourceControlFileAndLocation parse_zlib_control_file()
+    {
+        auto pghs = Paragraphs::parse_paragraphs(R"(
+Source: zlib
+Version: 1.5
+Description: a spiffy compression library wrapper
+)",
+                                                 "<testdata>");
+        REQUIRE(pghs.has_value());
+        auto maybe_scf = SourceControlFile::parse_control_file("test-origin", std::move(*pghs.get()));
+        REQUIRE(maybe_scf.has_value());
+        return SourceControlFileAndLocation{std::move(*maybe_scf.get()), Path()};
+    }
 };
 
 TEST_CASE ("CacheStatus operations", "[BinaryCache]")
@@ -66,6 +159,15 @@ TEST_CASE ("CacheStatus operations", "[BinaryCache]")
     REQUIRE(available.get_available_provider() == &know_nothing);
     REQUIRE(!available.is_restored());
 
+    CacheStatus no_longer_available;
+    no_longer_available.mark_available(&know_nothing);
+    no_longer_available.mark_unavailable(&know_nothing);
+    REQUIRE(!no_longer_available.should_attempt_precheck(&know_nothing));
+    REQUIRE(!no_longer_available.should_attempt_restore(&know_nothing));
+    REQUIRE(no_longer_available.is_unavailable(&know_nothing));
+    REQUIRE(no_longer_available.get_available_provider() == nullptr);
+    REQUIRE(!no_longer_available.is_restored());
+
     CacheStatus restored;
     restored.mark_restored();
     REQUIRE(!restored.should_attempt_precheck(&know_nothing));
@@ -360,6 +462,150 @@ Description:
     uut.fetch(install_plan); // should have no effects
 }
 
+TEST_CASE ("Read providers are combined in configuration order", "[BinaryCache]")
+{
+    AbiInstallPlan plan{{"a", "b", "c", "d"}};
+    const auto& install_plan = plan.actions;
+
+    ReadOnlyBinaryCache uut;
+    auto first = std::make_unique<FakeReadBinaryProvider>(std::vector<std::string>{"a", "b"},
+                                                          std::vector<std::string>{"a"});
+    auto second = std::make_unique<FakeReadBinaryProvider>(std::vector<std::string>{"b", "c"},
+                                                           std::vector<std::string>{"b", "c"});
+    const auto& first_calls = *first;
+    const auto& second_calls = *second;
+    uut.install_read_provider(std::move(first));
+    uut.install_read_provider(std::move(second));
+
+    auto action_ptrs = Util::fmap(install_plan, [](const InstallPlanAction& action) { return &action; });
+    CHECK(uut.precheck(action_ptrs) == std::vector<CacheAvailability>{CacheAvailability::available,
+                                                                       CacheAvailability::available,
+                                                                       CacheAvailability::available,
+                                                                       CacheAvailability::unavailable});
+    // both providers were asked about everything at once
+    CHECK(first_calls.prechecked == std::vector<std::string>{"a", "b", "c", "d"});
+    CHECK(second_calls.prechecked == std::vector<std::string>{"a", "b", "c", "d"});
+
+    // "b" goes to the first provider, which claimed it first, then falls back to the second when that fails
+    uut.fetch(install_plan);
+    CHECK(uut.is_restored(install_plan[0]));
+    CHECK(uut.is_restored(install_plan[1]));
+    CHECK(uut.is_restored(install_plan[2]));
+    CHECK(!uut.is_restored(install_plan[3]));
+    CHECK(first_calls.fetched == std::vector<std::string>{"a", "b"});
+    CHECK(second_calls.fetched == std::vector<std::string>{"c", "b"});
+    // the availability learned by precheck is reused rather than asked for again
+    CHECK(first_calls.prechecked.size() == 4);
+    CHECK(second_calls.prechecked.size() == 4);
+}
+
+TEST_CASE ("Fetch without precheck asks providers in configuration order", "[BinaryCache]")
+{
+    AbiInstallPlan plan{{"a", "b", "c"}};
+    const auto& install_plan = plan.actions;
+
+    ReadOnlyBinaryCache uut;
+    auto first = std::make_unique<FakeReadBinaryProvider>(std::vector<std::string>{"a"},
+                                                          std::vector<std::string>{"a"});
+    auto second = std::make_unique<FakeReadBinaryProvider>(std::vector<std::string>{"b"},
+                                                           std::vector<std::string>{"b"});
+    const auto& first_calls = *first;
+    const auto& second_calls = *second;
+    uut.install_read_provider(std::move(first));
+    uut.install_read_provider(std::move(second));
+
+    uut.fetch(install_plan);
+    CHECK(uut.is_restored(install_plan[0]));
+    CHECK(uut.is_restored(install_plan[1]));
+    CHECK(!uut.is_restored(install_plan[2]));
+    CHECK(first_calls.prechecked.empty());
+    CHECK(second_calls.prechecked.empty());
+    CHECK(first_calls.fetched == std::vector<std::string>{"a", "b", "c"});
+    CHECK(second_calls.fetched == std::vector<std::string>{"b", "c"});
+}
+
+// Records the size of every fetch call
+struct BatchRecordingBinaryProvider : IReadBinaryProvider
+{
+    void fetch(View<const BinaryPackageReadInfo*> packages, Span<RestoreResult> out_status) const override
+    {
+        batch_sizes.push_back(packages.size());
+        for (size_t idx = 0; idx < packages.size(); ++idx)
+        {
+            fetched.push_back(packages[idx]->package_abi);
+            out_status[idx] = RestoreResult::restored;
+        }
+    }
+
+    void precheck(View<const InstallPlanAction*>, Span<CacheAvailability>) const override { }
+
+    LocalizedString restored_message(size_t, std::chrono::high_resolution_clock::duration) const override
+    {
+        return LocalizedString::from_raw("Restored");
+    }
+
+    bool supports_concurrent_reads() const override { return true; }
+
+    mutable std::vector<size_t> batch_sizes;
+    mutable std::vector<std::string> fetched;
+};
+
+TEST_CASE ("Fetch restores in batches in plan order", "[BinaryCache]")
+{
+    std::vector<std::string> names;
+    for (size_t idx = 0; idx < 30; ++idx)
+    {
+        names.push_back(fmt::format("port{}", idx));
+    }
+
+    AbiInstallPlan plan{names};
+    const auto& install_plan = plan.actions;
+
+    ReadOnlyBinaryCache uut;
+    auto provider = std::make_unique<BatchRecordingBinaryProvider>();
+    const auto& calls = *provider;
+    uut.install_read_provider(std::move(provider));
+
+    // already restored packages are not fetched again
+    uut.mark_restored(install_plan[3]);
+    uut.fetch(install_plan);
+    for (auto&& action : install_plan)
+    {
+        CHECK(uut.is_restored(action));
+    }
+
+    names.erase(names.begin() + 3);
+    CHECK(calls.batch_sizes == std::vector<size_t>{8, 16, 5});
+    CHECK(calls.fetched == names);
+}
+
+TEST_CASE ("Fetch does not refer to the plan after returning", "[BinaryCache]")
+{
+    std::vector<std::string> names;
+    for (size_t idx = 0; idx < 30; ++idx)
+    {
+        names.push_back(fmt::format("port{}", idx));
+    }
+
+    ReadOnlyBinaryCache uut;
+    auto provider = std::make_unique<BatchRecordingBinaryProvider>();
+    const auto& calls = *provider;
+    uut.install_read_provider(std::move(provider));
+
+    {
+        AbiInstallPlan plan{names};
+        uut.fetch(plan.actions);
+    }
+
+    AbiInstallPlan same_abis{names};
+    for (auto&& action : same_abis.actions)
+    {
+        CHECK(uut.is_restored(action));
+    }
+
+    CHECK(calls.fetched == names);
+}
+
 TEST_CASE ("XmlSerializer", "[XmlSerializer]")
 {
     XmlSerializer xml;
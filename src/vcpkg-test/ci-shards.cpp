@@ -0,0 +1,497 @@
+#include <vcpkg-test/util.h>
+
+#include <vcpkg/base/contractual-constants.h>
+#include <vcpkg/base/json.h>
+
+#include <vcpkg/ci-shards.h>
+#include <vcpkg/commands.build.h>
+#include <vcpkg/dependencies.h>
+#include <vcpkg/portfileprovider.h>
+
+#include <map>
+#include <set>
+
+#include <vcpkg-test/mockcmakevarprovider.h>
+
+using namespace vcpkg;
+
+using Test::MockCMakeVarProvider;
+using Test::PackageSpecMap;
+
+namespace
+{
+    struct ShardNames
+    {
+        // the ports which the shard builds
+        std::set<std::string> built;
+        // the ports which the shard installs, including those built by other shards or cached
+        std::set<std::string> kept;
+        std::map<std::string, size_t> waves;
+        size_t wave_count;
+    };
+
+    ActionPlan make_plan(const PackageSpecMap& spec_map)
+    {
+        MapPortFileProvider map_port(spec_map.map);
+        MockCMakeVarProvider var_provider;
+        std::vector<FullPackageSpec> specs;
+        for (auto&& entry : spec_map.map)
+        {
+            specs.emplace_back(PackageSpec{entry.first, Test::X86_WINDOWS},
+                               InternalFeatureSet{FeatureNameCore.to_string()});
+        }
+
+        PackagesDirAssigner packages_dir_assigner{"pkg"};
+        const CreateInstallPlanOptions create_options{
+            nullptr, Test::X64_ANDROID, UnsupportedPortAction::Error, UseHeadVersion::No, Editable::No};
+        return create_feature_install_plan(map_port, var_provider, specs, {}, packages_dir_assigner, create_options);
+    }
+
+    ShardNames shard_names(const PackageSpecMap& spec_map,
+                           const std::map<PackageSpec, BuildResult>& known,
+                           const std::map<PackageSpec, double>& build_seconds,
+                           CiShard shard)
+    {
+        auto action_plan = make_plan(spec_map);
+        const auto targets = assign_ci_shards(action_plan, known, build_seconds, shard.count);
+        // the other shards may see a different part of the plan cached; the targets must not depend on it
+        const auto uncached_targets = assign_ci_shards(action_plan, {}, build_seconds, shard.count);
+        REQUIRE(targets.size() == uncached_targets.size());
+        for (auto&& target : targets)
+        {
+            auto it_uncached = uncached_targets.find(target.first);
+            REQUIRE(it_uncached != uncached_targets.end());
+            CHECK(target.second.shard == it_uncached->second.shard);
+            CHECK(target.second.wave == it_uncached->second.wave);
+        }
+
+        const auto shard_plan = shard_action_plan(action_plan, known, targets, shard);
+
+        ShardNames names;
+        names.wave_count = shard_plan.wave_count;
+        for (auto&& action : action_plan.install_actions)
+        {
+            names.kept.insert(action.spec.name());
+            if (!Util::Sets::contains(known, action.spec) &&
+                !Util::Sets::contains(shard_plan.built_elsewhere, action.spec))
+            {
+                names.built.insert(action.spec.name());
+            }
+
+            auto it_wave = shard_plan.waves.find(action.spec);
+            REQUIRE(it_wave != shard_plan.waves.end());
+            CHECK(it_wave->second < shard_plan.wave_count);
+            names.waves.emplace(action.spec.name(), it_wave->second);
+        }
+
+        return names;
+    }
+
+    // Other shards as scripted by a test: each port is pending until the poll in available_at or failed_at, and every
+    // pause takes 10 seconds.
+    struct ScriptedShards final : ICiShardObserver
+    {
+        std::map<std::string, size_t> available_at;
+        std::map<std::string, size_t> failed_at;
+        size_t polls = 0;
+        std::vector<std::string> polled;
+
+        std::vector<CiShardPortState> poll(View<const InstallPlanAction*> actions) override
+        {
+            std::vector<CiShardPortState> states;
+            for (auto action : actions)
+            {
+                const auto& name = action->spec.name();
+                polled.push_back(name);
+                auto it_available = available_at.find(name);
+                auto it_failed = failed_at.find(name);
+                if (it_available != available_at.end() && it_available->second <= polls)
+                {
+                    states.push_back(CiShardPortState::Available);
+                }
+                else if (it_failed != failed_at.end() && it_failed->second <= polls)
+                {
+                    states.push_back(CiShardPortState::Failed);
+                }
+                else
+                {
+                    states.push_back(CiShardPortState::Pending);
+                }
+            }
+
+            ++polls;
+            return states;
+        }
+
+        void pause() override { ++pauses; }
+
+        std::chrono::seconds elapsed() const override { return std::chrono::seconds(10 * pauses); }
+
+        size_t pauses = 0;
+    };
+
+    std::vector<std::string> action_names(const std::vector<InstallPlanAction>& actions)
+    {
+        return Util::fmap(actions, [](const InstallPlanAction& action) { return action.spec.name(); });
+    }
+
+    // Moves the actions of a fresh plan for spec_map with the given names.
+    std::vector<InstallPlanAction> plan_actions(const PackageSpecMap& spec_map, const std::set<std::string>& names)
+    {
+        auto actions = make_plan(spec_map).install_actions;
+        Util::erase_remove_if(actions,
+                              [&](const InstallPlanAction& action) { return !names.count(action.spec.name()); });
+        return actions;
+    }
+
+    std::set<PackageSpec> all_specs(const std::vector<InstallPlanAction>& actions)
+    {
+        std::set<PackageSpec> specs;
+        for (auto&& action : actions)
+        {
+            specs.insert(action.spec);
+        }
+
+        return specs;
+    }
+}
+
+TEST_CASE ("parse_ci_shard", "[ci-shards]")
+{
+    auto shard = parse_ci_shard("2/4").value_or_exit(VCPKG_LINE_INFO);
+    CHECK(shard.index == 1);
+    CHECK(shard.count == 4);
+    shard = parse_ci_shard("1/1").value_or_exit(VCPKG_LINE_INFO);
+    CHECK(shard.index == 0);
+    CHECK(shard.count == 1);
+
+    CHECK(!parse_ci_shard("").has_value());
+    CHECK(!parse_ci_shard("2").has_value());
+    CHECK(!parse_ci_shard("0/4").has_value());
+    CHECK(!parse_ci_shard("5/4").has_value());
+    CHECK(!parse_ci_shard("-1/4").has_value());
+    CHECK(!parse_ci_shard("a/4").has_value());
+    CHECK(!parse_ci_shard("1/4/2").has_value());
+}
+
+TEST_CASE ("shard_action_plan", "[ci-shards]")
+{
+    PackageSpecMap spec_map;
+    spec_map.emplace("a");
+    spec_map.emplace("b", "a");
+    spec_map.emplace("c", "b");
+    spec_map.emplace("d");
+    spec_map.emplace("e");
+    spec_map.emplace("cached");
+    spec_map.emplace("f", "cached");
+
+    const std::map<PackageSpec, BuildResult> known{
+        {PackageSpec{"cached", Test::X86_WINDOWS}, BuildResult::Succeeded},
+    };
+
+    SECTION ("a single shard keeps everything")
+    {
+        auto names = shard_names(spec_map, known, {}, CiShard{0, 1});
+        CHECK(names.kept == std::set<std::string>{"a", "b", "c", "d", "e", "cached", "f"});
+        CHECK(names.built == std::set<std::string>{"a", "b", "c", "d", "e", "f"});
+    }
+
+    SECTION ("every port to build lands in exactly one shard")
+    {
+        for (size_t count = 2; count < 6; ++count)
+        {
+            std::multiset<std::string> built;
+            for (size_t index = 0; index < count; ++index)
+            {
+                auto names = shard_names(spec_map, known, {}, CiShard{index, count});
+                // the dependencies of the ports a shard builds are built in earlier waves, and those built by
+                // other shards are installed at the latest in the same wave
+                if (names.built.count("c"))
+                {
+                    CHECK(names.waves.at("b") <= names.waves.at("c") - names.built.count("b"));
+                }
+
+                if (names.built.count("b"))
+                {
+                    CHECK(names.waves.at("a") <= names.waves.at("b") - names.built.count("a"));
+                }
+
+                // known ports are kept only for the shards which depend on them
+                CHECK(names.kept.count("cached") == names.kept.count("f"));
+                built.insert(names.built.begin(), names.built.end());
+            }
+
+            CHECK(built == std::multiset<std::string>{"a", "b", "c", "d", "e", "f"});
+        }
+    }
+
+    SECTION ("history balances the shards")
+    {
+        const std::map<PackageSpec, double> build_seconds{
+            {PackageSpec{"a", Test::X86_WINDOWS}, 10.0},
+            {PackageSpec{"b", Test::X86_WINDOWS}, 10.0},
+            {PackageSpec{"c", Test::X86_WINDOWS}, 10.0},
+            {PackageSpec{"d", Test::X86_WINDOWS}, 20.0},
+            {PackageSpec{"e", Test::X86_WINDOWS}, 5.0},
+            {PackageSpec{"f", Test::X86_WINDOWS}, 5.0},
+        };
+
+        auto first = shard_names(spec_map, known, build_seconds, CiShard{0, 2});
+        CHECK(first.built == std::set<std::string>{"b", "d"});
+        CHECK(first.kept == std::set<std::string>{"a", "b", "d"});
+        CHECK(first.waves == std::map<std::string, size_t>{{"a", 1}, {"b", 1}, {"d", 0}});
+        CHECK(first.wave_count == 2);
+
+        auto second = shard_names(spec_map, known, build_seconds, CiShard{1, 2});
+        CHECK(second.built == std::set<std::string>{"a", "c", "e", "f"});
+        CHECK(second.kept == std::set<std::string>{"a", "b", "c", "e", "cached", "f"});
+        CHECK(second.waves ==
+              std::map<std::string, size_t>{{"a", 0}, {"b", 2}, {"c", 2}, {"e", 0}, {"cached", 1}, {"f", 1}});
+        CHECK(second.wave_count == 3);
+    }
+}
+
+TEST_CASE ("shard_action_plan full rebuild", "[ci-shards]")
+{
+    // host tools like vcpkg-cmake connect nearly every port, which must not put them all in one shard
+    PackageSpecMap spec_map;
+    spec_map.emplace("tool");
+    for (int i = 0; i < 8; ++i)
+    {
+        spec_map.emplace(("port" + std::to_string(i)).c_str(), "tool");
+    }
+
+    std::multiset<std::string> built;
+    for (size_t index = 0; index < 2; ++index)
+    {
+        auto names = shard_names(spec_map, {}, {}, CiShard{index, 2});
+        CHECK(names.built.size() - names.built.count("tool") == 4);
+        CHECK(names.kept.count("tool") == 1);
+        // a dependency built by another shard is installed in the first wave which needs it
+        CHECK(names.waves.at("tool") == (names.built.count("tool") ? 0 : 1));
+        CHECK(names.wave_count == 2);
+        for (auto&& name : names.built)
+        {
+            if (name != "tool")
+            {
+                CHECK(names.waves.at(name) == 1);
+            }
+        }
+
+        built.insert(names.built.begin(), names.built.end());
+    }
+
+    CHECK(built.size() == 9);
+    CHECK(built.count("tool") == 1);
+}
+
+TEST_CASE ("shard_action_plan port weight", "[ci-shards]")
+{
+    // without history, a port which depends on more ports is expected to take longer to build
+    PackageSpecMap spec_map;
+    spec_map.emplace("v");
+    spec_map.emplace("w");
+    spec_map.emplace("x");
+    spec_map.emplace("y");
+    spec_map.emplace("z");
+    spec_map.emplace("big", "v, w, x, y, z");
+    spec_map.emplace("mid1", "x");
+    spec_map.emplace("mid2", "x");
+    spec_map.emplace("mid3", "x");
+
+    // the time per weight of the ports with history scales the weights of the others
+    const std::map<PackageSpec, double> build_seconds{
+        {PackageSpec{"x", Test::X86_WINDOWS}, 10.0},
+    };
+
+    for (size_t index = 0; index < 2; ++index)
+    {
+        auto names = shard_names(spec_map, {}, build_seconds, CiShard{index, 2});
+        if (names.built.count("big"))
+        {
+            CHECK(names.built.count("mid1") + names.built.count("mid2") + names.built.count("mid3") == 0);
+        }
+        else
+        {
+            CHECK(names.built.count("mid1") + names.built.count("mid2") + names.built.count("mid3") == 3);
+        }
+    }
+}
+
+TEST_CASE ("ci results round trip", "[ci-shards]")
+{
+    std::vector<CiResult> results;
+    results.push_back(CiResult{PackageSpec{"zlib", Test::X64_LINUX},
+                               "*",
+                               BuildResult::Succeeded,
+                               "0123abcd",
+                               {"core", "extra"},
+                               ElapsedTime{std::chrono::milliseconds(1500)},
+                               std::chrono::system_clock::time_point{std::chrono::milliseconds(1700000000123)}});
+    results.push_back(CiResult{PackageSpec{"curl", Test::X64_LINUX},
+                               "cascade",
+                               BuildResult::CascadedDueToMissingDependencies,
+                               "",
+                               {},
+                               ElapsedTime{},
+                               std::chrono::system_clock::time_point{}});
+
+    auto serialized = Json::stringify(serialize_ci_results(results));
+    auto parsed_json = Json::parse(serialized, "test").value_or_exit(VCPKG_LINE_INFO).value;
+    auto parsed = parse_ci_results(parsed_json, "test").value_or_exit(VCPKG_LINE_INFO);
+    REQUIRE(parsed.size() == 2);
+    CHECK(parsed[0].spec == results[0].spec);
+    CHECK(parsed[0].state == "*");
+    CHECK(parsed[0].result == BuildResult::Succeeded);
+    CHECK(parsed[0].abi == "0123abcd");
+    CHECK(parsed[0].features == std::vector<std::string>{"core", "extra"});
+    CHECK(parsed[0].elapsed.as<std::chrono::milliseconds>().count() == 1500);
+    CHECK(parsed[0].start_time == results[0].start_time);
+    CHECK(parsed[1].spec == results[1].spec);
+    CHECK(parsed[1].state == "cascade");
+    CHECK(parsed[1].result == BuildResult::CascadedDueToMissingDependencies);
+    CHECK(parsed[1].features.empty());
+
+    auto build_seconds = get_ci_build_seconds(parsed);
+    REQUIRE(build_seconds.size() == 1);
+    CHECK(build_seconds.begin()->first == results[0].spec);
+    CHECK(build_seconds.begin()->second == 1.5);
+
+    CHECK(!parse_ci_results(Json::Value::string("not an array"), "test").has_value());
+    auto missing_field = Json::parse(R"([{"name": "zlib", "triplet": "x64-linux"}])", "test");
+    CHECK(!parse_ci_results(missing_field.value_or_exit(VCPKG_LINE_INFO).value, "test").has_value());
+}
+
+TEST_CASE ("merge_ci_results", "[ci-shards]")
+{
+    const auto make_result = [](StringLiteral name, StringLiteral state, BuildResult result) {
+        return CiResult{PackageSpec{name.to_string(), Test::X64_LINUX},
+                        state.to_string(),
+                        result,
+                        "",
+                        {},
+                        ElapsedTime{},
+                        std::chrono::system_clock::time_point{}};
+    };
+
+    std::vector<std::vector<CiResult>> shards(2);
+    shards[0].push_back(make_result("b", "*", BuildResult::BuildFailed));
+    shards[0].push_back(make_result("a", "pass", BuildResult::Succeeded));
+    shards[0].push_back(make_result("c", "cascade", BuildResult::CascadedDueToMissingDependencies));
+    shards[1].push_back(make_result("a", "pass", BuildResult::Succeeded));
+    shards[1].push_back(make_result("c", "*", BuildResult::Succeeded));
+
+    auto merged = merge_ci_results(shards);
+    REQUIRE(merged.size() == 3);
+    CHECK(merged[0].spec.name() == "a");
+    CHECK(merged[0].state == "pass");
+    CHECK(merged[1].spec.name() == "b");
+    CHECK(merged[1].result == BuildResult::BuildFailed);
+    CHECK(merged[2].spec.name() == "c");
+    CHECK(merged[2].state == "*");
+    CHECK(merged[2].result == BuildResult::Succeeded);
+}
+
+TEST_CASE ("CiShardWaiter gives up on failed dependencies", "[ci-shards]")
+{
+    PackageSpecMap spec_map;
+    spec_map.emplace("a");
+    spec_map.emplace("b", "a");
+    spec_map.emplace("c", "b");
+    spec_map.emplace("d");
+    spec_map.emplace("e", "d");
+    auto actions = make_plan(spec_map).install_actions;
+    REQUIRE(action_names(actions) == std::vector<std::string>{"a", "b", "c", "d", "e"});
+
+    // every port is built elsewhere, a and b on shard 1, the others on shard 2
+    std::map<PackageSpec, CiShardTarget> targets;
+    for (auto&& action : actions)
+    {
+        const auto& name = action.spec.name();
+        targets.emplace(action.spec, CiShardTarget{name == "a" || name == "b" ? size_t{1} : size_t{2}, 0});
+    }
+
+    const auto built_elsewhere = all_specs(actions);
+    CiShardWaiter waiter(targets, std::chrono::seconds(1800));
+    ScriptedShards shards;
+    shards.failed_at["a"] = 0;
+    shards.available_at["d"] = 2;
+    shards.available_at["e"] = 2;
+    auto wave = std::move(actions);
+    waiter.wait(wave, built_elsewhere, shards);
+    // b and c depend on a, which failed, so only d and e are waited for
+    CHECK(action_names(wave) == std::vector<std::string>{"d", "e"});
+    CHECK(shards.pauses == 2);
+    CHECK(shards.polled == std::vector<std::string>{"a", "b", "c", "d", "e", "d", "e", "d", "e"});
+
+    // the ports depending on ports given up on in earlier waves aren't waited for
+    shards.polled.clear();
+    wave = plan_actions(spec_map, {"b", "c"});
+    waiter.wait(wave, built_elsewhere, shards);
+    CHECK(wave.empty());
+    CHECK(shards.polled.empty());
+}
+
+TEST_CASE ("CiShardWaiter gives up on dependents of this shard's failures", "[ci-shards]")
+{
+    PackageSpecMap spec_map;
+    spec_map.emplace("a");
+    spec_map.emplace("b", "a");
+    auto actions = make_plan(spec_map).install_actions;
+    REQUIRE(action_names(actions) == std::vector<std::string>{"a", "b"});
+
+    std::map<PackageSpec, CiShardTarget> targets{
+        {actions[0].spec, CiShardTarget{0, 0}},
+        {actions[1].spec, CiShardTarget{1, 1}},
+    };
+
+    CiShardWaiter waiter(targets, std::chrono::seconds(1800));
+    ScriptedShards shards;
+    waiter.record_failure(actions[0].spec);
+    std::vector<InstallPlanAction> wave;
+    wave.push_back(std::move(actions[1]));
+    waiter.wait(wave, {wave[0].spec}, shards);
+    CHECK(wave.empty());
+    CHECK(shards.polled.empty());
+}
+
+TEST_CASE ("CiShardWaiter times out shards which make no progress", "[ci-shards]")
+{
+    PackageSpecMap spec_map;
+    spec_map.emplace("a");
+    spec_map.emplace("b");
+    spec_map.emplace("c");
+    spec_map.emplace("d", "c");
+    spec_map.emplace("e");
+    spec_map.emplace("f");
+    auto actions = make_plan(spec_map).install_actions;
+    REQUIRE(action_names(actions) == std::vector<std::string>{"a", "b", "c", "d", "e", "f"});
+
+    // c never arrives from shard 2
+    std::map<PackageSpec, CiShardTarget> targets;
+    for (auto&& action : actions)
+    {
+        const auto& name = action.spec.name();
+        targets.emplace(action.spec, CiShardTarget{name == "c" || name == "f" ? size_t{2} : size_t{1}, 0});
+    }
+
+    const auto built_elsewhere = all_specs(actions);
+    CiShardWaiter waiter(targets, std::chrono::seconds(30));
+    ScriptedShards shards;
+    shards.available_at["a"] = 2;
+    shards.available_at["b"] = 5;
+    shards.available_at["e"] = 0;
+    shards.available_at["f"] = 0;
+    auto wave = plan_actions(spec_map, {"a", "b", "c", "d"});
+    waiter.wait(wave, built_elsewhere, shards);
+    // b arrives 30 seconds after a, which restarts the timeout; c then times out, and d depends on it
+    CHECK(action_names(wave) == std::vector<std::string>{"a", "b"});
+    CHECK(shards.pauses == 8);
+
+    // shard 2 isn't waited for again, unlike shard 1
+    shards.polled.clear();
+    wave = plan_actions(spec_map, {"e", "f"});
+    waiter.wait(wave, built_elsewhere, shards);
+    CHECK(action_names(wave) == std::vector<std::string>{"e"});
+    CHECK(shards.polled == std::vector<std::string>{"e"});
+}
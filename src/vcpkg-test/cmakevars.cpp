@@ -0,0 +1,75 @@
+#include <vcpkg-test/util.h>
+
+#include <vcpkg/base/strings.h>
+
+#include <vcpkg/cmakevars.h>
+
+using namespace vcpkg;
+using namespace vcpkg::CMakeVars;
+
+namespace
+{
+    using PortVars = std::vector<std::pair<std::string, std::string>>;
+
+    constexpr StringLiteral PORT_START = "d8187afd-ea4a-4fc3-9aa4-a6782e1ed9af";
+    constexpr StringLiteral PORT_END = "8c504940-be29-4cba-9f8f-6cd83e9d87b7";
+    constexpr StringLiteral BLOCK_START = "c35112b6-d1ba-415b-aa5d-81de856ef8eb";
+    constexpr StringLiteral BLOCK_END = "e1e74b5c-18cb-4474-a6bd-5c1c8bc81f3f";
+
+    bool parse_output(std::vector<PortVars>& vars, View<StringView> lines)
+    {
+        CMakeVarsOutputParser parser{vars};
+        for (auto&& line : lines)
+        {
+            parser.parse_line(line);
+        }
+
+        return parser.is_complete();
+    }
+}
+
+TEST_CASE ("parse cmake var extraction output", "[cmakevars]")
+{
+    std::vector<PortVars> vars(2);
+    const StringView lines[] = {
+        "-- some unrelated output",
+        PORT_START,
+        "a message printed by the triplet",
+        BLOCK_START,
+        "VCPKG_TARGET_ARCHITECTURE=x64",
+        "VCPKG_BUILD_TYPE",
+        BLOCK_END,
+        "a warning between blocks",
+        BLOCK_START,
+        "VCPKG_ENV_PASSTHROUGH=PATH;INCLUDE",
+        BLOCK_END,
+        PORT_END,
+        PORT_START,
+        BLOCK_START,
+        "VCPKG_TARGET_ARCHITECTURE=arm64",
+        BLOCK_END,
+        PORT_END,
+    };
+
+    REQUIRE(parse_output(vars, lines));
+    CHECK(vars[0] == PortVars{{"VCPKG_TARGET_ARCHITECTURE", "x64"},
+                              {"VCPKG_BUILD_TYPE", ""},
+                              {"VCPKG_ENV_PASSTHROUGH", "PATH;INCLUDE"}});
+    CHECK(vars[1] == PortVars{{"VCPKG_TARGET_ARCHITECTURE", "arm64"}});
+}
+
+TEST_CASE ("parse incomplete cmake var extraction output", "[cmakevars]")
+{
+    std::vector<PortVars> vars(2);
+    const StringView missing_port[] = {PORT_START, BLOCK_START, "A=1", BLOCK_END, PORT_END};
+    CHECK(!parse_output(vars, missing_port));
+
+    vars = std::vector<PortVars>(1);
+    const StringView unterminated_port[] = {PORT_START, BLOCK_START, "A=1", BLOCK_END};
+    CHECK(!parse_output(vars, unterminated_port));
+
+    vars = std::vector<PortVars>(1);
+    const StringView extra_port[] = {PORT_START, PORT_END, PORT_START, BLOCK_START, "A=1", BLOCK_END, PORT_END};
+    CHECK(!parse_output(vars, extra_port));
+    CHECK(vars[0].empty());
+}
@@ -1,9 +1,27 @@
 #include <vcpkg-test/util.h>
 
+#include <vcpkg/base/contractual-constants.h>
+
 #include <vcpkg/commands.install.h>
+#include <vcpkg/commands.install.test.h>
+#include <vcpkg/dependencies.h>
+#include <vcpkg/portfileprovider.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include <vcpkg-test/mockcmakevarprovider.h>
 
 using namespace vcpkg;
 
+using Test::MockCMakeVarProvider;
+using Test::PackageSpecMap;
+
 TEST_CASE ("get_cmake_add_library_names", "[install]")
 {
     constexpr static StringLiteral fmt_targets = R"cmake(
@@ -163,3 +181,224 @@ cmake_policy(POP)
     CHECK(get_cmake_find_package_name("Pro", "ProjConfig.cmake") == "");
     CHECK(get_cmake_find_package_name("proj", "Findproj.cmake") == "");
 }
+
+namespace
+{
+    ActionPlan make_install_plan(const PackageSpecMap& spec_map)
+    {
+        MapPortFileProvider map_port(spec_map.map);
+        MockCMakeVarProvider var_provider;
+        std::vector<FullPackageSpec> specs;
+        for (auto&& entry : spec_map.map)
+        {
+            specs.emplace_back(PackageSpec{entry.first, Test::X86_WINDOWS},
+                               InternalFeatureSet{FeatureNameCore.to_string()});
+        }
+
+        PackagesDirAssigner packages_dir_assigner{"pkg"};
+        const CreateInstallPlanOptions create_options{
+            nullptr, Test::X64_ANDROID, UnsupportedPortAction::Error, UseHeadVersion::No, Editable::No};
+        return create_feature_install_plan(map_port, var_provider, specs, {}, packages_dir_assigner, create_options);
+    }
+
+    // Builds by name: ports in failing fail, ports in restored are installed without building, and a port whose
+    // dependencies in the plan were not installed cascades, as with the status database.
+    struct StubInstallSteps final : IParallelInstallSteps
+    {
+        explicit StubInstallSteps(const ActionPlan& plan) : actions(plan.install_actions) { }
+
+        bool needs_build(size_t install_index) const override
+        {
+            return !Util::Sets::contains(restored, name(install_index));
+        }
+
+        void start(size_t install_index) override
+        {
+            for (auto&& dependency : actions[install_index].package_dependencies)
+            {
+                if (dependency != actions[install_index].spec && is_in_plan(dependency))
+                {
+                    CHECK(Util::Sets::contains(finished, dependency.name()));
+                }
+            }
+
+            CHECK(started.insert(name(install_index)).second);
+        }
+
+        ExtendedBuildResult install(size_t install_index) override
+        {
+            installed.insert(name(install_index));
+            return ExtendedBuildResult{BuildResult::Succeeded};
+        }
+
+        Optional<ExtendedBuildResult> check_build(size_t install_index) override
+        {
+            for (auto&& dependency : actions[install_index].package_dependencies)
+            {
+                if (dependency != actions[install_index].spec && is_in_plan(dependency) &&
+                    !Util::Sets::contains(installed, dependency.name()))
+                {
+                    return ExtendedBuildResult{BuildResult::CascadedDueToMissingDependencies};
+                }
+            }
+
+            return nullopt;
+        }
+
+        ExtendedBuildResult build(size_t install_index) override
+        {
+            const auto& port = name(install_index);
+            std::unique_lock<std::mutex> lock(mtx);
+            built.insert(port);
+            max_running = std::max(max_running, ++running);
+            if (port == wait_for_failure)
+            {
+                // stays in flight until the failing build has been reported
+                // Catch assertions are not thread safe, so this is checked by the test
+                waited_for_failure = cv.wait_for(lock, std::chrono::seconds(10), [this]() { return failure_reported; });
+            }
+            else
+            {
+                lock.unlock();
+                std::this_thread::sleep_for(std::chrono::milliseconds(20));
+                lock.lock();
+            }
+
+            --running;
+            return ExtendedBuildResult{Util::Sets::contains(failing, port) ? BuildResult::BuildFailed
+                                                                          : BuildResult::Succeeded};
+        }
+
+        ExtendedBuildResult finish_build(size_t install_index, ExtendedBuildResult&& result) override
+        {
+            if (result.code == BuildResult::Succeeded)
+            {
+                installed.insert(name(install_index));
+            }
+
+            return std::move(result);
+        }
+
+        void finish(size_t install_index, ExtendedBuildResult&& result) override
+        {
+            CHECK(Util::Sets::contains(started, name(install_index)));
+            CHECK(results.emplace(name(install_index), result.code).second);
+            finished.insert(name(install_index));
+            if (result.code != BuildResult::Succeeded)
+            {
+                std::lock_guard<std::mutex> lock(mtx);
+                failure_reported = true;
+                cv.notify_all();
+            }
+        }
+
+        const std::string& name(size_t install_index) const { return actions[install_index].spec.name(); }
+
+        bool is_in_plan(const PackageSpec& spec) const
+        {
+            return Util::any_of(actions, [&spec](const InstallPlanAction& action) { return action.spec == spec; });
+        }
+
+        size_t index_of(StringView port) const
+        {
+            for (size_t idx = 0; idx < actions.size(); ++idx)
+            {
+                if (name(idx) == port)
+                {
+                    return idx;
+                }
+            }
+
+            Checks::unreachable(VCPKG_LINE_INFO);
+        }
+
+        const std::vector<InstallPlanAction>& actions;
+        std::set<std::string> failing;
+        std::set<std::string> restored;
+        std::string wait_for_failure;
+
+        std::set<std::string> started;
+        std::set<std::string> installed;
+        std::set<std::string> finished;
+        std::map<std::string, BuildResult> results;
+
+        std::mutex mtx;
+        std::condition_variable cv;
+        std::set<std::string> built;
+        size_t running = 0;
+        size_t max_running = 0;
+        bool failure_reported = false;
+        bool waited_for_failure = false;
+    };
+}
+
+TEST_CASE ("run_parallel_install starts actions once their dependencies finish", "[install]")
+{
+    PackageSpecMap spec_map;
+    spec_map.emplace("a");
+    spec_map.emplace("b", "a");
+    spec_map.emplace("c", "b");
+    spec_map.emplace("d");
+    spec_map.emplace("e");
+    spec_map.emplace("f");
+    spec_map.emplace("restored", "a");
+    spec_map.emplace("g", "restored, d");
+    auto plan = make_install_plan(spec_map);
+    REQUIRE(plan.install_actions.size() == 8);
+
+    StubInstallSteps steps(plan);
+    steps.restored.insert("restored");
+    CHECK(!run_parallel_install(plan.install_actions, 3, KeepGoing::No, steps).has_value());
+    CHECK(steps.finished.size() == 8);
+    CHECK(Util::all_of(steps.results, [](const auto& entry) { return entry.second == BuildResult::Succeeded; }));
+    CHECK(steps.built == std::set<std::string>{"a", "b", "c", "d", "e", "f", "g"});
+    CHECK(steps.max_running > 1);
+    CHECK(steps.max_running <= 3);
+}
+
+TEST_CASE ("run_parallel_install cascades failures to dependents", "[install]")
+{
+    PackageSpecMap spec_map;
+    spec_map.emplace("a");
+    spec_map.emplace("b", "a");
+    spec_map.emplace("c", "b");
+    spec_map.emplace("d");
+    spec_map.emplace("e", "d");
+    auto plan = make_install_plan(spec_map);
+
+    StubInstallSteps steps(plan);
+    steps.failing.insert("a");
+    CHECK(!run_parallel_install(plan.install_actions, 2, KeepGoing::Yes, steps).has_value());
+    CHECK(steps.results == std::map<std::string, BuildResult>{
+                               {"a", BuildResult::BuildFailed},
+                               {"b", BuildResult::CascadedDueToMissingDependencies},
+                               {"c", BuildResult::CascadedDueToMissingDependencies},
+                               {"d", BuildResult::Succeeded},
+                               {"e", BuildResult::Succeeded},
+                           });
+    CHECK(steps.built == std::set<std::string>{"a", "d", "e"});
+}
+
+TEST_CASE ("run_parallel_install stops after a failure with KeepGoing::No", "[install]")
+{
+    PackageSpecMap spec_map;
+    spec_map.emplace("fail");
+    spec_map.emplace("slow");
+    spec_map.emplace("after-fail", "fail");
+    spec_map.emplace("after-slow", "slow");
+    auto plan = make_install_plan(spec_map);
+
+    StubInstallSteps steps(plan);
+    steps.failing.insert("fail");
+    steps.wait_for_failure = "slow";
+    auto maybe_failed_index = run_parallel_install(plan.install_actions, 2, KeepGoing::No, steps);
+    REQUIRE(maybe_failed_index.has_value());
+    CHECK(*maybe_failed_index.get() == steps.index_of("fail"));
+    // the build in flight when the failure was reported still finishes, but nothing else starts
+    CHECK(steps.results == std::map<std::string, BuildResult>{
+                               {"fail", BuildResult::BuildFailed},
+                               {"slow", BuildResult::Succeeded},
+                           });
+    CHECK(steps.started == std::set<std::string>{"fail", "slow"});
+    CHECK(steps.waited_for_failure);
+}
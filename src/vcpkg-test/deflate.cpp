@@ -0,0 +1,103 @@
+#include <vcpkg-test/util.h>
+
+#include <vcpkg/base/deflate.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using namespace vcpkg;
+
+namespace
+{
+    // Bytes which don't repeat by themselves, so the only matches are the copies a test makes.
+    std::string noise(std::size_t size, std::uint32_t seed)
+    {
+        std::string result;
+        result.reserve(size);
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            seed = seed * 1664525u + 1013904223u;
+            result.push_back(static_cast<char>(seed >> 24));
+        }
+
+        return result;
+    }
+
+    void check_round_trip(const std::string& data)
+    {
+        const auto first = reinterpret_cast<const unsigned char*>(data.data());
+        const auto compressed = deflate_bytes(first, data.size());
+        const auto compressed_first = reinterpret_cast<const unsigned char*>(compressed.data());
+        std::string inflated;
+        REQUIRE(inflate_bytes(compressed_first, compressed_first + compressed.size(), data.size(), inflated));
+        CHECK(inflated == data);
+    }
+}
+
+TEST_CASE ("deflate round trips", "[deflate]")
+{
+    check_round_trip("");
+    check_round_trip("a");
+    check_round_trip(std::string(100000, 'z'));
+    check_round_trip(noise(70000, 1));
+}
+
+TEST_CASE ("deflate round trips matches at every distance code", "[deflate]")
+{
+    // the first and last distance of each of the 30 distance codes
+    std::vector<std::size_t> distances;
+    for (std::size_t base = 1; base <= 4; ++base)
+    {
+        distances.push_back(base);
+    }
+
+    for (std::size_t extra_bits = 1; extra_bits <= 13; ++extra_bits)
+    {
+        for (std::size_t half = 0; half < 2; ++half)
+        {
+            const std::size_t first = (std::size_t{1} << extra_bits) * (2 + half) + 1;
+            distances.push_back(first);
+            distances.push_back(first + (std::size_t{1} << extra_bits) - 1);
+        }
+    }
+
+    REQUIRE(distances.back() == 32768);
+    for (auto distance : distances)
+    {
+        INFO("distance " << distance);
+        // 32 bytes of noise, compressible filler up to `distance` bytes, then either a copy of the bytes `distance`
+        // back, which can only be compressed as a match at that distance, or fresh noise
+        auto data = noise(32, static_cast<std::uint32_t>(distance));
+        if (distance > 32)
+        {
+            data.append(distance - 32, 'a');
+        }
+
+        auto control = data + noise(32, static_cast<std::uint32_t>(distance) + 65536);
+        for (std::size_t i = 0; i < 32; ++i)
+        {
+            data.push_back(data[data.size() - distance]);
+        }
+
+        check_round_trip(data);
+        check_round_trip(control);
+
+        const auto first = reinterpret_cast<const unsigned char*>(data.data());
+        const auto control_first = reinterpret_cast<const unsigned char*>(control.data());
+        CHECK(deflate_bytes(first, data.size()).size() + 16 < deflate_bytes(control_first, control.size()).size());
+    }
+}
+
+TEST_CASE ("inflate rejects a wrong size", "[deflate]")
+{
+    const std::string data(1000, 'q');
+    const auto first = reinterpret_cast<const unsigned char*>(data.data());
+    const auto compressed = deflate_bytes(first, data.size());
+    const auto compressed_first = reinterpret_cast<const unsigned char*>(compressed.data());
+    std::string inflated;
+    CHECK(!inflate_bytes(compressed_first, compressed_first + compressed.size(), data.size() - 1, inflated));
+    inflated.clear();
+    CHECK(!inflate_bytes(compressed_first, compressed_first + compressed.size(), data.size() + 1, inflated));
+}
@@ -7,6 +7,7 @@
 
 #include <iostream>
 #include <random>
+#include <thread>
 #include <vector>
 
 #if !defined(_WIN32)
@@ -734,6 +735,109 @@ TEST_CASE ("remove all symlinks", "[files]")
     CHECK_EC_ON_FILE(temp_dir, ec);
 }
 
+#if !defined(_WIN32)
+namespace
+{
+    // A tree of `directories` directories, each holding a read-only file, with every fourth directory read-only and a
+    // symlink to `outside` in the middle.
+    void create_wide_tree(const Filesystem& fs, const Path& root, const Path& outside, std::size_t directories)
+    {
+        fs.create_directory(root, VCPKG_LINE_INFO);
+        for (std::size_t i = 0; i < directories; ++i)
+        {
+            const auto directory = root / fmt::format("dir{}", i % 8) / fmt::format("sub{}", i);
+            fs.create_directories(directory, VCPKG_LINE_INFO);
+            const auto file = directory / "readonly_file";
+            fs.write_contents(file, "content", VCPKG_LINE_INFO);
+            set_readonly(file);
+            if (i == directories / 2)
+            {
+                fs.create_directory_symlink(outside, directory / "symlink_to_outside", VCPKG_LINE_INFO);
+            }
+
+            if (i % 4 == 0)
+            {
+                REQUIRE(::chmod(directory.c_str(), 0555) == 0);
+            }
+        }
+    }
+}
+
+TEST_CASE ("remove all large trees", "[files]")
+{
+    urbg_t urbg;
+
+    auto& fs = setup();
+
+    auto temp_dir = base_temporary_directory() / get_random_filename(urbg, "_remove_all_large");
+    INFO("temp dir is: " << temp_dir.native());
+
+    const auto outside = temp_dir / "outside";
+    fs.create_directories(outside, VCPKG_LINE_INFO);
+    const auto outside_file = outside / "file.txt";
+    fs.write_contents(outside_file, "content", VCPKG_LINE_INFO);
+
+    std::error_code ec;
+    Path fp;
+    // small trees are removed on the calling thread, large ones with helpers
+    for (std::size_t directories : {1, 10, 500})
+    {
+        INFO("directories: " << directories);
+        const auto root = temp_dir / "tree";
+        create_wide_tree(fs, root, outside, directories);
+        fs.remove_all(root, ec, fp);
+        CHECK_EC_ON_FILE(fp, ec);
+        CHECK_FALSE(fs.exists(root, ec));
+        CHECK(fs.exists(outside_file, ec));
+    }
+
+    // trees whose root isn't deletable are removed serially
+    {
+        const auto root = temp_dir / "readonly_root";
+        create_wide_tree(fs, root, outside, 100);
+        REQUIRE(::chmod(root.c_str(), 0555) == 0);
+        fs.remove_all(root, ec, fp);
+        CHECK_EC_ON_FILE(fp, ec);
+        CHECK_FALSE(fs.exists(root, ec));
+        CHECK(fs.exists(outside_file, ec));
+    }
+
+    // concurrent removals share the helper threads
+    {
+        std::vector<Path> roots;
+        for (std::size_t i = 0; i < 4; ++i)
+        {
+            roots.push_back(temp_dir / fmt::format("concurrent{}", i));
+            create_wide_tree(fs, roots.back(), outside, 200);
+        }
+
+        std::vector<std::error_code> ecs(roots.size());
+        std::vector<Path> fps(roots.size());
+        std::vector<std::thread> threads;
+        for (std::size_t i = 0; i < roots.size(); ++i)
+        {
+            threads.emplace_back([&, i] { fs.remove_all(roots[i], ecs[i], fps[i]); });
+        }
+
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+
+        for (std::size_t i = 0; i < roots.size(); ++i)
+        {
+            CHECK_EC_ON_FILE(fps[i], ecs[i]);
+            CHECK_FALSE(fs.exists(roots[i], ec));
+        }
+
+        CHECK(fs.exists(outside_file, ec));
+    }
+
+    fs.remove_all(temp_dir, ec, fp);
+    CHECK_EC_ON_FILE(fp, ec);
+}
+#endif // ^^^ !_WIN32
+
 TEST_CASE ("get_files_recursive_symlinks", "[files]")
 {
     do_filesystem_enumeration_test(
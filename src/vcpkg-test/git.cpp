@@ -1,9 +1,223 @@
 #include <vcpkg-test/util.h>
 
+#include <vcpkg/base/files.h>
 #include <vcpkg/base/git.h>
 
+#include <algorithm>
+#include <numeric>
+
 using namespace vcpkg;
 
+namespace
+{
+    // Loose objects for a commit whose tree is {dir/hello.txt, run.sh (executable)}, both containing "hello\n"
+    constexpr StringLiteral blob_sha = "ce013625030ba8dba906f756967f9e9ca394464a";
+    constexpr unsigned char blob_object[] = {0x78, 0x9c, 0x4b, 0xca, 0xc9, 0x4f, 0x52, 0x30, 0x63, 0xc8, 0x48,
+                                             0xcd, 0xc9, 0xc9, 0xe7, 0x02, 0x00, 0x1d, 0xc5, 0x04, 0x14};
+    constexpr StringLiteral dir_tree_sha = "aaa96ced2d9a1c8e72c56b253a0e2fe78393feb7";
+    constexpr unsigned char dir_tree_object[] = {
+        0x78, 0x9c, 0x2b, 0x29, 0x4a, 0x4d, 0x55, 0x30, 0x36, 0x67, 0x30, 0x34, 0x30, 0x30, 0x33, 0x31, 0x51, 0xc8,
+        0x48, 0xcd, 0xc9, 0xc9, 0xd7, 0x2b, 0xa9, 0x28, 0x61, 0x38, 0xc7, 0x68, 0xa6, 0xca, 0xcc, 0xbd, 0xe2, 0xf6,
+        0x4a, 0xb6, 0xef, 0x61, 0xd3, 0xea, 0xe7, 0xcd, 0x59, 0x3c, 0xc5, 0xcd, 0x0b, 0x00, 0x3e, 0x89, 0x0f, 0xf9};
+    constexpr StringLiteral root_tree_sha = "db4d2b1e2bb5219e18feabe3b334ec59cda26a0a";
+    constexpr unsigned char root_tree_object[] = {
+        0x78, 0x9c, 0x2b, 0x29, 0x4a, 0x4d, 0x55, 0x30, 0x33, 0x61, 0x30, 0x31, 0x00, 0x02, 0x85, 0x94, 0xcc,
+        0x22, 0x86, 0x55, 0x2b, 0x73, 0xde, 0xea, 0xce, 0x92, 0xe9, 0x2b, 0x3a, 0x9a, 0xad, 0x6a, 0xc5, 0xa7,
+        0xff, 0xbc, 0x79, 0xf2, 0xbf, 0xed, 0x86, 0x06, 0x06, 0xe6, 0xa6, 0xa6, 0x0a, 0x45, 0xa5, 0x79, 0x7a,
+        0xc5, 0x19, 0x0c, 0xe7, 0x18, 0xcd, 0x54, 0x99, 0xb9, 0x57, 0xdc, 0x5e, 0xc9, 0xf6, 0x3d, 0x6c, 0x5a,
+        0xfd, 0xbc, 0x39, 0x8b, 0xa7, 0xb8, 0x79, 0x01, 0x00, 0x99, 0xd2, 0x1b, 0x18};
+    constexpr StringLiteral commit_sha = "4cee1a11b767f7f2ab93115771e1aec709a22683";
+    constexpr unsigned char commit_object[] = {
+        0x78, 0x9c, 0x5d, 0xcc, 0x3d, 0x0a, 0x80, 0x30, 0x0c, 0x40, 0x61, 0xe7, 0x9c, 0x22, 0xbb, 0x4b, 0x7f, 0xc5,
+        0x82, 0x78, 0x97, 0x24, 0x8d, 0xe8, 0x50, 0x0a, 0x25, 0xde, 0x5f, 0x71, 0xf4, 0x8d, 0xdf, 0xf0, 0xa4, 0xb7,
+        0x76, 0x19, 0x96, 0x34, 0xd9, 0x50, 0xc5, 0xca, 0xa9, 0x06, 0xf6, 0x1a, 0x98, 0x73, 0xf0, 0x45, 0xfd, 0x7a,
+        0x28, 0xb1, 0x46, 0x8e, 0x31, 0xa9, 0xe4, 0x22, 0x95, 0xc2, 0x42, 0x8e, 0x80, 0x6e, 0x3b, 0xfb, 0x40, 0xc2,
+        0x8d, 0x76, 0x74, 0x38, 0xbb, 0x37, 0x90, 0x6f, 0x66, 0xfa, 0x77, 0x68, 0xf0, 0x00, 0x77, 0xf4, 0x1d, 0x92};
+
+    void write_loose_object(const Path& objects_dir, StringLiteral sha, StringView object)
+    {
+        auto directory = objects_dir / StringView{sha.data(), 2};
+        real_filesystem.create_directories(directory, VCPKG_LINE_INFO);
+        real_filesystem.write_contents(directory / StringView{sha.data() + 2, sha.size() - 2}, object, VCPKG_LINE_INFO);
+    }
+
+    template<std::size_t N>
+    void write_loose_object(const Path& dot_git, StringLiteral sha, const unsigned char (&object)[N])
+    {
+        write_loose_object(dot_git / "objects", sha, StringView{reinterpret_cast<const char*>(object), N});
+    }
+
+    // Objects for a packed commit whose tree is {dir/hello.txt, dir/world.txt, run.sh (executable)}
+    constexpr StringLiteral world_blob_sha = "94954abda49de8615a048f8d2e64b5de848e27a1";
+    constexpr StringLiteral packed_dir_tree_sha = "26599bcfcb2c812589f97b44099265cb66f07794";
+    constexpr StringLiteral packed_root_tree_sha = "6e575ea19c6a5529eb854348f1c1ccef1847f60e";
+    constexpr StringLiteral packed_commit_sha = "cd8e65f905e10330e9f423ec6f159065bb6181b9";
+    constexpr StringLiteral packed_commit_object = "tree 6e575ea19c6a5529eb854348f1c1ccef1847f60e\n"
+                                                   "author vcpkg <vcpkg@example.com> 0 +0000\n"
+                                                   "committer vcpkg <vcpkg@example.com> 0 +0000\n"
+                                                   "\n"
+                                                   "packed\n";
+
+    std::string object_id_bytes(StringView sha)
+    {
+        std::string result;
+        for (std::size_t i = 0; i < sha.size(); i += 2)
+        {
+            result.push_back(static_cast<char>(std::stoi(std::string(sha.data() + i, 2), nullptr, 16)));
+        }
+
+        return result;
+    }
+
+    void append_be32(std::string& target, std::uint32_t value)
+    {
+        for (int shift = 24; shift >= 0; shift -= 8)
+        {
+            target.push_back(static_cast<char>((value >> shift) & 0xFF));
+        }
+    }
+
+    // A zlib stream holding `data` in a single uncompressed block
+    std::string zlib_stored(StringView data)
+    {
+        std::string result = "\x78\x01\x01";
+        const auto size = static_cast<std::uint16_t>(data.size());
+        result.push_back(static_cast<char>(size & 0xFF));
+        result.push_back(static_cast<char>(size >> 8));
+        result.push_back(static_cast<char>(~size & 0xFF));
+        result.push_back(static_cast<char>((~size >> 8) & 0xFF));
+        result.append(data.data(), data.size());
+        std::uint32_t a = 1;
+        std::uint32_t b = 0;
+        for (unsigned char ch : data)
+        {
+            a = (a + ch) % 65521;
+            b = (b + a) % 65521;
+        }
+
+        append_be32(result, (b << 16) | a);
+        return result;
+    }
+
+    // The variable length size encoding of pack entry headers and delta headers
+    std::string size_header(std::size_t size, unsigned int first_byte_bits, unsigned char first_byte)
+    {
+        std::string result;
+        first_byte |= static_cast<unsigned char>(size & ((1u << first_byte_bits) - 1));
+        size >>= first_byte_bits;
+        result.push_back(static_cast<char>(first_byte | (size ? 0x80 : 0)));
+        while (size)
+        {
+            result.push_back(static_cast<char>((size & 0x7F) | (size > 0x7F ? 0x80 : 0)));
+            size >>= 7;
+        }
+
+        return result;
+    }
+
+    std::string pack_entry(unsigned char type, StringView prefix, StringView data)
+    {
+        auto result = size_header(data.size(), 4, static_cast<unsigned char>(type << 4));
+        result.append(prefix.data(), prefix.size());
+        result += zlib_stored(data);
+        return result;
+    }
+
+    std::string delta_header(std::size_t base_size, std::size_t result_size)
+    {
+        return size_header(base_size, 7, 0) + size_header(result_size, 7, 0);
+    }
+
+    struct PackedObject
+    {
+        StringLiteral sha;
+        std::string entry;
+    };
+
+    // Writes a pack of `objects` and its version 2 index. The objects at `large_indices` are found through the
+    // index's table of 64-bit offsets.
+    void write_pack(const Path& dot_git,
+                    const std::vector<PackedObject>& objects,
+                    const std::vector<std::size_t>& large_indices)
+    {
+        std::string pack = "PACK";
+        append_be32(pack, 2);
+        append_be32(pack, static_cast<std::uint32_t>(objects.size()));
+        std::vector<std::pair<std::string, std::uint32_t>> names;
+        for (auto&& object : objects)
+        {
+            names.emplace_back(object.sha.to_string(), static_cast<std::uint32_t>(pack.size()));
+            pack += object.entry;
+        }
+
+        pack.append(20, '\0');
+
+        std::vector<bool> is_large(objects.size());
+        for (auto index : large_indices)
+        {
+            is_large[index] = true;
+        }
+
+        std::vector<std::size_t> order(objects.size());
+        std::iota(order.begin(), order.end(), std::size_t{0});
+        std::sort(order.begin(), order.end(), [&](std::size_t lhs, std::size_t rhs) {
+            return names[lhs].first < names[rhs].first;
+        });
+
+        std::string index = "\xFFtOc";
+        append_be32(index, 2);
+        std::uint32_t fanout[256] = {};
+        for (auto&& name : names)
+        {
+            for (unsigned int first_byte = static_cast<unsigned char>(object_id_bytes(name.first)[0]);
+                 first_byte < 256;
+                 ++first_byte)
+            {
+                ++fanout[first_byte];
+            }
+        }
+
+        for (auto count : fanout)
+        {
+            append_be32(index, count);
+        }
+
+        for (auto i : order)
+        {
+            index += object_id_bytes(names[i].first);
+        }
+
+        // CRCs, which the reader doesn't check
+        for (std::size_t i = 0; i < order.size(); ++i)
+        {
+            append_be32(index, 0);
+        }
+
+        std::string large_offsets;
+        for (auto i : order)
+        {
+            if (is_large[i])
+            {
+                append_be32(index, 0x80000000u | static_cast<std::uint32_t>(large_offsets.size() / 8));
+                append_be32(large_offsets, 0);
+                append_be32(large_offsets, names[i].second);
+            }
+            else
+            {
+                append_be32(index, names[i].second);
+            }
+        }
+
+        index += large_offsets;
+        index.append(40, '\0');
+
+        const auto pack_dir = dot_git / "objects" / "pack";
+        real_filesystem.create_directories(pack_dir, VCPKG_LINE_INFO);
+        real_filesystem.write_contents(pack_dir / "pack-test.pack", pack, VCPKG_LINE_INFO);
+        real_filesystem.write_contents(pack_dir / "pack-test.idx", index, VCPKG_LINE_INFO);
+    }
+}
+
 TEST_CASE ("parse_git_ls_tree_output", "[git]")
 {
     static constexpr StringLiteral test_data =
@@ -294,3 +508,138 @@ TEST_CASE ("parse_git_diff_tree_line_failures", "[git]")
         ":100644 100644 abcd123abcd123abcd123abcd123abcd123 abcd123abcd123abcd123abcd123abcd123 M\0file1";
     REQUIRE(!parse_git_diff_tree_line(test_out, test_missing_term.begin(), test_missing_term.end()));
 }
+
+TEST_CASE ("read loose git objects in-process", "[git]")
+{
+    const auto root = Test::base_temporary_directory() / "git-loose-objects";
+    const auto dot_git = root / ".git";
+    real_filesystem.remove_all(root, VCPKG_LINE_INFO);
+    write_loose_object(dot_git, blob_sha, blob_object);
+    write_loose_object(dot_git, dir_tree_sha, dir_tree_object);
+    write_loose_object(dot_git, root_tree_sha, root_tree_object);
+    write_loose_object(dot_git, commit_sha, commit_object);
+    real_filesystem.create_directories(dot_git / "refs" / "heads", VCPKG_LINE_INFO);
+    real_filesystem.write_contents(dot_git / "HEAD", "ref: refs/heads/main\n", VCPKG_LINE_INFO);
+    real_filesystem.write_contents(dot_git / "packed-refs",
+                                   fmt::format("# pack-refs with: peeled\n{} refs/heads/main\n", commit_sha),
+                                   VCPKG_LINE_INFO);
+    real_filesystem.write_contents(dot_git / "FETCH_HEAD",
+                                   fmt::format("{}\t\tbranch 'main' of https://example.com\n", commit_sha),
+                                   VCPKG_LINE_INFO);
+
+    CHECK(git_try_read_blob(real_filesystem, dot_git, fmt::format("{}:dir/hello.txt", commit_sha)).value_or("") ==
+          "hello\n");
+    CHECK(git_try_read_blob(real_filesystem, dot_git, "main:run.sh").value_or("") == "hello\n");
+    CHECK(git_try_rev_parse(real_filesystem, dot_git, "HEAD").value_or("") == commit_sha);
+    CHECK(git_try_rev_parse(real_filesystem, dot_git, "FETCH_HEAD:").value_or("") == root_tree_sha);
+    CHECK(git_try_rev_parse(real_filesystem, dot_git, "refs/heads/main:dir").value_or("") == dir_tree_sha);
+
+    // anything which can't be answered in-process is left to git
+    CHECK(!git_try_read_blob(real_filesystem, dot_git, "HEAD:dir").has_value());
+    CHECK(!git_try_read_blob(real_filesystem, dot_git, "HEAD:missing.txt").has_value());
+    CHECK(!git_try_rev_parse(real_filesystem, dot_git, "HEAD~1").has_value());
+    CHECK(!git_try_rev_parse(real_filesystem, dot_git, "4cee1a1").has_value());
+
+    // the git executable is never run when the tree can be read in-process
+    const auto destination = root / "extracted";
+    CHECK(git_extract_tree(console_diagnostic_context,
+                           real_filesystem,
+                           root / "no-such-git",
+                           GitRepoLocator{GitRepoLocatorKind::DotGitDir, dot_git},
+                           destination,
+                           "HEAD"));
+    CHECK(real_filesystem.read_contents(destination / "dir" / "hello.txt", VCPKG_LINE_INFO) == "hello\n");
+    CHECK(real_filesystem.read_contents(destination / "run.sh", VCPKG_LINE_INFO) == "hello\n");
+    real_filesystem.remove_all(root, VCPKG_LINE_INFO);
+}
+
+TEST_CASE ("read packed git objects in-process", "[git]")
+{
+    constexpr unsigned char blob_type = 3;
+    constexpr unsigned char commit_type = 1;
+    constexpr unsigned char ofs_delta_type = 6;
+    constexpr unsigned char ref_delta_type = 7;
+
+    const auto root = Test::base_temporary_directory() / "git-packed-objects";
+    const auto dot_git = root / ".git";
+    real_filesystem.remove_all(root, VCPKG_LINE_INFO);
+
+    const std::string nul(1, '\0');
+    const auto hello_id = object_id_bytes(blob_sha);
+    const auto world_id = object_id_bytes(world_blob_sha);
+    const auto dir_id = object_id_bytes(packed_dir_tree_sha);
+    const auto dir_tree = Strings::concat("100644 hello.txt", nul, hello_id, "100644 world.txt", nul, world_id);
+    const auto root_tree_prefix = Strings::concat("40000 dir", nul, dir_id, "100755 run.sh", nul);
+    const auto root_tree = root_tree_prefix + hello_id;
+
+    // "hello\nworld\n" copies "hello\n" from the preceding blob, then inserts "world\n"
+    const auto hello_blob = pack_entry(blob_type, {}, "hello\n");
+    const auto world_delta = delta_header(6, 12) + "\x90\x06\x06world\n";
+    const auto world_distance = std::string(1, static_cast<char>(hello_blob.size()));
+    // the root tree inserts its own entries, then copies the hello.txt id from the dir tree in the alternate
+    auto root_delta = delta_header(dir_tree.size(), root_tree.size());
+    root_delta.push_back(static_cast<char>(root_tree_prefix.size()));
+    root_delta += root_tree_prefix;
+    root_delta += "\x91\x11\x14";
+
+    write_pack(dot_git,
+               {{blob_sha, hello_blob},
+                {world_blob_sha, pack_entry(ofs_delta_type, world_distance, world_delta)},
+                {packed_root_tree_sha, pack_entry(ref_delta_type, dir_id, root_delta)},
+                {packed_commit_sha, pack_entry(commit_type, {}, packed_commit_object)}},
+               {3});
+
+    // the dir tree is only in the alternate object database
+    const auto alternate_objects = root / "alternate" / "objects";
+    write_loose_object(alternate_objects,
+                       packed_dir_tree_sha,
+                       zlib_stored(Strings::concat("tree ", std::to_string(dir_tree.size()), nul, dir_tree)));
+    real_filesystem.create_directories(dot_git / "objects" / "info", VCPKG_LINE_INFO);
+    real_filesystem.write_contents(
+        dot_git / "objects" / "info" / "alternates", "../../alternate/objects\n", VCPKG_LINE_INFO);
+
+    real_filesystem.write_contents(dot_git / "HEAD", "ref: refs/heads/main\n", VCPKG_LINE_INFO);
+    real_filesystem.write_contents(dot_git / "packed-refs",
+                                   fmt::format("# pack-refs with: peeled fully-peeled sorted\n"
+                                               "{0} refs/heads/main\n"
+                                               "{0} refs/remotes/origin/main\n"
+                                               "{1} refs/tags/v1\n"
+                                               "^{0}\n",
+                                               packed_commit_sha,
+                                               blob_sha),
+                                   VCPKG_LINE_INFO);
+
+    CHECK(git_try_rev_parse(real_filesystem, dot_git, "HEAD").value_or("") == packed_commit_sha);
+    CHECK(git_try_rev_parse(real_filesystem, dot_git, "origin/main").value_or("") == packed_commit_sha);
+    CHECK(git_try_rev_parse(real_filesystem, dot_git, "v1").value_or("") == blob_sha);
+    CHECK(git_try_rev_parse(real_filesystem, dot_git, "main:").value_or("") == packed_root_tree_sha);
+    CHECK(git_try_rev_parse(real_filesystem, dot_git, "main:dir").value_or("") == packed_dir_tree_sha);
+    CHECK(git_try_read_blob(real_filesystem, dot_git, "HEAD:run.sh").value_or("") == "hello\n");
+    CHECK(git_try_read_blob(real_filesystem, dot_git, "HEAD:dir/hello.txt").value_or("") == "hello\n");
+    CHECK(git_try_read_blob(real_filesystem, dot_git, "HEAD:dir/world.txt").value_or("") == "hello\nworld\n");
+    CHECK(git_try_read_blob(real_filesystem, dot_git, world_blob_sha).value_or("") == "hello\nworld\n");
+
+    const auto destination = root / "extracted";
+    CHECK(git_extract_tree(console_diagnostic_context,
+                           real_filesystem,
+                           root / "no-such-git",
+                           GitRepoLocator{GitRepoLocatorKind::DotGitDir, dot_git},
+                           destination,
+                           "origin/main"));
+    CHECK(real_filesystem.read_contents(destination / "dir" / "world.txt", VCPKG_LINE_INFO) == "hello\nworld\n");
+    CHECK(real_filesystem.read_contents(destination / "run.sh", VCPKG_LINE_INFO) == "hello\n");
+    git_release_object_database(dot_git);
+    real_filesystem.remove_all(root, VCPKG_LINE_INFO);
+}
+
+TEST_CASE ("git repositories created after a failed lookup are found", "[git]")
+{
+    const auto root = Test::base_temporary_directory() / "git-created-later";
+    const auto dot_git = root / ".git";
+    real_filesystem.remove_all(root, VCPKG_LINE_INFO);
+    CHECK(!git_try_rev_parse(real_filesystem, dot_git, blob_sha).has_value());
+
+    write_loose_object(dot_git, blob_sha, blob_object);
+    CHECK(git_try_read_blob(real_filesystem, dot_git, blob_sha).value_or("") == "hello\n");
+    real_filesystem.remove_all(root, VCPKG_LINE_INFO);
+}
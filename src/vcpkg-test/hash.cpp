@@ -156,6 +156,34 @@ TEST_CASE ("SHA512: NIST test cases (large)", "[.][hash-expensive][sha512-expens
                      "70a0f3bd577eea326aed40ab7dd58b1");
 }
 
+#if !defined(_WIN32)
+TEST_CASE ("SHA: accelerated and portable hashers agree", "[hash]")
+{
+    std::vector<unsigned char> data(1000);
+    for (std::size_t i = 0; i < data.size(); ++i)
+    {
+        data[i] = static_cast<unsigned char>(i * 7 + 3);
+    }
+
+    for (auto algo : {Hash::Algorithm::Sha256, Hash::Algorithm::Sha512})
+    {
+        auto hasher = Hash::get_hasher_for(algo);
+        auto portable = Hash::get_portable_hasher_for(algo);
+        for (std::size_t size : {0, 1, 55, 56, 63, 64, 65, 127, 128, 129, 200, 1000})
+        {
+            // split the input so that whole chunks are hashed both from the input and from the partial chunk buffer
+            const std::size_t split = size / 3;
+            hasher->clear();
+            hasher->add_bytes(data.data(), data.data() + split);
+            hasher->add_bytes(data.data() + split, data.data() + size);
+            portable->clear();
+            portable->add_bytes(data.data(), data.data() + size);
+            CHECK(hasher->get_hash() == portable->get_hash());
+        }
+    }
+}
+#endif
+
 #if defined(CATCH_CONFIG_ENABLE_BENCHMARKING)
 using Catch::Benchmark::Chronometer;
 static void benchmark_hasher(Chronometer& meter, Hash::Hasher& hasher, std::uint64_t size, unsigned char byte) noexcept
@@ -207,6 +235,22 @@ TEST_CASE ("SHA256: benchmark", "[.][hash][sha256][!benchmark]")
     };
 }
 
+#if !defined(_WIN32)
+TEST_CASE ("SHA256: portable -- benchmark", "[.][hash][sha256][!benchmark]")
+{
+    auto hasher = Hash::get_portable_hasher_for(Hash::Algorithm::Sha256);
+
+    BENCHMARK_ADVANCED("0 x 1'000'000")(Catch::Benchmark::Chronometer meter)
+    {
+        benchmark_hasher(meter, *hasher, 1'000'000, 0);
+    };
+    BENCHMARK_ADVANCED("'Z' x 0x2000'0000")(Catch::Benchmark::Chronometer meter)
+    {
+        benchmark_hasher(meter, *hasher, 0x2000'0000, 'Z');
+    };
+}
+#endif
+
 TEST_CASE ("SHA512: large -- benchmark", "[.][hash][sha512][!benchmark]")
 {
     auto hasher = Hash::get_hasher_for(Hash::Algorithm::Sha512);
@@ -1,6 +1,7 @@
 #include <vcpkg-test/util.h>
 
 #include <vcpkg/base/json.h>
+#include <vcpkg/base/jsonreader.h>
 #include <vcpkg/base/messages.h>
 
 #include <iostream>
@@ -225,6 +226,125 @@ TEST_CASE ("JSON parse full file", "[json]")
     REQUIRE(res);
 }
 
+TEST_CASE ("JSON parse full file into a document", "[json]")
+{
+    StringView json =
+#include "large-json-document.json.inc"
+        ;
+
+    auto res = Json::parse(json, "test");
+    REQUIRE(res);
+    auto doc = Json::parse_document(json.to_string(), "test");
+    REQUIRE(doc);
+    CHECK(doc.get()->value == res.get()->value);
+    CHECK(Json::stringify(doc.get()->value) == Json::stringify(res.get()->value));
+}
+
+TEST_CASE ("JSON document values", "[json]")
+{
+    static constexpr StringLiteral text = R"json({
+    "plain": "abc",
+    "escaped": "a\tb\u00e9",
+    "array": [1, 2.5, true, null],
+    "paragraph": ["line one", "line \"two\""]
+})json";
+
+    Value copied;
+    {
+        auto maybe_doc = Json::parse_document(text.to_string(), "test");
+        REQUIRE(maybe_doc);
+        auto& doc = *maybe_doc.get();
+        auto& obj = doc.value.object(VCPKG_LINE_INFO);
+        CHECK(obj["plain"].string(VCPKG_LINE_INFO) == "abc");
+        CHECK(obj["escaped"].string(VCPKG_LINE_INFO) == U8_STR("a\tb\u00e9"));
+        auto& arr = obj["array"].array(VCPKG_LINE_INFO);
+        REQUIRE(arr.size() == 4);
+        CHECK(arr[0].integer(VCPKG_LINE_INFO) == 1);
+        CHECK(arr[1].number(VCPKG_LINE_INFO) == 2.5);
+        CHECK(arr[2].boolean(VCPKG_LINE_INFO));
+        CHECK(arr[3].is_null());
+
+        // deserializers work unchanged against documents
+        Json::Reader r("test");
+        std::vector<std::string> paragraph;
+        r.required_object_field(
+            LocalizedString::from_raw("test"), obj, "paragraph", paragraph, Json::ParagraphDeserializer::instance);
+        CHECK(!r.messages().any_errors());
+        CHECK(paragraph == std::vector<std::string>{"line one", "line \"two\""});
+
+        copied = doc.value;
+        obj.insert("added", Value::string("xyz"));
+        CHECK(obj.size() == 5);
+    }
+
+    // copies of document values are independent of the document
+    auto& obj = copied.object(VCPKG_LINE_INFO);
+    CHECK(obj.size() == 4);
+    CHECK(obj["plain"].string(VCPKG_LINE_INFO) == "abc");
+    CHECK(obj["escaped"].string(VCPKG_LINE_INFO) == U8_STR("a\tb\u00e9"));
+    CHECK(obj["array"].array(VCPKG_LINE_INFO)[1].number(VCPKG_LINE_INFO) == 2.5);
+    auto maybe_plain = obj["plain"].maybe_string();
+    REQUIRE(maybe_plain.get());
+    CHECK(*maybe_plain.get() == "abc");
+    CHECK(!obj["array"].maybe_string().has_value());
+
+    auto bad = Json::parse_document(R"json({"a": 1, "a": 2})json", "test");
+    CHECK(!bad);
+}
+
+TEST_CASE ("JSON large objects", "[json]")
+{
+    Json::Object obj;
+    for (int i = 0; i < 100; ++i)
+    {
+        obj.insert(fmt::format("key-{}", 99 - i), Value::integer(i));
+    }
+
+    REQUIRE(obj.size() == 100);
+    for (int i = 0; i < 100; ++i)
+    {
+        auto value = obj.get(fmt::format("key-{}", 99 - i));
+        REQUIRE(value);
+        CHECK(value->integer(VCPKG_LINE_INFO) == i);
+    }
+
+    CHECK(!obj.contains("key-100"));
+    CHECK(!obj.contains(""));
+
+    // iteration order is insertion order
+    int expected = 0;
+    for (auto&& entry : obj)
+    {
+        CHECK(entry.first == fmt::format("key-{}", 99 - expected));
+        CHECK(entry.second.integer(VCPKG_LINE_INFO) == expected);
+        ++expected;
+    }
+
+    CHECK(obj.remove("key-50"));
+    CHECK(!obj.remove("key-50"));
+    CHECK(!obj.contains("key-50"));
+    CHECK(obj["key-49"].integer(VCPKG_LINE_INFO) == 50);
+    CHECK(obj["key-51"].integer(VCPKG_LINE_INFO) == 48);
+
+    obj.insert_or_replace("key-51", Value::integer(1000));
+    CHECK(obj["key-51"].integer(VCPKG_LINE_INFO) == 1000);
+    CHECK(obj.size() == 99);
+
+    auto copy = obj;
+    copy.sort_keys();
+    CHECK(copy.begin().operator*().first == "key-0");
+    CHECK(copy["key-99"].integer(VCPKG_LINE_INFO) == 0);
+    CHECK(copy == copy);
+
+    while (obj.size() > 3)
+    {
+        obj.remove((*obj.begin()).first.to_string());
+    }
+
+    CHECK(obj.contains("key-0"));
+    CHECK(!obj.contains("key-99"));
+}
+
 TEST_CASE ("JSON track newlines", "[json]")
 {
     auto res = Json::parse("{\n,", "filename");
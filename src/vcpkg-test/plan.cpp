@@ -982,6 +982,92 @@ TEST_CASE ("only transitive features test", "[plan]")
     features_check(install_plan.install_actions.at(2), "a", {"0", "core"}, Test::X64_WINDOWS);
 }
 
+TEST_CASE ("filter supported specs", "[plan]")
+{
+    using MBO = PlatformExpression::MultipleBinaryOperators;
+    const auto linux_expr =
+        PlatformExpression::parse_platform_expression("linux", MBO::Deny).value_or_exit(VCPKG_LINE_INFO);
+
+    PackageSpecMap spec_map;
+    spec_map.emplace("unsupported");
+    spec_map.map["unsupported"].source_control_file->core_paragraph->supports_expression = linux_expr;
+    spec_map.emplace("leaf");
+    spec_map.emplace("uses-unsupported", "leaf, unsupported");
+    spec_map.emplace("uses-unsupported-on-linux", "leaf, unsupported (linux)");
+    spec_map.emplace("default-uses-unsupported", "", {{"x", "unsupported"}, {"y", "leaf"}}, {"x"});
+    spec_map.emplace("feature-uses-unsupported", "", {{"x", "unsupported"}, {"y", "leaf"}});
+    spec_map.emplace("uses-default", "default-uses-unsupported[y]");
+    spec_map.emplace("uses-feature", "feature-uses-unsupported[y]");
+    spec_map.emplace("uses-bad-feature", "feature-uses-unsupported[x]");
+    spec_map.emplace("unsupported-feature", "", {{"x", ""}}, {"x"});
+    spec_map.map["unsupported-feature"].source_control_file->feature_paragraphs[0]->supports_expression = linux_expr;
+    spec_map.emplace("feature-cycle", "", {{"x", "feature-cycle[y]"}, {"y", "feature-cycle[x], leaf"}}, {"x"});
+    spec_map.emplace(
+        "bad-feature-cycle", "", {{"x", "bad-feature-cycle[y]"}, {"y", "bad-feature-cycle[x], unsupported"}}, {"x"});
+    spec_map.emplace("uses-bad-feature-cycle", "bad-feature-cycle");
+
+    MapPortFileProvider map_port(spec_map.map);
+    const CreateInstallPlanOptions create_options{
+        nullptr, Test::X64_ANDROID, UnsupportedPortAction::Warn, UseHeadVersion::No, Editable::No};
+
+    std::vector<FullPackageSpec> specs;
+    for (auto&& entry : spec_map.map)
+    {
+        specs.emplace_back(PackageSpec{entry.first, Test::X86_WINDOWS},
+                           InternalFeatureSet{FeatureNameCore.to_string(), FeatureNameDefault.to_string()});
+        specs.emplace_back(PackageSpec{entry.first, Test::X86_WINDOWS},
+                           InternalFeatureSet{FeatureNameCore.to_string()});
+    }
+
+    // Pin the results to those of building an install plan per spec
+    std::vector<FullPackageSpec> expected;
+    {
+        MockCMakeVarProvider var_provider;
+        for (auto&& spec : specs)
+        {
+            PackagesDirAssigner packages_dir_assigner{"pkg"};
+            auto plan = create_feature_install_plan(
+                map_port, var_provider, {&spec, 1}, {}, packages_dir_assigner, create_options);
+            if (plan.unsupported_features.empty())
+            {
+                expected.push_back(spec);
+            }
+        }
+    }
+
+    MockCMakeVarProvider var_provider;
+    auto supported = filter_supported_specs(map_port, var_provider, specs, create_options);
+    CHECK(supported == expected);
+
+    auto supported_names = Util::fmap(Util::filter(supported,
+                                                   [](const FullPackageSpec& spec) {
+                                                       return spec.features.size() == 2;
+                                                   }),
+                                      [](const FullPackageSpec& spec) { return spec.package_spec.name(); });
+    Util::sort(supported_names);
+    CHECK(supported_names == std::vector<std::string>{"feature-cycle",
+                                                      "feature-uses-unsupported",
+                                                      "leaf",
+                                                      "uses-feature",
+                                                      "uses-unsupported-on-linux"});
+
+    // bad-feature-cycle, default-uses-unsupported and unsupported-feature only fail through their defaults
+    auto core_only_names = Util::fmap(Util::filter(supported,
+                                                   [](const FullPackageSpec& spec) {
+                                                       return spec.features.size() == 1;
+                                                   }),
+                                      [](const FullPackageSpec& spec) { return spec.package_spec.name(); });
+    Util::sort(core_only_names);
+    CHECK(core_only_names == std::vector<std::string>{"bad-feature-cycle",
+                                                      "default-uses-unsupported",
+                                                      "feature-cycle",
+                                                      "feature-uses-unsupported",
+                                                      "leaf",
+                                                      "unsupported-feature",
+                                                      "uses-feature",
+                                                      "uses-unsupported-on-linux"});
+}
+
 TEST_CASE ("basic remove scheme", "[plan]")
 {
     std::vector<std::unique_ptr<StatusParagraph>> pghs;
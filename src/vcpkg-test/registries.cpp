@@ -6,6 +6,7 @@
 #include <vcpkg/configuration.h>
 #include <vcpkg/documentation.h>
 #include <vcpkg/registries-parsing.h>
+#include <vcpkg/registries.h>
 
 using namespace vcpkg;
 
@@ -583,6 +584,56 @@ TEST_CASE ("git_version_db_parsing", "[registries]")
     CHECK(!r.messages().any_errors());
 }
 
+TEST_CASE ("git_versions_index", "[registries]")
+{
+    std::map<std::string, GitVersionsLoadResult, std::less<>> db;
+    db.emplace("zlib",
+               GitVersionsLoadResult{std::vector<GitVersionDbEntry>{
+                                         {{VersionScheme::Semver, Version{"1.3.1", 2}},
+                                          "9b07f8a38bbc4d13f8411921e6734753e15f8d50"},
+                                         {{VersionScheme::Relaxed, Version{"1.2", 0}},
+                                          "12b84a31469a78dd4b42dcf58a27d4600f6b2d48"},
+                                     },
+                                     "z-/zlib.json"});
+    db.emplace("boost", GitVersionsLoadResult{std::vector<GitVersionDbEntry>{}, "b-/boost.json"});
+    db.emplace("fmt",
+               GitVersionsLoadResult{std::vector<GitVersionDbEntry>{
+                                         {{VersionScheme::Date, Version{"2021-01-14", 1}},
+                                          "bd4565e8ab55bc5e098a1750fa5ff0bc4406ca9b"},
+                                     },
+                                     "f-/fmt.json"});
+
+    auto serialized = GitVersionsIndex::serialize(db).value_or_exit(VCPKG_LINE_INFO);
+    auto index = GitVersionsIndex::parse(std::string(serialized)).value_or_exit(VCPKG_LINE_INFO);
+
+    auto zlib = index.lookup("zlib").value_or_exit(VCPKG_LINE_INFO);
+    REQUIRE(zlib.size() == 2);
+    CHECK(zlib[0].version == SchemedVersion{VersionScheme::Semver, Version{"1.3.1", 2}});
+    CHECK(zlib[0].git_tree == "9b07f8a38bbc4d13f8411921e6734753e15f8d50");
+    CHECK(zlib[1].version == SchemedVersion{VersionScheme::Relaxed, Version{"1.2", 0}});
+    CHECK(zlib[1].git_tree == "12b84a31469a78dd4b42dcf58a27d4600f6b2d48");
+    auto fmt_entries = index.lookup("fmt").value_or_exit(VCPKG_LINE_INFO);
+    REQUIRE(fmt_entries.size() == 1);
+    CHECK(fmt_entries[0].version == SchemedVersion{VersionScheme::Date, Version{"2021-01-14", 1}});
+    CHECK(index.lookup("boost").value_or_exit(VCPKG_LINE_INFO).empty());
+    CHECK(!index.lookup("curl").has_value());
+    CHECK(!index.lookup("").has_value());
+
+    // truncations and corruptions are rejected rather than trusted
+    for (std::size_t size = 0; size < serialized.size(); ++size)
+    {
+        CHECK(!GitVersionsIndex::parse(serialized.substr(0, size)).has_value());
+    }
+
+    auto bad_magic = serialized;
+    bad_magic[0] = 'X';
+    CHECK(!GitVersionsIndex::parse(std::move(bad_magic)).has_value());
+
+    // a versions file that failed to load can't be indexed
+    db.emplace("curl", GitVersionsLoadResult{LocalizedString::from_raw("error"), "c-/curl.json"});
+    CHECK(!GitVersionsIndex::serialize(db).has_value());
+}
+
 TEST_CASE ("filesystem_version_db_parsing", "[registries]")
 {
     FilesystemVersionDbEntryArrayDeserializer filesystem_version_db("a/b");
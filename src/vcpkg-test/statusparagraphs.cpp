@@ -144,3 +144,79 @@ Status: install ok installed
     auto it = status_db.find_installed({{"ffmpeg", Test::X64_WINDOWS}, "openssl"});
     REQUIRE(it != status_db.end());
 }
+
+TEST_CASE ("index many packages", "[statusparagraphs]")
+{
+    StatusParagraphs status_db;
+    std::vector<std::string> names;
+    for (int i = 0; i < 200; ++i)
+    {
+        names.push_back(fmt::format("pkg{}", i));
+    }
+
+    for (auto&& name : names)
+    {
+        status_db.insert(make_status_pgh(name.c_str()));
+        status_db.insert(make_status_pgh(name.c_str(), "", "", "x64-windows"));
+        status_db.insert(make_status_feature_pgh(name.c_str(), "a"));
+        status_db.insert(make_status_feature_pgh(name.c_str(), "b"));
+    }
+
+    std::string serialized;
+    serialize(status_db, serialized);
+    CHECK(Strings::starts_with(serialized, "Package: pkg0\n"));
+
+    for (auto&& name : names)
+    {
+        auto core = status_db.find(name, Test::X86_WINDOWS);
+        REQUIRE(core != status_db.end());
+        CHECK((*core)->package.spec.name() == name);
+        CHECK(!(*core)->package.is_feature());
+        CHECK(status_db.find(name, Test::X86_WINDOWS, "core") == core);
+        CHECK(status_db.find(name, Test::X64_WINDOWS) != status_db.end());
+        CHECK(status_db.find(name, Test::X64_WINDOWS, "a") == status_db.end());
+
+        auto feature = status_db.find({{name, Test::X86_WINDOWS}, "b"});
+        REQUIRE(feature != status_db.end());
+        CHECK((*feature)->package.feature == "b");
+
+        auto all = status_db.find_all(name, Test::X86_WINDOWS);
+        REQUIRE(all.size() == 3);
+        CHECK(!(*all[0])->package.is_feature());
+        CHECK((*all[1])->package.feature == "b");
+        CHECK((*all[2])->package.feature == "a");
+
+        auto ipv = status_db.get_installed_package_view({name, Test::X86_WINDOWS}).value_or_exit(VCPKG_LINE_INFO);
+        CHECK(ipv.core == core->get());
+        REQUIRE(ipv.features.size() == 2);
+        CHECK(ipv.features[0]->package.feature == "b");
+    }
+
+    CHECK(status_db.find("pkg200", Test::X86_WINDOWS) == status_db.end());
+    CHECK(!status_db.get_installed_package_view({"pkg200", Test::X86_WINDOWS}).has_value());
+
+    // replacing a paragraph keeps its position
+    auto replacement = make_status_pgh("pkg7");
+    replacement->status.state = InstallState::HALF_INSTALLED;
+    auto replaced = status_db.insert(std::move(replacement));
+    CHECK(replaced == status_db.find("pkg7", Test::X86_WINDOWS));
+    CHECK(!status_db.is_installed(PackageSpec{"pkg7", Test::X86_WINDOWS}));
+    CHECK(std::distance(status_db.begin(), status_db.end()) == 800);
+
+    std::string reserialized;
+    serialize(status_db, reserialized);
+    CHECK(reserialized.size() == serialized.size() + StringView{"half-"}.size());
+}
+
+TEST_CASE ("find prefers the last duplicate paragraph", "[statusparagraphs]")
+{
+    std::vector<std::unique_ptr<StatusParagraph>> pghs;
+    pghs.push_back(make_status_pgh("a"));
+    pghs.push_back(make_status_pgh("a"));
+    pghs.back()->status.state = InstallState::NOT_INSTALLED;
+    StatusParagraphs status_db(std::move(pghs));
+    auto it = status_db.find("a", Test::X86_WINDOWS);
+    REQUIRE(it == status_db.begin());
+    CHECK((*it)->status.state == InstallState::NOT_INSTALLED);
+    CHECK(status_db.find_all("a", Test::X86_WINDOWS).size() == 2);
+}
@@ -304,3 +304,98 @@ TEST_CASE ("parse_tool_data errors", "[tools]")
     CHECK("invalid_sha512.json: error: $.tools[0].sha512 (a SHA-512 hash): invalid SHA-512 hash: notasha512\n"
           "SHA-512 hash must be 128 characters long and contain only hexadecimal digits" == invalid_sha512.error());
 }
+
+TEST_CASE ("ToolVersionProbeCache", "[tools]")
+{
+    auto& fs = real_filesystem;
+    const auto root = Test::base_temporary_directory() / "tool-version-probes";
+    fs.remove_all(root, VCPKG_LINE_INFO);
+    fs.create_directories(root, VCPKG_LINE_INFO);
+    const auto cache_path = root / "tool-versions-cache.json";
+    const auto exe_path = root / "tool";
+    fs.write_contents(exe_path, std::string("\x7F" "ELF", 4) + "version 1", VCPKG_LINE_INFO);
+
+    size_t probe_count = 0;
+    std::string reported_version = "1.0";
+    const auto probe = [&]() -> ExpectedL<std::string> {
+        ++probe_count;
+        return reported_version;
+    };
+
+    {
+        ToolVersionProbeCache cache(fs, cache_path);
+        CHECK(cache.get_version("tool", exe_path, probe).value_or_exit(VCPKG_LINE_INFO) == "1.0");
+        CHECK(probe_count == 1);
+        CHECK(cache.get_version("tool", exe_path, probe).value_or_exit(VCPKG_LINE_INFO) == "1.0");
+        CHECK(probe_count == 1);
+        // other tools at the same path are probed separately
+        CHECK(cache.get_version("other", exe_path, probe).value_or_exit(VCPKG_LINE_INFO) == "1.0");
+        CHECK(probe_count == 2);
+    }
+
+    // a later invocation reuses the probe
+    {
+        ToolVersionProbeCache cache(fs, cache_path);
+        CHECK(cache.get_version("tool", exe_path, probe).value_or_exit(VCPKG_LINE_INFO) == "1.0");
+        CHECK(probe_count == 2);
+    }
+
+    // replacing the executable invalidates the probe
+    fs.write_contents(exe_path, std::string("\x7F" "ELF", 4) + "version 2.0", VCPKG_LINE_INFO);
+    reported_version = "2.0";
+    {
+        ToolVersionProbeCache cache(fs, cache_path);
+        CHECK(cache.get_version("tool", exe_path, probe).value_or_exit(VCPKG_LINE_INFO) == "2.0");
+        CHECK(probe_count == 3);
+        CHECK(cache.get_version("tool", exe_path, probe).value_or_exit(VCPKG_LINE_INFO) == "2.0");
+        CHECK(probe_count == 3);
+    }
+
+    // a damaged cache is probed again and rewritten
+    fs.write_contents(cache_path, "{ not json", VCPKG_LINE_INFO);
+    {
+        ToolVersionProbeCache cache(fs, cache_path);
+        CHECK(cache.get_version("tool", exe_path, probe).value_or_exit(VCPKG_LINE_INFO) == "2.0");
+        CHECK(probe_count == 4);
+    }
+
+    {
+        ToolVersionProbeCache cache(fs, cache_path);
+        CHECK(cache.get_version("tool", exe_path, probe).value_or_exit(VCPKG_LINE_INFO) == "2.0");
+        CHECK(probe_count == 4);
+    }
+
+    // failed probes are not cached
+    const auto broken_path = root / "broken";
+    fs.write_contents(broken_path, std::string("\x7F" "ELF", 4), VCPKG_LINE_INFO);
+    const auto failing_probe = [&]() -> ExpectedL<std::string> {
+        ++probe_count;
+        return LocalizedString::from_raw("no version");
+    };
+
+    {
+        ToolVersionProbeCache cache(fs, cache_path);
+        CHECK(!cache.get_version("tool", broken_path, failing_probe).has_value());
+        CHECK(!cache.get_version("tool", broken_path, failing_probe).has_value());
+        CHECK(probe_count == 6);
+    }
+
+    // the version reported by scripts and shims comes from other files, so they are always probed
+    const auto script_path = root / "shim";
+    fs.write_contents(script_path, "#!/bin/sh\nexec \"$(tool-manager which tool)\" \"$@\"\n", VCPKG_LINE_INFO);
+    {
+        ToolVersionProbeCache cache(fs, cache_path);
+        CHECK(cache.get_version("tool", script_path, probe).value_or_exit(VCPKG_LINE_INFO) == "2.0");
+        CHECK(cache.get_version("tool", script_path, probe).value_or_exit(VCPKG_LINE_INFO) == "2.0");
+        CHECK(probe_count == 8);
+    }
+
+    // executables which don't exist are probed, which reports the error
+    {
+        ToolVersionProbeCache cache(fs, cache_path);
+        CHECK(!cache.get_version("tool", root / "missing", failing_probe).has_value());
+        CHECK(probe_count == 9);
+    }
+
+    fs.remove_all(root, VCPKG_LINE_INFO);
+}
@@ -0,0 +1,139 @@
+#include <vcpkg-test/util.h>
+
+#include <vcpkg/base/files.h>
+#include <vcpkg/base/strings.h>
+#include <vcpkg/base/util.h>
+
+#include <vcpkg/installedpaths.h>
+#include <vcpkg/statusparagraphs.h>
+#include <vcpkg/vcpkglib.h>
+
+using namespace vcpkg;
+using namespace vcpkg::Test;
+
+namespace
+{
+    struct InstalledFixture
+    {
+        InstalledFixture(StringView name) : installed(base_temporary_directory() / name)
+        {
+            real_filesystem.remove_all(installed.root(), VCPKG_LINE_INFO);
+            real_filesystem.create_directories(installed.vcpkg_dir_info(), VCPKG_LINE_INFO);
+        }
+
+        ~InstalledFixture() { real_filesystem.remove_all(installed.root(), IgnoreErrors{}); }
+
+        void install(const char* name, std::vector<std::string> lines)
+        {
+            auto pgh = make_status_pgh(name);
+            real_filesystem.write_lines(installed.listfile_path(pgh->package), lines, VCPKG_LINE_INFO);
+            status_db.insert(std::move(pgh));
+        }
+
+        InstalledPaths installed;
+        StatusParagraphs status_db;
+    };
+}
+
+TEST_CASE ("installed files index finds conflicts", "[vcpkglib]")
+{
+    InstalledFixture fixture("installed_files_index_conflicts");
+    fixture.install("a", {"x86-windows/", "x86-windows/include/", "x86-windows/include/a.h", "x86-windows/lib/a.lib"});
+    fixture.install("b", {"x86-windows/", "x86-windows/include/", "x86-windows/include/B.h"});
+
+    auto index = load_installed_files_index(real_filesystem, fixture.installed, fixture.status_db);
+    CHECK(index.is_modified());
+
+    SortedVector<std::string> package_files(std::vector<std::string>{"include/b.h", "include/c.h", "lib/a.lib"});
+    std::vector<std::pair<std::string, std::string>> expected{{"lib/a.lib", "a:x86-windows"},
+                                                              {"include/B.h", "b:x86-windows"}};
+    CHECK(index.find_conflicts(Test::X86_WINDOWS, package_files) == expected);
+    CHECK(index.find_conflicts(Test::X64_WINDOWS, package_files).empty());
+
+    CHECK(index.find_owner("x86-windows/include/a.h").value_or_exit(VCPKG_LINE_INFO) == "a:x86-windows");
+    CHECK(!index.find_owner("x86-windows/include/b.h").has_value());
+    CHECK(!index.find_owner("x86-windows/include/").has_value());
+
+    std::vector<std::pair<std::string, std::string>> expected_search{{"a:x86-windows", "x86-windows/include/a.h"},
+                                                                     {"b:x86-windows", "x86-windows/include/B.h"}};
+    auto actual_search = index.search(".h");
+    Util::sort(actual_search);
+    CHECK(actual_search == expected_search);
+}
+
+TEST_CASE ("installed files index persistence", "[vcpkglib]")
+{
+    InstalledFixture fixture("installed_files_index_persistence");
+    fixture.install("a", {"x86-windows/", "x86-windows/a.h"});
+
+    auto index = load_installed_files_index_and_upgrade(real_filesystem, fixture.installed, fixture.status_db);
+    save_installed_files_index(real_filesystem, fixture.installed, index);
+    REQUIRE(real_filesystem.exists(fixture.installed.vcpkg_dir_files_index(), IgnoreErrors{}));
+
+    auto reloaded = load_installed_files_index(real_filesystem, fixture.installed, fixture.status_db);
+    CHECK(!reloaded.is_modified());
+    CHECK(reloaded.serialize() == index.serialize());
+
+    // installing another package without updating the index makes it stale
+    fixture.install("b", {"x86-windows/", "x86-windows/b.h"});
+    CHECK(!reloaded.is_current(real_filesystem, fixture.installed, fixture.status_db));
+    auto rebuilt = load_installed_files_index(real_filesystem, fixture.installed, fixture.status_db);
+    CHECK(rebuilt.is_modified());
+    CHECK(rebuilt.find_owner("x86-windows/b.h").value_or_exit(VCPKG_LINE_INFO) == "b:x86-windows");
+
+    // which incremental updates avoid
+    reloaded.add_package(real_filesystem, fixture.installed, make_status_pgh("b")->package);
+    CHECK(reloaded.is_current(real_filesystem, fixture.installed, fixture.status_db));
+    CHECK(reloaded.find_owner("x86-windows/b.h").value_or_exit(VCPKG_LINE_INFO) == "b:x86-windows");
+
+    reloaded.remove_package(fixture.installed, make_status_pgh("a")->package);
+    CHECK(!reloaded.find_owner("x86-windows/a.h").has_value());
+    CHECK(reloaded.find_owner("x86-windows/b.h").value_or_exit(VCPKG_LINE_INFO) == "b:x86-windows");
+
+    CHECK(!InstalledFilesIndex::deserialize("").has_value());
+    auto serialized = rebuilt.serialize();
+    CHECK(InstalledFilesIndex::deserialize(serialized).has_value());
+    serialized.pop_back();
+    CHECK(!InstalledFilesIndex::deserialize(serialized).has_value());
+}
+
+TEST_CASE ("status snapshot", "[vcpkglib]")
+{
+    InstalledFixture fixture("status_snapshot");
+    const auto& installed = fixture.installed;
+    StatusParagraphs text_db;
+    text_db.insert(make_status_pgh("a", "b, c:x64-windows", "x"));
+    text_db.insert(make_status_feature_pgh("a", "x", "d"));
+    text_db.insert(make_status_pgh("b"));
+    real_filesystem.write_contents(installed.vcpkg_dir_status_file(), Strings::serialize(text_db), VCPKG_LINE_INFO);
+    const auto expected = Strings::serialize(text_db);
+
+    auto collapsed = database_load_collapse(real_filesystem, installed);
+    CHECK(Strings::serialize(collapsed) == expected);
+    REQUIRE(real_filesystem.exists(installed.vcpkg_dir_status_snapshot(), IgnoreErrors{}));
+
+    auto loaded = database_load(real_filesystem, installed);
+    CHECK(Strings::serialize(loaded) == expected);
+    auto a = loaded.find_installed(FeatureSpec{{"a", Test::X86_WINDOWS}, "x"});
+    REQUIRE(a != loaded.end());
+    CHECK((*a)->package.dependencies == std::vector<PackageSpec>{{"d", Test::X86_WINDOWS}});
+
+    // updates are applied on top of the snapshot, and collapsing them refreshes it
+    write_update(real_filesystem, installed, *make_status_pgh("c"));
+    loaded = database_load(real_filesystem, installed);
+    CHECK(loaded.is_installed(PackageSpec{"c", Test::X86_WINDOWS}));
+    auto old_snapshot = real_filesystem.read_contents(installed.vcpkg_dir_status_snapshot(), VCPKG_LINE_INFO);
+    collapsed = database_load_collapse(real_filesystem, installed);
+    CHECK(real_filesystem.read_contents(installed.vcpkg_dir_status_snapshot(), VCPKG_LINE_INFO) != old_snapshot);
+    CHECK(Strings::serialize(database_load(real_filesystem, installed)) == Strings::serialize(collapsed));
+
+    // the text status file remains the source of truth
+    text_db.insert(make_status_pgh("d"));
+    real_filesystem.write_contents(installed.vcpkg_dir_status_file(), Strings::serialize(text_db), VCPKG_LINE_INFO);
+    loaded = database_load(real_filesystem, installed);
+    CHECK(loaded.is_installed(PackageSpec{"d", Test::X86_WINDOWS}));
+    CHECK(!loaded.is_installed(PackageSpec{"c", Test::X86_WINDOWS}));
+
+    real_filesystem.write_contents(installed.vcpkg_dir_status_snapshot(), "garbage", VCPKG_LINE_INFO);
+    CHECK(Strings::serialize(database_load(real_filesystem, installed)) == Strings::serialize(text_db));
+}
@@ -1,5 +1,7 @@
 #include <vcpkg/base/contractual-constants.h>
+#include <vcpkg/base/deflate.h>
 #include <vcpkg/base/files.h>
+#include <vcpkg/base/parallel-algorithms.h>
 #include <vcpkg/base/parse.h>
 #include <vcpkg/base/strings.h>
 #include <vcpkg/base/system.h>
@@ -9,6 +11,15 @@
 #include <vcpkg/archives.h>
 #include <vcpkg/tools.h>
 
+#if !defined(_WIN32)
+#include <limits.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+#include <set>
+
 namespace
 {
     using namespace vcpkg;
@@ -126,6 +137,655 @@ namespace
     }
 #endif // ^^^ _WIN32
 
+#if !defined(_WIN32)
+    // A native implementation of the parts of the zip format used by binary caching: stored and deflated entries,
+    // zip64 extensions, unix permissions and symlinks. It produces archives that `unzip` accepts and reads archives
+    // produced by `zip -y -r`, so binary caches can be shared with versions of vcpkg that use those tools.
+
+    constexpr std::uint32_t ZipLocalHeaderSignature = 0x04034b50;
+    constexpr std::uint32_t ZipCentralHeaderSignature = 0x02014b50;
+    constexpr std::uint32_t ZipEndOfCentralDirectorySignature = 0x06054b50;
+    constexpr std::uint32_t Zip64EndOfCentralDirectorySignature = 0x06064b50;
+    constexpr std::uint32_t Zip64EndOfCentralDirectoryLocatorSignature = 0x07064b50;
+    constexpr std::uint16_t Zip64ExtraFieldTag = 0x0001;
+    constexpr std::uint16_t ZipMethodStored = 0;
+    constexpr std::uint16_t ZipMethodDeflated = 8;
+    constexpr std::uint16_t ZipFlagEncrypted = 0x0001;
+    constexpr std::uint16_t ZipFlagUtf8 = 0x0800;
+    constexpr std::uint16_t ZipVersionDeflate = 20;
+    constexpr std::uint16_t ZipVersionZip64 = 45;
+    constexpr std::uint16_t ZipMadeByUnix = 3;
+    constexpr std::uint32_t ZipMax32 = 0xFFFFFFFFu;
+    constexpr std::uint16_t ZipMax16 = 0xFFFFu;
+    constexpr std::size_t ZipLocalHeaderSize = 30;
+    constexpr std::size_t ZipCentralHeaderSize = 46;
+    constexpr std::size_t ZipEndOfCentralDirectorySize = 22;
+    constexpr std::size_t Zip64EndOfCentralDirectorySize = 56;
+    constexpr std::size_t Zip64EndOfCentralDirectoryLocatorSize = 20;
+
+    std::uint16_t load_le16(const unsigned char* p) noexcept { return static_cast<std::uint16_t>(p[0] | (p[1] << 8)); }
+
+    std::uint32_t load_le32(const unsigned char* p) noexcept
+    {
+        return static_cast<std::uint32_t>(p[0]) | (static_cast<std::uint32_t>(p[1]) << 8) |
+               (static_cast<std::uint32_t>(p[2]) << 16) | (static_cast<std::uint32_t>(p[3]) << 24);
+    }
+
+    std::uint64_t load_le64(const unsigned char* p) noexcept
+    {
+        return static_cast<std::uint64_t>(load_le32(p)) | (static_cast<std::uint64_t>(load_le32(p + 4)) << 32);
+    }
+
+    void append_le16(std::string& out, std::uint16_t value)
+    {
+        out.push_back(static_cast<char>(value & 0xFF));
+        out.push_back(static_cast<char>(value >> 8));
+    }
+
+    void append_le32(std::string& out, std::uint32_t value)
+    {
+        append_le16(out, static_cast<std::uint16_t>(value & 0xFFFF));
+        append_le16(out, static_cast<std::uint16_t>(value >> 16));
+    }
+
+    void append_le64(std::string& out, std::uint64_t value)
+    {
+        append_le32(out, static_cast<std::uint32_t>(value & 0xFFFFFFFFu));
+        append_le32(out, static_cast<std::uint32_t>(value >> 32));
+    }
+
+    struct Crc32Table
+    {
+        Crc32Table() noexcept
+        {
+            for (std::uint32_t i = 0; i < 256; ++i)
+            {
+                std::uint32_t crc = i;
+                for (int bit = 0; bit < 8; ++bit)
+                {
+                    crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1u)));
+                }
+
+                entries[0][i] = crc;
+            }
+
+            for (std::size_t slice = 1; slice < 8; ++slice)
+            {
+                for (std::size_t i = 0; i < 256; ++i)
+                {
+                    const auto previous = entries[slice - 1][i];
+                    entries[slice][i] = (previous >> 8) ^ entries[0][previous & 0xFF];
+                }
+            }
+        }
+
+        std::uint32_t entries[8][256];
+    };
+
+    // slicing-by-8 CRC-32 as used by zip
+    std::uint32_t zip_crc32(const unsigned char* data, std::size_t size) noexcept
+    {
+        static const Crc32Table table;
+        const auto& t = table.entries;
+        std::uint32_t crc = 0xFFFFFFFFu;
+        for (; size >= 8; size -= 8, data += 8)
+        {
+            crc ^= load_le32(data);
+            const auto high = load_le32(data + 4);
+            crc = t[7][crc & 0xFF] ^ t[6][(crc >> 8) & 0xFF] ^ t[5][(crc >> 16) & 0xFF] ^ t[4][crc >> 24] ^
+                  t[3][high & 0xFF] ^ t[2][(high >> 8) & 0xFF] ^ t[1][(high >> 16) & 0xFF] ^ t[0][high >> 24];
+        }
+
+        for (; size != 0; --size, ++data)
+        {
+            crc = t[0][(crc ^ *data) & 0xFF] ^ (crc >> 8);
+        }
+
+        return ~crc;
+    }
+
+    struct ZipSourceEntry
+    {
+        // relative path with '/' separators; directories end with '/'
+        std::string name;
+        Path path;
+        FileType type;
+        std::uint32_t mode;
+        std::uint16_t dos_time;
+        std::uint16_t dos_date;
+        std::uint64_t size;
+    };
+
+    struct ZipCompressedEntry
+    {
+        std::uint16_t method = ZipMethodStored;
+        std::uint32_t crc = 0;
+        std::uint64_t uncompressed_size = 0;
+        std::string data;
+        std::error_code ec;
+    };
+
+    struct ZipCentralEntry
+    {
+        std::string name;
+        std::uint16_t flags;
+        std::uint16_t method;
+        std::uint16_t dos_time;
+        std::uint16_t dos_date;
+        std::uint32_t crc;
+        std::uint64_t compressed_size;
+        std::uint64_t uncompressed_size;
+        std::uint64_t local_header_offset;
+        std::uint32_t mode;
+    };
+
+    void to_dos_date_time(time_t time, std::uint16_t& dos_time, std::uint16_t& dos_date)
+    {
+        struct tm parts;
+        if (!localtime_r(&time, &parts) || parts.tm_year < 80)
+        {
+            dos_time = 0;
+            dos_date = (1 << 5) | 1; // 1980-01-01
+            return;
+        }
+
+        dos_time = static_cast<std::uint16_t>((parts.tm_hour << 11) | (parts.tm_min << 5) | (parts.tm_sec / 2));
+        dos_date = static_cast<std::uint16_t>(((parts.tm_year - 80) << 9) | ((parts.tm_mon + 1) << 5) | parts.tm_mday);
+    }
+
+    bool read_symlink_target(const Path& path, std::string& target, std::error_code& ec)
+    {
+        target.resize(PATH_MAX);
+        for (;;)
+        {
+            const auto result = ::readlink(path.c_str(), &target[0], target.size());
+            if (result < 0)
+            {
+                ec.assign(errno, std::generic_category());
+                return false;
+            }
+
+            if (static_cast<std::size_t>(result) < target.size())
+            {
+                target.resize(static_cast<std::size_t>(result));
+                return true;
+            }
+
+            target.resize(target.size() * 2);
+        }
+    }
+
+    // Lists the entries `zip -y -r destination *` would add when run in `source`.
+    bool collect_zip_source_entries(DiagnosticContext& context,
+                                    const Filesystem& fs,
+                                    const Path& source,
+                                    std::vector<ZipSourceEntry>& entries)
+    {
+        std::error_code ec;
+        auto paths = fs.get_files_recursive(source, ec);
+        if (ec)
+        {
+            context.report_error(format_filesystem_call_error(ec, "get_files_recursive", {source}));
+            return false;
+        }
+
+        Util::sort(paths);
+        std::string prefix = source.native();
+        if (!prefix.empty() && prefix.back() != '/')
+        {
+            prefix.push_back('/');
+        }
+
+        for (auto&& path : paths)
+        {
+            if (!Strings::starts_with(path.native(), prefix))
+            {
+                continue;
+            }
+
+            std::string name = path.native().substr(prefix.size());
+            // the `*` glob skips hidden files at the top level
+            if (name.empty() || name[0] == '.' || path.filename() == FileDotDsStore)
+            {
+                continue;
+            }
+
+            ZipSourceEntry entry;
+            entry.path = std::move(path);
+            struct stat info;
+            if (::lstat(entry.path.c_str(), &info) != 0)
+            {
+                ec.assign(errno, std::generic_category());
+                context.report_error(format_filesystem_call_error(ec, "lstat", {entry.path}));
+                return false;
+            }
+
+            if (S_ISDIR(info.st_mode))
+            {
+                entry.type = FileType::directory;
+                name.push_back('/');
+            }
+            else if (S_ISLNK(info.st_mode))
+            {
+                entry.type = FileType::symlink;
+            }
+            else if (S_ISREG(info.st_mode))
+            {
+                entry.type = FileType::regular;
+            }
+            else
+            {
+                continue;
+            }
+
+            entry.name = std::move(name);
+            entry.mode = static_cast<std::uint32_t>(info.st_mode);
+            entry.size = entry.type == FileType::regular ? static_cast<std::uint64_t>(info.st_size) : 0;
+            to_dos_date_time(info.st_mtime, entry.dos_time, entry.dos_date);
+            entries.push_back(std::move(entry));
+        }
+
+        return true;
+    }
+
+    ZipCompressedEntry compress_zip_entry(const Filesystem& fs, const ZipSourceEntry& entry)
+    {
+        ZipCompressedEntry result;
+        std::string contents;
+        if (entry.type == FileType::regular)
+        {
+            contents = fs.read_contents(entry.path, result.ec);
+        }
+        else if (entry.type == FileType::symlink)
+        {
+            read_symlink_target(entry.path, contents, result.ec);
+        }
+
+        if (result.ec)
+        {
+            return result;
+        }
+
+        const auto bytes = reinterpret_cast<const unsigned char*>(contents.data());
+        result.uncompressed_size = contents.size();
+        result.crc = zip_crc32(bytes, contents.size());
+        if (!contents.empty())
+        {
+            result.data = deflate_bytes(bytes, contents.size());
+            if (result.data.size() < contents.size())
+            {
+                result.method = ZipMethodDeflated;
+                return result;
+            }
+        }
+
+        result.data = std::move(contents);
+        return result;
+    }
+
+    bool is_ascii(StringView sv)
+    {
+        return std::all_of(sv.begin(), sv.end(), [](char ch) { return static_cast<unsigned char>(ch) < 0x80; });
+    }
+
+    // Appends the local header of `entry` to `out` and the central directory header to `central_directory`.
+    void append_zip_headers(std::string& out,
+                            std::string& central_directory,
+                            const ZipSourceEntry& source,
+                            const ZipCompressedEntry& entry,
+                            std::uint64_t local_header_offset)
+    {
+        const std::uint64_t compressed_size = entry.data.size();
+        const bool sizes_need_zip64 = entry.uncompressed_size >= ZipMax32 || compressed_size >= ZipMax32;
+        const bool offset_needs_zip64 = local_header_offset >= ZipMax32;
+        const std::uint16_t version_needed =
+            sizes_need_zip64 || offset_needs_zip64 ? ZipVersionZip64 : ZipVersionDeflate;
+        const std::uint16_t flags = is_ascii(source.name) ? 0 : ZipFlagUtf8;
+        const auto name_size = static_cast<std::uint16_t>(source.name.size());
+
+        std::string local_extra;
+        if (sizes_need_zip64)
+        {
+            append_le16(local_extra, Zip64ExtraFieldTag);
+            append_le16(local_extra, 16);
+            append_le64(local_extra, entry.uncompressed_size);
+            append_le64(local_extra, compressed_size);
+        }
+
+        append_le32(out, ZipLocalHeaderSignature);
+        append_le16(out, version_needed);
+        append_le16(out, flags);
+        append_le16(out, entry.method);
+        append_le16(out, source.dos_time);
+        append_le16(out, source.dos_date);
+        append_le32(out, entry.crc);
+        append_le32(out, sizes_need_zip64 ? ZipMax32 : static_cast<std::uint32_t>(compressed_size));
+        append_le32(out, sizes_need_zip64 ? ZipMax32 : static_cast<std::uint32_t>(entry.uncompressed_size));
+        append_le16(out, name_size);
+        append_le16(out, static_cast<std::uint16_t>(local_extra.size()));
+        out.append(source.name);
+        out.append(local_extra);
+
+        std::string central_extra;
+        if (sizes_need_zip64 || offset_needs_zip64)
+        {
+            append_le16(central_extra, Zip64ExtraFieldTag);
+            append_le16(central_extra,
+                        static_cast<std::uint16_t>((sizes_need_zip64 ? 16 : 0) + (offset_needs_zip64 ? 8 : 0)));
+            if (sizes_need_zip64)
+            {
+                append_le64(central_extra, entry.uncompressed_size);
+                append_le64(central_extra, compressed_size);
+            }
+
+            if (offset_needs_zip64)
+            {
+                append_le64(central_extra, local_header_offset);
+            }
+        }
+
+        // MS-DOS directory attribute in the low byte, unix mode in the high word
+        const std::uint32_t external_attributes =
+            (source.mode << 16) | (source.type == FileType::directory ? 0x10u : 0u);
+        append_le32(central_directory, ZipCentralHeaderSignature);
+        append_le16(central_directory, static_cast<std::uint16_t>((ZipMadeByUnix << 8) | ZipVersionZip64));
+        append_le16(central_directory, version_needed);
+        append_le16(central_directory, flags);
+        append_le16(central_directory, entry.method);
+        append_le16(central_directory, source.dos_time);
+        append_le16(central_directory, source.dos_date);
+        append_le32(central_directory, entry.crc);
+        append_le32(central_directory, sizes_need_zip64 ? ZipMax32 : static_cast<std::uint32_t>(compressed_size));
+        append_le32(central_directory,
+                    sizes_need_zip64 ? ZipMax32 : static_cast<std::uint32_t>(entry.uncompressed_size));
+        append_le16(central_directory, name_size);
+        append_le16(central_directory, static_cast<std::uint16_t>(central_extra.size()));
+        append_le16(central_directory, 0); // comment length
+        append_le16(central_directory, 0); // disk number
+        append_le16(central_directory, 0); // internal attributes
+        append_le32(central_directory, external_attributes);
+        append_le32(central_directory, offset_needs_zip64 ? ZipMax32 : static_cast<std::uint32_t>(local_header_offset));
+        central_directory.append(source.name);
+        central_directory.append(central_extra);
+    }
+
+    void append_zip_end_of_central_directory(std::string& out,
+                                             std::uint64_t entry_count,
+                                             std::uint64_t central_directory_offset,
+                                             std::uint64_t central_directory_size)
+    {
+        const bool needs_zip64 =
+            entry_count >= ZipMax16 || central_directory_offset >= ZipMax32 || central_directory_size >= ZipMax32;
+        if (needs_zip64)
+        {
+            const std::uint64_t zip64_end_offset = central_directory_offset + central_directory_size;
+            append_le32(out, Zip64EndOfCentralDirectorySignature);
+            append_le64(out, Zip64EndOfCentralDirectorySize - 12);
+            append_le16(out, static_cast<std::uint16_t>((ZipMadeByUnix << 8) | ZipVersionZip64));
+            append_le16(out, ZipVersionZip64);
+            append_le32(out, 0); // this disk
+            append_le32(out, 0); // disk with the central directory
+            append_le64(out, entry_count);
+            append_le64(out, entry_count);
+            append_le64(out, central_directory_size);
+            append_le64(out, central_directory_offset);
+
+            append_le32(out, Zip64EndOfCentralDirectoryLocatorSignature);
+            append_le32(out, 0);
+            append_le64(out, zip64_end_offset);
+            append_le32(out, 1); // total disks
+        }
+
+        append_le32(out, ZipEndOfCentralDirectorySignature);
+        append_le16(out, 0);
+        append_le16(out, 0);
+        const auto short_count = needs_zip64 ? ZipMax16 : static_cast<std::uint16_t>(entry_count);
+        append_le16(out, short_count);
+        append_le16(out, short_count);
+        append_le32(out, needs_zip64 ? ZipMax32 : static_cast<std::uint32_t>(central_directory_size));
+        append_le32(out, needs_zip64 ? ZipMax32 : static_cast<std::uint32_t>(central_directory_offset));
+        append_le16(out, 0); // comment length
+    }
+
+    bool read_zip_central_directory(StringView contents, std::vector<ZipCentralEntry>& entries)
+    {
+        const auto data = reinterpret_cast<const unsigned char*>(contents.data());
+        const std::size_t size = contents.size();
+        if (size < ZipEndOfCentralDirectorySize)
+        {
+            return false;
+        }
+
+        // the end of central directory record is followed by a comment of at most 65535 bytes
+        std::size_t end_offset = size - ZipEndOfCentralDirectorySize;
+        const std::size_t search_limit = end_offset > ZipMax16 ? end_offset - ZipMax16 : 0;
+        while (load_le32(data + end_offset) != ZipEndOfCentralDirectorySignature)
+        {
+            if (end_offset == search_limit)
+            {
+                return false;
+            }
+
+            --end_offset;
+        }
+
+        std::uint64_t entry_count = load_le16(data + end_offset + 10);
+        std::uint64_t central_directory_size = load_le32(data + end_offset + 12);
+        std::uint64_t central_directory_offset = load_le32(data + end_offset + 16);
+        if (end_offset >= Zip64EndOfCentralDirectoryLocatorSize &&
+            load_le32(data + end_offset - Zip64EndOfCentralDirectoryLocatorSize) ==
+                Zip64EndOfCentralDirectoryLocatorSignature)
+        {
+            const auto zip64_end_offset = load_le64(data + end_offset - Zip64EndOfCentralDirectoryLocatorSize + 8);
+            if (zip64_end_offset > size - Zip64EndOfCentralDirectorySize ||
+                load_le32(data + zip64_end_offset) != Zip64EndOfCentralDirectorySignature)
+            {
+                return false;
+            }
+
+            entry_count = load_le64(data + zip64_end_offset + 32);
+            central_directory_size = load_le64(data + zip64_end_offset + 40);
+            central_directory_offset = load_le64(data + zip64_end_offset + 48);
+        }
+
+        if (central_directory_offset > size || central_directory_size > size - central_directory_offset)
+        {
+            return false;
+        }
+
+        const unsigned char* pos = data + central_directory_offset;
+        const unsigned char* const central_directory_end = pos + central_directory_size;
+        entries.clear();
+        for (std::uint64_t i = 0; i < entry_count; ++i)
+        {
+            if (static_cast<std::size_t>(central_directory_end - pos) < ZipCentralHeaderSize ||
+                load_le32(pos) != ZipCentralHeaderSignature)
+            {
+                return false;
+            }
+
+            const std::size_t name_size = load_le16(pos + 28);
+            const std::size_t extra_size = load_le16(pos + 30);
+            const std::size_t comment_size = load_le16(pos + 32);
+            const std::size_t header_size = ZipCentralHeaderSize + name_size + extra_size + comment_size;
+            if (static_cast<std::size_t>(central_directory_end - pos) < header_size)
+            {
+                return false;
+            }
+
+            ZipCentralEntry entry;
+            entry.flags = load_le16(pos + 8);
+            entry.method = load_le16(pos + 10);
+            entry.dos_time = load_le16(pos + 12);
+            entry.dos_date = load_le16(pos + 14);
+            entry.crc = load_le32(pos + 16);
+            entry.compressed_size = load_le32(pos + 20);
+            entry.uncompressed_size = load_le32(pos + 24);
+            entry.local_header_offset = load_le32(pos + 42);
+            entry.mode = (load_le16(pos + 4) >> 8) == ZipMadeByUnix ? load_le32(pos + 38) >> 16 : 0;
+            entry.name.assign(reinterpret_cast<const char*>(pos + ZipCentralHeaderSize), name_size);
+
+            // zip64 values are present only for the fields which overflowed, in this order
+            const unsigned char* extra = pos + ZipCentralHeaderSize + name_size;
+            const unsigned char* const extra_end = extra + extra_size;
+            while (extra_end - extra >= 4)
+            {
+                const auto tag = load_le16(extra);
+                const std::size_t field_size = load_le16(extra + 2);
+                const unsigned char* field = extra + 4;
+                if (static_cast<std::size_t>(extra_end - field) < field_size)
+                {
+                    return false;
+                }
+
+                if (tag == Zip64ExtraFieldTag)
+                {
+                    const unsigned char* const field_end = field + field_size;
+                    for (auto value : {&entry.uncompressed_size, &entry.compressed_size, &entry.local_header_offset})
+                    {
+                        if (*value == ZipMax32)
+                        {
+                            if (field_end - field < 8)
+                            {
+                                return false;
+                            }
+
+                            *value = load_le64(field);
+                            field += 8;
+                        }
+                    }
+                }
+
+                extra += 4 + field_size;
+            }
+
+            entries.push_back(std::move(entry));
+            pos += header_size;
+        }
+
+        return true;
+    }
+
+    // Returns the offset of the data of `entry` in `contents`, or 0 if the local header is invalid.
+    std::size_t find_zip_entry_data(StringView contents, const ZipCentralEntry& entry)
+    {
+        const auto data = reinterpret_cast<const unsigned char*>(contents.data());
+        const std::size_t size = contents.size();
+        if (entry.local_header_offset > size || size - entry.local_header_offset < ZipLocalHeaderSize ||
+            load_le32(data + entry.local_header_offset) != ZipLocalHeaderSignature)
+        {
+            return 0;
+        }
+
+        const std::size_t data_offset = static_cast<std::size_t>(entry.local_header_offset) + ZipLocalHeaderSize +
+                                        load_le16(data + entry.local_header_offset + 26) +
+                                        load_le16(data + entry.local_header_offset + 28);
+        if (data_offset > size || size - data_offset < entry.compressed_size)
+        {
+            return 0;
+        }
+
+        return data_offset;
+    }
+
+    // Rejects absolute paths and `..` components, which would extract outside of the destination.
+    bool is_safe_zip_entry_name(StringView name)
+    {
+        if (name.empty() || name[0] == '/')
+        {
+            return false;
+        }
+
+        for (auto&& component : Strings::split(name, '/'))
+        {
+            if (component == "..")
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    struct ZipExtractionState
+    {
+        std::string contents;
+        std::vector<ZipCentralEntry> entries;
+        Optional<LocalizedString> error;
+    };
+
+    struct ZipFileExtraction
+    {
+        std::size_t job;
+        const ZipCentralEntry* entry;
+        Optional<LocalizedString> error;
+    };
+
+    Optional<LocalizedString> extract_zip_file(const Filesystem& fs,
+                                               const Path& archive,
+                                               StringView contents,
+                                               const ZipCentralEntry& entry,
+                                               const Path& target)
+    {
+        if ((entry.flags & ZipFlagEncrypted) || (entry.method != ZipMethodStored && entry.method != ZipMethodDeflated))
+        {
+            return msg::format(msgZipEntryUnsupported, msg::path = archive, msg::value = entry.name);
+        }
+
+        const auto data_offset = find_zip_entry_data(contents, entry);
+        if (data_offset == 0 || (entry.method == ZipMethodStored && entry.compressed_size != entry.uncompressed_size))
+        {
+            return msg::format(msgZipEntryCorrupt, msg::path = archive, msg::value = entry.name);
+        }
+
+        const auto compressed = reinterpret_cast<const unsigned char*>(contents.data()) + data_offset;
+        std::string inflated;
+        StringView file_contents;
+        if (entry.method == ZipMethodStored)
+        {
+            file_contents = StringView{reinterpret_cast<const char*>(compressed), entry.compressed_size};
+        }
+        else if (inflate_bytes(compressed, compressed + entry.compressed_size, entry.uncompressed_size, inflated))
+        {
+            file_contents = inflated;
+        }
+        else
+        {
+            return msg::format(msgZipEntryCorrupt, msg::path = archive, msg::value = entry.name);
+        }
+
+        if (zip_crc32(reinterpret_cast<const unsigned char*>(file_contents.data()), file_contents.size()) != entry.crc)
+        {
+            return msg::format(msgZipEntryCorrupt, msg::path = archive, msg::value = entry.name);
+        }
+
+        std::error_code ec;
+        if (S_ISLNK(entry.mode))
+        {
+            fs.create_symlink(file_contents, target, ec);
+            if (ec)
+            {
+                return format_filesystem_call_error(ec, "create_symlink", {file_contents, target});
+            }
+
+            return nullopt;
+        }
+
+        fs.write_contents(target, file_contents, ec);
+        if (ec)
+        {
+            return format_filesystem_call_error(ec, "write_contents", {target});
+        }
+
+        if ((entry.mode & 0777) != 0 && ::chmod(target.c_str(), static_cast<mode_t>(entry.mode & 07777)) != 0)
+        {
+            ec.assign(errno, std::generic_category());
+            return format_filesystem_call_error(ec, "chmod", {target});
+        }
+
+        return nullopt;
+    }
+#endif // ^^^ !_WIN32
 }
 
 namespace vcpkg
@@ -310,6 +970,208 @@ namespace vcpkg
                                msg::path = archive);
     }
 
+#if !defined(_WIN32)
+    bool zip_directory(DiagnosticContext& context, const Filesystem& fs, const Path& source, const Path& destination)
+    {
+        // bounds the amount of file contents held in memory while compressing
+        static constexpr std::uint64_t BatchBytes = 256 * 1024 * 1024;
+
+        std::vector<ZipSourceEntry> entries;
+        if (!collect_zip_source_entries(context, fs, source, entries))
+        {
+            return false;
+        }
+
+        std::error_code ec;
+        auto out = fs.open_for_write(destination, Append::NO, ec);
+        if (ec)
+        {
+            context.report_error(format_filesystem_call_error(ec, "open_for_write", {destination}));
+            return false;
+        }
+
+        std::uint64_t offset = 0;
+        auto write = [&](StringView data) {
+            if (out.write(data.data(), 1, data.size()) != data.size())
+            {
+                context.report_error(format_filesystem_call_error(out.error(), "write", {destination}));
+                return false;
+            }
+
+            offset += data.size();
+            return true;
+        };
+
+        std::string headers;
+        std::string central_directory;
+        std::vector<ZipCompressedEntry> compressed;
+        for (std::size_t batch_start = 0; batch_start != entries.size();)
+        {
+            std::size_t batch_end = batch_start;
+            std::uint64_t batch_bytes = 0;
+            do
+            {
+                batch_bytes += entries[batch_end].size;
+                ++batch_end;
+            } while (batch_end != entries.size() && batch_bytes < BatchBytes);
+
+            compressed.clear();
+            compressed.resize(batch_end - batch_start);
+            execute_in_parallel(compressed.size(), [&](std::size_t i) {
+                compressed[i] = compress_zip_entry(fs, entries[batch_start + i]);
+            });
+
+            for (std::size_t i = 0; i < compressed.size(); ++i)
+            {
+                const auto& source_entry = entries[batch_start + i];
+                const auto& compressed_entry = compressed[i];
+                if (compressed_entry.ec)
+                {
+                    context.report_error(
+                        format_filesystem_call_error(compressed_entry.ec, "read_contents", {source_entry.path}));
+                    return false;
+                }
+
+                headers.clear();
+                append_zip_headers(headers, central_directory, source_entry, compressed_entry, offset);
+                if (!write(headers) || !write(compressed_entry.data))
+                {
+                    return false;
+                }
+            }
+
+            batch_start = batch_end;
+        }
+
+        const auto central_directory_offset = offset;
+        append_zip_end_of_central_directory(
+            central_directory, entries.size(), central_directory_offset, central_directory.size());
+        if (!write(central_directory))
+        {
+            return false;
+        }
+
+        out.close();
+        return true;
+    }
+
+    std::vector<ExpectedL<Unit>> unzip_archives(const Filesystem& fs, View<ZipArchiveExtraction> jobs)
+    {
+        // bounds the amount of archive contents held in memory at once
+        static constexpr std::uint64_t BatchBytes = 512 * 1024 * 1024;
+
+        std::vector<ExpectedL<Unit>> results;
+        results.reserve(jobs.size());
+        for (std::size_t batch_start = 0; batch_start != jobs.size();)
+        {
+            std::size_t batch_end = batch_start;
+            std::uint64_t batch_bytes = 0;
+            do
+            {
+                batch_bytes += fs.file_size(jobs[batch_end].archive, IgnoreErrors{});
+                ++batch_end;
+            } while (batch_end != jobs.size() && batch_bytes < BatchBytes);
+
+            const View<ZipArchiveExtraction> batch{jobs.data() + batch_start, batch_end - batch_start};
+            std::vector<ZipExtractionState> states(batch.size());
+            execute_in_parallel(batch.size(), [&](std::size_t i) {
+                auto& state = states[i];
+                std::error_code ec;
+                state.contents = fs.read_contents(batch[i].archive, ec);
+                if (ec)
+                {
+                    state.error = format_filesystem_call_error(ec, "read_contents", {batch[i].archive});
+                    return;
+                }
+
+                if (!read_zip_central_directory(state.contents, state.entries))
+                {
+                    state.error = msg::format(msgZipInvalidArchive, msg::path = batch[i].archive);
+                    return;
+                }
+
+                for (auto&& entry : state.entries)
+                {
+                    if (!is_safe_zip_entry_name(entry.name))
+                    {
+                        state.error = msg::format(
+                            msgZipEntryOutsideDestination, msg::path = batch[i].archive, msg::value = entry.name);
+                        return;
+                    }
+                }
+            });
+
+            // directories are created up front so that files can be extracted in any order
+            std::vector<ZipFileExtraction> files;
+            for (std::size_t i = 0; i < batch.size(); ++i)
+            {
+                auto& state = states[i];
+                std::set<Path> created_directories;
+                for (auto&& entry : state.entries)
+                {
+                    if (state.error)
+                    {
+                        break;
+                    }
+
+                    auto target = batch[i].destination / entry.name;
+                    const bool is_directory = Strings::ends_with(entry.name, "/");
+                    Path directory = is_directory ? std::move(target) : Path(target.parent_path());
+                    if (created_directories.insert(directory).second)
+                    {
+                        std::error_code ec;
+                        fs.create_directories(directory, ec);
+                        if (ec)
+                        {
+                            state.error = format_filesystem_call_error(ec, "create_directories", {directory});
+                        }
+                    }
+
+                    if (!is_directory)
+                    {
+                        files.push_back(ZipFileExtraction{i, &entry, nullopt});
+                    }
+                }
+            }
+
+            execute_in_parallel(files.size(), [&](std::size_t i) {
+                auto& file = files[i];
+                const auto& job = batch[file.job];
+                if (!states[file.job].error)
+                {
+                    file.error = extract_zip_file(
+                        fs, job.archive, states[file.job].contents, *file.entry, job.destination / file.entry->name);
+                }
+            });
+
+            for (auto&& file : files)
+            {
+                auto& state = states[file.job];
+                if (!state.error && file.error)
+                {
+                    state.error = std::move(file.error);
+                }
+            }
+
+            for (auto&& state : states)
+            {
+                if (auto error = state.error.get())
+                {
+                    results.emplace_back(std::move(*error));
+                }
+                else
+                {
+                    results.emplace_back(Unit{});
+                }
+            }
+
+            batch_start = batch_end;
+        }
+
+        return results;
+    }
+#endif // ^^^ !_WIN32
+
     bool ZipTool::compress_directory_to_zip(DiagnosticContext& context,
                                             const Filesystem& fs,
                                             const Path& source,
@@ -325,18 +1187,13 @@ namespace vcpkg
         auto output = cmd_execute_and_capture_output(context, seven_zip_command, settings);
         return check_zero_exit_code(context, seven_zip_command, output) != nullptr;
 #else
-        RedirectedProcessLaunchSettings settings;
-        settings.working_directory = source;
-        Command zip_command{"zip"};
-        zip_command.string_arg("--quiet")
-            .string_arg("-y")
-            .string_arg("-r")
-            .string_arg(destination)
-            .string_arg("*")
-            .string_arg("--exclude")
-            .string_arg(FileDotDsStore);
-        auto output = cmd_execute_and_capture_output(context, zip_command, settings);
-        return check_zero_exit_code(context, zip_command, output) != nullptr;
+        if (!zip_directory(context, fs, source, destination))
+        {
+            fs.remove(destination, IgnoreErrors{});
+            return false;
+        }
+
+        return true;
 #endif
     }
 
@@ -369,6 +1226,20 @@ namespace vcpkg
         return cmd;
     }
 
+    std::vector<ExpectedL<Unit>> ZipTool::decompress_zip_archives(const Filesystem& fs,
+                                                                 View<ZipArchiveExtraction> jobs) const
+    {
+#if defined(_WIN32)
+        (void)fs;
+        auto commands = Util::fmap(jobs, [this](const ZipArchiveExtraction& job) {
+            return decompress_zip_archive_cmd(job.destination, job.archive);
+        });
+        return decompress_in_parallel(commands);
+#else
+        return unzip_archives(fs, jobs);
+#endif
+    }
+
     std::vector<ExpectedL<Unit>> decompress_in_parallel(View<Command> jobs)
     {
         RedirectedProcessLaunchSettings settings;
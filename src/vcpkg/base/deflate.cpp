@@ -0,0 +1,1120 @@
+#include <vcpkg/base/deflate.h>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+namespace
+{
+    std::uint16_t load_le16(const unsigned char* p) noexcept { return static_cast<std::uint16_t>(p[0] | (p[1] << 8)); }
+
+    void append_le16(std::string& out, std::uint16_t value)
+    {
+        out.push_back(static_cast<char>(value & 0xFF));
+        out.push_back(static_cast<char>(value >> 8));
+    }
+
+    void append_le32(std::string& out, std::uint32_t value)
+    {
+        append_le16(out, static_cast<std::uint16_t>(value & 0xFFFF));
+        append_le16(out, static_cast<std::uint16_t>(value >> 16));
+    }
+
+    std::uint32_t adler32(const unsigned char* data, std::size_t size) noexcept
+    {
+        // 5552 is the largest number of bytes which can be summed before `b` could overflow
+        constexpr std::size_t MaxBlock = 5552;
+        std::uint32_t a = 1;
+        std::uint32_t b = 0;
+        while (size != 0)
+        {
+            const auto block = std::min(size, MaxBlock);
+            for (std::size_t i = 0; i < block; ++i)
+            {
+                a += data[i];
+                b += a;
+            }
+
+            a %= 65521u;
+            b %= 65521u;
+            data += block;
+            size -= block;
+        }
+
+        return (b << 16) | a;
+    }
+
+    constexpr std::size_t DeflateMinMatch = 3;
+    constexpr std::size_t DeflateMaxMatch = 258;
+    constexpr std::size_t DeflateWindowSize = 32768;
+    constexpr std::size_t DeflateLiteralLengthCodes = 286;
+    constexpr std::size_t DeflateDistanceCodes = 30;
+    constexpr std::size_t DeflateCodeLengthCodes = 19;
+    constexpr unsigned int DeflateMaxCodeLength = 15;
+    constexpr unsigned int DeflateMaxCodeLengthCodeLength = 7;
+    constexpr std::uint16_t DeflateEndOfBlock = 256;
+
+    constexpr std::uint16_t deflate_length_base[29] = {3,  4,  5,  6,  7,  8,  9,  10, 11,  13,  15,  17,  19,  23, 27,
+                                                       31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+    constexpr std::uint8_t deflate_length_extra_bits[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2,
+                                                            2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+    constexpr std::uint16_t deflate_distance_base[30] = {1,    2,    3,    4,    5,    7,     9,     13,    17,  25,
+                                                         33,   49,   65,   97,   129,  193,   257,   385,   513, 769,
+                                                         1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577};
+    constexpr std::uint8_t deflate_distance_extra_bits[30] = {0, 0, 0, 0, 1, 1, 2, 2,  3,  3,  4,  4,  5,  5,  6,
+                                                              6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+    constexpr std::uint8_t deflate_code_length_order[DeflateCodeLengthCodes] = {
+        16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15};
+
+    std::uint16_t reverse_bits(std::uint16_t code, unsigned int length) noexcept
+    {
+        std::uint16_t result = 0;
+        for (unsigned int i = 0; i < length; ++i)
+        {
+            result = static_cast<std::uint16_t>((result << 1) | (code & 1));
+            code >>= 1;
+        }
+
+        return result;
+    }
+
+    // Decodes canonical Huffman codes by looking up the next `max_bits` bits of input.
+    struct HuffmanDecoder
+    {
+        // Each entry holds the symbol in the upper bits and the code length in the low 4 bits; 0 marks bit patterns
+        // which are not a prefix of any code.
+        std::vector<std::uint16_t> table;
+        unsigned int max_bits = 0;
+
+        bool build(const std::uint8_t* lengths, std::size_t count)
+        {
+            std::uint16_t length_counts[DeflateMaxCodeLength + 1] = {};
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                ++length_counts[lengths[i]];
+            }
+
+            length_counts[0] = 0;
+            max_bits = 0;
+            int remaining = 1;
+            for (unsigned int length = 1; length <= DeflateMaxCodeLength; ++length)
+            {
+                remaining = remaining * 2 - length_counts[length];
+                if (remaining < 0)
+                {
+                    return false; // over-subscribed
+                }
+
+                if (length_counts[length] != 0)
+                {
+                    max_bits = length;
+                }
+            }
+
+            if (max_bits == 0)
+            {
+                max_bits = 1;
+            }
+
+            std::uint16_t next_code[DeflateMaxCodeLength + 2] = {};
+            for (unsigned int length = 1; length <= DeflateMaxCodeLength; ++length)
+            {
+                next_code[length + 1] = static_cast<std::uint16_t>((next_code[length] + length_counts[length]) << 1);
+            }
+
+            table.assign(std::size_t{1} << max_bits, 0);
+            for (std::size_t symbol = 0; symbol < count; ++symbol)
+            {
+                const unsigned int length = lengths[symbol];
+                if (length == 0)
+                {
+                    continue;
+                }
+
+                const auto entry = static_cast<std::uint16_t>((symbol << 4) | length);
+                for (std::size_t index = reverse_bits(next_code[length]++, length); index < table.size();
+                     index += std::size_t{1} << length)
+                {
+                    table[index] = entry;
+                }
+            }
+
+            return true;
+        }
+    };
+
+    struct InflateBitReader
+    {
+        InflateBitReader(const unsigned char* first, const unsigned char* last) : m_pos(first), m_end(last) { }
+
+        // ensures at least 56 bits are buffered; past the end of input, zero bits are supplied and counted in
+        // `m_padding_bits` so that over-reads can be detected
+        void refill() noexcept
+        {
+            while (m_count <= 56)
+            {
+                if (m_pos != m_end)
+                {
+                    m_bits |= static_cast<std::uint64_t>(*m_pos++) << m_count;
+                }
+                else
+                {
+                    m_padding_bits += 8;
+                }
+
+                m_count += 8;
+            }
+        }
+
+        std::uint32_t take(unsigned int count) noexcept
+        {
+            const auto result = static_cast<std::uint32_t>(m_bits & ((std::uint64_t{1} << count) - 1));
+            m_bits >>= count;
+            m_count -= count;
+            return result;
+        }
+
+        bool decode(const HuffmanDecoder& decoder, std::uint16_t& symbol) noexcept
+        {
+            const auto entry = decoder.table[m_bits & ((std::uint64_t{1} << decoder.max_bits) - 1)];
+            if (entry == 0)
+            {
+                return false;
+            }
+
+            take(entry & 0xF);
+            symbol = static_cast<std::uint16_t>(entry >> 4);
+            return true;
+        }
+
+        bool overrun() const noexcept { return m_count < m_padding_bits; }
+
+        // discards bits up to the next byte boundary and returns the unread input
+        bool align_to_byte(const unsigned char*& pos) noexcept
+        {
+            take(m_count % 8);
+            if (overrun())
+            {
+                return false;
+            }
+
+            pos = m_pos - (m_count - m_padding_bits) / 8;
+            m_bits = 0;
+            m_count = 0;
+            m_padding_bits = 0;
+            return true;
+        }
+
+        void reset(const unsigned char* pos) noexcept { m_pos = pos; }
+
+    private:
+        const unsigned char* m_pos;
+        const unsigned char* m_end;
+        std::uint64_t m_bits = 0;
+        unsigned int m_count = 0;
+        unsigned int m_padding_bits = 0;
+    };
+
+    const std::pair<HuffmanDecoder, HuffmanDecoder>& fixed_huffman_decoders()
+    {
+        static const auto decoders = [] {
+            std::pair<HuffmanDecoder, HuffmanDecoder> result;
+            std::uint8_t lengths[288];
+            std::fill(lengths, lengths + 144, std::uint8_t{8});
+            std::fill(lengths + 144, lengths + 256, std::uint8_t{9});
+            std::fill(lengths + 256, lengths + 280, std::uint8_t{7});
+            std::fill(lengths + 280, lengths + 288, std::uint8_t{8});
+            result.first.build(lengths, 288);
+            std::fill(lengths, lengths + 32, std::uint8_t{5});
+            result.second.build(lengths, 32);
+            return result;
+        }();
+
+        return decoders;
+    }
+
+    bool read_dynamic_huffman_decoders(InflateBitReader& reader, HuffmanDecoder& literals, HuffmanDecoder& distances)
+    {
+        reader.refill();
+        const std::size_t literal_count = reader.take(5) + 257;
+        const std::size_t distance_count = reader.take(5) + 1;
+        const std::size_t code_length_count = reader.take(4) + 4;
+        if (literal_count > DeflateLiteralLengthCodes || distance_count > DeflateDistanceCodes)
+        {
+            return false;
+        }
+
+        std::uint8_t code_length_lengths[DeflateCodeLengthCodes] = {};
+        for (std::size_t i = 0; i < code_length_count; ++i)
+        {
+            reader.refill();
+            code_length_lengths[deflate_code_length_order[i]] = static_cast<std::uint8_t>(reader.take(3));
+        }
+
+        HuffmanDecoder code_lengths;
+        if (!code_lengths.build(code_length_lengths, DeflateCodeLengthCodes))
+        {
+            return false;
+        }
+
+        std::uint8_t lengths[DeflateLiteralLengthCodes + DeflateDistanceCodes] = {};
+        const std::size_t total = literal_count + distance_count;
+        for (std::size_t i = 0; i < total;)
+        {
+            reader.refill();
+            std::uint16_t symbol;
+            if (!reader.decode(code_lengths, symbol))
+            {
+                return false;
+            }
+
+            if (symbol < 16)
+            {
+                lengths[i++] = static_cast<std::uint8_t>(symbol);
+                continue;
+            }
+
+            std::uint8_t repeated = 0;
+            std::size_t repeat;
+            if (symbol == 16)
+            {
+                if (i == 0)
+                {
+                    return false;
+                }
+
+                repeated = lengths[i - 1];
+                repeat = 3 + reader.take(2);
+            }
+            else if (symbol == 17)
+            {
+                repeat = 3 + reader.take(3);
+            }
+            else
+            {
+                repeat = 11 + reader.take(7);
+            }
+
+            if (repeat > total - i)
+            {
+                return false;
+            }
+
+            std::fill(lengths + i, lengths + i + repeat, repeated);
+            i += repeat;
+        }
+
+        if (reader.overrun() || lengths[DeflateEndOfBlock] == 0)
+        {
+            return false;
+        }
+
+        return literals.build(lengths, literal_count) && distances.build(lengths + literal_count, distance_count);
+    }
+
+    // Appends the decompression of the raw deflate stream starting at `first` to `out`, failing if more than
+    // `max_size` bytes would be produced. On success, `stream_end` is set to the first byte after the stream.
+    bool inflate_stream(const unsigned char* first,
+                        const unsigned char* last,
+                        std::size_t max_size,
+                        std::string& out,
+                        const unsigned char*& stream_end)
+    {
+        InflateBitReader reader(first, last);
+        HuffmanDecoder dynamic_literals;
+        HuffmanDecoder dynamic_distances;
+        for (;;)
+        {
+            reader.refill();
+            const bool final_block = reader.take(1) != 0;
+            const auto block_type = reader.take(2);
+            const HuffmanDecoder* literals;
+            const HuffmanDecoder* distances;
+            if (block_type == 0)
+            {
+                const unsigned char* pos;
+                if (!reader.align_to_byte(pos) || last - pos < 4)
+                {
+                    return false;
+                }
+
+                const std::size_t length = load_le16(pos);
+                if ((length ^ load_le16(pos + 2)) != 0xFFFF || static_cast<std::size_t>(last - pos - 4) < length ||
+                    max_size - out.size() < length)
+                {
+                    return false;
+                }
+
+                out.append(reinterpret_cast<const char*>(pos + 4), length);
+                reader.reset(pos + 4 + length);
+                if (final_block)
+                {
+                    break;
+                }
+
+                continue;
+            }
+            else if (block_type == 1)
+            {
+                literals = &fixed_huffman_decoders().first;
+                distances = &fixed_huffman_decoders().second;
+            }
+            else if (block_type == 2)
+            {
+                if (!read_dynamic_huffman_decoders(reader, dynamic_literals, dynamic_distances))
+                {
+                    return false;
+                }
+
+                literals = &dynamic_literals;
+                distances = &dynamic_distances;
+            }
+            else
+            {
+                return false;
+            }
+
+            for (;;)
+            {
+                // a length/distance pair needs at most 15 + 5 + 15 + 13 bits
+                reader.refill();
+                std::uint16_t symbol;
+                if (!reader.decode(*literals, symbol))
+                {
+                    return false;
+                }
+
+                if (symbol < 256)
+                {
+                    if (out.size() == max_size)
+                    {
+                        return false;
+                    }
+
+                    out.push_back(static_cast<char>(symbol));
+                    continue;
+                }
+
+                if (symbol == DeflateEndOfBlock)
+                {
+                    break;
+                }
+
+                symbol -= 257;
+                if (symbol >= 29)
+                {
+                    return false;
+                }
+
+                const std::size_t length =
+                    deflate_length_base[symbol] + reader.take(deflate_length_extra_bits[symbol]);
+                if (!reader.decode(*distances, symbol) || symbol >= DeflateDistanceCodes)
+                {
+                    return false;
+                }
+
+                const std::size_t distance =
+                    deflate_distance_base[symbol] + reader.take(deflate_distance_extra_bits[symbol]);
+                const auto start = out.size();
+                if (distance > start || max_size - start < length)
+                {
+                    return false;
+                }
+
+                out.resize(start + length);
+                char* const dst = &out[start];
+                const char* const src = dst - distance;
+                if (distance >= length)
+                {
+                    std::memcpy(dst, src, length);
+                }
+                else
+                {
+                    for (std::size_t i = 0; i < length; ++i)
+                    {
+                        dst[i] = src[i];
+                    }
+                }
+            }
+
+            if (reader.overrun())
+            {
+                return false;
+            }
+
+            if (final_block)
+            {
+                break;
+            }
+        }
+
+        return reader.align_to_byte(stream_end);
+    }
+
+    struct DeflateBitWriter
+    {
+        explicit DeflateBitWriter(std::string& out) : m_out(out) { }
+
+        // pre: count <= 32
+        void put(std::uint32_t value, unsigned int count)
+        {
+            m_bits |= static_cast<std::uint64_t>(value) << m_count;
+            m_count += count;
+            if (m_count >= 32)
+            {
+                append_le32(m_out, static_cast<std::uint32_t>(m_bits));
+                m_bits >>= 32;
+                m_count -= 32;
+            }
+        }
+
+        void flush_to_byte()
+        {
+            while (m_count > 0)
+            {
+                m_out.push_back(static_cast<char>(m_bits & 0xFF));
+                m_bits >>= 8;
+                m_count = m_count > 8 ? m_count - 8 : 0;
+            }
+
+            m_bits = 0;
+        }
+
+        std::string& m_out;
+
+    private:
+        std::uint64_t m_bits = 0;
+        unsigned int m_count = 0;
+    };
+
+    // Computes code lengths of at most `max_length` bits for the symbols with nonzero frequency, such that the code
+    // is complete. Lengths of unused symbols are set to 0.
+    void build_huffman_lengths(const std::uint32_t* frequencies,
+                               std::size_t count,
+                               unsigned int max_length,
+                               std::uint8_t* lengths)
+    {
+        std::fill(lengths, lengths + count, std::uint8_t{0});
+        std::vector<std::uint16_t> symbols;
+        for (std::size_t symbol = 0; symbol < count; ++symbol)
+        {
+            if (frequencies[symbol] != 0)
+            {
+                symbols.push_back(static_cast<std::uint16_t>(symbol));
+            }
+        }
+
+        // a complete code needs at least 2 symbols
+        if (symbols.size() < 2)
+        {
+            lengths[0] = 1;
+            lengths[1] = 1;
+            if (!symbols.empty() && symbols[0] > 1)
+            {
+                lengths[1] = 0;
+                lengths[symbols[0]] = 1;
+            }
+
+            return;
+        }
+
+        std::stable_sort(symbols.begin(), symbols.end(), [&](std::uint16_t lhs, std::uint16_t rhs) {
+            return frequencies[lhs] < frequencies[rhs];
+        });
+
+        // build the Huffman tree with the two queue method: leaves are [0, n), internal nodes are [n, 2n - 1)
+        const std::size_t leaf_count = symbols.size();
+        const std::size_t node_count = 2 * leaf_count - 1;
+        std::vector<std::uint64_t> weights(node_count);
+        std::vector<std::size_t> parents(node_count);
+        for (std::size_t i = 0; i < leaf_count; ++i)
+        {
+            weights[i] = frequencies[symbols[i]];
+        }
+
+        std::size_t next_leaf = 0;
+        std::size_t next_internal = leaf_count;
+        for (std::size_t node = leaf_count; node < node_count; ++node)
+        {
+            auto pick = [&]() {
+                if (next_leaf < leaf_count && (next_internal == node || weights[next_leaf] <= weights[next_internal]))
+                {
+                    return next_leaf++;
+                }
+
+                return next_internal++;
+            };
+
+            const auto first = pick();
+            const auto second = pick();
+            weights[node] = weights[first] + weights[second];
+            parents[first] = node;
+            parents[second] = node;
+        }
+
+        // parents always have higher indices than their children, so depths can be filled in from the root down
+        std::vector<std::size_t> depths(node_count);
+        std::vector<std::size_t> length_counts(max_length + 1);
+        for (std::size_t node = node_count - 1; node-- > 0;)
+        {
+            depths[node] = depths[parents[node]] + 1;
+            if (node < leaf_count)
+            {
+                ++length_counts[std::min<std::size_t>(depths[node], max_length)];
+            }
+        }
+
+        // clamping lengths to max_length over-subscribes the code; lengthen shorter codes until it is complete again
+        std::uint64_t kraft_total = 0;
+        for (unsigned int length = 1; length <= max_length; ++length)
+        {
+            kraft_total += static_cast<std::uint64_t>(length_counts[length]) << (max_length - length);
+        }
+
+        while (kraft_total > (std::uint64_t{1} << max_length))
+        {
+            --length_counts[max_length];
+            for (unsigned int length = max_length - 1; length > 0; --length)
+            {
+                if (length_counts[length] != 0)
+                {
+                    --length_counts[length];
+                    length_counts[length + 1] += 2;
+                    break;
+                }
+            }
+
+            --kraft_total;
+        }
+
+        // the least frequent symbols get the longest codes
+        std::size_t next_symbol = 0;
+        for (unsigned int length = max_length; length > 0; --length)
+        {
+            for (std::size_t i = 0; i < length_counts[length]; ++i)
+            {
+                lengths[symbols[next_symbol++]] = static_cast<std::uint8_t>(length);
+            }
+        }
+    }
+
+    // Assigns canonical codes, bit reversed for output, to the symbols described by `lengths`.
+    void build_huffman_codes(const std::uint8_t* lengths, std::size_t count, std::uint16_t* codes)
+    {
+        std::uint16_t length_counts[DeflateMaxCodeLength + 1] = {};
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            ++length_counts[lengths[i]];
+        }
+
+        length_counts[0] = 0;
+        std::uint16_t next_code[DeflateMaxCodeLength + 2] = {};
+        for (unsigned int length = 1; length <= DeflateMaxCodeLength; ++length)
+        {
+            next_code[length + 1] = static_cast<std::uint16_t>((next_code[length] + length_counts[length]) << 1);
+        }
+
+        for (std::size_t symbol = 0; symbol < count; ++symbol)
+        {
+            codes[symbol] = lengths[symbol] == 0 ? 0 : reverse_bits(next_code[lengths[symbol]]++, lengths[symbol]);
+        }
+    }
+
+    std::uint16_t deflate_length_code(std::size_t length) noexcept
+    {
+        static const auto codes = [] {
+            std::array<std::uint8_t, DeflateMaxMatch + 1> result{};
+            for (std::uint8_t code = 0; code < 28; ++code)
+            {
+                for (std::size_t i = 0; i < (std::size_t{1} << deflate_length_extra_bits[code]); ++i)
+                {
+                    result[deflate_length_base[code] + i] = code;
+                }
+            }
+
+            result[DeflateMaxMatch] = 28;
+            return result;
+        }();
+
+        return codes[length];
+    }
+
+    std::uint16_t deflate_distance_code(std::size_t distance) noexcept
+    {
+        // distances up to 256 are looked up directly, larger ones by their bits above the lowest 7, which the extra
+        // bits of their codes always cover
+        static const auto codes = [] {
+            std::array<std::uint8_t, 512> result{};
+            for (std::uint8_t code = 0; code < 30; ++code)
+            {
+                const std::size_t first = deflate_distance_base[code];
+                const std::size_t last = first + (std::size_t{1} << deflate_distance_extra_bits[code]);
+                for (std::size_t i = first; i < last; ++i)
+                {
+                    if (i <= 256)
+                    {
+                        result[i] = code;
+                    }
+                    else
+                    {
+                        result[256 + ((i - 1) >> 7)] = code;
+                    }
+                }
+            }
+
+            return result;
+        }();
+
+        return distance <= 256 ? codes[distance] : codes[256 + ((distance - 1) >> 7)];
+    }
+
+    // A literal when `distance` is 0, otherwise a match of `literal_or_length` bytes.
+    struct DeflateToken
+    {
+        std::uint16_t literal_or_length;
+        std::uint16_t distance;
+    };
+
+    struct DeflateCompressor
+    {
+        DeflateCompressor(const unsigned char* data, std::size_t size, std::string& out)
+            : m_data(data), m_size(size), m_writer(out), m_head(HashSize, 0), m_prev(DeflateWindowSize, 0)
+        {
+        }
+
+        void compress()
+        {
+            std::size_t block_start = 0;
+            std::size_t pos = 0;
+            std::size_t lazy_pos = SIZE_MAX;
+            Match lazy_match{};
+            while (pos < m_size)
+            {
+                const Match match = lazy_pos == pos ? lazy_match : find_longest_match(pos);
+                if (match.length >= DeflateMinMatch)
+                {
+                    if (match.length < NiceMatch && pos + 1 < m_size)
+                    {
+                        // lazy matching: prefer a literal if the next position has a longer match
+                        lazy_match = find_longest_match(pos + 1);
+                        lazy_pos = pos + 1;
+                        if (lazy_match.length > match.length)
+                        {
+                            m_tokens.push_back({m_data[pos], 0});
+                            ++pos;
+                            continue;
+                        }
+                    }
+
+                    m_tokens.push_back(
+                        {static_cast<std::uint16_t>(match.length), static_cast<std::uint16_t>(match.distance)});
+                    pos += match.length;
+                }
+                else
+                {
+                    m_tokens.push_back({m_data[pos], 0});
+                    ++pos;
+                }
+
+                if (m_tokens.size() >= MaxBlockTokens)
+                {
+                    write_block(block_start, pos, false);
+                    block_start = pos;
+                }
+            }
+
+            write_block(block_start, pos, true);
+            m_writer.flush_to_byte();
+        }
+
+    private:
+        static constexpr std::size_t HashBits = 15;
+        static constexpr std::size_t HashSize = std::size_t{1} << HashBits;
+        static constexpr std::size_t MaxChain = 64;
+        static constexpr std::size_t NiceMatch = 128;
+        static constexpr std::size_t MaxBlockTokens = 1 << 15;
+
+        struct Match
+        {
+            std::size_t length;
+            std::size_t distance;
+        };
+
+        std::size_t hash(std::size_t pos) const noexcept
+        {
+            const auto value = static_cast<std::uint32_t>(m_data[pos]) |
+                               (static_cast<std::uint32_t>(m_data[pos + 1]) << 8) |
+                               (static_cast<std::uint32_t>(m_data[pos + 2]) << 16);
+            return (value * 2654435761u) >> (32 - HashBits);
+        }
+
+        // adds the positions before `pos` to the hash chains
+        void insert_up_to(std::size_t pos) noexcept
+        {
+            const auto last = std::min(pos, m_size - (DeflateMinMatch - 1));
+            for (; m_inserted < last; ++m_inserted)
+            {
+                auto& head = m_head[hash(m_inserted)];
+                m_prev[m_inserted % DeflateWindowSize] = head;
+                head = m_inserted + 1;
+            }
+        }
+
+        Match find_longest_match(std::size_t pos) noexcept
+        {
+            Match best{0, 0};
+            if (m_size - pos < DeflateMinMatch)
+            {
+                return best;
+            }
+
+            insert_up_to(pos);
+            const auto max_length = std::min(DeflateMaxMatch, m_size - pos);
+            const unsigned char* const current = m_data + pos;
+            auto candidate = m_head[hash(pos)];
+            for (std::size_t chain = 0; candidate != 0 && chain < MaxChain; ++chain)
+            {
+                const auto candidate_pos = candidate - 1;
+                const auto distance = pos - candidate_pos;
+                if (distance > DeflateWindowSize)
+                {
+                    break;
+                }
+
+                const unsigned char* const previous = m_data + candidate_pos;
+                if (best.length == 0 || previous[best.length] == current[best.length])
+                {
+                    std::size_t length = 0;
+                    while (length < max_length && previous[length] == current[length])
+                    {
+                        ++length;
+                    }
+
+                    if (length > best.length && length >= DeflateMinMatch)
+                    {
+                        best.length = length;
+                        best.distance = distance;
+                        if (length >= std::min(max_length, NiceMatch))
+                        {
+                            break;
+                        }
+                    }
+                }
+
+                candidate = m_prev[candidate_pos % DeflateWindowSize];
+            }
+
+            return best;
+        }
+
+        void write_block(std::size_t block_start, std::size_t block_end, bool final_block)
+        {
+            std::uint32_t literal_frequencies[DeflateLiteralLengthCodes] = {};
+            std::uint32_t distance_frequencies[DeflateDistanceCodes] = {};
+            for (auto&& token : m_tokens)
+            {
+                if (token.distance == 0)
+                {
+                    ++literal_frequencies[token.literal_or_length];
+                }
+                else
+                {
+                    ++literal_frequencies[257 + deflate_length_code(token.literal_or_length)];
+                    ++distance_frequencies[deflate_distance_code(token.distance)];
+                }
+            }
+
+            literal_frequencies[DeflateEndOfBlock] = 1;
+
+            std::uint8_t literal_lengths[DeflateLiteralLengthCodes];
+            std::uint8_t distance_lengths[DeflateDistanceCodes];
+            build_huffman_lengths(
+                literal_frequencies, DeflateLiteralLengthCodes, DeflateMaxCodeLength, literal_lengths);
+            build_huffman_lengths(distance_frequencies, DeflateDistanceCodes, DeflateMaxCodeLength, distance_lengths);
+
+            std::size_t literal_count = DeflateLiteralLengthCodes;
+            while (literal_lengths[literal_count - 1] == 0)
+            {
+                --literal_count;
+            }
+
+            std::size_t distance_count = DeflateDistanceCodes;
+            while (distance_count > 1 && distance_lengths[distance_count - 1] == 0)
+            {
+                --distance_count;
+            }
+
+            // run length encode the code lengths as symbol + extra bits
+            std::uint8_t all_lengths[DeflateLiteralLengthCodes + DeflateDistanceCodes];
+            std::copy(literal_lengths, literal_lengths + literal_count, all_lengths);
+            std::copy(distance_lengths, distance_lengths + distance_count, all_lengths + literal_count);
+            const std::size_t all_count = literal_count + distance_count;
+            std::vector<std::pair<std::uint8_t, std::uint8_t>> length_tokens;
+            std::uint32_t code_length_frequencies[DeflateCodeLengthCodes] = {};
+            for (std::size_t i = 0; i < all_count;)
+            {
+                const auto length = all_lengths[i];
+                std::size_t run = 1;
+                while (i + run < all_count && all_lengths[i + run] == length)
+                {
+                    ++run;
+                }
+
+                i += run;
+                if (length == 0)
+                {
+                    for (; run >= 11; run -= std::min<std::size_t>(run, 138))
+                    {
+                        length_tokens.emplace_back(18, static_cast<std::uint8_t>(std::min<std::size_t>(run, 138) - 11));
+                    }
+
+                    if (run >= 3)
+                    {
+                        length_tokens.emplace_back(17, static_cast<std::uint8_t>(run - 3));
+                        run = 0;
+                    }
+                }
+                else
+                {
+                    length_tokens.emplace_back(length, 0);
+                    --run;
+                    for (; run >= 3; run -= std::min<std::size_t>(run, 6))
+                    {
+                        length_tokens.emplace_back(16, static_cast<std::uint8_t>(std::min<std::size_t>(run, 6) - 3));
+                    }
+                }
+
+                for (; run > 0; --run)
+                {
+                    length_tokens.emplace_back(length, 0);
+                }
+            }
+
+            for (auto&& length_token : length_tokens)
+            {
+                ++code_length_frequencies[length_token.first];
+            }
+
+            std::uint8_t code_length_lengths[DeflateCodeLengthCodes];
+            build_huffman_lengths(
+                code_length_frequencies, DeflateCodeLengthCodes, DeflateMaxCodeLengthCodeLength, code_length_lengths);
+            std::size_t code_length_count = DeflateCodeLengthCodes;
+            while (code_length_count > 4 &&
+                   code_length_lengths[deflate_code_length_order[code_length_count - 1]] == 0)
+            {
+                --code_length_count;
+            }
+
+            // pick the smallest of a dynamic, fixed, or stored block
+            std::uint64_t dynamic_bits = 3 + 5 + 5 + 4 + 3 * code_length_count;
+            for (auto&& length_token : length_tokens)
+            {
+                dynamic_bits += code_length_lengths[length_token.first];
+                dynamic_bits += length_token.first == 16   ? 2
+                                : length_token.first == 17 ? 3
+                                : length_token.first == 18 ? 7
+                                                           : 0;
+            }
+
+            std::uint64_t fixed_bits = 3;
+            for (std::size_t symbol = 0; symbol < DeflateLiteralLengthCodes; ++symbol)
+            {
+                const auto frequency = literal_frequencies[symbol];
+                dynamic_bits += static_cast<std::uint64_t>(frequency) * literal_lengths[symbol];
+                fixed_bits += static_cast<std::uint64_t>(frequency) *
+                              (symbol < 144 ? 8 : symbol < 256 ? 9 : symbol < 280 ? 7 : 8);
+                if (symbol > 256)
+                {
+                    const auto extra = static_cast<std::uint64_t>(frequency) * deflate_length_extra_bits[symbol - 257];
+                    dynamic_bits += extra;
+                    fixed_bits += extra;
+                }
+            }
+
+            for (std::size_t symbol = 0; symbol < DeflateDistanceCodes; ++symbol)
+            {
+                const auto frequency = distance_frequencies[symbol];
+                dynamic_bits += static_cast<std::uint64_t>(frequency) * distance_lengths[symbol];
+                fixed_bits += static_cast<std::uint64_t>(frequency) * 5;
+                const auto extra = static_cast<std::uint64_t>(frequency) * deflate_distance_extra_bits[symbol];
+                dynamic_bits += extra;
+                fixed_bits += extra;
+            }
+
+            const std::size_t block_size = block_end - block_start;
+            const std::uint64_t stored_bits = 8 * static_cast<std::uint64_t>(block_size) +
+                                              (block_size / 0xFFFF + 1) * (3 + 7 + 32);
+            if (stored_bits <= dynamic_bits && stored_bits <= fixed_bits)
+            {
+                write_stored_block(block_start, block_end, final_block);
+            }
+            else if (fixed_bits <= dynamic_bits)
+            {
+                m_writer.put(final_block ? 1 : 0, 1);
+                m_writer.put(1, 2);
+                const auto& fixed = fixed_huffman_codes();
+                write_tokens(
+                    fixed.first.data(), fixed.second.data(), fixed.first.data() + 288, fixed.second.data() + 32);
+            }
+            else
+            {
+                m_writer.put(final_block ? 1 : 0, 1);
+                m_writer.put(2, 2);
+                m_writer.put(static_cast<std::uint32_t>(literal_count - 257), 5);
+                m_writer.put(static_cast<std::uint32_t>(distance_count - 1), 5);
+                m_writer.put(static_cast<std::uint32_t>(code_length_count - 4), 4);
+                for (std::size_t i = 0; i < code_length_count; ++i)
+                {
+                    m_writer.put(code_length_lengths[deflate_code_length_order[i]], 3);
+                }
+
+                std::uint16_t code_length_codes[DeflateCodeLengthCodes];
+                build_huffman_codes(code_length_lengths, DeflateCodeLengthCodes, code_length_codes);
+                for (auto&& length_token : length_tokens)
+                {
+                    m_writer.put(code_length_codes[length_token.first], code_length_lengths[length_token.first]);
+                    if (length_token.first >= 16)
+                    {
+                        m_writer.put(length_token.second,
+                                     length_token.first == 16 ? 2 : length_token.first == 17 ? 3 : 7);
+                    }
+                }
+
+                std::uint16_t literal_codes[DeflateLiteralLengthCodes];
+                std::uint16_t distance_codes[DeflateDistanceCodes];
+                build_huffman_codes(literal_lengths, DeflateLiteralLengthCodes, literal_codes);
+                build_huffman_codes(distance_lengths, DeflateDistanceCodes, distance_codes);
+                write_tokens(literal_codes, distance_codes, literal_lengths, distance_lengths);
+            }
+
+            m_tokens.clear();
+        }
+
+        static const std::pair<std::array<std::uint16_t, 288 + 288>, std::array<std::uint16_t, 32 + 32>>&
+        fixed_huffman_codes()
+        {
+            // codes followed by lengths
+            static const auto codes = [] {
+                std::pair<std::array<std::uint16_t, 288 + 288>, std::array<std::uint16_t, 32 + 32>> result;
+                std::uint8_t lengths[288];
+                std::fill(lengths, lengths + 144, std::uint8_t{8});
+                std::fill(lengths + 144, lengths + 256, std::uint8_t{9});
+                std::fill(lengths + 256, lengths + 280, std::uint8_t{7});
+                std::fill(lengths + 280, lengths + 288, std::uint8_t{8});
+                build_huffman_codes(lengths, 288, result.first.data());
+                std::copy(lengths, lengths + 288, result.first.data() + 288);
+                std::fill(lengths, lengths + 32, std::uint8_t{5});
+                build_huffman_codes(lengths, 32, result.second.data());
+                std::copy(lengths, lengths + 32, result.second.data() + 32);
+                return result;
+            }();
+
+            return codes;
+        }
+
+        template<class LengthTy>
+        void write_tokens(const std::uint16_t* literal_codes,
+                          const std::uint16_t* distance_codes,
+                          const LengthTy* literal_lengths,
+                          const LengthTy* distance_lengths)
+        {
+            for (auto&& token : m_tokens)
+            {
+                if (token.distance == 0)
+                {
+                    m_writer.put(literal_codes[token.literal_or_length], literal_lengths[token.literal_or_length]);
+                    continue;
+                }
+
+                const auto length_code = deflate_length_code(token.literal_or_length);
+                m_writer.put(literal_codes[257 + length_code], literal_lengths[257 + length_code]);
+                m_writer.put(token.literal_or_length - deflate_length_base[length_code],
+                             deflate_length_extra_bits[length_code]);
+                const auto distance_code = deflate_distance_code(token.distance);
+                m_writer.put(distance_codes[distance_code], distance_lengths[distance_code]);
+                m_writer.put(token.distance - deflate_distance_base[distance_code],
+                             deflate_distance_extra_bits[distance_code]);
+            }
+
+            m_writer.put(literal_codes[DeflateEndOfBlock], literal_lengths[DeflateEndOfBlock]);
+        }
+
+        void write_stored_block(std::size_t block_start, std::size_t block_end, bool final_block)
+        {
+            do
+            {
+                const auto length = static_cast<std::uint16_t>(std::min<std::size_t>(block_end - block_start, 0xFFFF));
+                const bool last_chunk = block_start + length == block_end;
+                m_writer.put(final_block && last_chunk ? 1 : 0, 1);
+                m_writer.put(0, 2);
+                m_writer.flush_to_byte();
+                append_le16(m_writer.m_out, length);
+                append_le16(m_writer.m_out, static_cast<std::uint16_t>(~length));
+                m_writer.m_out.append(reinterpret_cast<const char*>(m_data + block_start), length);
+                block_start += length;
+            } while (block_start != block_end);
+        }
+
+        const unsigned char* m_data;
+        std::size_t m_size;
+        DeflateBitWriter m_writer;
+        // positions + 1 of the most recent occurrence of each hash, 0 if none
+        std::vector<std::size_t> m_head;
+        // positions + 1 of the previous occurrence of the hash at each position in the window
+        std::vector<std::size_t> m_prev;
+        std::size_t m_inserted = 0;
+        std::vector<DeflateToken> m_tokens;
+    };
+}
+
+namespace vcpkg
+{
+    std::string deflate_bytes(const unsigned char* data, std::size_t size)
+    {
+        std::string result;
+        DeflateCompressor{data, size, result}.compress();
+        return result;
+    }
+
+    bool inflate_bytes(const unsigned char* first,
+                       const unsigned char* last,
+                       std::size_t expected_size,
+                       std::string& out)
+    {
+        out.clear();
+        out.reserve(expected_size);
+        const unsigned char* stream_end;
+        return inflate_stream(first, last, expected_size, out, stream_end) && out.size() == expected_size;
+    }
+
+    bool zlib_inflate(const unsigned char* first, const unsigned char* last, std::size_t max_size, std::string& out)
+    {
+        out.clear();
+        if (last - first < 6)
+        {
+            return false;
+        }
+
+        // CM = 8 (deflate), CINFO <= 7 (window of at most 32K), FCHECK valid, and no preset dictionary
+        const unsigned int cmf = first[0];
+        const unsigned int flg = first[1];
+        if ((cmf & 0x0F) != 8 || (cmf >> 4) > 7 || ((cmf << 8) | flg) % 31 != 0 || (flg & 0x20) != 0)
+        {
+            return false;
+        }
+
+        const unsigned char* stream_end;
+        if (!inflate_stream(first + 2, last, max_size, out, stream_end) || last - stream_end < 4)
+        {
+            return false;
+        }
+
+        const std::uint32_t expected_checksum = (static_cast<std::uint32_t>(stream_end[0]) << 24) |
+                                                (static_cast<std::uint32_t>(stream_end[1]) << 16) |
+                                                (static_cast<std::uint32_t>(stream_end[2]) << 8) | stream_end[3];
+        return adler32(reinterpret_cast<const unsigned char*>(out.data()), out.size()) == expected_checksum;
+    }
+}
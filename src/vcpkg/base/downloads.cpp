@@ -665,6 +665,125 @@ namespace vcpkg
         return true;
     }
 
+    // Hashes a file while curl is still writing it, so that once the transfer finishes only the last few bytes
+    // remain to be read, and they are still in the page cache. If curl may have rewritten the file (it truncates the
+    // output to retry), the streamed hash is abandoned and callers fall back to hashing the whole file.
+    struct GrowingFileHasher
+    {
+        GrowingFileHasher(const ReadOnlyFilesystem& fs, const Path& path, bool enabled)
+            : m_fs(fs), m_path(path), m_hasher(enabled ? Hash::get_hasher_for(Hash::Algorithm::Sha512) : nullptr)
+        {
+        }
+
+        // reads any bytes appended since the last call
+        void catch_up()
+        {
+            if (!m_hasher)
+            {
+                return;
+            }
+
+            std::error_code ec;
+            if (!m_file)
+            {
+                m_file = m_fs.open_for_read(m_path, ec);
+                if (ec)
+                {
+                    // curl hasn't created the file yet
+                    m_file = ReadFilePointer{};
+                    return;
+                }
+            }
+
+            const auto size = m_fs.file_size(m_path, ec);
+            if (ec || size < m_offset || !m_file.try_seek_to(static_cast<long long>(m_offset)))
+            {
+                abandon();
+                return;
+            }
+
+            // seeking also clears any end of file indication from the previous call
+            constexpr std::size_t buffer_size = 1024 * 32;
+            char buffer[buffer_size];
+            for (;;)
+            {
+                const auto this_read = m_file.read(buffer, 1, buffer_size);
+                if (this_read == 0)
+                {
+                    break;
+                }
+
+                m_hasher->add_bytes(buffer, buffer + this_read);
+                m_offset += this_read;
+            }
+
+            if (m_file.error())
+            {
+                abandon();
+            }
+        }
+
+        void abandon()
+        {
+            m_hasher.reset();
+            m_file.close();
+        }
+
+        Optional<std::string> finish()
+        {
+            catch_up();
+            if (!m_hasher)
+            {
+                return nullopt;
+            }
+
+            // the file is about to be renamed
+            m_file.close();
+            std::error_code ec;
+            const auto size = m_fs.file_size(m_path, ec);
+            if (ec || size != m_offset)
+            {
+                return nullopt;
+            }
+
+            return m_hasher->get_hash();
+        }
+
+    private:
+        const ReadOnlyFilesystem& m_fs;
+        const Path& m_path;
+        std::unique_ptr<Hash::Hasher> m_hasher;
+        ReadFilePointer m_file;
+        std::uint64_t m_offset = 0;
+    };
+
+    static bool check_downloaded_file_hash(DiagnosticContext& context,
+                                           const ReadOnlyFilesystem& fs,
+                                           const SanitizedUrl& sanitized_url,
+                                           const Path& downloaded_path,
+                                           const StringView* maybe_sha512,
+                                           std::string* out_sha512,
+                                           GrowingFileHasher& streamed_hasher)
+    {
+        auto maybe_streamed_hash = streamed_hasher.finish();
+        if (auto streamed_hash = maybe_streamed_hash.get())
+        {
+            if (!maybe_sha512 || *maybe_sha512 == *streamed_hash)
+            {
+                if (out_sha512)
+                {
+                    *out_sha512 = std::move(*streamed_hash);
+                }
+
+                return true;
+            }
+        }
+
+        // either no streamed hash is available, or it mismatched, which is rare enough that confirming by
+        // rehashing the whole file is worth it
+        return check_downloaded_file_hash(context, fs, sanitized_url, downloaded_path, maybe_sha512, out_sha512);
+    }
+
     static std::vector<int> curl_bulk_operation(DiagnosticContext& context,
                                                 View<Command> operation_args,
                                                 StringLiteral prefixArgs,
@@ -1177,6 +1296,7 @@ namespace vcpkg
                        .string_arg("--output")
                        .string_arg(download_path_part_path);
         add_curl_headers(cmd, headers);
+        GrowingFileHasher streamed_hasher{fs, download_path_part_path, maybe_sha512 || out_sha512};
         bool seen_any_curl_errors = false;
         // if seen_any_curl_errors, contains the curl error lines starting with "curl:"
         // otherwise, contains all curl's output unless it is the machine readable output
@@ -1187,12 +1307,16 @@ namespace vcpkg
             {
                 machine_readable_progress.println(Color::none,
                                                   LocalizedString::from_raw(fmt::format("{}%", parsed->total_percent)));
+                // curl prints progress about once a second while the body arrives
+                streamed_hasher.catch_up();
                 return;
             }
 
             static constexpr StringLiteral WarningColon = "warning: ";
             if (Strings::case_insensitive_ascii_starts_with(line, WarningColon))
             {
+                // curl warns before retrying, which rewrites the output
+                streamed_hasher.abandon();
                 context.statusln(
                     DiagnosticLine{DiagKind::Warning, LocalizedString::from_raw(line.substr(WarningColon.size()))}
                         .to_message_line());
@@ -1248,7 +1372,8 @@ namespace vcpkg
             return DownloadPrognosis::NetworkErrorProxyMightHelp;
         }
 
-        if (!check_downloaded_file_hash(context, fs, sanitized_url, download_path_part_path, maybe_sha512, out_sha512))
+        if (!check_downloaded_file_hash(
+                context, fs, sanitized_url, download_path_part_path, maybe_sha512, out_sha512, streamed_hasher))
         {
             return DownloadPrognosis::OtherError;
         }
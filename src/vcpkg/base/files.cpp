@@ -6,6 +6,7 @@
 #include <vcpkg/base/files.h>
 #include <vcpkg/base/message_sinks.h>
 #include <vcpkg/base/messages.h>
+#include <vcpkg/base/parallel-algorithms.h>
 #include <vcpkg/base/span.h>
 #include <vcpkg/base/system.debug.h>
 #include <vcpkg/base/system.h>
@@ -23,14 +24,21 @@
 #endif // !_WIN32
 
 #if defined(__linux__)
+#include <linux/fs.h>
+#include <sys/ioctl.h>
 #include <sys/sendfile.h>
+#include <sys/syscall.h>
 #elif defined(__APPLE__)
 #include <copyfile.h>
 #endif // ^^^ defined(__APPLE__)
 
 #include <algorithm>
+#include <atomic>
+#include <condition_variable>
 #include <iterator>
 #include <list>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <thread>
 #include <vector>
@@ -611,6 +619,11 @@ namespace
             check_error(ec);
         }
 
+        PosixFd(int dirfd, const char* path, int oflag, std::error_code& ec) noexcept : fd(::openat(dirfd, path, oflag))
+        {
+            check_error(ec);
+        }
+
         void swap(PosixFd& other) noexcept { std::swap(fd, other.fd); }
 
         PosixFd(const PosixFd&) = delete;
@@ -706,6 +719,31 @@ namespace
             }
         }
 
+        // reads the directory open as `fd`, which remains owned by the caller
+        ReadDirOp(int fd, std::error_code& ec) : dirp(nullptr)
+        {
+            const int dup_fd = ::fcntl(fd, F_DUPFD_CLOEXEC, 0);
+            if (dup_fd >= 0)
+            {
+                dirp = ::fdopendir(dup_fd);
+                if (!dirp)
+                {
+                    const auto fdopendir_error = errno;
+                    ::close(dup_fd);
+                    errno = fdopendir_error;
+                }
+            }
+
+            if (dirp)
+            {
+                ec.clear();
+            }
+            else
+            {
+                ec.assign(errno, std::generic_category());
+            }
+        }
+
         ReadDirOp(const ReadDirOp&) = delete;
         ReadDirOp& operator=(const ReadDirOp&) = delete;
 
@@ -895,6 +933,279 @@ namespace
             mark_recursive_error(base, ec, failure_point);
         }
     }
+
+    // The number of directories ParallelRemoveAll removes on the calling thread before it asks for helper threads;
+    // most trees, such as the packages directories of small ports, are removed without starting any.
+    constexpr std::size_t ParallelRemoveAllSerialDirectories = 64;
+
+    // Helper threads are shared by every remove_all in the process, so that concurrent removals, such as those of
+    // parallel builds, together start at most get_concurrency() - 1 threads.
+    std::atomic<std::size_t> parallel_remove_all_helpers{0};
+
+    std::size_t acquire_parallel_remove_all_helpers()
+    {
+        const auto limit = static_cast<std::size_t>(get_concurrency()) - 1;
+        auto in_use = parallel_remove_all_helpers.load();
+        std::size_t acquired;
+        do
+        {
+            if (in_use >= limit)
+            {
+                return 0;
+            }
+
+            acquired = limit - in_use;
+        } while (!parallel_remove_all_helpers.compare_exchange_weak(in_use, in_use + acquired));
+
+        return acquired;
+    }
+
+    // Deletes a directory tree, from a pool of threads if it is large. Directories are addressed relative to their
+    // parent's file descriptor to avoid resolving ever longer paths; each stays open until all of its children are
+    // removed. Work is taken newest first so that the tree is walked roughly depth first, which bounds the number of
+    // directories open at once.
+    struct ParallelRemoveAll
+    {
+        struct Directory
+        {
+            Directory* parent;
+            std::string name;
+            PosixFd fd;
+            // 1 for the scan of this directory itself, plus 1 for each subdirectory not yet removed
+            std::atomic<std::size_t> pending{1};
+        };
+
+        // returns whether everything was deleted; if not, the caller should retry with the serial implementation,
+        // which reports where the failure was
+        bool run(const Path& base)
+        {
+            std::error_code ec;
+            m_root.fd = PosixFd{base.c_str(), O_RDONLY | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC, ec};
+            if (ec)
+            {
+                return false;
+            }
+
+            m_base = &base;
+            if (!scan(m_root))
+            {
+                return false;
+            }
+
+            if (m_root.pending.fetch_sub(1) == 1)
+            {
+                return finish(&m_root);
+            }
+
+            // no other thread is running yet, so the stack only empties once the whole tree is removed
+            for (std::size_t removed = 0; removed < ParallelRemoveAllSerialDirectories && !m_stack.empty(); ++removed)
+            {
+                auto directory = m_stack.back();
+                m_stack.pop_back();
+                if (!remove(directory))
+                {
+                    return false;
+                }
+            }
+
+            if (m_completed)
+            {
+                return true;
+            }
+
+            // without helpers available, the calling thread continues alone
+            const auto helpers = acquire_parallel_remove_all_helpers();
+            execute_in_parallel(helpers + 1, [this](std::size_t) { work(); });
+            parallel_remove_all_helpers.fetch_sub(helpers);
+            return m_completed && !m_failed;
+        }
+
+    private:
+        void work()
+        {
+            for (;;)
+            {
+                Directory* directory;
+                {
+                    std::unique_lock<std::mutex> lock(m_mutex);
+                    m_cv.wait(lock, [this] { return !m_stack.empty() || m_completed || m_failed; });
+                    if (m_failed || m_stack.empty())
+                    {
+                        return;
+                    }
+
+                    directory = m_stack.back();
+                    m_stack.pop_back();
+                }
+
+                if (!remove(directory))
+                {
+                    fail();
+                    return;
+                }
+            }
+        }
+
+        // scans `directory`, and removes it if it has no subdirectories left
+        bool remove(Directory* directory)
+        {
+            if (!scan(*directory))
+            {
+                return false;
+            }
+
+            return directory->pending.fetch_sub(1) != 1 || finish(directory);
+        }
+
+        // removes the non-directory contents of `directory` and queues its subdirectories
+        bool scan(Directory& directory)
+        {
+            std::error_code ec;
+            if (!directory.fd)
+            {
+                directory.fd = PosixFd{directory.parent->fd.get(),
+                                       directory.name.c_str(),
+                                       O_RDONLY | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC,
+                                       ec};
+                if (ec)
+                {
+                    return false;
+                }
+            }
+
+            const int fd = directory.fd.get();
+            ReadDirOp op{fd, ec};
+            if (ec)
+            {
+                return false;
+            }
+
+            for (;;)
+            {
+                const auto entry = op.read(ec);
+                if (ec)
+                {
+                    return false;
+                }
+
+                if (!entry)
+                {
+                    return true;
+                }
+
+                if (is_dot_or_dot_dot(entry->d_name))
+                {
+                    continue;
+                }
+
+                bool is_directory = false;
+                const auto d_type = get_d_type(entry);
+                if (d_type == PosixDType::Directory || d_type == PosixDType::Unknown)
+                {
+                    struct stat s;
+                    if (::fstatat(fd, entry->d_name, &s, AT_SYMLINK_NOFOLLOW) != 0)
+                    {
+                        if (errno == ENOENT)
+                        {
+                            continue;
+                        }
+
+                        return false;
+                    }
+
+                    is_directory = S_ISDIR(s.st_mode);
+                    // the directory must be readable, writable and executable to delete its contents
+                    if (is_directory && (s.st_mode & (S_IRUSR | S_IWUSR | S_IXUSR)) != (S_IRUSR | S_IWUSR | S_IXUSR) &&
+                        ::fchmodat(fd, entry->d_name, s.st_mode | S_IRUSR | S_IWUSR | S_IXUSR, 0) != 0)
+                    {
+                        return false;
+                    }
+                }
+
+                if (is_directory)
+                {
+                    directory.pending.fetch_add(1);
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    m_directories.push_back(std::make_unique<Directory>());
+                    auto& subdirectory = *m_directories.back();
+                    subdirectory.parent = &directory;
+                    subdirectory.name = entry->d_name;
+                    m_stack.push_back(&subdirectory);
+                    m_cv.notify_one();
+                }
+                else if (::unlinkat(fd, entry->d_name, 0) != 0 && errno != ENOENT)
+                {
+                    return false;
+                }
+            }
+        }
+
+        // removes `directory`, which is now empty, and any ancestors that become empty as a result
+        bool finish(Directory* directory)
+        {
+            for (;;)
+            {
+                directory->fd.close();
+                auto parent = directory->parent;
+                if (!parent)
+                {
+                    if (::rmdir(m_base->c_str()) != 0 && errno != ENOENT)
+                    {
+                        return false;
+                    }
+
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    m_completed = true;
+                    m_cv.notify_all();
+                    return true;
+                }
+
+                if (::unlinkat(parent->fd.get(), directory->name.c_str(), AT_REMOVEDIR) != 0 && errno != ENOENT)
+                {
+                    return false;
+                }
+
+                if (parent->pending.fetch_sub(1) != 1)
+                {
+                    return true;
+                }
+
+                directory = parent;
+            }
+        }
+
+        void fail()
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_failed = true;
+            m_cv.notify_all();
+        }
+
+        const Path* m_base = nullptr;
+        Directory m_root{nullptr, {}, {}};
+        std::mutex m_mutex;
+        std::condition_variable m_cv;
+        std::vector<Directory*> m_stack;
+        std::vector<std::unique_ptr<Directory>> m_directories;
+        bool m_completed = false;
+        bool m_failed = false;
+    };
+
+    void vcpkg_remove_all_parallel(const Path& base, std::error_code& ec, Path& failure_point)
+    {
+        struct stat s;
+        if (::lstat(base.c_str(), &s) == 0 && S_ISDIR(s.st_mode) &&
+            ((s.st_mode & (S_IRUSR | S_IWUSR | S_IXUSR)) == (S_IRUSR | S_IWUSR | S_IXUSR)) &&
+            ParallelRemoveAll{}.run(base))
+        {
+            ec.clear();
+            return;
+        }
+
+        // not a directory, not obviously deletable, or something went wrong; whatever remains is removed (or the
+        // failure diagnosed) serially
+        vcpkg_remove_all(base, ec, failure_point);
+    }
 #endif // ^^^ !_WIN32
 
     constexpr char preferred_separator = VCPKG_PREFERRED_SEPARATOR[0];
@@ -1608,6 +1919,18 @@ namespace vcpkg
         return maybe_contents;
     }
 
+    int64_t ReadOnlyFilesystem::last_write_time(const Path& target, vcpkg::LineInfo li) const noexcept
+    {
+        std::error_code ec;
+        auto result = this->last_write_time(target, ec);
+        if (ec)
+        {
+            exit_filesystem_call_error(li, ec, __func__, {target});
+        }
+
+        return result;
+    }
+
     std::string ReadOnlyFilesystem::read_contents(const Path& file_path, LineInfo li) const
     {
         std::error_code ec;
@@ -2245,18 +2568,6 @@ namespace vcpkg
         }
     }
 
-    int64_t Filesystem::last_write_time(const Path& target, vcpkg::LineInfo li) const noexcept
-    {
-        std::error_code ec;
-        auto result = this->last_write_time(target, ec);
-        if (ec)
-        {
-            exit_filesystem_call_error(li, ec, __func__, {target});
-        }
-
-        return result;
-    }
-
     void Filesystem::write_lines(const Path& file_path, const std::vector<std::string>& lines, LineInfo li) const
     {
         std::error_code ec;
@@ -3351,7 +3662,11 @@ namespace vcpkg
         }
         virtual void remove_all(const Path& base, std::error_code& ec, Path& failure_point) const override
         {
+#if defined(_WIN32)
             vcpkg_remove_all(base, ec, failure_point);
+#else  // ^^^ _WIN32 // !_WIN32 vvv
+            vcpkg_remove_all_parallel(base, ec, failure_point);
+#endif // ^^^ !_WIN32
         }
 
 #if !defined(_WIN32)
@@ -3526,38 +3841,75 @@ namespace vcpkg
 #if defined(_WIN32)
             stdfs::copy(to_stdfs_path(source), to_stdfs_path(destination), stdfs::copy_options::recursive, ec);
 #else  // ^^^ _WIN32 // !_WIN32 vvv
+            // The directory structure is created serially, then the files are copied in parallel, as with
+            // large trees most of the time is spent in the individual copies.
+            std::vector<std::pair<Path, Path>> files;
+            collect_regular_recursive(source, destination, files, ec);
+            if (ec)
+            {
+                return;
+            }
+
+            std::mutex ec_mtx;
+            std::atomic<bool> failed{false};
+            execute_in_parallel(files.size(), [&](size_t idx) {
+                if (failed.load(std::memory_order_relaxed))
+                {
+                    return;
+                }
+
+                std::error_code this_ec;
+                this->copy_file(files[idx].first, files[idx].second, CopyOptions::none, this_ec);
+                if (this_ec)
+                {
+                    std::lock_guard<std::mutex> lock(ec_mtx);
+                    if (!failed.load(std::memory_order_relaxed))
+                    {
+                        ec = this_ec;
+                        failed.store(true, std::memory_order_relaxed);
+                    }
+                }
+            });
+#endif // ^^^ !_WIN32
+        }
+
+#if !defined(_WIN32)
+        // Creates the directories of the tree rooted at source under destination and collects the (source,
+        // destination) pairs of the files that need to be copied.
+        void collect_regular_recursive(const Path& source,
+                                       const Path& destination,
+                                       std::vector<std::pair<Path, Path>>& files,
+                                       std::error_code& ec) const
+        {
             ReadDirOp rd{source.c_str(), ec};
             if (ec)
             {
                 if (ec == std::errc::not_a_directory)
                 {
-                    this->copy_file(source, destination, CopyOptions::none, ec);
+                    ec.clear();
+                    files.emplace_back(source, destination);
                 }
 
                 return;
             }
 
             this->create_directory(destination, ec);
-            Path source_entry_name;
-            Path destination_entry_name;
             const dirent* entry;
             // the !ec check is either for the create_directory above on the first iteration, or for the most
-            // recent copy_file or copy_regular_recursive on subsequent iterations
+            // recent collect_regular_recursive on subsequent iterations
             while (!ec && (entry = rd.read(ec)))
             {
-                source_entry_name = source / entry->d_name;
-                destination_entry_name = destination / entry->d_name;
                 if (get_d_type(entry) == PosixDType::Regular)
                 {
-                    this->copy_file(source_entry_name, destination_entry_name, CopyOptions::none, ec);
+                    files.emplace_back(source / entry->d_name, destination / entry->d_name);
                 }
                 else if (!is_dot_or_dot_dot(entry->d_name))
                 {
-                    this->copy_regular_recursive_impl(source_entry_name, destination_entry_name, ec);
+                    this->collect_regular_recursive(source / entry->d_name, destination / entry->d_name, files, ec);
                 }
             }
-#endif // ^^^ !_WIN32
         }
+#endif // ^^^ !_WIN32
 
         virtual bool copy_file(const Path& source,
                                const Path& destination,
@@ -3729,12 +4081,46 @@ namespace vcpkg
             if (ec) return false;
 
 #if defined(__linux__)
+            off_t offset = 0;
+#if defined(FICLONE)
+            // On copy-on-write filesystems like btrfs and XFS, share the source's extents rather than copying
+            // any data. This fails with EOPNOTSUPP, EXDEV, EINVAL, etc. when that isn't possible.
+            if (ioctl(destination_fd.get(), FICLONE, source_fd.get()) == 0)
+            {
+                return true;
+            }
+#endif // ^^^ defined(FICLONE)
+
+#if defined(SYS_copy_file_range)
+            // copy_file_range lets the filesystem copy in-kernel, server-side for network filesystems, or reflink
+            // parts of the file. Called through syscall() because older C libraries don't declare it; older
+            // kernels reject copies across filesystems with EXDEV, in which case we continue with sendfile.
+            while (offset != source_stat.st_size)
+            {
+                loff_t range_offset = offset;
+                const auto this_copy_actual = syscall(SYS_copy_file_range,
+                                                      source_fd.get(),
+                                                      &range_offset,
+                                                      destination_fd.get(),
+                                                      nullptr,
+                                                      static_cast<size_t>(source_stat.st_size - offset),
+                                                      0u);
+                if (this_copy_actual <= 0)
+                {
+                    // 0 can be returned spuriously for some special filesystems like procfs, so don't trust it
+                    // to mean end of file
+                    break;
+                }
+
+                offset += static_cast<off_t>(this_copy_actual);
+            }
+#endif // ^^^ defined(SYS_copy_file_range)
+
             // https://man7.org/linux/man-pages/man2/sendfile.2.html#NOTES
             // sendfile() will transfer at most 0x7ffff000 (2,147,479,552)
             // bytes, returning the number of bytes actually transferred.
             constexpr off_t maximum_sendfile = 0x7ffff000;
-            off_t offset = 0;
-            for (off_t remaining_size = source_stat.st_size; remaining_size != 0;)
+            for (off_t remaining_size = source_stat.st_size - offset; remaining_size != 0;)
             {
                 const off_t this_send_attempt = std::min(maximum_sendfile, remaining_size);
                 const ssize_t this_send_actual =
@@ -1,3 +1,4 @@
+#include <vcpkg/base/deflate.h>
 #include <vcpkg/base/files.h>
 #include <vcpkg/base/fmt.h>
 #include <vcpkg/base/git.h>
@@ -5,12 +6,30 @@
 #include <vcpkg/base/parse.h>
 #include <vcpkg/base/strings.h>
 #include <vcpkg/base/stringview.h>
+#include <vcpkg/base/system.debug.h>
 #include <vcpkg/base/system.h>
 #include <vcpkg/base/system.process.h>
+#include <vcpkg/base/util.h>
 
 #include <vcpkg/tools.h>
 
+#if defined(_WIN32)
+#include <vcpkg/base/system-headers.h>
+#else // ^^^ _WIN32 / !_WIN32 vvv
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif // ^^^ !_WIN32
+
+#include <stdint.h>
+
 #include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <mutex>
 
 // When making changes to this file, check that the git command lines intended do what is expected on
 // vcpkg's current minimum supported git version (2.7.4). You can get a version of git that old with docker:
@@ -77,6 +96,962 @@ namespace
         environment.add_entry("GIT_INDEX_FILE", index_file);
         return run_cmd_trim(context, command, launch_settings);
     }
+
+    // In-process reading of the object database, used to avoid launching git once per object. See
+    // https://git-scm.com/docs/gitformat-pack for the pack and index formats.
+    enum class GitObjectType
+    {
+        Commit = 1,
+        Tree = 2,
+        Blob = 3,
+        Tag = 4,
+        OfsDelta = 6,
+        RefDelta = 7,
+    };
+
+    constexpr std::size_t GitObjectIdSize = 20;
+    // git itself refuses to create delta chains longer than 4095
+    constexpr int MaxDeltaChainLength = 4096;
+
+    struct GitObjectId
+    {
+        unsigned char bytes[GitObjectIdSize];
+    };
+
+    int hex_digit_value(char ch) noexcept
+    {
+        if ('0' <= ch && ch <= '9') return ch - '0';
+        if ('a' <= ch && ch <= 'f') return ch - 'a' + 10;
+        return -1;
+    }
+
+    bool parse_object_id(StringView hex, GitObjectId& id) noexcept
+    {
+        if (!is_git_sha(hex))
+        {
+            return false;
+        }
+
+        for (std::size_t i = 0; i < GitObjectIdSize; ++i)
+        {
+            id.bytes[i] =
+                static_cast<unsigned char>((hex_digit_value(hex[2 * i]) << 4) | hex_digit_value(hex[2 * i + 1]));
+        }
+
+        return true;
+    }
+
+    std::string object_id_to_hex(const GitObjectId& id)
+    {
+        static constexpr char digits[] = "0123456789abcdef";
+        std::string result;
+        result.reserve(GitObjectIdSize * 2);
+        for (auto byte : id.bytes)
+        {
+            result.push_back(digits[byte >> 4]);
+            result.push_back(digits[byte & 0xF]);
+        }
+
+        return result;
+    }
+
+    std::uint32_t load_be32(const unsigned char* p) noexcept
+    {
+        return (static_cast<std::uint32_t>(p[0]) << 24) | (static_cast<std::uint32_t>(p[1]) << 16) |
+               (static_cast<std::uint32_t>(p[2]) << 8) | static_cast<std::uint32_t>(p[3]);
+    }
+
+    // A read-only memory mapping of an entire file.
+    struct MappedFile
+    {
+        MappedFile() = default;
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+        ~MappedFile()
+        {
+            if (m_data)
+            {
+#if defined(_WIN32)
+                ::UnmapViewOfFile(m_data);
+#else  // ^^^ _WIN32 / !_WIN32 vvv
+                ::munmap(const_cast<unsigned char*>(m_data), m_size);
+#endif // ^^^ !_WIN32
+            }
+        }
+
+        bool open(const Path& path)
+        {
+#if defined(_WIN32)
+            HANDLE file = ::CreateFileW(Strings::to_utf16(path.native()).c_str(),
+                                        GENERIC_READ,
+                                        FILE_SHARE_READ | FILE_SHARE_DELETE,
+                                        nullptr,
+                                        OPEN_EXISTING,
+                                        FILE_ATTRIBUTE_NORMAL,
+                                        nullptr);
+            if (file == INVALID_HANDLE_VALUE)
+            {
+                return false;
+            }
+
+            LARGE_INTEGER size;
+            HANDLE mapping = nullptr;
+            if (::GetFileSizeEx(file, &size) && size.QuadPart > 0 &&
+                static_cast<unsigned long long>(size.QuadPart) <= SIZE_MAX)
+            {
+                mapping = ::CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            }
+
+            ::CloseHandle(file);
+            if (!mapping)
+            {
+                return false;
+            }
+
+            // the view keeps the mapping alive
+            m_data = static_cast<const unsigned char*>(::MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+            ::CloseHandle(mapping);
+            m_size = m_data ? static_cast<std::size_t>(size.QuadPart) : 0;
+            return m_data != nullptr;
+#else  // ^^^ _WIN32 / !_WIN32 vvv
+            const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+            if (fd < 0)
+            {
+                return false;
+            }
+
+            struct stat st;
+            void* data = MAP_FAILED;
+            if (::fstat(fd, &st) == 0 && st.st_size > 0 && static_cast<std::uintmax_t>(st.st_size) <= SIZE_MAX)
+            {
+                data = ::mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+            }
+
+            ::close(fd);
+            if (data == MAP_FAILED)
+            {
+                return false;
+            }
+
+            m_data = static_cast<const unsigned char*>(data);
+            m_size = static_cast<std::size_t>(st.st_size);
+            return true;
+#endif // ^^^ !_WIN32
+        }
+
+        const unsigned char* data() const noexcept { return m_data; }
+        std::size_t size() const noexcept { return m_size; }
+
+    private:
+        const unsigned char* m_data = nullptr;
+        std::size_t m_size = 0;
+    };
+
+    // A packfile and its version 2 index.
+    struct GitPack
+    {
+        bool open(const Path& index_path)
+        {
+            static constexpr unsigned char index_signature[] = {0xFF, 't', 'O', 'c', 0, 0, 0, 2};
+            static constexpr std::size_t fanout_size = 256 * 4;
+            if (!m_index.open(index_path) || m_index.size() < sizeof(index_signature) + fanout_size ||
+                std::memcmp(m_index.data(), index_signature, sizeof(index_signature)) != 0)
+            {
+                return false;
+            }
+
+            m_fanout = m_index.data() + sizeof(index_signature);
+            m_count = load_be32(m_fanout + 255 * 4);
+            // names, CRCs and offsets for each object, then large offsets, then the checksums of the pack and of the
+            // index itself
+            const std::size_t fixed_size = sizeof(index_signature) + fanout_size +
+                                           static_cast<std::size_t>(m_count) * (GitObjectIdSize + 4 + 4) +
+                                           2 * GitObjectIdSize;
+            if (m_index.size() < fixed_size)
+            {
+                return false;
+            }
+
+            m_names = m_fanout + fanout_size;
+            m_offsets = m_names + static_cast<std::size_t>(m_count) * (GitObjectIdSize + 4);
+            m_large_offsets = m_offsets + static_cast<std::size_t>(m_count) * 4;
+            m_large_offset_count = (m_index.size() - fixed_size) / 8;
+
+            auto pack_path = index_path.native();
+            pack_path.replace(pack_path.size() - 4, 4, ".pack");
+            static constexpr unsigned char pack_signature[] = {'P', 'A', 'C', 'K'};
+            return m_pack.open(pack_path) && m_pack.size() >= 12 + GitObjectIdSize &&
+                   std::memcmp(m_pack.data(), pack_signature, sizeof(pack_signature)) == 0 &&
+                   load_be32(m_pack.data() + 8) == m_count;
+        }
+
+        bool find(const GitObjectId& id, std::uint64_t& offset) const noexcept
+        {
+            const std::uint32_t first_byte = id.bytes[0];
+            std::uint32_t lo = first_byte == 0 ? 0 : load_be32(m_fanout + (first_byte - 1) * 4);
+            std::uint32_t hi = load_be32(m_fanout + first_byte * 4);
+            if (hi > m_count || lo > hi)
+            {
+                return false;
+            }
+
+            while (lo < hi)
+            {
+                const auto mid = lo + (hi - lo) / 2;
+                const int cmp = std::memcmp(m_names + static_cast<std::size_t>(mid) * GitObjectIdSize,
+                                            id.bytes,
+                                            GitObjectIdSize);
+                if (cmp < 0)
+                {
+                    lo = mid + 1;
+                }
+                else if (cmp > 0)
+                {
+                    hi = mid;
+                }
+                else
+                {
+                    const auto small_offset = load_be32(m_offsets + static_cast<std::size_t>(mid) * 4);
+                    if ((small_offset & 0x80000000u) == 0)
+                    {
+                        offset = small_offset;
+                        return true;
+                    }
+
+                    const std::size_t large_index = small_offset & 0x7FFFFFFFu;
+                    if (large_index >= m_large_offset_count)
+                    {
+                        return false;
+                    }
+
+                    const auto large = m_large_offsets + large_index * 8;
+                    offset = (static_cast<std::uint64_t>(load_be32(large)) << 32) | load_be32(large + 4);
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
+        // object data ends where the trailing checksum begins
+        const unsigned char* pack_begin() const noexcept { return m_pack.data(); }
+        const unsigned char* pack_end() const noexcept { return m_pack.data() + m_pack.size() - GitObjectIdSize; }
+
+    private:
+        MappedFile m_index;
+        MappedFile m_pack;
+        const unsigned char* m_fanout = nullptr;
+        const unsigned char* m_names = nullptr;
+        const unsigned char* m_offsets = nullptr;
+        const unsigned char* m_large_offsets = nullptr;
+        std::size_t m_large_offset_count = 0;
+        std::uint32_t m_count = 0;
+    };
+
+    bool read_delta_size(const unsigned char*& pos, const unsigned char* last, std::size_t& size) noexcept
+    {
+        size = 0;
+        for (unsigned int shift = 0; pos != last && shift < 64; shift += 7)
+        {
+            const auto byte = *pos++;
+            size |= static_cast<std::size_t>(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0)
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    // Reconstructs an object from its delta against `base`.
+    bool apply_delta(const std::string& base, const std::string& delta, std::string& out)
+    {
+        auto pos = reinterpret_cast<const unsigned char*>(delta.data());
+        const auto last = pos + delta.size();
+        std::size_t base_size;
+        std::size_t result_size;
+        if (!read_delta_size(pos, last, base_size) || base_size != base.size() ||
+            !read_delta_size(pos, last, result_size))
+        {
+            return false;
+        }
+
+        out.clear();
+        out.reserve(result_size);
+        while (pos != last)
+        {
+            const auto instruction = *pos++;
+            if (instruction & 0x80)
+            {
+                // copy from the base; the low 4 bits select offset bytes and the next 3 select size bytes
+                std::size_t offset = 0;
+                std::size_t size = 0;
+                for (unsigned int i = 0; i < 7; ++i)
+                {
+                    if (instruction & (1u << i))
+                    {
+                        if (pos == last)
+                        {
+                            return false;
+                        }
+
+                        const auto value = static_cast<std::size_t>(*pos++);
+                        if (i < 4)
+                        {
+                            offset |= value << (8 * i);
+                        }
+                        else
+                        {
+                            size |= value << (8 * (i - 4));
+                        }
+                    }
+                }
+
+                if (size == 0)
+                {
+                    size = 0x10000;
+                }
+
+                if (offset > base.size() || base.size() - offset < size || result_size - out.size() < size)
+                {
+                    return false;
+                }
+
+                out.append(base, offset, size);
+            }
+            else if (instruction != 0)
+            {
+                // insert the next `instruction` bytes of the delta
+                const std::size_t size = instruction;
+                if (static_cast<std::size_t>(last - pos) < size || result_size - out.size() < size)
+                {
+                    return false;
+                }
+
+                out.append(reinterpret_cast<const char*>(pos), size);
+                pos += size;
+            }
+            else
+            {
+                return false;
+            }
+        }
+
+        return out.size() == result_size;
+    }
+
+    struct GitPackSet
+    {
+        std::vector<std::unique_ptr<GitPack>> packs;
+    };
+
+    // The loose objects and packfiles of a repository, including those of its alternates. Packs are mapped on first
+    // use and rescanned when an object can't be found, since fetches add new packs.
+    struct GitObjectDatabase
+    {
+        GitObjectDatabase(const Filesystem& fs, Path git_dir, Path common_dir)
+            : fs(fs), git_dir(std::move(git_dir)), common_dir(std::move(common_dir))
+        {
+            objects_dirs.push_back(this->common_dir / "objects");
+            std::error_code ec;
+            auto alternates = fs.read_contents(objects_dirs.front() / "info" / "alternates", ec);
+            if (!ec)
+            {
+                for (auto&& line : Strings::split(alternates, '\n'))
+                {
+                    Strings::inplace_trim(line);
+                    if (!line.empty() && line[0] != '#')
+                    {
+                        objects_dirs.push_back((objects_dirs.front() / line).lexically_normal());
+                    }
+                }
+            }
+        }
+
+        bool read_object(const GitObjectId& id, GitObjectType& type, std::string& data, int depth = 0) const
+        {
+            auto packs = get_packs(false);
+            if (read_packed_object(*packs, id, type, data, depth) || read_loose_object(id, type, data))
+            {
+                return true;
+            }
+
+            auto rescanned_packs = get_packs(true);
+            return rescanned_packs != packs && read_packed_object(*rescanned_packs, id, type, data, depth);
+        }
+
+        void release()
+        {
+            std::lock_guard<std::mutex> lock(m_packs_mutex);
+            m_packs.reset();
+        }
+
+        const Filesystem& fs;
+        const Path git_dir;
+        const Path common_dir;
+
+    private:
+        std::shared_ptr<const GitPackSet> get_packs(bool rescan) const
+        {
+            std::lock_guard<std::mutex> lock(m_packs_mutex);
+            if (m_packs && !rescan)
+            {
+                return m_packs;
+            }
+
+            auto packs = std::make_shared<GitPackSet>();
+            for (auto&& objects_dir : objects_dirs)
+            {
+                std::error_code ec;
+                for (auto&& file : fs.get_regular_files_non_recursive(objects_dir / "pack", ec))
+                {
+                    if (file.extension() == ".idx" && file.native().size() > 4)
+                    {
+                        auto pack = std::make_unique<GitPack>();
+                        if (pack->open(file))
+                        {
+                            packs->packs.push_back(std::move(pack));
+                        }
+                        else
+                        {
+                            Debug::println("Ignoring unreadable git pack index ", file);
+                        }
+                    }
+                }
+            }
+
+            m_packs = std::move(packs);
+            return m_packs;
+        }
+
+        bool read_packed_object(
+            const GitPackSet& packs, const GitObjectId& id, GitObjectType& type, std::string& data, int depth) const
+        {
+            for (auto&& pack : packs.packs)
+            {
+                std::uint64_t offset;
+                if (pack->find(id, offset))
+                {
+                    return read_pack_entry(*pack, offset, type, data, depth);
+                }
+            }
+
+            return false;
+        }
+
+        bool read_pack_entry(
+            const GitPack& pack, std::uint64_t offset, GitObjectType& type, std::string& data, int depth) const
+        {
+            if (depth > MaxDeltaChainLength || offset < 12 ||
+                offset >= static_cast<std::uint64_t>(pack.pack_end() - pack.pack_begin()))
+            {
+                return false;
+            }
+
+            const unsigned char* pos = pack.pack_begin() + offset;
+            const unsigned char* const last = pack.pack_end();
+            // type and size header: 3 bits of type and 4 bits of size, then 7 more bits of size per byte
+            unsigned int byte = *pos++;
+            type = static_cast<GitObjectType>((byte >> 4) & 7);
+            std::size_t size = byte & 0x0F;
+            for (unsigned int shift = 4; byte & 0x80; shift += 7)
+            {
+                if (pos == last || shift >= 64)
+                {
+                    return false;
+                }
+
+                byte = *pos++;
+                size |= static_cast<std::size_t>(byte & 0x7F) << shift;
+            }
+
+            switch (type)
+            {
+                case GitObjectType::Commit:
+                case GitObjectType::Tree:
+                case GitObjectType::Blob:
+                case GitObjectType::Tag:
+                    data.reserve(size);
+                    return zlib_inflate(pos, last, size, data) && data.size() == size;
+                case GitObjectType::OfsDelta:
+                {
+                    // the base is earlier in this pack, at a distance encoded with an offset of 1 per extra byte
+                    if (pos == last)
+                    {
+                        return false;
+                    }
+
+                    byte = *pos++;
+                    std::uint64_t distance = byte & 0x7F;
+                    while (byte & 0x80)
+                    {
+                        if (pos == last || distance >= (std::uint64_t{1} << 56))
+                        {
+                            return false;
+                        }
+
+                        byte = *pos++;
+                        distance = ((distance + 1) << 7) | (byte & 0x7F);
+                    }
+
+                    std::string delta;
+                    std::string base;
+                    return distance != 0 && distance <= offset && zlib_inflate(pos, last, size, delta) &&
+                           delta.size() == size && read_pack_entry(pack, offset - distance, type, base, depth + 1) &&
+                           apply_delta(base, delta, data);
+                }
+                case GitObjectType::RefDelta:
+                {
+                    if (static_cast<std::size_t>(last - pos) < GitObjectIdSize)
+                    {
+                        return false;
+                    }
+
+                    GitObjectId base_id;
+                    std::memcpy(base_id.bytes, pos, GitObjectIdSize);
+                    pos += GitObjectIdSize;
+                    std::string delta;
+                    std::string base;
+                    return zlib_inflate(pos, last, size, delta) && delta.size() == size &&
+                           read_object(base_id, type, base, depth + 1) && apply_delta(base, delta, data);
+                }
+                default: return false;
+            }
+        }
+
+        bool read_loose_object(const GitObjectId& id, GitObjectType& type, std::string& data) const
+        {
+            const auto hex = object_id_to_hex(id);
+            for (auto&& objects_dir : objects_dirs)
+            {
+                MappedFile file;
+                if (!file.open(objects_dir / StringView{hex.data(), 2} / StringView{hex.data() + 2, hex.size() - 2}))
+                {
+                    continue;
+                }
+
+                // "<type> <size>\0<contents>"
+                std::string object;
+                if (!zlib_inflate(file.data(), file.data() + file.size(), SIZE_MAX, object))
+                {
+                    return false;
+                }
+
+                const auto space = object.find(' ');
+                const auto nul = object.find('\0');
+                if (space == std::string::npos || nul == std::string::npos || space > nul)
+                {
+                    return false;
+                }
+
+                const StringView type_name{object.data(), space};
+                if (type_name == "commit")
+                {
+                    type = GitObjectType::Commit;
+                }
+                else if (type_name == "tree")
+                {
+                    type = GitObjectType::Tree;
+                }
+                else if (type_name == "blob")
+                {
+                    type = GitObjectType::Blob;
+                }
+                else if (type_name == "tag")
+                {
+                    type = GitObjectType::Tag;
+                }
+                else
+                {
+                    return false;
+                }
+
+                auto maybe_size =
+                    Strings::strto<unsigned long long>(StringView{object.data() + space + 1, nul - space - 1});
+                auto size = maybe_size.get();
+                if (!size || *size != object.size() - nul - 1)
+                {
+                    return false;
+                }
+
+                data.assign(object, nul + 1, std::string::npos);
+                return true;
+            }
+
+            return false;
+        }
+
+        std::vector<Path> objects_dirs;
+        mutable std::mutex m_packs_mutex;
+        mutable std::shared_ptr<const GitPackSet> m_packs;
+    };
+
+    // Reads the object named by a ref such as "HEAD", "FETCH_HEAD", or "main", trying the same locations as
+    // `git rev-parse` (https://git-scm.com/docs/gitrevisions).
+    bool resolve_ref(const GitObjectDatabase& db, StringView name, GitObjectId& id)
+    {
+        if (name.empty() || Util::any_of(name, [](char ch) { return ch == '~' || ch == '^' || ch == '@'; }))
+        {
+            return false;
+        }
+
+        const auto name_str = name.to_string();
+        const std::string candidates[] = {name_str,
+                                          "refs/" + name_str,
+                                          "refs/tags/" + name_str,
+                                          "refs/heads/" + name_str,
+                                          "refs/remotes/" + name_str,
+                                          "refs/remotes/" + name_str + "/HEAD"};
+        std::error_code ec;
+        bool packed_refs_loaded = false;
+        std::string packed_refs;
+        for (const auto& candidate : candidates)
+        {
+            auto ref = candidate;
+            for (int symbolic_depth = 0; symbolic_depth < 5; ++symbolic_depth)
+            {
+                // HEAD, FETCH_HEAD and friends are per worktree; everything under refs/ is shared
+                const auto& ref_dir = Strings::starts_with(ref, "refs/") ? db.common_dir : db.git_dir;
+                auto contents = db.fs.read_contents(ref_dir / ref, ec);
+                if (ec)
+                {
+                    if (!packed_refs_loaded)
+                    {
+                        packed_refs = db.fs.read_contents(db.common_dir / "packed-refs", ec);
+                        packed_refs_loaded = true;
+                    }
+
+                    // "<sha> <ref>" lines; peeled tags are on following lines starting with '^'
+                    for (auto&& line : Strings::split(packed_refs, '\n'))
+                    {
+                        if (line.size() == 41 + ref.size() && line[40] == ' ' &&
+                            StringView{line}.substr(41) == StringView{ref})
+                        {
+                            return parse_object_id(StringView{line}.substr(0, 40), id);
+                        }
+                    }
+
+                    break;
+                }
+
+                if (Strings::starts_with(contents, "ref: "))
+                {
+                    ref = Strings::trim(StringView{contents}.substr(5)).to_string();
+                    continue;
+                }
+
+                // FETCH_HEAD has additional information after the first object id
+                return contents.size() >= 40 && parse_object_id(StringView{contents}.substr(0, 40), id);
+            }
+        }
+
+        return false;
+    }
+
+    // Replaces the commit or tag in `type` and `data` with the tree it refers to.
+    bool peel_to_tree(const GitObjectDatabase& db, GitObjectId& id, GitObjectType& type, std::string& data)
+    {
+        while (type != GitObjectType::Tree)
+        {
+            StringView header;
+            if (type == GitObjectType::Commit)
+            {
+                header = "tree ";
+            }
+            else if (type == GitObjectType::Tag)
+            {
+                header = "object ";
+            }
+            else
+            {
+                return false;
+            }
+
+            if (!Strings::starts_with(data, header) || data.size() < header.size() + 40 ||
+                !parse_object_id(StringView{data}.substr(header.size(), 40), id) || !db.read_object(id, type, data))
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    // Resolves "<rev>" or "<rev>:<path>" like `git rev-parse`, and reads the resulting object.
+    bool read_treeish(
+        const GitObjectDatabase& db, StringView treeish, GitObjectId& id, GitObjectType& type, std::string& data)
+    {
+        const auto colon = std::find(treeish.begin(), treeish.end(), ':');
+        const StringView rev{treeish.begin(), colon};
+        if ((!parse_object_id(rev, id) && !resolve_ref(db, rev, id)) || !db.read_object(id, type, data))
+        {
+            return false;
+        }
+
+        if (colon == treeish.end())
+        {
+            return true;
+        }
+
+        if (!peel_to_tree(db, id, type, data))
+        {
+            return false;
+        }
+
+        for (auto&& component : Strings::split(StringView{colon + 1, treeish.end()}, '/'))
+        {
+            if (type != GitObjectType::Tree)
+            {
+                return false;
+            }
+
+            // "<mode> <name>\0<20 byte id>" for each entry
+            bool found = false;
+            const char* pos = data.data();
+            const char* const last = pos + data.size();
+            while (pos != last)
+            {
+                const auto space = std::find(pos, last, ' ');
+                const auto nul = std::find(space, last, '\0');
+                if (nul == last || static_cast<std::size_t>(last - nul - 1) < GitObjectIdSize)
+                {
+                    return false;
+                }
+
+                if (StringView{space + 1, nul} == component)
+                {
+                    std::memcpy(id.bytes, nul + 1, GitObjectIdSize);
+                    found = true;
+                    break;
+                }
+
+                pos = nul + 1 + GitObjectIdSize;
+            }
+
+            if (!found || !db.read_object(id, type, data))
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    bool is_safe_tree_entry_name(StringView name)
+    {
+        return !name.empty() && name != "." && name != ".." && !Strings::case_insensitive_ascii_equals(name, ".git") &&
+               std::none_of(name.begin(), name.end(), [](char ch) { return ch == '/' || ch == '\\'; });
+    }
+
+    // Writes the contents of `tree` to `directory`, like `git checkout-index`.
+    bool checkout_tree(const GitObjectDatabase& db, const std::string& tree, const Path& directory)
+    {
+        const char* pos = tree.data();
+        const char* const last = pos + tree.size();
+        std::error_code ec;
+        while (pos != last)
+        {
+            const auto space = std::find(pos, last, ' ');
+            const auto nul = std::find(space, last, '\0');
+            if (nul == last || static_cast<std::size_t>(last - nul - 1) < GitObjectIdSize)
+            {
+                return false;
+            }
+
+            const StringView mode{pos, space};
+            const StringView name{space + 1, nul};
+            GitObjectId id;
+            std::memcpy(id.bytes, nul + 1, GitObjectIdSize);
+            pos = nul + 1 + GitObjectIdSize;
+            if (!is_safe_tree_entry_name(name))
+            {
+                return false;
+            }
+
+            const auto target = directory / name;
+            if (mode == "160000")
+            {
+                // submodules are checked out as empty directories
+                db.fs.create_directory(target, ec);
+                if (ec)
+                {
+                    return false;
+                }
+
+                continue;
+            }
+
+            GitObjectType type;
+            std::string contents;
+            if (!db.read_object(id, type, contents))
+            {
+                return false;
+            }
+
+            if (mode == "40000")
+            {
+                db.fs.create_directory(target, ec);
+                if (ec || type != GitObjectType::Tree || !checkout_tree(db, contents, target))
+                {
+                    return false;
+                }
+
+                continue;
+            }
+
+            if (type != GitObjectType::Blob)
+            {
+                return false;
+            }
+
+            if (mode == "120000")
+            {
+#if defined(_WIN32)
+                // without core.symlinks, git checks out symbolic links as files containing the link text
+                db.fs.write_contents(target, contents, ec);
+#else  // ^^^ _WIN32 / !_WIN32 vvv
+                db.fs.create_symlink(contents, target, ec);
+#endif // ^^^ !_WIN32
+                if (ec)
+                {
+                    return false;
+                }
+
+                continue;
+            }
+
+            if (mode != "100644" && mode != "100755" && mode != "100664")
+            {
+                return false;
+            }
+
+            db.fs.write_contents(target, contents, ec);
+            if (ec)
+            {
+                return false;
+            }
+
+#if !defined(_WIN32)
+            if (mode == "100755" && ::chmod(target.c_str(), 0755) != 0)
+            {
+                return false;
+            }
+#endif // ^^^ !_WIN32
+        }
+
+        return true;
+    }
+
+    // Finds the git directory and common directory (which differ for worktrees) for `dot_git`, which may be a
+    // ".git" file pointing elsewhere as used by submodules and worktrees.
+    bool find_git_dirs(const Filesystem& fs, const Path& dot_git, Path& git_dir, Path& common_dir)
+    {
+        git_dir = dot_git;
+        std::error_code ec;
+        if (fs.is_regular_file(dot_git))
+        {
+            auto contents = fs.read_contents(dot_git, ec);
+            if (ec || !Strings::starts_with(contents, "gitdir: "))
+            {
+                return false;
+            }
+
+            git_dir = (Path{dot_git.parent_path()} / Strings::trim(StringView{contents}.substr(8))).lexically_normal();
+        }
+
+        if (!fs.is_directory(git_dir))
+        {
+            return false;
+        }
+
+        common_dir = git_dir;
+        auto common_dir_contents = fs.read_contents(git_dir / "commondir", ec);
+        if (!ec)
+        {
+            common_dir = (git_dir / Strings::trim(common_dir_contents)).lexically_normal();
+        }
+
+        return true;
+    }
+
+    struct GitObjectDatabases
+    {
+        std::mutex mutex;
+        std::map<std::string, std::shared_ptr<GitObjectDatabase>, std::less<>> databases;
+    };
+
+    GitObjectDatabases& git_object_databases()
+    {
+        static GitObjectDatabases instance;
+        return instance;
+    }
+
+    // Gets the object database for `dot_git`, which is shared by all callers in this process.
+    // Returns nullptr if `dot_git` is not a repository; that is not remembered, as it may become one later.
+    std::shared_ptr<GitObjectDatabase> get_object_database(const Filesystem& fs, const Path& dot_git)
+    {
+        auto& instance = git_object_databases();
+        std::lock_guard<std::mutex> lock(instance.mutex);
+        auto it = instance.databases.find(dot_git.native());
+        if (it != instance.databases.end())
+        {
+            return it->second;
+        }
+
+        Path git_dir;
+        Path common_dir;
+        if (!find_git_dirs(fs, dot_git, git_dir, common_dir))
+        {
+            return nullptr;
+        }
+
+        auto database = std::make_shared<GitObjectDatabase>(fs, std::move(git_dir), std::move(common_dir));
+        instance.databases.emplace(dot_git.native(), database);
+        return database;
+    }
+
+    std::shared_ptr<GitObjectDatabase> get_object_database(const Filesystem& fs, GitRepoLocator locator)
+    {
+        switch (locator.kind)
+        {
+            case GitRepoLocatorKind::CurrentDirectory:
+            {
+                auto maybe_parent = fs.try_find_file_recursively_up(locator.path, ".git");
+                if (auto parent = maybe_parent.get())
+                {
+                    return get_object_database(fs, *parent / ".git");
+                }
+
+                return nullptr;
+            }
+            case GitRepoLocatorKind::DotGitDir: return get_object_database(fs, locator.path);
+            default: Checks::unreachable(VCPKG_LINE_INFO);
+        }
+    }
+
+    // Checks out `treeish` into the empty directory `git_tree_temp`; on failure, leaves it empty again.
+    bool extract_tree_in_process(const Filesystem& fs,
+                                 GitRepoLocator locator,
+                                 const Path& git_tree_temp,
+                                 StringView treeish)
+    {
+        auto database = get_object_database(fs, locator);
+        GitObjectId id;
+        GitObjectType type;
+        std::string tree;
+        if (database && read_treeish(*database, treeish, id, type, tree) &&
+            peel_to_tree(*database, id, type, tree) && checkout_tree(*database, tree, git_tree_temp))
+        {
+            return true;
+        }
+
+        Debug::println("Falling back to git to extract ", treeish);
+        std::error_code ec;
+        fs.remove_all(git_tree_temp, ec);
+        fs.create_directory(git_tree_temp, ec);
+        return false;
+    }
 }
 
 namespace vcpkg
@@ -265,10 +1240,12 @@ namespace vcpkg
                           const Path& destination,
                           StringView treeish)
     {
-        auto pid = get_process_id();
-        Path git_tree_temp = fmt::format("{}_{}.tmp", destination, pid);
+        // the counter keeps threads extracting the same tree from sharing temporaries
+        static std::atomic<unsigned int> extraction_count{0};
+        auto temp_suffix = fmt::format("{}_{}", get_process_id(), extraction_count.fetch_add(1));
+        Path git_tree_temp = fmt::format("{}_{}.tmp", destination, temp_suffix);
         git_tree_temp.make_generic();
-        Path git_tree_index = fmt::format("{}_{}.index", destination, pid);
+        Path git_tree_index = fmt::format("{}_{}.index", destination, temp_suffix);
         auto parent = destination.parent_path();
         if (!parent.empty())
         {
@@ -283,6 +1260,11 @@ namespace vcpkg
             return false;
         }
 
+        if (extract_tree_in_process(fs, locator, git_tree_temp, treeish))
+        {
+            return fs.rename_or_delete(context, git_tree_temp, destination).has_value();
+        }
+
         StringView read_tree_args[] = {StringLiteral{"read-tree"}, treeish};
         auto read_tree_cmd = make_git_command(git_exe, locator, read_tree_args);
         if (run_cmd_git_with_index(context, read_tree_cmd, git_tree_index).has_value())
@@ -308,6 +1290,45 @@ namespace vcpkg
         return false;
     }
 
+    Optional<std::string> git_try_read_blob(const Filesystem& fs, const Path& dot_git_dir, StringView treeish)
+    {
+        auto database = get_object_database(fs, dot_git_dir);
+        GitObjectId id;
+        GitObjectType type;
+        std::string data;
+        if (database && read_treeish(*database, treeish, id, type, data) && type == GitObjectType::Blob)
+        {
+            return data;
+        }
+
+        return nullopt;
+    }
+
+    Optional<std::string> git_try_rev_parse(const Filesystem& fs, const Path& dot_git_dir, StringView treeish)
+    {
+        auto database = get_object_database(fs, dot_git_dir);
+        GitObjectId id;
+        GitObjectType type;
+        std::string data;
+        if (database && read_treeish(*database, treeish, id, type, data))
+        {
+            return object_id_to_hex(id);
+        }
+
+        return nullopt;
+    }
+
+    void git_release_object_database(const Path& dot_git_dir)
+    {
+        auto& instance = git_object_databases();
+        std::lock_guard<std::mutex> lock(instance.mutex);
+        auto it = instance.databases.find(dot_git_dir.native());
+        if (it != instance.databases.end() && it->second)
+        {
+            it->second->release();
+        }
+    }
+
     Optional<bool> git_check_is_commit(DiagnosticContext& context,
                                        const Path& git_exe,
                                        GitRepoLocator locator,
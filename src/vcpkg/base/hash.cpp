@@ -15,8 +15,19 @@
 #define NT_SUCCESS(Status) (((NTSTATUS)(Status)) >= 0)
 #endif
 
+#else // ^^^ _WIN32 // !_WIN32 vvv
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define VCPKG_SHA256_X86_EXTENSIONS 1
+#include <cpuid.h>
+#include <immintrin.h>
+#elif defined(__aarch64__) && (defined(__ARM_FEATURE_SHA2) || defined(__ARM_FEATURE_CRYPTO))
+#define VCPKG_SHA256_ARM_EXTENSIONS 1
+#include <arm_neon.h>
 #endif
 
+#endif // ^^^ !_WIN32
+
 namespace vcpkg::Hash
 {
     using uchar = unsigned char;
@@ -201,20 +212,34 @@ namespace vcpkg::Hash
         struct ShaHasher final : Hasher
         {
             ShaHasher() = default;
+            explicit ShaHasher(ShaAlgorithm impl) noexcept : m_impl(impl) { }
 
-            virtual void add_bytes(const void* start, const void* end) noexcept override
+            virtual void add_bytes(const void* start_, const void* end_) noexcept override
             {
-                for (;;)
+                const uchar* start = static_cast<const uchar*>(start_);
+                const uchar* end = static_cast<const uchar*>(end_);
+                if (m_current_chunk_size != 0)
                 {
-                    start = add_to_unprocessed(start, end);
+                    start = static_cast<const uchar*>(add_to_unprocessed(start, end));
                     if (!start)
                     {
-                        break; // done
+                        return; // done
                     }
 
-                    m_impl.process_full_chunk(m_chunk);
+                    m_impl.process_full_chunks(m_chunk, 1);
                     m_current_chunk_size = 0;
                 }
+
+                // whole chunks are hashed straight from the input rather than being copied into m_chunk first
+                const std::size_t full_chunks = static_cast<std::size_t>(end - start) / chunk_size;
+                if (full_chunks != 0)
+                {
+                    m_impl.process_full_chunks(start, full_chunks);
+                    start += full_chunks * chunk_size;
+                    m_message_length += full_chunks * chunk_size * 8;
+                }
+
+                add_to_unprocessed(start, end);
             }
 
             virtual void clear() noexcept override
@@ -279,7 +304,7 @@ namespace vcpkg::Hash
                     // not enough space to add the message length
                     // just resize and process full chunk
                     std::fill(chunk_begin(), chunk_end, static_cast<uchar>(0));
-                    m_impl.process_full_chunk(m_chunk);
+                    m_impl.process_full_chunks(m_chunk, 1);
                     m_current_chunk_size = 0;
                 }
 
@@ -291,7 +316,7 @@ namespace vcpkg::Hash
                     return result;
                 });
 
-                m_impl.process_full_chunk(m_chunk);
+                m_impl.process_full_chunks(m_chunk, 1);
             }
 
             auto chunk_begin() { return m_chunk + m_current_chunk_size; }
@@ -322,6 +347,11 @@ namespace vcpkg::Hash
             }
         }
 
+        // Hashes `count` consecutive chunks of 64 bytes into `digest`
+        using Sha256Kernel = void (*)(std::uint32_t* digest, const uchar* chunks, std::size_t count) noexcept;
+
+        static Sha256Kernel get_sha256_kernel() noexcept;
+
         struct Sha256Algorithm
         {
             using underlying_type = std::uint32_t;
@@ -330,53 +360,61 @@ namespace vcpkg::Hash
 
             constexpr static std::size_t number_of_rounds = 64;
 
-            Sha256Algorithm() noexcept { clear(); }
+            explicit Sha256Algorithm(Sha256Kernel kernel = get_sha256_kernel()) noexcept : m_kernel(kernel) { clear(); }
 
-            void process_full_chunk(const uchar (&chunk)[chunk_size]) noexcept
+            void process_full_chunks(const uchar* chunks, std::size_t count) noexcept
             {
-                std::uint32_t words[64];
-
-                sha_fill_initial_words(&chunk[0], words);
-
-                for (std::size_t i = 16; i < number_of_rounds; ++i)
-                {
-                    const auto w0 = words[i - 15];
-                    const auto s0 = ror32(w0, 7) ^ ror32(w0, 18) ^ shr32(w0, 3);
-                    const auto w1 = words[i - 2];
-                    const auto s1 = ror32(w1, 17) ^ ror32(w1, 19) ^ shr32(w1, 10);
-                    words[i] = words[i - 16] + s0 + words[i - 7] + s1;
-                }
-
-                std::uint32_t local[8];
-                std::copy(begin(), end(), std::begin(local));
+                m_kernel(m_digest, chunks, count);
+            }
 
-                for (std::size_t i = 0; i < number_of_rounds; ++i)
+            static void process_portable(std::uint32_t* digest, const uchar* chunks, std::size_t count) noexcept
+            {
+                for (; count != 0; --count, chunks += chunk_size)
                 {
-                    const auto a = local[0];
-                    const auto b = local[1];
-                    const auto c = local[2];
+                    std::uint32_t words[64];
 
-                    const auto s0 = ror32(a, 2) ^ ror32(a, 13) ^ ror32(a, 22);
-                    const auto maj = (a & b) ^ (a & c) ^ (b & c);
-                    const auto tmp1 = s0 + maj;
+                    sha_fill_initial_words(chunks, words);
 
-                    const auto e = local[4];
+                    for (std::size_t i = 16; i < number_of_rounds; ++i)
+                    {
+                        const auto w0 = words[i - 15];
+                        const auto s0 = ror32(w0, 7) ^ ror32(w0, 18) ^ shr32(w0, 3);
+                        const auto w1 = words[i - 2];
+                        const auto s1 = ror32(w1, 17) ^ ror32(w1, 19) ^ shr32(w1, 10);
+                        words[i] = words[i - 16] + s0 + words[i - 7] + s1;
+                    }
 
-                    const auto s1 = ror32(e, 6) ^ ror32(e, 11) ^ ror32(e, 25);
-                    const auto ch = (e & local[5]) ^ (~e & local[6]);
-                    const auto tmp2 = local[7] + s1 + ch + round_constants[i] + words[i];
+                    std::uint32_t local[8];
+                    std::copy(digest, digest + 8, std::begin(local));
 
-                    for (std::size_t j = 7; j > 0; --j)
+                    for (std::size_t i = 0; i < number_of_rounds; ++i)
                     {
-                        local[j] = local[j - 1];
+                        const auto a = local[0];
+                        const auto b = local[1];
+                        const auto c = local[2];
+
+                        const auto s0 = ror32(a, 2) ^ ror32(a, 13) ^ ror32(a, 22);
+                        const auto maj = (a & b) ^ (a & c) ^ (b & c);
+                        const auto tmp1 = s0 + maj;
+
+                        const auto e = local[4];
+
+                        const auto s1 = ror32(e, 6) ^ ror32(e, 11) ^ ror32(e, 25);
+                        const auto ch = (e & local[5]) ^ (~e & local[6]);
+                        const auto tmp2 = local[7] + s1 + ch + round_constants[i] + words[i];
+
+                        for (std::size_t j = 7; j > 0; --j)
+                        {
+                            local[j] = local[j - 1];
+                        }
+                        local[4] += tmp2;
+                        local[0] = tmp1 + tmp2;
                     }
-                    local[4] += tmp2;
-                    local[0] = tmp1 + tmp2;
-                }
 
-                for (std::size_t i = 0; i < 8; ++i)
-                {
-                    m_digest[i] += local[i];
+                    for (std::size_t i = 0; i < 8; ++i)
+                    {
+                        digest[i] += local[i];
+                    }
                 }
             }
 
@@ -392,7 +430,7 @@ namespace vcpkg::Hash
                 m_digest[7] = 0x5be0cd19;
             }
 
-            constexpr static std::uint32_t round_constants[number_of_rounds] = {
+            alignas(16) constexpr static std::uint32_t round_constants[number_of_rounds] = {
                 0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
                 0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
                 0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
@@ -405,9 +443,128 @@ namespace vcpkg::Hash
             std::uint32_t* begin() noexcept { return &m_digest[0]; }
             std::uint32_t* end() noexcept { return &m_digest[8]; }
 
+            Sha256Kernel m_kernel;
             std::uint32_t m_digest[8];
         };
 
+#if defined(VCPKG_SHA256_X86_EXTENSIONS)
+        static bool cpu_has_sha_extensions() noexcept
+        {
+            unsigned int eax;
+            unsigned int ebx;
+            unsigned int ecx;
+            unsigned int edx;
+            // SSSE3 and SSE4.1 are needed for the byte shuffles and blends around the SHA instructions
+            if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx) || !(ecx & (1u << 9)) || !(ecx & (1u << 19)))
+            {
+                return false;
+            }
+
+            return __get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx) && (ebx & (1u << 29));
+        }
+
+        __attribute__((target("sha,sse4.1"))) static void process_sha256_x86_extensions(std::uint32_t* digest,
+                                                                                        const uchar* chunks,
+                                                                                        std::size_t count) noexcept
+        {
+            const __m128i byte_swap = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+            const auto round_constants = reinterpret_cast<const __m128i*>(Sha256Algorithm::round_constants);
+
+            // the SHA instructions keep the state as ABEF and CDGH
+            __m128i tmp = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(digest)), 0xB1);
+            __m128i state1 = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(digest + 4)), 0x1B);
+            __m128i state0 = _mm_alignr_epi8(tmp, state1, 8);
+            state1 = _mm_blend_epi16(state1, tmp, 0xF0);
+
+            for (; count != 0; --count, chunks += Sha256Algorithm::chunk_size)
+            {
+                const __m128i abef = state0;
+                const __m128i cdgh = state1;
+                __m128i words[4];
+                for (int i = 0; i < 4; ++i)
+                {
+                    words[i] = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(chunks) + i),
+                                                byte_swap);
+                }
+
+                // each iteration performs 4 rounds, and computes the words needed 4 iterations later
+                for (int i = 0; i < 16; ++i)
+                {
+                    const __m128i message = _mm_add_epi32(words[i & 3], _mm_load_si128(round_constants + i));
+                    state1 = _mm_sha256rnds2_epu32(state1, state0, message);
+                    state0 = _mm_sha256rnds2_epu32(state0, state1, _mm_shuffle_epi32(message, 0x0E));
+                    if (i < 12)
+                    {
+                        const __m128i next = _mm_add_epi32(_mm_sha256msg1_epu32(words[i & 3], words[(i + 1) & 3]),
+                                                           _mm_alignr_epi8(words[(i + 3) & 3], words[(i + 2) & 3], 4));
+                        words[i & 3] = _mm_sha256msg2_epu32(next, words[(i + 3) & 3]);
+                    }
+                }
+
+                state0 = _mm_add_epi32(state0, abef);
+                state1 = _mm_add_epi32(state1, cdgh);
+            }
+
+            tmp = _mm_shuffle_epi32(state0, 0x1B);
+            state1 = _mm_shuffle_epi32(state1, 0xB1);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(digest), _mm_blend_epi16(tmp, state1, 0xF0));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(digest + 4), _mm_alignr_epi8(state1, tmp, 8));
+        }
+#elif defined(VCPKG_SHA256_ARM_EXTENSIONS)
+        static void process_sha256_arm_extensions(std::uint32_t* digest,
+                                                  const uchar* chunks,
+                                                  std::size_t count) noexcept
+        {
+            uint32x4_t state0 = vld1q_u32(digest);
+            uint32x4_t state1 = vld1q_u32(digest + 4);
+            for (; count != 0; --count, chunks += Sha256Algorithm::chunk_size)
+            {
+                const uint32x4_t abcd = state0;
+                const uint32x4_t efgh = state1;
+                uint32x4_t words[4];
+                for (int i = 0; i < 4; ++i)
+                {
+                    words[i] = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(chunks + 16 * i)));
+                }
+
+                // each iteration performs 4 rounds, and computes the words needed 4 iterations later
+                for (int i = 0; i < 16; ++i)
+                {
+                    const uint32x4_t message =
+                        vaddq_u32(words[i & 3], vld1q_u32(Sha256Algorithm::round_constants + 4 * i));
+                    if (i < 12)
+                    {
+                        words[i & 3] = vsha256su1q_u32(
+                            vsha256su0q_u32(words[i & 3], words[(i + 1) & 3]), words[(i + 2) & 3], words[(i + 3) & 3]);
+                    }
+
+                    const uint32x4_t previous_state0 = state0;
+                    state0 = vsha256hq_u32(state0, state1, message);
+                    state1 = vsha256h2q_u32(state1, previous_state0, message);
+                }
+
+                state0 = vaddq_u32(state0, abcd);
+                state1 = vaddq_u32(state1, efgh);
+            }
+
+            vst1q_u32(digest, state0);
+            vst1q_u32(digest + 4, state1);
+        }
+#endif
+
+        static Sha256Kernel get_sha256_kernel() noexcept
+        {
+#if defined(VCPKG_SHA256_X86_EXTENSIONS)
+            static const Sha256Kernel kernel =
+                cpu_has_sha_extensions() ? &process_sha256_x86_extensions : &Sha256Algorithm::process_portable;
+            return kernel;
+#elif defined(VCPKG_SHA256_ARM_EXTENSIONS)
+            return &process_sha256_arm_extensions;
+#else
+            return &Sha256Algorithm::process_portable;
+#endif
+        }
+
         struct Sha512Algorithm
         {
             using underlying_type = std::uint64_t;
@@ -418,11 +575,19 @@ namespace vcpkg::Hash
 
             Sha512Algorithm() noexcept { clear(); }
 
-            void process_full_chunk(const uchar (&chunk)[chunk_size]) noexcept
+            void process_full_chunks(const uchar* chunks, std::size_t count) noexcept
+            {
+                for (; count != 0; --count, chunks += chunk_size)
+                {
+                    process_full_chunk(chunks);
+                }
+            }
+
+            void process_full_chunk(const uchar* chunk) noexcept
             {
                 std::uint64_t words[80];
 
-                sha_fill_initial_words(&chunk[0], words);
+                sha_fill_initial_words(chunk, words);
 
                 for (std::size_t i = 16; i < number_of_rounds; ++i)
                 {
@@ -518,6 +683,20 @@ namespace vcpkg::Hash
 #endif
     }
 
+#if !defined(_WIN32)
+    std::unique_ptr<Hasher> get_portable_hasher_for(Algorithm algo)
+    {
+        switch (algo)
+        {
+            case Algorithm::Sha256:
+                return std::make_unique<ShaHasher<Sha256Algorithm>>(
+                    Sha256Algorithm(&Sha256Algorithm::process_portable));
+            case Algorithm::Sha512: return std::make_unique<ShaHasher<Sha512Algorithm>>();
+            default: Checks::unreachable(VCPKG_LINE_INFO);
+        }
+    }
+#endif
+
     template<class ReturnType, class F>
     static ReturnType do_hash(Algorithm algo, const F& f)
     {
@@ -28,9 +28,18 @@ namespace vcpkg::Json
         template<ValueKind Vk>
         using ValueKindConstant = std::integral_constant<ValueKind, Vk>;
 
+        struct BorrowedString
+        {
+            StringView sv;
+        };
+
         struct ValueImpl
         {
             VK tag;
+            // whether this was allocated from the arena of a Document
+            bool in_arena = false;
+            // whether the string is borrowed_string rather than string
+            bool is_borrowed_string = false;
             union
             {
                 std::nullptr_t null;
@@ -38,6 +47,7 @@ namespace vcpkg::Json
                 int64_t integer;
                 double number;
                 std::string string;
+                StringView borrowed_string;
                 Array array;
                 Object object;
             };
@@ -48,6 +58,10 @@ namespace vcpkg::Json
             ValueImpl(ValueKindConstant<VK::Number> vk, double d) : tag(vk), number(d) { }
             ValueImpl(ValueKindConstant<VK::String> vk, std::string&& s) : tag(vk), string(std::move(s)) { }
             ValueImpl(ValueKindConstant<VK::String> vk, const std::string& s) : tag(vk), string(s) { }
+            ValueImpl(ValueKindConstant<VK::String> vk, BorrowedString s)
+                : tag(vk), is_borrowed_string(true), borrowed_string(s.sv)
+            {
+            }
             ValueImpl(ValueKindConstant<VK::Array> vk, Array&& arr) : tag(vk), array(std::move(arr)) { }
             ValueImpl(ValueKindConstant<VK::Array> vk, const Array& arr) : tag(vk), array(arr) { }
             ValueImpl(ValueKindConstant<VK::Object> vk, Object&& obj) : tag(vk), object(std::move(obj)) { }
@@ -61,7 +75,22 @@ namespace vcpkg::Json
                     case VK::Boolean: return internal_assign(VK::Boolean, &ValueImpl::boolean, other);
                     case VK::Integer: return internal_assign(VK::Integer, &ValueImpl::integer, other);
                     case VK::Number: return internal_assign(VK::Number, &ValueImpl::number, other);
-                    case VK::String: return internal_assign(VK::String, &ValueImpl::string, other);
+                    case VK::String:
+                        if (other.is_borrowed_string)
+                        {
+                            destroy_underlying();
+                            new (&borrowed_string) StringView(other.borrowed_string);
+                            tag = VK::String;
+                            is_borrowed_string = true;
+                            return *this;
+                        }
+
+                        if (is_borrowed_string)
+                        {
+                            destroy_underlying();
+                        }
+
+                        return internal_assign(VK::String, &ValueImpl::string, other);
                     case VK::Array: return internal_assign(VK::Array, &ValueImpl::array, other);
                     case VK::Object: return internal_assign(VK::Object, &ValueImpl::object, other);
                     default: Checks::unreachable(VCPKG_LINE_INFO);
@@ -70,6 +99,16 @@ namespace vcpkg::Json
 
             ~ValueImpl() { destroy_underlying(); }
 
+            StringView string_view() const noexcept
+            {
+                if (is_borrowed_string)
+                {
+                    return borrowed_string;
+                }
+
+                return string;
+            }
+
         private:
             template<class T>
             ValueImpl& internal_assign(ValueKind vk, T ValueImpl::*mp, ValueImpl& other) noexcept
@@ -93,20 +132,145 @@ namespace vcpkg::Json
             {
                 switch (tag)
                 {
-                    case VK::String: string.~basic_string(); break;
+                    case VK::String:
+                        if (!is_borrowed_string)
+                        {
+                            string.~basic_string();
+                        }
+                        break;
                     case VK::Array: array.~Array(); break;
                     case VK::Object: object.~Object(); break;
                     default: break;
                 }
                 new (&null) std::nullptr_t();
                 tag = VK::Null;
+                is_borrowed_string = false;
+            }
+        };
+
+        void ValueImplDeleter::operator()(ValueImpl* ptr) const noexcept
+        {
+            if (ptr->in_arena)
+            {
+                ptr->~ValueImpl();
+            }
+            else
+            {
+                delete ptr;
+            }
+        }
+
+        struct JsonArena
+        {
+            explicit JsonArena(std::string&& source) : text(std::move(source)), next_block_size(initial_block_size)
+            {
+                // parsed documents typically need a bit more memory than the size of their text
+                next_block_size = std::max(next_block_size, std::min(text.size() * 2, max_block_size));
+            }
+
+            JsonArena(const JsonArena&) = delete;
+            JsonArena& operator=(const JsonArena&) = delete;
+
+            void* allocate(std::size_t size, std::size_t alignment)
+            {
+                auto aligned = (current + alignment - 1) & ~(alignment - 1);
+                if (blocks.empty() || aligned + size > current_block_size)
+                {
+                    // blocks from new[] are aligned for any fundamental type
+                    current_block_size = std::max(next_block_size, size);
+                    blocks.push_back(std::make_unique<unsigned char[]>(current_block_size));
+                    next_block_size = std::min(next_block_size * 2, max_block_size);
+                    aligned = 0;
+                }
+
+                current = aligned + size;
+                return blocks.back().get() + aligned;
+            }
+
+            StringView copy_string(StringView sv)
+            {
+                if (sv.empty())
+                {
+                    return StringView{};
+                }
+
+                auto buffer = static_cast<char*>(allocate(sv.size(), 1));
+                std::copy(sv.begin(), sv.end(), buffer);
+                return StringView{buffer, sv.size()};
+            }
+
+            // the text of the document, which borrowed strings point into
+            std::string text;
+
+        private:
+            static constexpr std::size_t initial_block_size = 4 * 1024;
+            static constexpr std::size_t max_block_size = 1024 * 1024;
+
+            std::vector<std::unique_ptr<unsigned char[]>> blocks;
+            std::size_t current = 0;
+            std::size_t current_block_size = 0;
+            std::size_t next_block_size;
+        };
+
+        void* arena_allocate(JsonArena* arena, std::size_t size, std::size_t alignment)
+        {
+            return arena->allocate(size, alignment);
+        }
+
+        template<class... Args>
+        static std::unique_ptr<ValueImpl, ValueImplDeleter> make_value_impl(Args&&... args)
+        {
+            return std::unique_ptr<ValueImpl, ValueImplDeleter>(new ValueImpl(std::forward<Args>(args)...));
+        }
+
+        // constructs values in the arena of a document, or on the heap if there is no arena
+        struct ArenaBuilder
+        {
+            template<ValueKind Vk, class Arg>
+            static Value make_value(JsonArena* arena, ValueKindConstant<Vk> vk, Arg&& arg)
+            {
+                Value val;
+                if (arena)
+                {
+                    auto ptr = new (arena->allocate(sizeof(ValueImpl), alignof(ValueImpl)))
+                        ValueImpl(vk, std::forward<Arg>(arg));
+                    ptr->in_arena = true;
+                    val.underlying_.reset(ptr);
+                }
+                else
+                {
+                    val.underlying_ = make_value_impl(vk, std::forward<Arg>(arg));
+                }
+
+                return val;
+            }
+
+            static Array make_array(JsonArena* arena) { return Array(arena); }
+            static Object make_object(JsonArena* arena) { return Object(arena); }
+            static JsonArena* make_arena(Document& doc, std::string&& text)
+            {
+                doc.arena_ = std::make_unique<JsonArena>(std::move(text));
+                return doc.arena_.get();
             }
         };
     }
 
+    using impl::ArenaBuilder;
+    using impl::BorrowedString;
+    using impl::JsonArena;
+    using impl::make_value_impl;
     using impl::ValueImpl;
     using impl::ValueKindConstant;
 
+    static void check_valid_utf8(StringView sv)
+    {
+        if (!Unicode::utf8_is_valid_string(sv.begin(), sv.end()))
+        {
+            Debug::print("Invalid string: ", sv, '\n');
+            vcpkg::Checks::msg_exit_with_message(VCPKG_LINE_INFO, msgInvalidString);
+        }
+    }
+
     VK Value::kind() const noexcept
     {
         if (underlying_)
@@ -156,27 +320,17 @@ namespace vcpkg::Json
     StringView Value::string(LineInfo li) const noexcept
     {
         vcpkg::Checks::msg_check_exit(li, is_string(), msgJsonValueNotString);
-        return underlying_->string;
-    }
-
-    std::string* Value::maybe_string() noexcept
-    {
-        if (underlying_ && underlying_->tag == VK::String)
-        {
-            return &underlying_->string;
-        }
-
-        return nullptr;
+        return underlying_->string_view();
     }
 
-    const std::string* Value::maybe_string() const noexcept
+    Optional<StringView> Value::maybe_string() const noexcept
     {
         if (underlying_ && underlying_->tag == VK::String)
         {
-            return &underlying_->string;
+            return underlying_->string_view();
         }
 
-        return nullptr;
+        return nullopt;
     }
 
     const Array& Value::array(LineInfo li) const& noexcept
@@ -253,22 +407,23 @@ namespace vcpkg::Json
         {
             case ValueKind::Null: return; // default construct underlying_
             case ValueKind::Boolean:
-                underlying_ = std::make_unique<ValueImpl>(ValueKindConstant<VK::Boolean>(), other.underlying_->boolean);
+                underlying_ = make_value_impl(ValueKindConstant<VK::Boolean>(), other.underlying_->boolean);
                 break;
             case ValueKind::Integer:
-                underlying_ = std::make_unique<ValueImpl>(ValueKindConstant<VK::Integer>(), other.underlying_->integer);
+                underlying_ = make_value_impl(ValueKindConstant<VK::Integer>(), other.underlying_->integer);
                 break;
             case ValueKind::Number:
-                underlying_ = std::make_unique<ValueImpl>(ValueKindConstant<VK::Number>(), other.underlying_->number);
+                underlying_ = make_value_impl(ValueKindConstant<VK::Number>(), other.underlying_->number);
                 break;
             case ValueKind::String:
-                underlying_ = std::make_unique<ValueImpl>(ValueKindConstant<VK::String>(), other.underlying_->string);
+                underlying_ =
+                    make_value_impl(ValueKindConstant<VK::String>(), other.underlying_->string_view().to_string());
                 break;
             case ValueKind::Array:
-                underlying_ = std::make_unique<ValueImpl>(ValueKindConstant<VK::Array>(), other.underlying_->array);
+                underlying_ = make_value_impl(ValueKindConstant<VK::Array>(), other.underlying_->array);
                 break;
             case ValueKind::Object:
-                underlying_ = std::make_unique<ValueImpl>(ValueKindConstant<VK::Object>(), other.underlying_->object);
+                underlying_ = make_value_impl(ValueKindConstant<VK::Object>(), other.underlying_->object);
                 break;
             default: Checks::unreachable(VCPKG_LINE_INFO);
         }
@@ -280,22 +435,23 @@ namespace vcpkg::Json
         {
             case ValueKind::Null: underlying_.reset(); break;
             case ValueKind::Boolean:
-                underlying_ = std::make_unique<ValueImpl>(ValueKindConstant<VK::Boolean>(), other.underlying_->boolean);
+                underlying_ = make_value_impl(ValueKindConstant<VK::Boolean>(), other.underlying_->boolean);
                 break;
             case ValueKind::Integer:
-                underlying_ = std::make_unique<ValueImpl>(ValueKindConstant<VK::Integer>(), other.underlying_->integer);
+                underlying_ = make_value_impl(ValueKindConstant<VK::Integer>(), other.underlying_->integer);
                 break;
             case ValueKind::Number:
-                underlying_ = std::make_unique<ValueImpl>(ValueKindConstant<VK::Number>(), other.underlying_->number);
+                underlying_ = make_value_impl(ValueKindConstant<VK::Number>(), other.underlying_->number);
                 break;
             case ValueKind::String:
-                underlying_ = std::make_unique<ValueImpl>(ValueKindConstant<VK::String>(), other.underlying_->string);
+                underlying_ =
+                    make_value_impl(ValueKindConstant<VK::String>(), other.underlying_->string_view().to_string());
                 break;
             case ValueKind::Array:
-                underlying_ = std::make_unique<ValueImpl>(ValueKindConstant<VK::Array>(), other.underlying_->array);
+                underlying_ = make_value_impl(ValueKindConstant<VK::Array>(), other.underlying_->array);
                 break;
             case ValueKind::Object:
-                underlying_ = std::make_unique<ValueImpl>(ValueKindConstant<VK::Object>(), other.underlying_->object);
+                underlying_ = make_value_impl(ValueKindConstant<VK::Object>(), other.underlying_->object);
                 break;
             default: Checks::unreachable(VCPKG_LINE_INFO);
         }
@@ -309,55 +465,51 @@ namespace vcpkg::Json
     Value Value::boolean(bool b) noexcept
     {
         Value val;
-        val.underlying_ = std::make_unique<ValueImpl>(ValueKindConstant<VK::Boolean>(), b);
+        val.underlying_ = make_value_impl(ValueKindConstant<VK::Boolean>(), b);
         return val;
     }
     Value Value::integer(int64_t i) noexcept
     {
         Value val;
-        val.underlying_ = std::make_unique<ValueImpl>(ValueKindConstant<VK::Integer>(), i);
+        val.underlying_ = make_value_impl(ValueKindConstant<VK::Integer>(), i);
         return val;
     }
     Value Value::number(double d) noexcept
     {
         vcpkg::Checks::check_exit(VCPKG_LINE_INFO, isfinite(d));
         Value val;
-        val.underlying_ = std::make_unique<ValueImpl>(ValueKindConstant<VK::Number>(), d);
+        val.underlying_ = make_value_impl(ValueKindConstant<VK::Number>(), d);
         return val;
     }
     Value Value::string(std::string&& s) noexcept
     {
-        if (!Unicode::utf8_is_valid_string(s.data(), s.data() + s.size()))
-        {
-            Debug::print("Invalid string: ", s, '\n');
-            vcpkg::Checks::msg_exit_with_message(VCPKG_LINE_INFO, msgInvalidString);
-        }
+        check_valid_utf8(s);
         Value val;
-        val.underlying_ = std::make_unique<ValueImpl>(ValueKindConstant<VK::String>(), std::move(s));
+        val.underlying_ = make_value_impl(ValueKindConstant<VK::String>(), std::move(s));
         return val;
     }
     Value Value::array(Array&& arr) noexcept
     {
         Value val;
-        val.underlying_ = std::make_unique<ValueImpl>(ValueKindConstant<VK::Array>(), std::move(arr));
+        val.underlying_ = make_value_impl(ValueKindConstant<VK::Array>(), std::move(arr));
         return val;
     }
     Value Value::array(const Array& arr) noexcept
     {
         Value val;
-        val.underlying_ = std::make_unique<ValueImpl>(ValueKindConstant<VK::Array>(), arr);
+        val.underlying_ = make_value_impl(ValueKindConstant<VK::Array>(), arr);
         return val;
     }
     Value Value::object(Object&& obj) noexcept
     {
         Value val;
-        val.underlying_ = std::make_unique<ValueImpl>(ValueKindConstant<VK::Object>(), std::move(obj));
+        val.underlying_ = make_value_impl(ValueKindConstant<VK::Object>(), std::move(obj));
         return val;
     }
     Value Value::object(const Object& obj) noexcept
     {
         Value val;
-        val.underlying_ = std::make_unique<ValueImpl>(ValueKindConstant<VK::Object>(), obj);
+        val.underlying_ = make_value_impl(ValueKindConstant<VK::Object>(), obj);
         return val;
     }
 
@@ -371,7 +523,7 @@ namespace vcpkg::Json
             case ValueKind::Boolean: return lhs.underlying_->boolean == rhs.underlying_->boolean;
             case ValueKind::Integer: return lhs.underlying_->integer == rhs.underlying_->integer;
             case ValueKind::Number: return lhs.underlying_->number == rhs.underlying_->number;
-            case ValueKind::String: return lhs.underlying_->string == rhs.underlying_->string;
+            case ValueKind::String: return lhs.underlying_->string_view() == rhs.underlying_->string_view();
             case ValueKind::Array: return lhs.underlying_->array == rhs.underlying_->array;
             case ValueKind::Object: return lhs.underlying_->object == rhs.underlying_->object;
             default: Checks::unreachable(VCPKG_LINE_INFO);
@@ -409,7 +561,7 @@ namespace vcpkg::Json
                                 fmt::format("attempted to insert duplicate key {} into JSON object", key));
         }
 
-        return underlying_.emplace_back(key.to_string(), std::move(value)).second;
+        return internal_emplace_back(key, std::move(value));
     }
     Value& Object::insert(StringView key, const Value& value)
     {
@@ -419,7 +571,7 @@ namespace vcpkg::Json
                                 fmt::format("attempted to insert duplicate key {} into JSON object", key));
         }
 
-        return underlying_.emplace_back(key.to_string(), value).second;
+        return internal_emplace_back(key, Value(value));
     }
     Array& Object::insert(StringView key, Array&& value)
     {
@@ -452,7 +604,7 @@ namespace vcpkg::Json
         }
         else
         {
-            return underlying_.emplace_back(key, std::move(value)).second;
+            return internal_emplace_back(key, std::move(value));
         }
     }
     Value& Object::insert_or_replace(StringView key, const Value& value)
@@ -465,7 +617,7 @@ namespace vcpkg::Json
         }
         else
         {
-            return underlying_.emplace_back(key, value).second;
+            return internal_emplace_back(key, Value(value));
         }
     }
     Array& Object::insert_or_replace(StringView key, Array&& value)
@@ -485,10 +637,93 @@ namespace vcpkg::Json
         return insert_or_replace(key, Value::object(value)).object(VCPKG_LINE_INFO);
     }
 
+    static constexpr std::size_t object_hashed_lookup_threshold = 16;
+
+    static std::size_t hash_object_key(StringView key) noexcept
+    {
+        // FNV-1a
+        uint64_t hash = 14695981039346656037ull;
+        for (unsigned char ch : key)
+        {
+            hash ^= ch;
+            hash *= 1099511628211ull;
+        }
+
+        return static_cast<std::size_t>(hash ^ (hash >> 32));
+    }
+
     auto Object::internal_find_key(StringView key) const noexcept -> underlying_t::const_iterator
     {
-        return std::find_if(
-            underlying_.begin(), underlying_.end(), [key](const auto& pair) { return pair.first == key; });
+        if (index_.empty())
+        {
+            return std::find_if(
+                underlying_.begin(), underlying_.end(), [key](const auto& pair) { return pair.first == key; });
+        }
+
+        const auto mask = index_.size() - 1;
+        for (auto slot = hash_object_key(key) & mask;; slot = (slot + 1) & mask)
+        {
+            const auto entry = index_[slot];
+            if (entry == 0)
+            {
+                return underlying_.end();
+            }
+
+            const auto it = underlying_.begin() + (entry - 1);
+            if (it->first == key)
+            {
+                return it;
+            }
+        }
+    }
+
+    Value& Object::internal_emplace_back(StringView key, Value&& value)
+    {
+        auto& inserted = underlying_.emplace_back(key.to_string(), std::move(value));
+        if (underlying_.size() * 2 > index_.size())
+        {
+            // keeps the table at most half full, which also builds it when crossing the threshold
+            internal_rebuild_index();
+        }
+        else
+        {
+            internal_insert_index(underlying_.size() - 1);
+        }
+
+        return inserted.second;
+    }
+
+    void Object::internal_insert_index(std::size_t position) noexcept
+    {
+        const auto mask = index_.size() - 1;
+        auto slot = hash_object_key(underlying_[position].first) & mask;
+        while (index_[slot] != 0)
+        {
+            slot = (slot + 1) & mask;
+        }
+
+        index_[slot] = static_cast<uint32_t>(position + 1);
+    }
+
+    void Object::internal_rebuild_index()
+    {
+        index_.clear();
+        if (underlying_.size() < object_hashed_lookup_threshold)
+        {
+            return;
+        }
+
+        std::size_t table_size = object_hashed_lookup_threshold * 2;
+        while (table_size < underlying_.size() * 4)
+        {
+            table_size *= 2;
+        }
+
+        index_.resize(table_size);
+        for (std::size_t position = 0; position < underlying_.size(); ++position)
+        {
+            internal_insert_index(position);
+        }
     }
 
     // returns whether the key existed
@@ -502,6 +737,7 @@ namespace vcpkg::Json
         else
         {
             underlying_.erase(it);
+            internal_rebuild_index();
             return true;
         }
     }
@@ -536,6 +772,7 @@ namespace vcpkg::Json
         std::sort(underlying_.begin(), underlying_.end(), [](const value_type& lhs, const value_type& rhs) {
             return lhs.first < rhs.first;
         });
+        internal_rebuild_index();
     }
 
     bool operator==(const Object& lhs, const Object& rhs) { return lhs.underlying_ == rhs.underlying_; }
@@ -546,8 +783,8 @@ namespace vcpkg::Json
     {
         struct Parser : private ParserBase
         {
-            Parser(StringView text, StringView origin, TextRowCol init_rowcol)
-                : ParserBase(text, origin, init_rowcol), style_()
+            Parser(StringView text, StringView origin, TextRowCol init_rowcol, JsonArena* arena)
+                : ParserBase(text, origin, init_rowcol), style_(), arena_(arena)
             {
             }
 
@@ -656,12 +893,57 @@ namespace vcpkg::Json
                 }
             }
 
+            template<ValueKind Vk, class Arg>
+            Value make_value(ValueKindConstant<Vk> vk, Arg&& arg)
+            {
+                return ArenaBuilder::make_value(arena_, vk, std::forward<Arg>(arg));
+            }
+
+            // matches the content of a string up to the closing quote or the first character that needs decoding
+            StringView match_unescaped_string_content()
+            {
+                return match_while([](char32_t ch) { return ch != '"' && ch != '\\' && ch > 0x1F; });
+            }
+
             std::string parse_string() noexcept
             {
                 Checks::check_exit(VCPKG_LINE_INFO, cur() == '"');
                 next();
 
-                std::string res;
+                auto unescaped = match_unescaped_string_content();
+                if (cur() == '"')
+                {
+                    next();
+                    return unescaped.to_string();
+                }
+
+                return parse_string_remainder(unescaped.to_string());
+            }
+
+            Value parse_string_value() noexcept
+            {
+                if (!arena_)
+                {
+                    return Value::string(parse_string());
+                }
+
+                Checks::check_exit(VCPKG_LINE_INFO, cur() == '"');
+                next();
+
+                auto unescaped = match_unescaped_string_content();
+                if (cur() == '"')
+                {
+                    next();
+                    return make_value(ValueKindConstant<VK::String>(), BorrowedString{unescaped});
+                }
+
+                auto decoded = parse_string_remainder(unescaped.to_string());
+                check_valid_utf8(decoded);
+                return make_value(ValueKindConstant<VK::String>(), BorrowedString{arena_->copy_string(decoded)});
+            }
+
+            std::string parse_string_remainder(std::string res) noexcept
+            {
                 char32_t previous_leading_surrogate = Unicode::end_of_file;
                 while (!at_eof())
                 {
@@ -741,11 +1023,11 @@ namespace vcpkg::Json
                     {
                         if (negative)
                         {
-                            return Value::number(-0.0);
+                            return make_value(ValueKindConstant<VK::Number>(), -0.0);
                         }
                         else
                         {
-                            return Value::integer(0);
+                            return make_value(ValueKindConstant<VK::Integer>(), int64_t(0));
                         }
                     }
                 }
@@ -779,7 +1061,7 @@ namespace vcpkg::Json
                     {
                         if (std::abs(*res) < INFINITY)
                         {
-                            return Value::number(*res);
+                            return make_value(ValueKindConstant<VK::Number>(), *res);
                         }
                         else
                         {
@@ -796,7 +1078,7 @@ namespace vcpkg::Json
                     auto opt = Strings::strto<int64_t>(number_to_parse);
                     if (auto res = opt.get())
                     {
-                        return Value::integer(*res);
+                        return make_value(ValueKindConstant<VK::Integer>(), *res);
                     }
                     else
                     {
@@ -816,11 +1098,11 @@ namespace vcpkg::Json
                 {
                     case 't': // parse true
                         rest = U"rue";
-                        val = Value::boolean(true);
+                        val = make_value(ValueKindConstant<VK::Boolean>(), true);
                         break;
                     case 'f': // parse false
                         rest = U"alse";
-                        val = Value::boolean(false);
+                        val = make_value(ValueKindConstant<VK::Boolean>(), false);
                         break;
                     case 'n': // parse null
                         rest = U"ull";
@@ -853,7 +1135,7 @@ namespace vcpkg::Json
                 Checks::check_exit(VCPKG_LINE_INFO, cur() == '[');
                 next();
 
-                Array arr;
+                Array arr = ArenaBuilder::make_array(arena_);
                 bool first = true;
                 for (;;)
                 {
@@ -868,7 +1150,7 @@ namespace vcpkg::Json
                     if (current == ']')
                     {
                         next();
-                        return Value::array(std::move(arr));
+                        return make_value(ValueKindConstant<VK::Array>(), std::move(arr));
                     }
 
                     if (first)
@@ -889,7 +1171,7 @@ namespace vcpkg::Json
                         if (current == ']')
                         {
                             add_error(msg::format(msgTrailingCommaInArray), comma_loc);
-                            return Value::array(std::move(arr));
+                            return make_value(ValueKindConstant<VK::Array>(), std::move(arr));
                         }
                     }
                     else if (current == '/')
@@ -962,7 +1244,7 @@ namespace vcpkg::Json
                 Checks::check_exit(VCPKG_LINE_INFO, current == '{');
                 next();
 
-                Object obj;
+                Object obj = ArenaBuilder::make_object(arena_);
                 bool first = true;
                 for (;;)
                 {
@@ -976,7 +1258,7 @@ namespace vcpkg::Json
                     else if (current == '}')
                     {
                         next();
-                        return Value::object(std::move(obj));
+                        return make_value(ValueKindConstant<VK::Object>(), std::move(obj));
                     }
 
                     if (first)
@@ -1036,7 +1318,7 @@ namespace vcpkg::Json
                 {
                     case '{': return parse_object();
                     case '[': return parse_array();
-                    case '"': return Value::string(parse_string());
+                    case '"': return parse_string_value();
                     case 'n':
                     case 't':
                     case 'f': return parse_keyword();
@@ -1066,28 +1348,55 @@ namespace vcpkg::Json
 
                 json.remove_bom();
 
-                auto parser = Parser(json, origin, {1, 1});
-
-                auto val = parser.parse_value();
-
-                parser.skip_whitespace();
-                if (!parser.at_eof())
+                auto parser = Parser(json, origin, {1, 1}, nullptr);
+                auto val = parser.parse_root();
+                if (parser.messages().any_errors())
                 {
-                    parser.add_error(msg::format(msgUnexpectedEOFExpectedChar));
+                    return parser.messages().join();
                 }
 
+                return ParsedJson{std::move(val), parser.style()};
+            }
+
+            static ExpectedL<Document> parse_document(std::string&& text, StringView origin)
+            {
+                StatsTimer t(g_json_parsing_stats);
+
+                Document doc;
+                auto arena = ArenaBuilder::make_arena(doc, std::move(text));
+                StringView json = arena->text;
+                json.remove_bom();
+
+                auto parser = Parser(json, origin, {1, 1}, arena);
+                doc.value = parser.parse_root();
                 if (parser.messages().any_errors())
                 {
                     return parser.messages().join();
                 }
 
-                return ParsedJson{std::move(val), parser.style()};
+                doc.style = parser.style();
+                return doc;
+            }
+
+            Value parse_root() noexcept
+            {
+                auto val = parse_value();
+
+                skip_whitespace();
+                if (!at_eof())
+                {
+                    add_error(msg::format(msgUnexpectedEOFExpectedChar));
+                }
+
+                return val;
             }
 
             JsonStyle style() const noexcept { return style_; }
 
         private:
             JsonStyle style_;
+            // null when parsing values that own their storage
+            JsonArena* arena_;
         };
     }
 
@@ -1182,6 +1491,23 @@ namespace vcpkg::Json
 
     ExpectedL<ParsedJson> parse(StringView json, StringView origin) { return Parser::parse(json, origin); }
 
+    ExpectedL<Document> parse_document(std::string&& text, StringView origin)
+    {
+        return Parser::parse_document(std::move(text), origin);
+    }
+
+    Document::Document() = default;
+    Document::Document(Document&&) noexcept = default;
+    Document& Document::operator=(Document&& other) noexcept
+    {
+        // the old value must be destroyed before the arena it was allocated from
+        value = std::move(other.value);
+        style = other.style;
+        arena_ = std::move(other.arena_);
+        return *this;
+    }
+    Document::~Document() = default;
+
     ExpectedL<Json::Object> parse_object(StringView text, StringView origin)
     {
         return parse(text, origin).then([&](ParsedJson&& mabeValueIsh) -> ExpectedL<Json::Object> {
@@ -21,7 +21,11 @@
 #include <winbase.h>
 // needed for mingw
 #include <processenv.h>
+
+#pragma comment(lib, "version")
 #else
+#include <sys/utsname.h>
+
 extern char** environ;
 #endif
 
@@ -775,6 +779,40 @@ namespace vcpkg
         return "linux";
 #else
         return "unknown"
+#endif
+    }
+
+    std::string get_host_os_version()
+    {
+#if defined(_WIN32)
+        std::wstring path;
+        path.resize(MAX_PATH);
+        const auto n = GetSystemDirectoryW(path.data(), static_cast<UINT>(path.size()));
+        path.resize(n);
+        path += L"\\kernel32.dll";
+
+        const auto versz = GetFileVersionInfoSizeW(path.c_str(), nullptr);
+        if (versz == 0) return {};
+
+        std::vector<char> verbuf;
+        verbuf.resize(versz);
+
+        if (!GetFileVersionInfoW(path.c_str(), 0, static_cast<DWORD>(verbuf.size()), verbuf.data())) return {};
+
+        void* rootblock;
+        UINT rootblocksize;
+        if (!VerQueryValueW(verbuf.data(), L"\\", &rootblock, &rootblocksize)) return {};
+
+        auto rootblock_ffi = static_cast<VS_FIXEDFILEINFO*>(rootblock);
+
+        return fmt::format("{}.{}.{}",
+                           static_cast<int>(HIWORD(rootblock_ffi->dwProductVersionMS)),
+                           static_cast<int>(LOWORD(rootblock_ffi->dwProductVersionMS)),
+                           static_cast<int>(HIWORD(rootblock_ffi->dwProductVersionLS)));
+#else
+        struct utsname name;
+        if (uname(&name) != 0) return {};
+        return name.release;
 #endif
     }
 }
@@ -8,6 +8,7 @@
 #include <vcpkg/base/json.h>
 #include <vcpkg/base/message_sinks.h>
 #include <vcpkg/base/messages.h>
+#include <vcpkg/base/parallel-algorithms.h>
 #include <vcpkg/base/parse.h>
 #include <vcpkg/base/strings.h>
 #include <vcpkg/base/system.debug.h>
@@ -267,6 +268,7 @@ namespace
 
         bool needs_nuspec_data() const override { return false; }
         bool needs_zip_file() const override { return true; }
+        bool supports_concurrent_pushes() const override { return true; }
 
     private:
         const Filesystem& m_fs;
@@ -295,24 +297,24 @@ namespace
     {
         ZipReadBinaryProvider(ZipTool zip, const Filesystem& fs) : m_zip(std::move(zip)), m_fs(fs) { }
 
-        void fetch(View<const InstallPlanAction*> actions, Span<RestoreResult> out_status) const override
+        void fetch(View<const BinaryPackageReadInfo*> packages, Span<RestoreResult> out_status) const override
         {
             const ElapsedTimer timer;
-            std::vector<Optional<ZipResource>> zip_paths(actions.size(), nullopt);
-            acquire_zips(actions, zip_paths);
+            std::vector<Optional<ZipResource>> zip_paths(packages.size(), nullopt);
+            acquire_zips(packages, zip_paths);
 
-            std::vector<Command> jobs;
+            std::vector<ZipArchiveExtraction> jobs;
             std::vector<size_t> action_idxs;
-            for (size_t i = 0; i < actions.size(); ++i)
+            for (size_t i = 0; i < packages.size(); ++i)
             {
                 if (!zip_paths[i]) continue;
-                const auto& pkg_path = actions[i]->package_dir.value_or_exit(VCPKG_LINE_INFO);
+                const auto& pkg_path = packages[i]->package_dir;
                 clean_prepare_dir(m_fs, pkg_path);
-                jobs.push_back(m_zip.decompress_zip_archive_cmd(pkg_path, zip_paths[i].get()->path));
+                jobs.push_back(ZipArchiveExtraction{zip_paths[i].get()->path, pkg_path});
                 action_idxs.push_back(i);
             }
 
-            auto job_results = decompress_in_parallel(jobs);
+            auto job_results = m_zip.decompress_zip_archives(m_fs, jobs);
 
             for (size_t j = 0; j < jobs.size(); ++j)
             {
@@ -340,11 +342,11 @@ namespace
             }
         }
 
-        // For every action denoted by actions, at corresponding indicies in out_zips, stores a ZipResource indicating
-        // the downloaded location.
+        // For every package denoted by packages, at corresponding indicies in out_zips, stores a ZipResource
+        // indicating the downloaded location.
         //
         // Leaving an Optional disengaged indicates that the cache does not contain the requested zip.
-        virtual void acquire_zips(View<const InstallPlanAction*> actions,
+        virtual void acquire_zips(View<const BinaryPackageReadInfo*> packages,
                                   Span<Optional<ZipResource>> out_zips) const = 0;
 
     protected:
@@ -359,12 +361,12 @@ namespace
         {
         }
 
-        void acquire_zips(View<const InstallPlanAction*> actions,
+        void acquire_zips(View<const BinaryPackageReadInfo*> packages,
                           Span<Optional<ZipResource>> out_zip_paths) const override
         {
-            for (size_t i = 0; i < actions.size(); ++i)
+            for (size_t i = 0; i < packages.size(); ++i)
             {
-                const auto& abi_tag = actions[i]->package_abi().value_or_exit(VCPKG_LINE_INFO);
+                const auto& abi_tag = packages[i]->package_abi;
                 auto archive_path = m_dir / files_archive_subpath(abi_tag);
                 if (m_fs.exists(archive_path, IgnoreErrors{}))
                 {
@@ -398,6 +400,8 @@ namespace
                                msg::path = m_dir);
         }
 
+        bool supports_concurrent_reads() const override { return true; }
+
     private:
         Path m_dir;
     };
@@ -431,6 +435,7 @@ namespace
 
         bool needs_nuspec_data() const override { return false; }
         bool needs_zip_file() const override { return true; }
+        bool supports_concurrent_pushes() const override { return true; }
 
     private:
         std::vector<UrlTemplate> m_urls;
@@ -443,35 +448,51 @@ namespace
                               const Filesystem& fs,
                               const Path& buildtrees,
                               UrlTemplate&& url_template,
-                              const std::vector<std::string>& secrets)
+                              const std::vector<std::string>& secrets,
+                              size_t max_in_flight)
             : ZipReadBinaryProvider(std::move(zip), fs)
             , m_buildtrees(buildtrees)
             , m_url_template(std::move(url_template))
             , m_secrets(secrets)
+            , m_max_in_flight(max_in_flight)
+        {
+        }
+
+        // Splits [0, count) into at most m_max_in_flight contiguous chunks, each handled by its own curl invocation.
+        template<class F>
+        void for_each_chunk(size_t count, F work) const
         {
+            const auto chunks = std::min(count, m_max_in_flight);
+            execute_in_parallel(chunks, chunks, [&](size_t chunk) {
+                work(count * chunk / chunks, count * (chunk + 1) / chunks);
+            });
         }
 
-        void acquire_zips(View<const InstallPlanAction*> actions,
+        void acquire_zips(View<const BinaryPackageReadInfo*> packages,
                           Span<Optional<ZipResource>> out_zip_paths) const override
         {
             std::vector<std::pair<std::string, Path>> url_paths;
-            for (size_t idx = 0; idx < actions.size(); ++idx)
+            for (size_t idx = 0; idx < packages.size(); ++idx)
             {
-                auto&& action = *actions[idx];
-                auto read_info = BinaryPackageReadInfo{action};
+                auto&& read_info = *packages[idx];
                 url_paths.emplace_back(m_url_template.instantiate_variables(read_info),
                                        make_temp_archive_path(m_buildtrees, read_info.spec, read_info.package_abi));
             }
 
-            WarningDiagnosticContext wdc{console_diagnostic_context};
-            auto codes = download_files_no_cache(wdc, url_paths, m_url_template.headers, m_secrets);
-            for (size_t i = 0; i < codes.size(); ++i)
-            {
-                if (codes[i] == 200)
+            for_each_chunk(url_paths.size(), [&](size_t first, size_t last) {
+                WarningDiagnosticContext wdc{console_diagnostic_context};
+                auto codes = download_files_no_cache(
+                    wdc, View<std::pair<std::string, Path>>{url_paths.data() + first, last - first},
+                    m_url_template.headers,
+                    m_secrets);
+                for (size_t i = 0; i < codes.size(); ++i)
                 {
-                    out_zip_paths[i].emplace(std::move(url_paths[i].second), RemoveWhen::always);
+                    if (codes[i] == 200)
+                    {
+                        out_zip_paths[first + i].emplace(std::move(url_paths[first + i].second), RemoveWhen::always);
+                    }
                 }
-            }
+            });
         }
 
         void precheck(View<const InstallPlanAction*> actions, Span<CacheAvailability> out_status) const override
@@ -482,17 +503,20 @@ namespace
                 urls.push_back(m_url_template.instantiate_variables(BinaryPackageReadInfo{*actions[idx]}));
             }
 
-            WarningDiagnosticContext wdc{console_diagnostic_context};
-            auto codes = url_heads(wdc, urls, {}, m_secrets);
-            for (size_t i = 0; i < codes.size(); ++i)
-            {
-                out_status[i] = codes[i] == 200 ? CacheAvailability::available : CacheAvailability::unavailable;
-            }
+            for_each_chunk(urls.size(), [&](size_t first, size_t last) {
+                WarningDiagnosticContext wdc{console_diagnostic_context};
+                auto codes = url_heads(wdc, View<std::string>{urls.data() + first, last - first}, {}, m_secrets);
+                for (size_t i = 0; i < codes.size(); ++i)
+                {
+                    out_status[first + i] =
+                        codes[i] == 200 ? CacheAvailability::available : CacheAvailability::unavailable;
+                }
 
-            for (size_t i = codes.size(); i < out_status.size(); ++i)
-            {
-                out_status[i] = CacheAvailability::unavailable;
-            }
+                for (size_t i = first + codes.size(); i < last; ++i)
+                {
+                    out_status[i] = CacheAvailability::unavailable;
+                }
+            });
         }
 
         LocalizedString restored_message(size_t count,
@@ -501,9 +525,12 @@ namespace
             return msg::format(msgRestoredPackagesFromHTTP, msg::count = count, msg::elapsed = ElapsedTime(elapsed));
         }
 
+        bool supports_concurrent_reads() const override { return true; }
+
         Path m_buildtrees;
         UrlTemplate m_url_template;
         std::vector<std::string> m_secrets;
+        size_t m_max_in_flight;
     };
 
     struct NuGetSource
@@ -708,21 +735,24 @@ namespace
             return msg::format(msgRestoredPackagesFromNuGet, msg::count = count, msg::elapsed = ElapsedTime(elapsed));
         }
 
-        void fetch(View<const InstallPlanAction*> actions, Span<RestoreResult> out_status) const override
+        // all NuGet providers share packages.config and the nuget.exe output directory
+        bool supports_concurrent_reads() const override { return false; }
+
+        void fetch(View<const BinaryPackageReadInfo*> packages, Span<RestoreResult> out_status) const override
         {
             auto packages_config = m_buildtrees / "packages.config";
-            auto refs =
-                Util::fmap(actions, [this](const InstallPlanAction* p) { return make_nugetref(*p, m_nuget_prefix); });
+            auto refs = Util::fmap(packages,
+                                   [this](const BinaryPackageReadInfo* p) { return make_feedref(*p, m_nuget_prefix); });
             m_fs.write_contents(packages_config, generate_packages_config(refs), VCPKG_LINE_INFO);
             m_cmd.install(out_sink, packages_config, m_packages, m_src);
-            for (size_t i = 0; i < actions.size(); ++i)
+            for (size_t i = 0; i < packages.size(); ++i)
             {
                 // nuget.exe provides the nupkg file and the unpacked folder
                 const auto nupkg_path = m_packages / refs[i].id / refs[i].id + ".nupkg";
                 if (m_fs.exists(nupkg_path, IgnoreErrors{}))
                 {
                     m_fs.remove(nupkg_path, VCPKG_LINE_INFO);
-                    const auto nuget_dir = actions[i]->spec.dir();
+                    const auto nuget_dir = packages[i]->spec.dir();
                     if (nuget_dir != refs[i].id)
                     {
                         const auto path_from = m_packages / refs[i].id;
@@ -750,6 +780,8 @@ namespace
 
         bool needs_nuspec_data() const override { return true; }
         bool needs_zip_file() const override { return false; }
+        // nuget.exe shares its local caches and configuration between invocations
+        bool supports_concurrent_pushes() const override { return false; }
 
         size_t push_success(const BinaryPackageWriteInfo& request, MessageSink& msg_sink) override
         {
@@ -857,11 +889,13 @@ namespace
                               const Filesystem& fs,
                               const Path& buildtrees,
                               std::string&& prefix,
-                              const std::shared_ptr<const IObjectStorageTool>& tool)
+                              const std::shared_ptr<const IObjectStorageTool>& tool,
+                              size_t max_in_flight)
             : ZipReadBinaryProvider(std::move(zip), fs)
             , m_buildtrees(buildtrees)
             , m_prefix(std::move(prefix))
             , m_tool(tool)
+            , m_max_in_flight(max_in_flight)
         {
         }
 
@@ -870,14 +904,14 @@ namespace
             return Strings::concat(prefix, abi, ".zip");
         }
 
-        void acquire_zips(View<const InstallPlanAction*> actions,
+        void acquire_zips(View<const BinaryPackageReadInfo*> packages,
                           Span<Optional<ZipResource>> out_zip_paths) const override
         {
-            for (size_t idx = 0; idx < actions.size(); ++idx)
-            {
-                auto&& action = *actions[idx];
-                const auto& abi = action.package_abi().value_or_exit(VCPKG_LINE_INFO);
-                auto tmp = make_temp_archive_path(m_buildtrees, action.spec, abi);
+            // each object is a separate tool invocation, so keep up to m_max_in_flight of them running
+            execute_in_parallel(packages.size(), m_max_in_flight, [&](size_t idx) {
+                auto&& package = *packages[idx];
+                const auto& abi = package.package_abi;
+                auto tmp = make_temp_archive_path(m_buildtrees, package.spec, abi);
                 auto res = m_tool->download_file(make_object_path(m_prefix, abi), tmp);
                 if (auto cache_result = res.get())
                 {
@@ -890,13 +924,12 @@ namespace
                 {
                     msg::println_warning(res.error());
                 }
-            }
+            });
         }
 
         void precheck(View<const InstallPlanAction*> actions, Span<CacheAvailability> cache_status) const override
         {
-            for (size_t idx = 0; idx < actions.size(); ++idx)
-            {
+            execute_in_parallel(actions.size(), m_max_in_flight, [&](size_t idx) {
                 auto&& action = *actions[idx];
                 const auto& abi = action.package_abi().value_or_exit(VCPKG_LINE_INFO);
                 auto maybe_res = m_tool->stat(make_object_path(m_prefix, abi));
@@ -908,7 +941,7 @@ namespace
                 {
                     cache_status[idx] = CacheAvailability::unavailable;
                 }
-            }
+            });
         }
 
         LocalizedString restored_message(size_t count,
@@ -917,9 +950,12 @@ namespace
             return m_tool->restored_message(count, elapsed);
         }
 
+        bool supports_concurrent_reads() const override { return true; }
+
         Path m_buildtrees;
         std::string m_prefix;
         std::shared_ptr<const IObjectStorageTool> m_tool;
+        size_t m_max_in_flight;
     };
     struct ObjectStoragePushProvider : IWriteBinaryProvider
     {
@@ -955,6 +991,7 @@ namespace
 
         bool needs_nuspec_data() const override { return false; }
         bool needs_zip_file() const override { return true; }
+        bool supports_concurrent_pushes() const override { return true; }
 
         std::vector<std::string> m_prefixes;
         std::shared_ptr<const IObjectStorageTool> m_tool;
@@ -1227,6 +1264,7 @@ namespace
 
         bool needs_nuspec_data() const override { return false; }
         bool needs_zip_file() const override { return true; }
+        bool supports_concurrent_pushes() const override { return false; }
 
     private:
         AzureUpkgTool m_azure_tool;
@@ -1258,12 +1296,14 @@ namespace
             return msg::format(msgRestoredPackagesFromAZUPKG, msg::count = count, msg::elapsed = ElapsedTime(elapsed));
         }
 
-        void acquire_zips(View<const InstallPlanAction*> actions, Span<Optional<ZipResource>> out_zips) const override
+        bool supports_concurrent_reads() const override { return true; }
+
+        void acquire_zips(View<const BinaryPackageReadInfo*> packages,
+                          Span<Optional<ZipResource>> out_zips) const override
         {
-            for (size_t i = 0; i < actions.size(); ++i)
+            for (size_t i = 0; i < packages.size(); ++i)
             {
-                const auto& action = *actions[i];
-                const auto info = BinaryPackageReadInfo{action};
+                const auto& info = *packages[i];
                 const auto ref = make_feedref(info, "");
 
                 Path temp_dir = m_buildtrees / fmt::format("upkg_download_{}", info.package_abi);
@@ -1877,10 +1917,267 @@ namespace
             }
         }
     };
+
+    Optional<size_t> parse_thread_count(const Optional<std::string>& maybe_raw,
+                                        StringLiteral option,
+                                        size_t default_count,
+                                        MessageSink& status_sink)
+    {
+        if (auto raw = maybe_raw.get())
+        {
+            auto maybe_count = Strings::strto<int>(*raw);
+            if (!maybe_count || *maybe_count.get() <= 0)
+            {
+                status_sink.println(
+                    Color::error,
+                    msg::format(msgOptionMustBePositiveInteger, msg::option = fmt::format("x-{}", option)));
+                return nullopt;
+            }
+
+            return static_cast<size_t>(*maybe_count.get());
+        }
+
+        return default_count;
+    }
+
+    // Runs work(provider_index) for each index in `providers_to_run`, with every provider that supports concurrent
+    // reads on its own thread and the remaining providers taking turns on one more.
+    template<class F>
+    void for_each_read_provider_concurrently(View<std::unique_ptr<IReadBinaryProvider>> providers,
+                                             View<size_t> providers_to_run,
+                                             F work)
+    {
+        std::vector<std::vector<size_t>> lanes;
+        std::vector<size_t> serial_lane;
+        for (auto provider_idx : providers_to_run)
+        {
+            if (providers[provider_idx]->supports_concurrent_reads())
+            {
+                lanes.push_back({provider_idx});
+            }
+            else
+            {
+                serial_lane.push_back(provider_idx);
+            }
+        }
+
+        if (!serial_lane.empty())
+        {
+            lanes.push_back(std::move(serial_lane));
+        }
+
+        execute_in_parallel(lanes.size(), lanes.size(), [&](size_t lane_idx) {
+            for (auto provider_idx : lanes[lane_idx])
+            {
+                work(provider_idx);
+            }
+        });
+    }
+
+    // Asks every read provider about the entries it has not already ruled out, all providers at once. The answers are
+    // applied in configuration order, so the first configured provider that has an entry becomes its source, the same
+    // as when the providers were asked one after another.
+    void precheck_read_providers(View<std::unique_ptr<IReadBinaryProvider>> providers,
+                                 View<const InstallPlanAction*> actions,
+                                 View<CacheStatus*> statuses)
+    {
+        std::vector<std::vector<size_t>> indexes(providers.size());
+        std::vector<std::vector<const InstallPlanAction*>> action_ptrs(providers.size());
+        std::vector<std::vector<CacheAvailability>> cache_results(providers.size());
+        std::vector<size_t> providers_to_run;
+        for (size_t provider_idx = 0; provider_idx < providers.size(); ++provider_idx)
+        {
+            for (size_t i = 0; i < actions.size(); ++i)
+            {
+                if (statuses[i]->should_attempt_precheck(providers[provider_idx].get()))
+                {
+                    indexes[provider_idx].push_back(i);
+                    action_ptrs[provider_idx].push_back(actions[i]);
+                }
+            }
+
+            if (!action_ptrs[provider_idx].empty())
+            {
+                cache_results[provider_idx].assign(action_ptrs[provider_idx].size(), CacheAvailability::unknown);
+                providers_to_run.push_back(provider_idx);
+            }
+        }
+
+        for_each_read_provider_concurrently(providers, providers_to_run, [&](size_t provider_idx) {
+            providers[provider_idx]->precheck(action_ptrs[provider_idx], cache_results[provider_idx]);
+        });
+
+        for (auto provider_idx : providers_to_run)
+        {
+            const auto provider = providers[provider_idx].get();
+            for (size_t j = 0; j < indexes[provider_idx].size(); ++j)
+            {
+                auto& this_status = *statuses[indexes[provider_idx][j]];
+                if (cache_results[provider_idx][j] == CacheAvailability::available)
+                {
+                    this_status.mark_available(provider);
+                }
+                else if (cache_results[provider_idx][j] == CacheAvailability::unavailable)
+                {
+                    this_status.mark_unavailable(provider);
+                }
+            }
+        }
+    }
+
+    // How many packages each read provider restored and how long that took, summed over all batches of a fetch.
+    struct FetchStatistics
+    {
+        explicit FetchStatistics(size_t provider_count)
+            : num_restored(provider_count), elapsed(provider_count), attempted(provider_count)
+        {
+        }
+
+        std::vector<size_t> num_restored;
+        std::vector<std::chrono::high_resolution_clock::duration> elapsed;
+        std::vector<bool> attempted;
+    };
+
+    void fetch_from_read_providers(View<std::unique_ptr<IReadBinaryProvider>> providers,
+                                   View<const BinaryPackageReadInfo*> packages,
+                                   View<CacheStatus*> statuses,
+                                   FetchStatistics& stats)
+    {
+        // Packages which an earlier precheck found in a provider go to that provider, so providers download at the
+        // same time without asking them all again first.
+        //
+        // Each round hands every package not yet restored to the first provider that may still have it, so no
+        // package is ever restored by two providers at once. Providers that fail to restore a package are recorded
+        // as not having it, so every round either finishes packages or rules out providers.
+        std::vector<std::vector<const BinaryPackageReadInfo*>> round_packages(providers.size());
+        std::vector<std::vector<CacheStatus*>> round_statuses(providers.size());
+        std::vector<std::vector<RestoreResult>> restores(providers.size());
+        std::vector<size_t> providers_to_run;
+        for (;;)
+        {
+            providers_to_run.clear();
+            for (size_t provider_idx = 0; provider_idx < providers.size(); ++provider_idx)
+            {
+                round_packages[provider_idx].clear();
+                round_statuses[provider_idx].clear();
+            }
+
+            for (size_t i = 0; i < packages.size(); ++i)
+            {
+                for (size_t provider_idx = 0; provider_idx < providers.size(); ++provider_idx)
+                {
+                    if (statuses[i]->should_attempt_restore(providers[provider_idx].get()))
+                    {
+                        round_packages[provider_idx].push_back(packages[i]);
+                        round_statuses[provider_idx].push_back(statuses[i]);
+                        break;
+                    }
+                }
+            }
+
+            for (size_t provider_idx = 0; provider_idx < providers.size(); ++provider_idx)
+            {
+                if (!round_packages[provider_idx].empty())
+                {
+                    restores[provider_idx].assign(round_packages[provider_idx].size(), RestoreResult::unavailable);
+                    providers_to_run.push_back(provider_idx);
+                }
+            }
+
+            if (providers_to_run.empty()) break;
+
+            for_each_read_provider_concurrently(providers, providers_to_run, [&](size_t provider_idx) {
+                ElapsedTimer timer;
+                providers[provider_idx]->fetch(round_packages[provider_idx], restores[provider_idx]);
+                stats.elapsed[provider_idx] += timer.elapsed().as<std::chrono::high_resolution_clock::duration>();
+            });
+
+            for (auto provider_idx : providers_to_run)
+            {
+                stats.attempted[provider_idx] = true;
+                for (size_t j = 0; j < restores[provider_idx].size(); ++j)
+                {
+                    if (restores[provider_idx][j] == RestoreResult::unavailable)
+                    {
+                        round_statuses[provider_idx][j]->mark_unavailable(providers[provider_idx].get());
+                    }
+                    else
+                    {
+                        round_statuses[provider_idx][j]->mark_restored();
+                        ++stats.num_restored[provider_idx];
+                    }
+                }
+            }
+        }
+    }
+
+    // The first batch of a fetch is small so that installing can start soon; later batches grow so that each still
+    // downloads many packages at once.
+    constexpr size_t FirstFetchBatchSize = 8;
+    constexpr size_t MaxFetchBatchSize = 128;
+    // How many restored batches may wait to be installed before the background fetch pauses.
+    constexpr size_t MaxFetchBatchesAhead = 2;
 }
 
 namespace vcpkg
 {
+    // Restores the batches of a fetch in order on a background thread. A batch owns copies of what the providers
+    // need of each action, so the actions passed to fetch may be destroyed while it runs. The statuses of a batch are
+    // private copies of the entries in ReadOnlyBinaryCache::m_status; only the background thread touches them until
+    // the batch is complete, after which the thread owning the cache merges them back.
+    struct BinaryCacheFetchPipeline
+    {
+        struct Batch
+        {
+            std::vector<BinaryPackageReadInfo> packages;
+            std::vector<CacheStatus> statuses;
+        };
+
+        explicit BinaryCacheFetchPipeline(size_t provider_count) : stats(provider_count) { }
+
+        void run(View<std::unique_ptr<IReadBinaryProvider>> providers)
+        {
+            for (size_t batch_idx = 0; batch_idx < batches.size(); ++batch_idx)
+            {
+                {
+                    std::unique_lock<std::mutex> lock(mtx);
+                    cv.wait(lock, [&] { return cancelled || batch_idx < merged + MaxFetchBatchesAhead; });
+                    if (cancelled) return;
+                }
+
+                auto& batch = batches[batch_idx];
+                std::vector<const BinaryPackageReadInfo*> packages;
+                std::vector<CacheStatus*> statuses;
+                for (size_t i = 0; i < batch.packages.size(); ++i)
+                {
+                    packages.push_back(&batch.packages[i]);
+                    statuses.push_back(&batch.statuses[i]);
+                }
+
+                fetch_from_read_providers(providers, packages, statuses, stats);
+                {
+                    std::lock_guard<std::mutex> lock(mtx);
+                    ++completed;
+                }
+
+                cv.notify_all();
+            }
+        }
+
+        std::vector<Batch> batches;
+        std::unordered_map<std::string, size_t> batch_indices;
+        // only touched by the background thread until it is joined
+        FetchStatistics stats;
+        std::thread worker;
+
+        std::mutex mtx;
+        std::condition_variable cv;
+        size_t completed = 0;
+        // only written by the thread owning the cache
+        size_t merged = 0;
+        bool cancelled = false;
+    };
+
     LocalizedString UrlTemplate::valid() const
     {
         BufferedDiagnosticContext bdc{out_sink};
@@ -1970,55 +2267,135 @@ namespace vcpkg
                 get_environment_variable(EnvironmentVariableGitHubSha).value_or("")};
     }
 
+    ReadOnlyBinaryCache::ReadOnlyBinaryCache() = default;
+
+    ReadOnlyBinaryCache::~ReadOnlyBinaryCache() { cancel_fetch(); }
+
     void ReadOnlyBinaryCache::fetch(View<InstallPlanAction> actions)
     {
-        std::vector<const InstallPlanAction*> action_ptrs;
-        std::vector<RestoreResult> restores;
-        std::vector<CacheStatus*> statuses;
-        for (auto&& provider : m_config.read)
+        wait_for_fetch();
+        if (m_config.read.empty()) return;
+
+        auto pipeline = std::make_unique<BinaryCacheFetchPipeline>(m_config.read.size());
+        size_t batch_size = FirstFetchBatchSize;
+        for (auto&& action : actions)
         {
-            action_ptrs.clear();
-            restores.clear();
-            statuses.clear();
-            for (size_t i = 0; i < actions.size(); ++i)
+            if (auto abi = action.package_abi().get())
             {
-                if (auto abi = actions[i].package_abi().get())
+                const CacheStatus& status = m_status[*abi];
+                if (status.is_restored())
+                {
+                    continue;
+                }
+
+                auto& batches = pipeline->batches;
+                if (batches.empty() || batches.back().packages.size() == batch_size)
                 {
-                    CacheStatus& status = m_status[*abi];
-                    if (status.should_attempt_restore(provider.get()))
+                    if (!batches.empty())
                     {
-                        action_ptrs.push_back(&actions[i]);
-                        restores.push_back(RestoreResult::unavailable);
-                        statuses.push_back(&status);
+                        batch_size = std::min(batch_size * 2, MaxFetchBatchSize);
                     }
+
+                    batches.emplace_back();
                 }
+
+                batches.back().packages.emplace_back(action);
+                batches.back().statuses.push_back(status);
+                pipeline->batch_indices.emplace(*abi, batches.size() - 1);
             }
-            if (action_ptrs.empty()) continue;
+        }
+
+        if (pipeline->batches.empty()) return;
+
+        auto& providers = m_config.read;
+        pipeline->worker = std::thread([pipeline = pipeline.get(), &providers]() { pipeline->run(providers); });
+        m_fetch = std::move(pipeline);
+    }
+
+    void ReadOnlyBinaryCache::wait_for_fetch(const std::string& abi)
+    {
+        if (!m_fetch) return;
+        auto it = m_fetch->batch_indices.find(abi);
+        if (it == m_fetch->batch_indices.end()) return;
+        const auto batch_idx = it->second;
+        while (m_fetch && m_fetch->merged <= batch_idx)
+        {
+            merge_fetched_batch();
+        }
+    }
+
+    void ReadOnlyBinaryCache::wait_for_fetch()
+    {
+        while (m_fetch)
+        {
+            merge_fetched_batch();
+        }
+    }
+
+    void ReadOnlyBinaryCache::merge_fetched_batch()
+    {
+        auto& pipeline = *m_fetch;
+        size_t batch_idx;
+        {
+            std::unique_lock<std::mutex> lock(pipeline.mtx);
+            pipeline.cv.wait(lock, [&] { return pipeline.completed > pipeline.merged; });
+            batch_idx = pipeline.merged;
+        }
+
+        auto& batch = pipeline.batches[batch_idx];
+        for (size_t i = 0; i < batch.packages.size(); ++i)
+        {
+            m_status[batch.packages[i].package_abi] = std::move(batch.statuses[i]);
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(pipeline.mtx);
+            ++pipeline.merged;
+        }
+
+        pipeline.cv.notify_all();
+        if (pipeline.merged != pipeline.batches.size())
+        {
+            return;
+        }
 
-            ElapsedTimer timer;
-            provider->fetch(action_ptrs, restores);
-            size_t num_restored = 0;
-            for (size_t i = 0; i < restores.size(); ++i)
+        finish_fetch();
+    }
+
+    void ReadOnlyBinaryCache::cancel_fetch()
+    {
+        if (!m_fetch) return;
+        {
+            std::lock_guard<std::mutex> lock(m_fetch->mtx);
+            m_fetch->cancelled = true;
+        }
+
+        m_fetch->cv.notify_all();
+        finish_fetch();
+    }
+
+    void ReadOnlyBinaryCache::finish_fetch()
+    {
+        auto& pipeline = *m_fetch;
+        pipeline.worker.join();
+        const auto& providers = m_config.read;
+        for (size_t provider_idx = 0; provider_idx < providers.size(); ++provider_idx)
+        {
+            if (pipeline.stats.attempted[provider_idx])
             {
-                if (restores[i] == RestoreResult::unavailable)
-                {
-                    statuses[i]->mark_unavailable(provider.get());
-                }
-                else
-                {
-                    statuses[i]->mark_restored();
-                    ++num_restored;
-                }
+                msg::println(providers[provider_idx]->restored_message(pipeline.stats.num_restored[provider_idx],
+                                                                       pipeline.stats.elapsed[provider_idx]));
             }
-            msg::println(provider->restored_message(
-                num_restored, timer.elapsed().as<std::chrono::high_resolution_clock::duration>()));
         }
+
+        m_fetch.reset();
     }
 
-    bool ReadOnlyBinaryCache::is_restored(const InstallPlanAction& action) const
+    bool ReadOnlyBinaryCache::is_restored(const InstallPlanAction& action)
     {
         if (auto abi = action.package_abi().get())
         {
+            wait_for_fetch(*abi);
             auto it = m_status.find(*abi);
             if (it != m_status.end()) return it->second.is_restored();
         }
@@ -2027,59 +2404,47 @@ namespace vcpkg
 
     void ReadOnlyBinaryCache::install_read_provider(std::unique_ptr<IReadBinaryProvider>&& provider)
     {
+        wait_for_fetch();
         m_config.read.push_back(std::move(provider));
     }
 
     void ReadOnlyBinaryCache::mark_all_unrestored()
     {
+        wait_for_fetch();
         for (auto& entry : m_status)
         {
             entry.second.mark_unrestored();
         }
     }
 
+    void ReadOnlyBinaryCache::mark_restored(const InstallPlanAction& action)
+    {
+        if (auto abi = action.package_abi().get())
+        {
+            wait_for_fetch(*abi);
+            m_status[*abi].mark_restored();
+        }
+    }
+
+    void ReadOnlyBinaryCache::mark_unknown(const InstallPlanAction& action)
+    {
+        if (auto abi = action.package_abi().get())
+        {
+            wait_for_fetch(*abi);
+            m_status[*abi].mark_unknown();
+        }
+    }
+
     std::vector<CacheAvailability> ReadOnlyBinaryCache::precheck(View<const InstallPlanAction*> actions)
     {
+        wait_for_fetch();
         std::vector<CacheStatus*> statuses = Util::fmap(actions, [this](const auto& action) {
             Checks::check_exit(VCPKG_LINE_INFO, action && action->package_abi());
             ASSUME(action);
             return &m_status[*action->package_abi().get()];
         });
 
-        std::vector<const InstallPlanAction*> action_ptrs;
-        std::vector<CacheAvailability> cache_result;
-        std::vector<size_t> indexes;
-        for (auto&& provider : m_config.read)
-        {
-            action_ptrs.clear();
-            cache_result.clear();
-            indexes.clear();
-            for (size_t i = 0; i < actions.size(); ++i)
-            {
-                if (statuses[i]->should_attempt_precheck(provider.get()))
-                {
-                    action_ptrs.push_back(actions[i]);
-                    cache_result.push_back(CacheAvailability::unknown);
-                    indexes.push_back(i);
-                }
-            }
-            if (action_ptrs.empty()) continue;
-
-            provider->precheck(action_ptrs, cache_result);
-
-            for (size_t i = 0; i < action_ptrs.size(); ++i)
-            {
-                auto&& this_status = m_status[*action_ptrs[i]->package_abi().get()];
-                if (cache_result[i] == CacheAvailability::available)
-                {
-                    this_status.mark_available(provider.get());
-                }
-                else if (cache_result[i] == CacheAvailability::unavailable)
-                {
-                    this_status.mark_unavailable(provider.get());
-                }
-            }
-        }
+        precheck_read_providers(m_config.read, actions, statuses);
 
         return Util::fmap(statuses, [](CacheStatus* s) {
             return s->get_available_provider() ? CacheAvailability::available : CacheAvailability::unavailable;
@@ -2149,6 +2514,17 @@ namespace vcpkg
                                         const VcpkgPaths& paths,
                                         MessageSink& status_sink)
     {
+        const auto maybe_read_threads =
+            parse_thread_count(args.binary_cache_read_threads, SwitchBinaryCacheReadThreads, 4, status_sink);
+        const auto maybe_push_threads =
+            parse_thread_count(args.binary_cache_push_threads, SwitchBinaryCachePushThreads, 1, status_sink);
+        const auto read_threads = maybe_read_threads.get();
+        const auto push_threads = maybe_push_threads.get();
+        if (!read_threads || !push_threads)
+        {
+            return false;
+        }
+
         if (args.binary_caching_enabled())
         {
             if (Debug::g_debugging)
@@ -2250,25 +2626,26 @@ namespace vcpkg
                 for (auto&& url : s.url_templates_to_get)
                 {
                     m_config.read.push_back(
-                        std::make_unique<HttpGetBinaryProvider>(zip_tool, fs, buildtrees, std::move(url), s.secrets));
+                        std::make_unique<HttpGetBinaryProvider>(
+                        zip_tool, fs, buildtrees, std::move(url), s.secrets, *read_threads));
                 }
 
                 for (auto&& prefix : s.gcs_read_prefixes)
                 {
-                    m_config.read.push_back(
-                        std::make_unique<ObjectStorageProvider>(zip_tool, fs, buildtrees, std::move(prefix), gcs_tool));
+                    m_config.read.push_back(std::make_unique<ObjectStorageProvider>(
+                        zip_tool, fs, buildtrees, std::move(prefix), gcs_tool, *read_threads));
                 }
 
                 for (auto&& prefix : s.aws_read_prefixes)
                 {
-                    m_config.read.push_back(
-                        std::make_unique<ObjectStorageProvider>(zip_tool, fs, buildtrees, std::move(prefix), aws_tool));
+                    m_config.read.push_back(std::make_unique<ObjectStorageProvider>(
+                        zip_tool, fs, buildtrees, std::move(prefix), aws_tool, *read_threads));
                 }
 
                 for (auto&& prefix : s.cos_read_prefixes)
                 {
-                    m_config.read.push_back(
-                        std::make_unique<ObjectStorageProvider>(zip_tool, fs, buildtrees, std::move(prefix), cos_tool));
+                    m_config.read.push_back(std::make_unique<ObjectStorageProvider>(
+                        zip_tool, fs, buildtrees, std::move(prefix), cos_tool, *read_threads));
                 }
 
                 for (auto&& src : s.upkg_templates_to_get)
@@ -2334,18 +2711,21 @@ namespace vcpkg
             m_zip_tool.setup(paths.get_tool_cache(), status_sink);
         }
 
+        if (!m_config.write.empty())
+        {
+            start_push_threads(*push_threads);
+        }
+
         return true;
     }
-    BinaryCache::BinaryCache(const Filesystem& fs)
-        : m_fs(fs), m_bg_msg_sink(stdout_sink), m_push_thread(&BinaryCache::push_thread_main, this)
-    {
-    }
+    BinaryCache::BinaryCache(const Filesystem& fs) : m_fs(fs), m_bg_msg_sink(stdout_sink) { }
     BinaryCache::~BinaryCache() { wait_for_async_complete_and_join(); }
 
     void BinaryCache::push_success(CleanPackages clean_packages, const InstallPlanAction& action)
     {
         if (auto abi = action.package_abi().get())
         {
+            wait_for_fetch(*abi);
             bool restored;
             auto it = m_status.find(*abi);
             if (it == m_status.end())
@@ -2382,7 +2762,10 @@ namespace vcpkg
                 msg::println(msg::format(msgSubmittingBinaryCacheBackground,
                                          msg::spec = action.display_name(),
                                          msg::count = m_config.write.size()));
-                m_actions_to_push.push(ActionToPush{std::move(request), clean_packages});
+                auto action_to_push = std::make_shared<ActionToPush>(std::move(request), clean_packages);
+                std::lock_guard<std::mutex> lock(m_push_mtx);
+                m_push_tasks.push_back(PushTask{PushStage::Compress, std::move(action_to_push), 0});
+                m_push_cv.notify_one();
                 return;
             }
         }
@@ -2397,6 +2780,8 @@ namespace vcpkg
 
     void BinaryCache::wait_for_async_complete_and_join()
     {
+        // packages still being restored will not be installed now, so don't download the rest of them
+        cancel_fetch();
         m_bg_msg_sink.print_published();
         auto incomplete_count = m_synchronizer.fetch_incomplete_mark_submission_complete();
         if (incomplete_count != 0)
@@ -2405,21 +2790,81 @@ namespace vcpkg
         }
 
         m_bg_msg_sink.publish_directly_to_out_sink();
-        m_actions_to_push.stop();
-        if (m_push_thread.joinable())
         {
-            m_push_thread.join();
+            std::lock_guard<std::mutex> lock(m_push_mtx);
+            m_push_running = false;
+            m_push_cv.notify_all();
+        }
+
+        for (auto&& push_thread : m_push_threads)
+        {
+            if (push_thread.joinable())
+            {
+                push_thread.join();
+            }
         }
     }
 
-    void BinaryCache::push_thread_main()
+    void BinaryCache::start_push_threads(size_t count)
     {
-        std::vector<ActionToPush> my_tasks;
-        while (m_actions_to_push.get_work(my_tasks))
+        if (!m_push_threads.empty())
         {
-            for (auto& action_to_push : my_tasks)
+            return;
+        }
+
+        m_provider_busy.assign(m_config.write.size(), false);
+        m_push_threads.reserve(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            m_push_threads.emplace_back(&BinaryCache::push_thread_main, this);
+        }
+    }
+
+    // Selects the next task to run, preferring later stages so that zip files and packages directories don't pile up
+    // while compression runs ahead of the uploads. Must be called with m_push_mtx held.
+    bool BinaryCache::take_push_task(PushTask& task)
+    {
+        auto best = m_push_tasks.end();
+        for (auto it = m_push_tasks.begin(); it != m_push_tasks.end(); ++it)
+        {
+            if (it->stage == PushStage::Upload && m_provider_busy[it->provider])
             {
-                ElapsedTimer timer;
+                continue;
+            }
+
+            if (best == m_push_tasks.end() || it->stage > best->stage)
+            {
+                best = it;
+                if (best->stage == PushStage::Clean)
+                {
+                    break;
+                }
+            }
+        }
+
+        if (best == m_push_tasks.end())
+        {
+            return false;
+        }
+
+        task = std::move(*best);
+        m_push_tasks.erase(best);
+        if (task.stage == PushStage::Upload && !m_config.write[task.provider]->supports_concurrent_pushes())
+        {
+            m_provider_busy[task.provider] = true;
+        }
+
+        ++m_push_tasks_running;
+        return true;
+    }
+
+    void BinaryCache::run_push_task(PushTask& task)
+    {
+        auto& action_to_push = *task.action;
+        switch (task.stage)
+        {
+            case PushStage::Compress:
+                action_to_push.timer.emplace();
                 if (m_needs_zip_file)
                 {
                     Path zip_path = action_to_push.request.package_dir + ".zip";
@@ -2430,15 +2875,14 @@ namespace vcpkg
                     }
                 }
 
-                size_t num_destinations = 0;
-                for (auto&& provider : m_config.write)
-                {
-                    if (!provider->needs_zip_file() || action_to_push.request.zip_path.has_value())
-                    {
-                        num_destinations += provider->push_success(action_to_push.request, m_bg_msg_sink);
-                    }
-                }
-
+                finish_push_task(task, 0);
+                return;
+            case PushStage::Upload:
+                finish_push_task(
+                    task, m_config.write[task.provider]->push_success(action_to_push.request, m_bg_msg_sink));
+                return;
+            case PushStage::Clean:
+            {
                 if (action_to_push.request.zip_path)
                 {
                     m_fs.remove(*action_to_push.request.zip_path.get(), IgnoreErrors{});
@@ -2450,17 +2894,82 @@ namespace vcpkg
                 }
 
                 auto sync_state = m_synchronizer.fetch_add_completed();
-                auto message = msg::format(msgSubmittingBinaryCacheComplete,
-                                           msg::spec = action_to_push.request.display_name,
-                                           msg::count = num_destinations,
-                                           msg::elapsed = timer.elapsed());
+                auto message =
+                    msg::format(msgSubmittingBinaryCacheComplete,
+                                msg::spec = action_to_push.request.display_name,
+                                msg::count = action_to_push.num_destinations,
+                                msg::elapsed = action_to_push.timer.value_or_exit(VCPKG_LINE_INFO).elapsed());
                 if (sync_state.submission_complete)
                 {
                     message.append_raw(fmt::format(" ({}/{})", sync_state.jobs_completed, sync_state.jobs_submitted));
                 }
 
                 m_bg_msg_sink.println(message);
+                finish_push_task(task, 0);
+                return;
             }
+            default: Checks::unreachable(VCPKG_LINE_INFO);
+        }
+    }
+
+    // Records the completion of `task` and submits the tasks for the next stage of its package.
+    void BinaryCache::finish_push_task(const PushTask& task, size_t num_destinations)
+    {
+        auto& action_to_push = *task.action;
+        std::lock_guard<std::mutex> lock(m_push_mtx);
+        --m_push_tasks_running;
+        switch (task.stage)
+        {
+            case PushStage::Compress:
+                for (size_t provider = 0; provider < m_config.write.size(); ++provider)
+                {
+                    if (!m_config.write[provider]->needs_zip_file() || action_to_push.request.zip_path.has_value())
+                    {
+                        ++action_to_push.remaining_uploads;
+                        m_push_tasks.push_back(PushTask{PushStage::Upload, task.action, provider});
+                    }
+                }
+
+                if (action_to_push.remaining_uploads == 0)
+                {
+                    m_push_tasks.push_back(PushTask{PushStage::Clean, task.action, 0});
+                }
+                break;
+            case PushStage::Upload:
+                m_provider_busy[task.provider] = false;
+                action_to_push.num_destinations += num_destinations;
+                if (--action_to_push.remaining_uploads == 0)
+                {
+                    m_push_tasks.push_back(PushTask{PushStage::Clean, task.action, 0});
+                }
+                break;
+            case PushStage::Clean: break;
+            default: Checks::unreachable(VCPKG_LINE_INFO);
+        }
+
+        m_push_cv.notify_all();
+    }
+
+    void BinaryCache::push_thread_main()
+    {
+        std::unique_lock<std::mutex> lock(m_push_mtx);
+        for (;;)
+        {
+            PushTask task;
+            if (take_push_task(task))
+            {
+                lock.unlock();
+                run_push_task(task);
+                lock.lock();
+                continue;
+            }
+
+            if (!m_push_running && m_push_tasks.empty() && m_push_tasks_running == 0)
+            {
+                return;
+            }
+
+            m_push_cv.wait(lock);
         }
     }
 
@@ -2495,6 +3004,12 @@ namespace vcpkg
 
     void CacheStatus::mark_unavailable(const IReadBinaryProvider* sender)
     {
+        if (m_status == CacheStatusState::available && m_available_provider == sender)
+        {
+            m_status = CacheStatusState::unknown;
+            m_available_provider = nullptr;
+        }
+
         if (!Util::Vectors::contains(m_known_unavailable_providers, sender))
         {
             m_known_unavailable_providers.push_back(sender);
@@ -2533,6 +3048,14 @@ namespace vcpkg
         }
     }
 
+    void CacheStatus::mark_unknown() noexcept
+    {
+        if (m_status == CacheStatusState::unknown)
+        {
+            m_known_unavailable_providers.clear();
+        }
+    }
+
     const IReadBinaryProvider* CacheStatus::get_available_provider() const noexcept
     {
         switch (m_status)
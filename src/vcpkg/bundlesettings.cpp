@@ -34,9 +34,10 @@ namespace
     {
         if (auto value = doc.get(field_name))
         {
-            if (auto value_string = value->maybe_string())
+            auto maybe_value_string = value->maybe_string();
+            if (auto value_string = maybe_value_string.get())
             {
-                output = *value_string;
+                output = value_string->to_string();
                 return true;
             }
 
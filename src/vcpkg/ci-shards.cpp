@@ -0,0 +1,544 @@
+#include <vcpkg/base/contractual-constants.h>
+#include <vcpkg/base/json.h>
+#include <vcpkg/base/messages.h>
+#include <vcpkg/base/strings.h>
+#include <vcpkg/base/util.h>
+
+#include <vcpkg/ci-shards.h>
+#include <vcpkg/commands.build.h>
+#include <vcpkg/dependencies.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <set>
+
+using namespace vcpkg;
+
+namespace
+{
+    constexpr StringLiteral CiStateBuild = "*";
+
+    constexpr BuildResult AllBuildResults[] = {
+        BuildResult::Succeeded,
+        BuildResult::BuildFailed,
+        BuildResult::PostBuildChecksFailed,
+        BuildResult::FileConflicts,
+        BuildResult::CascadedDueToMissingDependencies,
+        BuildResult::Excluded,
+        BuildResult::CacheMissing,
+        BuildResult::Downloaded,
+        BuildResult::Removed,
+    };
+
+    Optional<BuildResult> build_result_from_string(StringView text)
+    {
+        for (auto result : AllBuildResults)
+        {
+            if (to_string_locale_invariant(result) == text)
+            {
+                return result;
+            }
+        }
+
+        return nullopt;
+    }
+
+    Optional<std::string> get_string_field(const Json::Object& obj, StringLiteral field)
+    {
+        if (auto value = obj.get(field))
+        {
+            auto maybe_str = value->maybe_string();
+            if (auto str = maybe_str.get())
+            {
+                return str->to_string();
+            }
+        }
+
+        return nullopt;
+    }
+
+    Optional<CiResult> parse_ci_result(const Json::Value& value)
+    {
+        auto obj = value.maybe_object();
+        if (!obj)
+        {
+            return nullopt;
+        }
+
+        auto name = get_string_field(*obj, JsonIdName);
+        auto triplet = get_string_field(*obj, JsonIdTriplet);
+        auto state = get_string_field(*obj, JsonIdState);
+        auto result = get_string_field(*obj, JsonIdResult);
+        auto abi = get_string_field(*obj, JsonIdAbi);
+        auto features = obj->get(JsonIdFeatures);
+        auto elapsed = obj->get(JsonIdElapsedSeconds);
+        auto start_time = obj->get(JsonIdStartTime);
+        auto name_value = name.get();
+        auto triplet_value = triplet.get();
+        auto state_value = state.get();
+        auto result_value = result.get();
+        auto abi_value = abi.get();
+        if (!name_value || !triplet_value || !state_value || !result_value || !abi_value || !features ||
+            !features->is_array() || !elapsed || !elapsed->is_number() || !start_time || !start_time->is_integer())
+        {
+            return nullopt;
+        }
+
+        auto maybe_build_result = build_result_from_string(*result_value);
+        auto build_result = maybe_build_result.get();
+        if (!build_result)
+        {
+            return nullopt;
+        }
+
+        std::vector<std::string> feature_names;
+        for (auto&& feature : features->array(VCPKG_LINE_INFO))
+        {
+            auto maybe_feature_name = feature.maybe_string();
+            auto feature_name = maybe_feature_name.get();
+            if (!feature_name)
+            {
+                return nullopt;
+            }
+
+            feature_names.push_back(feature_name->to_string());
+        }
+
+        return CiResult{
+            PackageSpec{std::move(*name_value), Triplet::from_canonical_name(*triplet_value)},
+            std::move(*state_value),
+            *build_result,
+            std::move(*abi_value),
+            std::move(feature_names),
+            ElapsedTime{std::chrono::duration_cast<ElapsedTime::duration>(
+                std::chrono::duration<double>(elapsed->number(VCPKG_LINE_INFO)))},
+            std::chrono::system_clock::time_point{std::chrono::duration_cast<std::chrono::system_clock::duration>(
+                std::chrono::milliseconds(start_time->integer(VCPKG_LINE_INFO)))}};
+    }
+}
+
+namespace vcpkg
+{
+    Optional<CiShard> parse_ci_shard(StringView text)
+    {
+        auto slash = Util::find(text, '/');
+        if (slash == text.end())
+        {
+            return nullopt;
+        }
+
+        auto maybe_index = Strings::strto<int>(StringView{text.begin(), slash});
+        auto maybe_count = Strings::strto<int>(StringView{slash + 1, text.end()});
+        auto index = maybe_index.get();
+        auto count = maybe_count.get();
+        if (!index || !count || *index < 1 || *index > *count)
+        {
+            return nullopt;
+        }
+
+        return CiShard{static_cast<size_t>(*index - 1), static_cast<size_t>(*count)};
+    }
+
+    std::map<PackageSpec, CiShardTarget> assign_ci_shards(const ActionPlan& action_plan,
+                                                          const std::map<PackageSpec, BuildResult>& known,
+                                                          const std::map<PackageSpec, double>& build_seconds,
+                                                          size_t shard_count)
+    {
+        const auto& actions = action_plan.install_actions;
+        const auto may_build = [&](const InstallPlanAction& action) {
+            if (action.plan_type == InstallPlanType::EXCLUDED)
+            {
+                return false;
+            }
+
+            auto it = known.find(action.spec);
+            return it == known.end() || it->second == BuildResult::Succeeded;
+        };
+
+        std::map<PackageSpec, size_t> action_indices;
+        for (size_t idx = 0; idx < actions.size(); ++idx)
+        {
+            action_indices.emplace(actions[idx].spec, idx);
+        }
+
+        // install_actions are topologically sorted, so dependencies are visited first
+        constexpr size_t word_bits = 64;
+        const size_t words = (actions.size() + word_bits - 1) / word_bits;
+        std::vector<std::vector<std::uint64_t>> all_dependencies(actions.size(), std::vector<std::uint64_t>(words));
+        std::vector<size_t> waves(actions.size(), 0);
+        for (size_t idx = 0; idx < actions.size(); ++idx)
+        {
+            for (auto&& dependency : actions[idx].package_dependencies)
+            {
+                auto it = action_indices.find(dependency);
+                if (it == action_indices.end() || it->second == idx)
+                {
+                    continue;
+                }
+
+                const auto dependency_idx = it->second;
+                auto& dependencies = all_dependencies[idx];
+                dependencies[dependency_idx / word_bits] |= std::uint64_t{1} << (dependency_idx % word_bits);
+                for (size_t word = 0; word < words; ++word)
+                {
+                    dependencies[word] |= all_dependencies[dependency_idx][word];
+                }
+
+                if (may_build(actions[dependency_idx]))
+                {
+                    waves[idx] = std::max(waves[idx], waves[dependency_idx] + 1);
+                }
+            }
+        }
+
+        const auto weight = [&](size_t idx) {
+            size_t dependency_count = 0;
+            for (auto word : all_dependencies[idx])
+            {
+                for (; word; word &= word - 1)
+                {
+                    ++dependency_count;
+                }
+            }
+
+            return static_cast<double>(1 + dependency_count);
+        };
+
+        std::vector<size_t> to_assign;
+        double history_seconds = 0.0;
+        double history_weight = 0.0;
+        for (size_t idx = 0; idx < actions.size(); ++idx)
+        {
+            if (!may_build(actions[idx]))
+            {
+                continue;
+            }
+
+            to_assign.push_back(idx);
+            auto it = build_seconds.find(actions[idx].spec);
+            if (it != build_seconds.end())
+            {
+                history_seconds += it->second;
+                history_weight += weight(idx);
+            }
+        }
+
+        const double seconds_per_weight = history_weight > 0.0 ? history_seconds / history_weight : 1.0;
+        std::vector<double> estimated_seconds(actions.size(), 0.0);
+        for (auto idx : to_assign)
+        {
+            auto it = build_seconds.find(actions[idx].spec);
+            estimated_seconds[idx] = it == build_seconds.end() ? weight(idx) * seconds_per_weight : it->second;
+        }
+
+        // Order by spec rather than plan order, which --x-randomize changes, so that every shard computes the same
+        // assignment. Within each wave, the longest builds go first, each to the shard with the least work in that
+        // wave so far.
+        std::sort(to_assign.begin(), to_assign.end(), [&](size_t lhs, size_t rhs) {
+            if (waves[lhs] != waves[rhs]) return waves[lhs] < waves[rhs];
+            if (estimated_seconds[lhs] != estimated_seconds[rhs])
+            {
+                return estimated_seconds[lhs] > estimated_seconds[rhs];
+            }
+
+            return actions[lhs].spec < actions[rhs].spec;
+        });
+
+        std::map<PackageSpec, CiShardTarget> targets;
+        std::vector<double> wave_seconds(shard_count, 0.0);
+        std::vector<double> total_seconds(shard_count, 0.0);
+        size_t current_wave = 0;
+        for (auto idx : to_assign)
+        {
+            if (waves[idx] != current_wave)
+            {
+                current_wave = waves[idx];
+                std::fill(wave_seconds.begin(), wave_seconds.end(), 0.0);
+            }
+
+            size_t target = 0;
+            for (size_t shard = 1; shard < shard_count; ++shard)
+            {
+                if (wave_seconds[shard] < wave_seconds[target] ||
+                    (wave_seconds[shard] == wave_seconds[target] && total_seconds[shard] < total_seconds[target]))
+                {
+                    target = shard;
+                }
+            }
+
+            wave_seconds[target] += estimated_seconds[idx];
+            total_seconds[target] += estimated_seconds[idx];
+            targets.emplace(actions[idx].spec, CiShardTarget{target, waves[idx]});
+        }
+
+        return targets;
+    }
+
+    CiShardPlan shard_action_plan(ActionPlan& action_plan,
+                                  const std::map<PackageSpec, BuildResult>& known,
+                                  const std::map<PackageSpec, CiShardTarget>& targets,
+                                  CiShard shard)
+    {
+        CiShardPlan shard_plan;
+        auto& actions = action_plan.install_actions;
+        std::set<PackageSpec> to_keep;
+        for (auto it = actions.rbegin(); it != actions.rend(); ++it)
+        {
+            const auto& action = *it;
+            auto it_target = targets.find(action.spec);
+            const bool builds = action.plan_type != InstallPlanType::EXCLUDED &&
+                                !Util::Sets::contains(known, action.spec) &&
+                                (it_target == targets.end() || it_target->second.shard == shard.index);
+            if (!builds && !Util::Sets::contains(to_keep, action.spec))
+            {
+                continue;
+            }
+
+            // dependencies are visited after their dependents, so the first wave needing one is known by now
+            const size_t target_wave = builds && it_target != targets.end() ? it_target->second.wave : 0;
+            auto inserted_self = shard_plan.waves.emplace(action.spec, target_wave);
+            if (builds && inserted_self.first->second > target_wave)
+            {
+                inserted_self.first->second = target_wave;
+            }
+
+            if (!builds && action.plan_type != InstallPlanType::EXCLUDED && !Util::Sets::contains(known, action.spec))
+            {
+                shard_plan.built_elsewhere.insert(action.spec);
+            }
+
+            const auto wave = shard_plan.waves[action.spec];
+            shard_plan.wave_count = std::max(shard_plan.wave_count, wave + 1);
+            to_keep.insert(action.spec);
+            for (auto&& dependency : action.package_dependencies)
+            {
+                if (dependency == action.spec) continue;
+                to_keep.insert(dependency);
+                auto inserted = shard_plan.waves.emplace(dependency, wave);
+                if (!inserted.second && inserted.first->second > wave)
+                {
+                    inserted.first->second = wave;
+                }
+            }
+        }
+
+        Util::erase_remove_if(actions, [&to_keep](const InstallPlanAction& action) {
+            return !Util::Sets::contains(to_keep, action.spec);
+        });
+
+        return shard_plan;
+    }
+
+    CiShardWaiter::CiShardWaiter(const std::map<PackageSpec, CiShardTarget>& targets, std::chrono::seconds timeout)
+        : m_targets(targets), m_timeout(timeout)
+    {
+    }
+
+    void CiShardWaiter::wait(std::vector<InstallPlanAction>& wave,
+                             const std::set<PackageSpec>& built_elsewhere,
+                             ICiShardObserver& observer)
+    {
+        // actions are in dependency order, so giving up on a port is seen by the ports of the wave depending on it
+        std::vector<const InstallPlanAction*> pending;
+        for (auto&& action : wave)
+        {
+            if (!Util::Sets::contains(built_elsewhere, action.spec))
+            {
+                continue;
+            }
+
+            auto it_target = m_targets.find(action.spec);
+            if (it_target != m_targets.end() && Util::Sets::contains(m_timed_out_shards, it_target->second.shard))
+            {
+                msg::println_warning(msgCiShardTimedOut, msg::spec = action.spec);
+                m_failed.insert(action.spec);
+            }
+            else if (depends_on_failure(action))
+            {
+                m_failed.insert(action.spec);
+            }
+            else
+            {
+                pending.push_back(&action);
+            }
+        }
+
+        auto last_progress = observer.elapsed();
+        bool waiting = false;
+        while (!pending.empty())
+        {
+            const auto states = observer.poll(pending);
+            bool progress = false;
+            for (size_t i = 0; i < pending.size(); ++i)
+            {
+                if (states[i] == CiShardPortState::Failed)
+                {
+                    msg::println_warning(msgCiShardPortFailed, msg::spec = pending[i]->spec);
+                    m_failed.insert(pending[i]->spec);
+                }
+
+                progress = progress || states[i] != CiShardPortState::Pending;
+            }
+
+            size_t still_pending = 0;
+            for (size_t i = 0; i < pending.size(); ++i)
+            {
+                if (states[i] != CiShardPortState::Pending)
+                {
+                    continue;
+                }
+
+                if (depends_on_failure(*pending[i]))
+                {
+                    m_failed.insert(pending[i]->spec);
+                }
+                else
+                {
+                    pending[still_pending++] = pending[i];
+                }
+            }
+
+            pending.resize(still_pending);
+            if (pending.empty())
+            {
+                break;
+            }
+
+            const auto now = observer.elapsed();
+            if (progress)
+            {
+                last_progress = now;
+            }
+            else if (now - last_progress >= m_timeout)
+            {
+                break;
+            }
+
+            if (!waiting)
+            {
+                msg::println(msgCiShardWaiting, msg::count = pending.size());
+                waiting = true;
+            }
+
+            observer.pause();
+        }
+
+        for (auto action : pending)
+        {
+            // a port waiting only for ports which timed out says nothing about its own shard
+            if (!depends_on_failure(*action))
+            {
+                msg::println_warning(msgCiShardTimedOut, msg::spec = action->spec);
+                auto it_target = m_targets.find(action->spec);
+                if (it_target != m_targets.end())
+                {
+                    m_timed_out_shards.insert(it_target->second.shard);
+                }
+            }
+
+            m_failed.insert(action->spec);
+        }
+
+        Util::erase_remove_if(wave, [&](const InstallPlanAction& action) {
+            return Util::Sets::contains(built_elsewhere, action.spec) && Util::Sets::contains(m_failed, action.spec);
+        });
+    }
+
+    void CiShardWaiter::record_failure(const PackageSpec& spec) { m_failed.insert(spec); }
+
+    bool CiShardWaiter::depends_on_failure(const InstallPlanAction& action) const
+    {
+        return Util::any_of(action.package_dependencies, [this](const PackageSpec& dependency) {
+            return Util::Sets::contains(m_failed, dependency);
+        });
+    }
+
+    Json::Array serialize_ci_results(View<CiResult> results)
+    {
+        Json::Array arr;
+        for (auto&& result : results)
+        {
+            Json::Object obj;
+            obj.insert(JsonIdName, Json::Value::string(result.spec.name()));
+            obj.insert(JsonIdTriplet, Json::Value::string(result.spec.triplet().canonical_name()));
+            obj.insert(JsonIdState, Json::Value::string(result.state));
+            obj.insert(JsonIdResult, Json::Value::string(to_string_locale_invariant(result.result)));
+            obj.insert(JsonIdAbi, Json::Value::string(result.abi));
+            Json::Array features;
+            for (auto&& feature : result.features)
+            {
+                features.push_back(Json::Value::string(feature));
+            }
+
+            obj.insert(JsonIdFeatures, std::move(features));
+            obj.insert(JsonIdElapsedSeconds,
+                       Json::Value::number(result.elapsed.as<std::chrono::duration<double>>().count()));
+            obj.insert(JsonIdStartTime,
+                       Json::Value::integer(std::chrono::duration_cast<std::chrono::milliseconds>(
+                                                result.start_time.time_since_epoch())
+                                                .count()));
+            arr.push_back(std::move(obj));
+        }
+
+        return arr;
+    }
+
+    ExpectedL<std::vector<CiResult>> parse_ci_results(const Json::Value& value, StringView origin)
+    {
+        std::vector<CiResult> results;
+        if (auto arr = value.maybe_array())
+        {
+            for (auto&& entry : *arr)
+            {
+                auto maybe_result = parse_ci_result(entry);
+                if (auto result = maybe_result.get())
+                {
+                    results.push_back(std::move(*result));
+                    continue;
+                }
+
+                return msg::format_error(msgCiInvalidResultsFile, msg::path = origin);
+            }
+
+            return results;
+        }
+
+        return msg::format_error(msgCiInvalidResultsFile, msg::path = origin);
+    }
+
+    std::vector<CiResult> merge_ci_results(View<std::vector<CiResult>> shard_results)
+    {
+        std::map<PackageSpec, CiResult> merged;
+        for (auto&& results : shard_results)
+        {
+            for (auto&& result : results)
+            {
+                auto it = merged.find(result.spec);
+                if (it == merged.end())
+                {
+                    merged.emplace(result.spec, result);
+                }
+                else if (it->second.state != CiStateBuild && result.state == CiStateBuild)
+                {
+                    it->second = result;
+                }
+            }
+        }
+
+        return Util::fmap(merged, [](const std::pair<const PackageSpec, CiResult>& entry) { return entry.second; });
+    }
+
+    std::map<PackageSpec, double> get_ci_build_seconds(View<CiResult> results)
+    {
+        std::map<PackageSpec, double> build_seconds;
+        for (auto&& result : results)
+        {
+            if (result.state == CiStateBuild)
+            {
+                build_seconds[result.spec] = result.elapsed.as<std::chrono::duration<double>>().count();
+            }
+        }
+
+        return build_seconds;
+    }
+}
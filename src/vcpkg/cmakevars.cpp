@@ -1,8 +1,14 @@
 #include <vcpkg/base/contractual-constants.h>
+#include <vcpkg/base/files.h>
+#include <vcpkg/base/hash.h>
+#include <vcpkg/base/json.h>
 #include <vcpkg/base/optional.h>
+#include <vcpkg/base/parse.h>
+#include <vcpkg/base/parallel-algorithms.h>
 #include <vcpkg/base/span.h>
 #include <vcpkg/base/strings.h>
 #include <vcpkg/base/system.debug.h>
+#include <vcpkg/base/system.h>
 #include <vcpkg/base/system.process.h>
 #include <vcpkg/base/util.h>
 
@@ -75,9 +81,32 @@ namespace vcpkg::CMakeVars
             Path create_dep_info_extraction_file(const View<PackageSpec> specs) const;
 
             void launch_and_split(const Path& script_path,
-                                  std::vector<std::vector<std::pair<std::string, std::string>>>& vars) const;
+                                  Span<std::vector<std::pair<std::string, std::string>>> vars) const;
+
+            // Splits `count` specs into shards, writes an extraction script for each shard with
+            // create_extraction_file(first, last), and runs those scripts in concurrent CMake processes.
+            template<class CreateExtractionFile>
+            std::vector<std::vector<std::pair<std::string, std::string>>> extract_sharded(
+                size_t count, CreateExtractionFile create_extraction_file) const;
+
+            // Describes everything outside of the port that can affect the variables extracted for `triplet`.
+            // Empty if that can't be determined, in which case the triplet's variables are not cached.
+            const std::string& triplet_cache_key(Triplet triplet) const;
+
+            // The cache key for the variables `entry` extracts for `triplet`, or empty if they are not cached.
+            std::string cache_key(Triplet triplet, StringView entry) const;
+
+            Optional<std::vector<std::pair<std::string, std::string>>> load_cached_vars(const std::string& key) const;
+
+            // Removes the least recently written entries once the cache grows past its limit.
+            void prune_cache() const;
+
+            void store_cached_vars(const std::string& key,
+                                   const std::vector<std::pair<std::string, std::string>>& vars) const;
 
             const VcpkgPaths& paths;
+            mutable std::unordered_map<Triplet, std::string> triplet_cache_keys;
+            mutable bool cache_pruned = false;
             mutable std::unordered_map<PackageSpec, std::unordered_map<std::string, std::string>> dep_resolution_vars;
             mutable std::unordered_map<PackageSpec, std::unordered_map<std::string, std::string>> tag_vars;
             mutable std::unordered_map<Triplet, std::unordered_map<std::string, std::string>> generic_triplet_vars;
@@ -89,55 +118,29 @@ namespace vcpkg::CMakeVars
         return std::make_unique<TripletCMakeVarProvider>(paths);
     }
 
-    static std::string create_extraction_file_prelude(const VcpkgPaths& paths,
-                                                      const std::map<Triplet, int>& emitted_triplets)
+    namespace
     {
-        const auto& fs = paths.get_filesystem();
-        std::string extraction_file;
+        constexpr StringLiteral PORT_START_GUID = "d8187afd-ea4a-4fc3-9aa4-a6782e1ed9af";
+        constexpr StringLiteral PORT_END_GUID = "8c504940-be29-4cba-9f8f-6cd83e9d87b7";
+        constexpr StringLiteral BLOCK_START_GUID = "c35112b6-d1ba-415b-aa5d-81de856ef8eb";
+        constexpr StringLiteral BLOCK_END_GUID = "e1e74b5c-18cb-4474-a6bd-5c1c8bc81f3f";
 
-        extraction_file.append("cmake_minimum_required(VERSION 3.5)\n"
-                               "macro(vcpkg_triplet_file VCPKG_TRIPLET_ID)\n"
-                               "set(_vcpkg_triplet_file_BACKUP_CURRENT_LIST_FILE \"${CMAKE_CURRENT_LIST_FILE}\")\n");
+        // Each CMake process evaluates the triplet files again, so small plans are not worth splitting up.
+        constexpr size_t MIN_SPECS_PER_SHARD = 64;
 
-        for (auto&& p : emitted_triplets)
-        {
-            auto path_to_triplet = paths.get_triplet_db().get_triplet_file_path(p.first);
-            fmt::format_to(std::back_inserter(extraction_file),
-                           "if(VCPKG_TRIPLET_ID EQUAL {})\n"
-                           "set(CMAKE_CURRENT_LIST_FILE \"{}\")\n"
-                           "get_filename_component(CMAKE_CURRENT_LIST_DIR \"${{CMAKE_CURRENT_LIST_FILE}}\" DIRECTORY)\n"
-                           "{}\n"
-                           "endif()\n",
-                           p.second,
-                           path_to_triplet.generic_u8string(),
-                           fs.read_contents(path_to_triplet, VCPKG_LINE_INFO));
-        }
+        constexpr StringLiteral EXTRACTION_FILE_PRELUDE_START =
+            "cmake_minimum_required(VERSION 3.5)\n"
+            "macro(vcpkg_triplet_file VCPKG_TRIPLET_ID)\n"
+            "set(_vcpkg_triplet_file_BACKUP_CURRENT_LIST_FILE \"${CMAKE_CURRENT_LIST_FILE}\")\n";
 
-        extraction_file.append(
-            R"(
+        constexpr StringLiteral EXTRACTION_FILE_PRELUDE_END = R"(
 set(CMAKE_CURRENT_LIST_FILE "${_vcpkg_triplet_file_BACKUP_CURRENT_LIST_FILE}")
 get_filename_component(CMAKE_CURRENT_LIST_DIR "${CMAKE_CURRENT_LIST_FILE}" DIRECTORY)
 endmacro()
-)");
-        return extraction_file;
-    }
-
-    Path TripletCMakeVarProvider::create_tag_extraction_file(
-        const View<std::pair<FullPackageSpec, std::string>> spec_abi_settings) const
-    {
-        const Filesystem& fs = paths.get_filesystem();
-        static int tag_extract_id = 0;
-
-        std::map<Triplet, int> emitted_triplets;
-        int emitted_triplet_id = 0;
-        for (const auto& spec_abi_setting : spec_abi_settings)
-        {
-            emitted_triplets[spec_abi_setting.first.package_spec.triplet()] = emitted_triplet_id++;
-        }
-        std::string extraction_file = create_extraction_file_prelude(paths, emitted_triplets);
+)";
 
         // The variables collected here are those necessary to perform builds.
-        extraction_file.append(R"(
+        constexpr StringLiteral TAG_EXTRACTION_FUNCTION = R"(
 
 function(vcpkg_get_tags PORT FEATURES VCPKG_TRIPLET_ID VCPKG_ABI_SETTINGS_FILE)
     message("d8187afd-ea4a-4fc3-9aa4-a6782e1ed9af")
@@ -177,12 +180,42 @@ Z_VCPKG_GameDKLatest=$ENV{GameDKLatest}
 e1e74b5c-18cb-4474-a6bd-5c1c8bc81f3f
 8c504940-be29-4cba-9f8f-6cd83e9d87b7")
 endfunction()
-)");
+)";
 
-        for (const auto& spec_abi_setting : spec_abi_settings)
-        {
-            const FullPackageSpec& spec = spec_abi_setting.first;
+        // The variables collected here are those necessary to perform dependency resolution.
+        // If a value affects platform expressions, it must be here.
+        constexpr StringLiteral DEP_INFO_EXTRACTION_FUNCTION = R"(
+
+function(vcpkg_get_dep_info PORT VCPKG_TRIPLET_ID)
+    message("d8187afd-ea4a-4fc3-9aa4-a6782e1ed9af")
+    vcpkg_triplet_file(${VCPKG_TRIPLET_ID})
+
+    # GUID used as a flag - "cut here line"
+    message("c35112b6-d1ba-415b-aa5d-81de856ef8eb
+VCPKG_TARGET_ARCHITECTURE=${VCPKG_TARGET_ARCHITECTURE}
+VCPKG_CMAKE_SYSTEM_NAME=${VCPKG_CMAKE_SYSTEM_NAME}
+VCPKG_CMAKE_SYSTEM_VERSION=${VCPKG_CMAKE_SYSTEM_VERSION}
+VCPKG_LIBRARY_LINKAGE=${VCPKG_LIBRARY_LINKAGE}
+VCPKG_CRT_LINKAGE=${VCPKG_CRT_LINKAGE}
+VCPKG_DEP_INFO_OVERRIDE_VARS=${VCPKG_DEP_INFO_OVERRIDE_VARS}
+CMAKE_HOST_SYSTEM_NAME=${CMAKE_HOST_SYSTEM_NAME}
+CMAKE_HOST_SYSTEM_PROCESSOR=${CMAKE_HOST_SYSTEM_PROCESSOR}
+CMAKE_HOST_SYSTEM_VERSION=${CMAKE_HOST_SYSTEM_VERSION}
+CMAKE_HOST_SYSTEM=${CMAKE_HOST_SYSTEM}
+VCPKG_XBOX_CONSOLE_TARGET=${VCPKG_XBOX_CONSOLE_TARGET}
+e1e74b5c-18cb-4474-a6bd-5c1c8bc81f3f
+8c504940-be29-4cba-9f8f-6cd83e9d87b7")
+endfunction()
+)";
+
+        // Bump when the format of cache entries changes.
+        constexpr StringLiteral CMAKE_VARS_CACHE_VERSION = "2";
 
+        // Enough for the dep-info and tag entries of every port in the curated registry for a handful of triplets.
+        constexpr size_t CMAKE_VARS_CACHE_MAX_ENTRIES = 50000;
+
+        std::string tag_feature_list(const FullPackageSpec& spec)
+        {
             std::string featurelist;
             for (auto&& f : spec.features)
             {
@@ -191,10 +224,174 @@ endfunction()
                 featurelist.append(f);
             }
 
+            return featurelist;
+        }
+
+        // Appends the name and current value of every environment variable `cmake_source` reads with $ENV{NAME}.
+        void append_referenced_environment(std::string& key, StringView cmake_source)
+        {
+            static constexpr StringLiteral env_prefix = "ENV{";
+            auto first = cmake_source.begin();
+            const auto last = cmake_source.end();
+            for (;;)
+            {
+                first = Util::search(first, last, env_prefix);
+                if (first == last) return;
+                first += env_prefix.size();
+                auto name_end = std::find(first, last, '}');
+                StringView name{first, name_end};
+                first = name_end;
+                if (name.empty() || Util::contains(name, '$')) continue;
+                fmt::format_to(std::back_inserter(key), "env {}", name);
+                auto maybe_value = get_environment_variable(name.to_string());
+                if (auto value = maybe_value.get())
+                {
+                    fmt::format_to(std::back_inserter(key), "={}", *value);
+                }
+
+                key.push_back('\n');
+            }
+        }
+
+        // Returns whether every include() in `cmake_source` names a file in the including script's directory,
+        // which is hashed into the triplet cache key.
+        bool includes_only_neighbors(StringView cmake_source)
+        {
+            static constexpr StringLiteral include_command = "include";
+            static constexpr StringLiteral neighbor_prefix = "${CMAKE_CURRENT_LIST_DIR}/";
+            for (auto&& full_line : Strings::split(cmake_source, '\n'))
+            {
+                const auto line_first = full_line.data();
+                const auto last = std::find(line_first, line_first + full_line.size(), '#');
+                auto first = line_first;
+                for (;;)
+                {
+                    first = Util::search(first, last, include_command);
+                    if (first == last) break;
+                    const bool starts_word = first == line_first || !ParserBase::is_word_char(first[-1]);
+                    first += include_command.size();
+                    auto open = std::find_if_not(first, last, ParserBase::is_whitespace);
+                    if (!starts_word || open == last || *open != '(') continue;
+                    auto arg_first = std::find_if_not(open + 1, last, ParserBase::is_whitespace);
+                    if (arg_first != last && *arg_first == '"') ++arg_first;
+                    auto arg_last = std::find_if(arg_first, last, [](char ch) {
+                        return ch == '"' || ch == ')' || ParserBase::is_whitespace(ch);
+                    });
+                    StringView arg{arg_first, arg_last};
+                    if (!Strings::starts_with(arg, neighbor_prefix)) return false;
+                    arg = arg.substr(neighbor_prefix.size());
+                    if (arg.empty() || Util::any_of(arg, [](char ch) { return ch == '/' || ch == '\\' || ch == '$'; }))
+                    {
+                        return false;
+                    }
+
+                    first = arg_last;
+                }
+            }
+
+            return true;
+        }
+    }
+
+    void CMakeVarsOutputParser::parse_line(StringView line)
+    {
+        switch (m_state)
+        {
+            case State::BetweenPorts:
+                if (line == PORT_START_GUID)
+                {
+                    m_state = State::InPort;
+                }
+                break;
+            case State::InPort:
+                if (line == BLOCK_START_GUID)
+                {
+                    m_state = State::InBlock;
+                }
+                else if (line == PORT_END_GUID)
+                {
+                    ++m_ports_seen;
+                    m_state = State::BetweenPorts;
+                }
+                break;
+            case State::InBlock:
+                if (line == BLOCK_END_GUID)
+                {
+                    m_state = State::InPort;
+                }
+                else
+                {
+                    std::vector<std::string> s = Strings::split(line, '=');
+                    Checks::msg_check_exit(VCPKG_LINE_INFO,
+                                           s.size() == 1 || s.size() == 2,
+                                           msgUnexpectedFormat,
+                                           msg::expected = "VARIABLE_NAME=VARIABLE_VALUE",
+                                           msg::actual = line);
+                    if (m_ports_seen < m_port_vars.size())
+                    {
+                        m_port_vars[m_ports_seen].emplace_back(std::move(s[0]),
+                                                               s.size() == 1 ? "" : std::move(s[1]));
+                    }
+                }
+                break;
+            default: Checks::unreachable(VCPKG_LINE_INFO);
+        }
+    }
+
+    bool CMakeVarsOutputParser::is_complete() const
+    {
+        return m_state == State::BetweenPorts && m_ports_seen == m_port_vars.size();
+    }
+
+    static std::string create_extraction_file_prelude(const VcpkgPaths& paths,
+                                                      const std::map<Triplet, int>& emitted_triplets)
+    {
+        const auto& fs = paths.get_filesystem();
+        std::string extraction_file;
+
+        Strings::append(extraction_file, EXTRACTION_FILE_PRELUDE_START);
+
+        for (auto&& p : emitted_triplets)
+        {
+            auto path_to_triplet = paths.get_triplet_db().get_triplet_file_path(p.first);
+            fmt::format_to(std::back_inserter(extraction_file),
+                           "if(VCPKG_TRIPLET_ID EQUAL {})\n"
+                           "set(CMAKE_CURRENT_LIST_FILE \"{}\")\n"
+                           "get_filename_component(CMAKE_CURRENT_LIST_DIR \"${{CMAKE_CURRENT_LIST_FILE}}\" DIRECTORY)\n"
+                           "{}\n"
+                           "endif()\n",
+                           p.second,
+                           path_to_triplet.generic_u8string(),
+                           fs.read_contents(path_to_triplet, VCPKG_LINE_INFO));
+        }
+
+        Strings::append(extraction_file, EXTRACTION_FILE_PRELUDE_END);
+        return extraction_file;
+    }
+
+    Path TripletCMakeVarProvider::create_tag_extraction_file(
+        const View<std::pair<FullPackageSpec, std::string>> spec_abi_settings) const
+    {
+        const Filesystem& fs = paths.get_filesystem();
+        static int tag_extract_id = 0;
+
+        std::map<Triplet, int> emitted_triplets;
+        int emitted_triplet_id = 0;
+        for (const auto& spec_abi_setting : spec_abi_settings)
+        {
+            emitted_triplets[spec_abi_setting.first.package_spec.triplet()] = emitted_triplet_id++;
+        }
+        std::string extraction_file = create_extraction_file_prelude(paths, emitted_triplets);
+
+        Strings::append(extraction_file, TAG_EXTRACTION_FUNCTION);
+
+        for (const auto& spec_abi_setting : spec_abi_settings)
+        {
+            const FullPackageSpec& spec = spec_abi_setting.first;
             fmt::format_to(std::back_inserter(extraction_file),
                            "vcpkg_get_tags(\"{}\" \"{}\" \"{}\" \"{}\")\n",
                            spec.package_spec.name(),
-                           featurelist,
+                           tag_feature_list(spec),
                            emitted_triplets[spec.package_spec.triplet()],
                            spec_abi_setting.second);
         }
@@ -218,31 +415,7 @@ endfunction()
 
         std::string extraction_file = create_extraction_file_prelude(paths, emitted_triplets);
 
-        // The variables collected here are those necessary to perform dependency resolution.
-        // If a value affects platform expressions, it must be here.
-        extraction_file.append(R"(
-
-function(vcpkg_get_dep_info PORT VCPKG_TRIPLET_ID)
-    message("d8187afd-ea4a-4fc3-9aa4-a6782e1ed9af")
-    vcpkg_triplet_file(${VCPKG_TRIPLET_ID})
-
-    # GUID used as a flag - "cut here line"
-    message("c35112b6-d1ba-415b-aa5d-81de856ef8eb
-VCPKG_TARGET_ARCHITECTURE=${VCPKG_TARGET_ARCHITECTURE}
-VCPKG_CMAKE_SYSTEM_NAME=${VCPKG_CMAKE_SYSTEM_NAME}
-VCPKG_CMAKE_SYSTEM_VERSION=${VCPKG_CMAKE_SYSTEM_VERSION}
-VCPKG_LIBRARY_LINKAGE=${VCPKG_LIBRARY_LINKAGE}
-VCPKG_CRT_LINKAGE=${VCPKG_CRT_LINKAGE}
-VCPKG_DEP_INFO_OVERRIDE_VARS=${VCPKG_DEP_INFO_OVERRIDE_VARS}
-CMAKE_HOST_SYSTEM_NAME=${CMAKE_HOST_SYSTEM_NAME}
-CMAKE_HOST_SYSTEM_PROCESSOR=${CMAKE_HOST_SYSTEM_PROCESSOR}
-CMAKE_HOST_SYSTEM_VERSION=${CMAKE_HOST_SYSTEM_VERSION}
-CMAKE_HOST_SYSTEM=${CMAKE_HOST_SYSTEM}
-VCPKG_XBOX_CONSOLE_TARGET=${VCPKG_XBOX_CONSOLE_TARGET}
-e1e74b5c-18cb-4474-a6bd-5c1c8bc81f3f
-8c504940-be29-4cba-9f8f-6cd83e9d87b7")
-endfunction()
-)");
+        Strings::append(extraction_file, DEP_INFO_EXTRACTION_FUNCTION);
 
         for (const PackageSpec& spec : specs)
         {
@@ -272,18 +445,16 @@ endfunction()
     }
 
     void TripletCMakeVarProvider::launch_and_split(
-        const Path& script_path, std::vector<std::vector<std::pair<std::string, std::string>>>& vars) const
+        const Path& script_path, Span<std::vector<std::pair<std::string, std::string>>> vars) const
     {
-        static constexpr StringLiteral PORT_START_GUID = "d8187afd-ea4a-4fc3-9aa4-a6782e1ed9af";
-        static constexpr StringLiteral PORT_END_GUID = "8c504940-be29-4cba-9f8f-6cd83e9d87b7";
-        static constexpr StringLiteral BLOCK_START_GUID = "c35112b6-d1ba-415b-aa5d-81de856ef8eb";
-        static constexpr StringLiteral BLOCK_END_GUID = "e1e74b5c-18cb-4474-a6bd-5c1c8bc81f3f";
-
         auto cmd = vcpkg::make_cmake_cmd(paths, script_path, {});
 
+        // keep the raw output only to report it if CMake fails
         std::vector<std::string> lines;
+        CMakeVarsOutputParser parser{vars};
         auto const exit_code = cmd_execute_and_stream_lines(cmd, [&](StringView sv) {
                                    lines.emplace_back(sv.begin(), sv.end());
+                                   parser.parse_line(sv);
                                }).value_or_exit(VCPKG_LINE_INFO);
 
         if (exit_code != 0)
@@ -294,54 +465,191 @@ endfunction()
                                               .append_raw(Strings::join(", ", lines)));
         }
 
-        const auto end = lines.cend();
+        Checks::msg_check_exit(VCPKG_LINE_INFO, parser.is_complete(), msgFailedToParseCMakeConsoleOut);
+    }
 
-        auto port_start = std::find(lines.cbegin(), end, PORT_START_GUID);
-        auto port_end = std::find(port_start, end, PORT_END_GUID);
-        Checks::msg_check_exit(VCPKG_LINE_INFO, port_start != end && port_end != end, msgFailedToParseCMakeConsoleOut);
+    template<class CreateExtractionFile>
+    std::vector<std::vector<std::pair<std::string, std::string>>> TripletCMakeVarProvider::extract_sharded(
+        size_t count, CreateExtractionFile create_extraction_file) const
+    {
+        const size_t shard_count = std::max(
+            size_t{1},
+            std::min(static_cast<size_t>(get_concurrency()), (count + MIN_SPECS_PER_SHARD - 1) / MIN_SPECS_PER_SHARD));
+        std::vector<size_t> shard_bounds;
+        std::vector<Path> script_paths;
+        for (size_t shard = 0; shard != shard_count; ++shard)
+        {
+            shard_bounds.push_back(count * shard / shard_count);
+            script_paths.push_back(create_extraction_file(shard_bounds.back(), count * (shard + 1) / shard_count));
+        }
 
-        for (auto var_itr = vars.begin(); port_start != end && var_itr != vars.end(); ++var_itr)
+        shard_bounds.push_back(count);
+        std::vector<std::vector<std::pair<std::string, std::string>>> vars(count);
+        execute_in_parallel(shard_count, [&](size_t shard) {
+            launch_and_split(script_paths[shard],
+                             Span<std::vector<std::pair<std::string, std::string>>>{
+                                 vars.data() + shard_bounds[shard], vars.data() + shard_bounds[shard + 1]});
+        });
+
+        const Filesystem& fs = paths.get_filesystem();
+        for (auto&& script_path : script_paths)
         {
-            auto block_start = std::find(port_start, port_end, BLOCK_START_GUID);
-            Checks::msg_check_exit(VCPKG_LINE_INFO, block_start != port_end, msgFailedToParseCMakeConsoleOut);
-            auto block_end = std::find(++block_start, port_end, BLOCK_END_GUID);
+            fs.remove(script_path, VCPKG_LINE_INFO);
+        }
+
+        return vars;
+    }
+
+    const std::string& TripletCMakeVarProvider::triplet_cache_key(Triplet triplet) const
+    {
+        auto it = triplet_cache_keys.find(triplet);
+        if (it != triplet_cache_keys.end()) return it->second;
 
-            while (block_start != port_end)
+        const auto& fs = paths.get_filesystem();
+        auto triplet_path = paths.get_triplet_db().get_triplet_file_path(triplet);
+        std::string key = fmt::format("version {}\n", CMAKE_VARS_CACHE_VERSION);
+        fmt::format_to(std::back_inserter(key), "command {}\n", make_cmake_cmd(paths, Path{}, {}).command_line());
+        fmt::format_to(std::back_inserter(key), "triplet {} {}\n", triplet, triplet_path.generic_u8string());
+        // CMAKE_HOST_SYSTEM and friends are part of the extracted variables
+        fmt::format_to(std::back_inserter(key),
+                       "host {} {} {}\n",
+                       get_host_os_name(),
+                       get_host_os_version(),
+                       get_host_processor());
+
+        // triplets commonly include their neighbors, so any change in the triplet's directory invalidates it
+        std::error_code ec;
+        auto neighbors = fs.get_regular_files_non_recursive(triplet_path.parent_path(), ec);
+        Util::sort(neighbors);
+        for (auto&& neighbor : neighbors)
+        {
+            if (!Strings::case_insensitive_ascii_ends_with(neighbor.native(), ".cmake")) continue;
+            auto contents = fs.read_contents(neighbor, ec);
+            if (ec) continue;
+            if (!includes_only_neighbors(contents))
             {
-                while (block_start != block_end)
-                {
-                    const std::string& line = *block_start;
+                Debug::println(fmt::format("Not caching CMake variables for {}: {} includes files outside of {}",
+                                           triplet,
+                                           neighbor,
+                                           triplet_path.parent_path()));
+                key.clear();
+                break;
+            }
 
-                    std::vector<std::string> s = Strings::split(line, '=');
-                    Checks::msg_check_exit(VCPKG_LINE_INFO,
-                                           s.size() == 1 || s.size() == 2,
-                                           msgUnexpectedFormat,
-                                           msg::expected = "VARIABLE_NAME=VARIABLE_VALUE",
-                                           msg::actual = line);
+            fmt::format_to(
+                std::back_inserter(key), "file {} {}\n", neighbor.filename(), Hash::get_string_sha256(contents));
+            append_referenced_environment(key, contents);
+        }
 
-                    var_itr->emplace_back(std::move(s[0]), s.size() == 1 ? "" : std::move(s[1]));
+        if (!key.empty())
+        {
+            append_referenced_environment(key, TAG_EXTRACTION_FUNCTION);
+        }
 
-                    ++block_start;
-                }
+        return triplet_cache_keys.emplace(triplet, std::move(key)).first->second;
+    }
 
-                block_start = std::find(block_end, port_end, BLOCK_START_GUID);
-                block_end = std::find(block_start, port_end, BLOCK_END_GUID);
-            }
+    std::string TripletCMakeVarProvider::cache_key(Triplet triplet, StringView entry) const
+    {
+        const auto& triplet_key = triplet_cache_key(triplet);
+        if (triplet_key.empty()) return std::string{};
+        return Strings::concat(triplet_key, entry);
+    }
+
+    Optional<std::vector<std::pair<std::string, std::string>>> TripletCMakeVarProvider::load_cached_vars(
+        const std::string& key) const
+    {
+        if (key.empty()) return nullopt;
+        const auto& fs = paths.get_filesystem();
+        const auto cache_path = paths.buildtrees() / FileCMakeVarsCache / Hash::get_string_sha256(key);
+        std::error_code ec;
+        auto contents = fs.read_contents(cache_path, ec);
+        if (ec) return nullopt;
+
+        auto maybe_object = Json::parse_object(contents, cache_path);
+        auto object = maybe_object.get();
+        if (!object) return nullopt;
+
+        std::vector<std::pair<std::string, std::string>> vars;
+        for (auto&& entry : *object)
+        {
+            if (!entry.second.is_string()) return nullopt;
+            vars.emplace_back(entry.first.to_string(), entry.second.string(VCPKG_LINE_INFO).to_string());
+        }
+
+        return vars;
+    }
+
+    void TripletCMakeVarProvider::store_cached_vars(const std::string& key,
+                                                    const std::vector<std::pair<std::string, std::string>>& vars) const
+    {
+        if (key.empty()) return;
+        prune_cache();
+        const auto& fs = paths.get_filesystem();
+        const auto cache_dir = paths.buildtrees() / FileCMakeVarsCache;
+        const auto cache_name = Hash::get_string_sha256(key);
+        Json::Object object;
+        for (auto&& var : vars)
+        {
+            object.insert_or_replace(var.first, var.second);
+        }
+
+        // other vcpkg processes may be reading or writing the same entry
+        std::error_code ec;
+        const auto temp_path = cache_dir / fmt::format("{}.{}", cache_name, get_process_id());
+        fs.write_contents_and_dirs(temp_path, Json::stringify(object), ec);
+        if (!ec)
+        {
+            fs.rename(temp_path, cache_dir / cache_name, ec);
+        }
+    }
+
+    void TripletCMakeVarProvider::prune_cache() const
+    {
+        if (cache_pruned) return;
+        cache_pruned = true;
+        const auto& fs = paths.get_filesystem();
+        std::error_code ec;
+        auto entries = fs.get_regular_files_non_recursive(paths.buildtrees() / FileCMakeVarsCache, ec);
+        if (ec || entries.size() <= CMAKE_VARS_CACHE_MAX_ENTRIES) return;
 
-            port_start = std::find(port_end, end, PORT_START_GUID);
-            port_end = std::find(port_start, end, PORT_END_GUID);
+        std::vector<std::pair<int64_t, Path>> entries_by_age;
+        for (auto&& entry : entries)
+        {
+            auto last_write_time = fs.last_write_time(entry, ec);
+            if (!ec) entries_by_age.emplace_back(last_write_time, std::move(entry));
+        }
+
+        if (entries_by_age.size() <= CMAKE_VARS_CACHE_MAX_ENTRIES) return;
+        // leave room for this run's entries so the next run doesn't prune again straight away
+        const auto to_remove = entries_by_age.size() - CMAKE_VARS_CACHE_MAX_ENTRIES / 2;
+        std::nth_element(entries_by_age.begin(), entries_by_age.begin() + to_remove, entries_by_age.end());
+        Debug::println(fmt::format("Pruning {} entries from the CMake variables cache", to_remove));
+        for (size_t i = 0; i < to_remove; ++i)
+        {
+            fs.remove(entries_by_age[i].second, ec);
         }
     }
 
     void TripletCMakeVarProvider::load_generic_triplet_vars(Triplet triplet) const
     {
         std::vector<std::vector<std::pair<std::string, std::string>>> vars(1);
-        // Hack: PackageSpecs should never have .name==""
-        std::pair<FullPackageSpec, std::string> tag_extracts{FullPackageSpec{{"", triplet}, {}}, ""};
-        const auto file_path =
-            create_tag_extraction_file(View<std::pair<FullPackageSpec, std::string>>{&tag_extracts, 1});
-        launch_and_split(file_path, vars);
-        paths.get_filesystem().remove(file_path, VCPKG_LINE_INFO);
+        const auto key = cache_key(triplet, "generic\n");
+        auto maybe_cached = load_cached_vars(key);
+        if (auto cached = maybe_cached.get())
+        {
+            vars.front() = std::move(*cached);
+        }
+        else
+        {
+            // Hack: PackageSpecs should never have .name==""
+            std::pair<FullPackageSpec, std::string> tag_extracts{FullPackageSpec{{"", triplet}, {}}, ""};
+            const auto file_path =
+                create_tag_extraction_file(View<std::pair<FullPackageSpec, std::string>>{&tag_extracts, 1});
+            launch_and_split(file_path, vars);
+            paths.get_filesystem().remove(file_path, VCPKG_LINE_INFO);
+            store_cached_vars(key, vars.front());
+        }
 
         generic_triplet_vars[triplet].insert(std::make_move_iterator(vars.front().begin()),
                                              std::make_move_iterator(vars.front().end()));
@@ -349,30 +657,45 @@ endfunction()
 
     void TripletCMakeVarProvider::load_dep_info_vars(View<PackageSpec> original_specs, Triplet host_triplet) const
     {
-        std::vector<PackageSpec> specs = Util::filter(original_specs, [this](const PackageSpec& spec) {
-            return dep_resolution_vars.find(spec) == dep_resolution_vars.end();
-        });
+        const auto add_vars = [&](const PackageSpec& spec, std::vector<std::pair<std::string, std::string>>&& vars) {
+            PlatformExpression::Context ctxt{std::make_move_iterator(vars.begin()),
+                                             std::make_move_iterator(vars.end())};
+            ctxt.emplace("Z_VCPKG_IS_NATIVE", host_triplet == spec.triplet() ? "1" : "0");
+            dep_resolution_vars.emplace(spec, std::move(ctxt));
+        };
+
+        std::vector<PackageSpec> specs;
+        std::vector<std::string> cache_keys;
+        for (const PackageSpec& spec : original_specs)
+        {
+            if (dep_resolution_vars.find(spec) != dep_resolution_vars.end()) continue;
+            auto key = cache_key(spec.triplet(), fmt::format("dep-info {}\n", spec.name()));
+            auto maybe_vars = load_cached_vars(key);
+            if (auto vars = maybe_vars.get())
+            {
+                add_vars(spec, std::move(*vars));
+                continue;
+            }
+
+            specs.push_back(spec);
+            cache_keys.push_back(std::move(key));
+        }
+
         if (specs.size() == 0) return;
         Debug::println("Loading dep info for: ", Strings::join(" ", specs));
-        std::vector<std::vector<std::pair<std::string, std::string>>> vars(specs.size());
-        const auto file_path = create_dep_info_extraction_file(specs);
         if (specs.size() > 100)
         {
             msg::println(msgLoadingDependencyInformation, msg::count = specs.size());
         }
-        launch_and_split(file_path, vars);
-        paths.get_filesystem().remove(file_path, VCPKG_LINE_INFO);
 
-        auto var_list_itr = vars.begin();
-        for (const PackageSpec& spec : specs)
-        {
-            PlatformExpression::Context ctxt{std::make_move_iterator(var_list_itr->begin()),
-                                             std::make_move_iterator(var_list_itr->end())};
-            ++var_list_itr;
-
-            ctxt.emplace("Z_VCPKG_IS_NATIVE", host_triplet == spec.triplet() ? "1" : "0");
+        auto vars = extract_sharded(specs.size(), [&](size_t first, size_t last) {
+            return create_dep_info_extraction_file(View<PackageSpec>{specs.data() + first, last - first});
+        });
 
-            dep_resolution_vars.emplace(spec, std::move(ctxt));
+        for (size_t i = 0; i < specs.size(); ++i)
+        {
+            store_cached_vars(cache_keys[i], vars[i]);
+            add_vars(specs[i], std::move(vars[i]));
         }
     }
 
@@ -382,31 +705,56 @@ endfunction()
     {
         if (specs.empty()) return;
         std::vector<std::pair<FullPackageSpec, std::string>> spec_abi_settings;
-        spec_abi_settings.reserve(specs.size());
+        std::vector<std::string> cache_keys;
         Checks::check_exit(VCPKG_LINE_INFO, specs.size() == port_locations.size());
 
+        const auto add_vars = [&](const FullPackageSpec& spec,
+                                  std::vector<std::pair<std::string, std::string>>&& vars) {
+            PlatformExpression::Context ctxt{std::make_move_iterator(vars.begin()),
+                                             std::make_move_iterator(vars.end())};
+            ctxt.emplace("Z_VCPKG_IS_NATIVE", host_triplet == spec.package_spec.triplet() ? "1" : "0");
+            tag_vars.emplace(spec.package_spec, std::move(ctxt));
+        };
+
+        const auto& fs = paths.get_filesystem();
         for (size_t i = 0; i < specs.size(); ++i)
         {
             const auto override_path = port_locations[i] / "vcpkg-abi-settings.cmake";
+            auto entry = fmt::format("tags {} {}\nabi-settings {}\n",
+                                     specs[i].package_spec.name(),
+                                     tag_feature_list(specs[i]),
+                                     override_path.generic_u8string());
+            std::error_code ec;
+            auto override_contents = fs.read_contents(override_path, ec);
+            if (!ec)
+            {
+                fmt::format_to(std::back_inserter(entry), "{}\n", Hash::get_string_sha256(override_contents));
+                append_referenced_environment(entry, override_contents);
+            }
+
+            auto key = cache_key(specs[i].package_spec.triplet(), entry);
+            auto maybe_vars = load_cached_vars(key);
+            if (auto vars = maybe_vars.get())
+            {
+                add_vars(specs[i], std::move(*vars));
+                continue;
+            }
+
             spec_abi_settings.emplace_back(specs[i], override_path.generic_u8string());
+            cache_keys.push_back(std::move(key));
         }
 
-        std::vector<std::vector<std::pair<std::string, std::string>>> vars(spec_abi_settings.size());
-        const auto file_path = create_tag_extraction_file(spec_abi_settings);
-        launch_and_split(file_path, vars);
-        paths.get_filesystem().remove(file_path, VCPKG_LINE_INFO);
+        if (spec_abi_settings.empty()) return;
 
-        auto var_list_itr = vars.begin();
-        for (const auto& spec_abi_setting : spec_abi_settings)
-        {
-            const FullPackageSpec& spec = spec_abi_setting.first;
-            PlatformExpression::Context ctxt{std::make_move_iterator(var_list_itr->begin()),
-                                             std::make_move_iterator(var_list_itr->end())};
-            ++var_list_itr;
-
-            ctxt.emplace("Z_VCPKG_IS_NATIVE", host_triplet == spec.package_spec.triplet() ? "1" : "0");
+        auto vars = extract_sharded(spec_abi_settings.size(), [&](size_t first, size_t last) {
+            return create_tag_extraction_file(
+                View<std::pair<FullPackageSpec, std::string>>{spec_abi_settings.data() + first, last - first});
+        });
 
-            tag_vars.emplace(spec.package_spec, std::move(ctxt));
+        for (size_t i = 0; i < spec_abi_settings.size(); ++i)
+        {
+            store_cached_vars(cache_keys[i], vars[i]);
+            add_vars(spec_abi_settings[i].first, std::move(vars[i]));
         }
     }
 
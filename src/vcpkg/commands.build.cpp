@@ -7,6 +7,7 @@
 #include <vcpkg/base/message_sinks.h>
 #include <vcpkg/base/messages.h>
 #include <vcpkg/base/optional.h>
+#include <vcpkg/base/parallel-algorithms.h>
 #include <vcpkg/base/stringview.h>
 #include <vcpkg/base/system.debug.h>
 #include <vcpkg/base/system.h>
@@ -37,6 +38,7 @@
 #include <vcpkg/vcpkgpaths.h>
 
 #include <numeric>
+#include <unordered_map>
 
 using namespace vcpkg;
 
@@ -777,6 +779,7 @@ namespace vcpkg
     static void get_generic_cmake_build_args(const VcpkgPaths& paths,
                                              Triplet triplet,
                                              const Toolset& toolset,
+                                             unsigned int concurrency,
                                              std::vector<CMakeVariable>& out_vars)
     {
         out_vars.emplace_back(CMakeVariableCmd, "BUILD");
@@ -784,7 +787,7 @@ namespace vcpkg
         out_vars.emplace_back(CMakeVariableTargetTriplet, triplet.canonical_name());
         out_vars.emplace_back(CMakeVariableTargetTripletFile, paths.get_triplet_db().get_triplet_file_path(triplet));
         out_vars.emplace_back(CMakeVariableBaseVersion, VCPKG_BASE_VERSION_AS_STRING);
-        out_vars.emplace_back(CMakeVariableConcurrency, std::to_string(get_concurrency()));
+        out_vars.emplace_back(CMakeVariableConcurrency, std::to_string(concurrency));
         out_vars.emplace_back(CMakeVariablePlatformToolset, toolset.version);
         // Make sure GIT could be found
         out_vars.emplace_back(CMakeVariableGit, paths.get_tool_exe(Tools::GIT, out_sink));
@@ -808,7 +811,7 @@ namespace vcpkg
             {CMakeVariableCompilerCacheFile, paths.installed().compiler_hash_cache_file()},
         };
 
-        get_generic_cmake_build_args(paths, triplet, toolset, cmake_args);
+        get_generic_cmake_build_args(paths, triplet, toolset, get_concurrency(), cmake_args);
 
         auto cmd = vcpkg::make_cmake_cmd(paths, paths.ports_cmake, std::move(cmake_args));
         RedirectedProcessLaunchSettings settings;
@@ -935,10 +938,15 @@ namespace vcpkg
             variables.emplace_back(CMakeVariableProhibitBackcompatFeatures, "1");
         }
 
+        // Ports built side by side share the concurrency budget rather than each using all of it
+        const auto parallel_ports = static_cast<unsigned int>(std::max<size_t>(1, build_options.parallel_ports) *
+                                                              std::max<size_t>(1, build_options.concurrent_plans));
+        const auto port_concurrency = std::max(1u, get_concurrency() / parallel_ports);
         get_generic_cmake_build_args(
             paths,
             action.spec.triplet(),
             action.abi_info.value_or_exit(VCPKG_LINE_INFO).toolset.value_or_exit(VCPKG_LINE_INFO),
+            port_concurrency,
             variables);
 
         if (Util::Enum::to_bool(build_options.only_downloads))
@@ -1138,8 +1146,14 @@ namespace vcpkg
         auto stdoutlog = buildpath / ("stdout-" + action.spec.triplet().canonical_name() + ".log");
         Optional<WriteFilePointer> out_file_storage = fs.open_for_write(stdoutlog, VCPKG_LINE_INFO);
         auto& out_file = out_file_storage.value_or_exit(VCPKG_LINE_INFO);
+        // Output of ports built in parallel would be interleaved on the console, so it only goes to the log
+        const bool echo_build_output = build_options.parallel_ports <= 1 && build_options.concurrent_plans <= 1;
         auto return_code = cmd_execute_and_stream_data(cmd, settings, [&](StringView sv) {
-            msg::write_unlocalized_text(Color::none, sv);
+            if (echo_build_output)
+            {
+                msg::write_unlocalized_text(Color::none, sv);
+            }
+
             Checks::msg_check_exit(VCPKG_LINE_INFO,
                                    out_file.write(sv.data(), 1, sv.size()) == sv.size(),
                                    msgErrorWhileWriting,
@@ -1288,11 +1302,87 @@ namespace vcpkg
         }
     }
 
+    // Hashes of the files named by VCPKG_HASH_ADDITIONAL_FILES and VCPKG_POST_PORTFILE_INCLUDES
+    using AbiFileHashes = std::map<Path, std::string, std::less<>>;
+
+    static std::string get_abi_file_hash(const ReadOnlyFilesystem& fs,
+                                         const AbiFileHashes& abi_file_hashes,
+                                         const Path& file)
+    {
+        auto it = abi_file_hashes.find(file);
+        if (it != abi_file_hashes.end() && !it->second.empty())
+        {
+            return it->second;
+        }
+
+        return Hash::get_file_hash(fs, file, Hash::Algorithm::Sha256).value_or_exit(VCPKG_LINE_INFO);
+    }
+
+    static PortDirAbiInfoCacheEntry compute_port_dir_abi_info(const VcpkgPaths& paths,
+                                                              const InstallPlanAction& action)
+    {
+        auto& fs = paths.get_filesystem();
+        auto& scfl = action.source_control_file_and_location.value_or_exit(VCPKG_LINE_INFO);
+        auto&& port_dir = scfl.port_directory();
+        PortDirAbiInfoCacheEntry port_dir_cache_entry;
+
+        std::string portfile_cmake_contents;
+        {
+            auto rel_port_files = fs.get_regular_files_recursive_lexically_proximate(port_dir, VCPKG_LINE_INFO);
+            Util::erase_remove_if(rel_port_files,
+                                  [](const Path& port_file) { return port_file.filename() == FileDotDsStore; });
+            // If there is an unusually large number of files in the port then
+            // something suspicious is going on.
+            constexpr int max_port_file_count = 100;
+            if (rel_port_files.size() > max_port_file_count)
+            {
+                msg::println_warning(
+                    msgHashPortManyFiles, msg::package_name = action.spec.name(), msg::count = rel_port_files.size());
+            }
+            port_dir_cache_entry.files = std::move(rel_port_files);
+        }
+
+        for (const Path& rel_port_file : port_dir_cache_entry.files)
+        {
+            const Path abs_port_file = port_dir / rel_port_file;
+
+            if (rel_port_file.extension() == ".cmake")
+            {
+                const auto contents = fs.read_contents(abs_port_file, VCPKG_LINE_INFO);
+                portfile_cmake_contents += contents;
+                port_dir_cache_entry.hashes.push_back(vcpkg::Hash::get_string_sha256(contents));
+            }
+            else
+            {
+                port_dir_cache_entry.hashes.push_back(
+                    vcpkg::Hash::get_file_hash(fs, abs_port_file, Hash::Algorithm::Sha256)
+                        .value_or_exit(VCPKG_LINE_INFO));
+            }
+            port_dir_cache_entry.abi_entries.emplace_back(rel_port_file, port_dir_cache_entry.hashes.back());
+        }
+
+        port_dir_cache_entry.heuristic_resources =
+            run_resource_heuristics(portfile_cmake_contents, scfl.source_control_file->core_paragraph->version.text);
+
+        auto& helpers = paths.get_cmake_script_hashes();
+        for (auto&& helper : helpers)
+        {
+            if (Strings::case_insensitive_ascii_contains(portfile_cmake_contents, helper.first))
+            {
+                port_dir_cache_entry.abi_entries.emplace_back(helper.first, helper.second);
+            }
+        }
+
+        return port_dir_cache_entry;
+    }
+
     static void populate_abi_tag(const VcpkgPaths& paths,
                                  InstallPlanAction& action,
                                  std::unique_ptr<PreBuildInfo>&& proto_pre_build_info,
                                  Span<const AbiEntry> dependency_abis,
                                  PortDirAbiInfoCache& port_dir_cache,
+                                 std::set<Path, std::less<>>& uncached_port_dirs,
+                                 const AbiFileHashes& abi_file_hashes,
                                  Cache<Path, Optional<std::string>>& grdk_cache)
     {
         Checks::check_exit(VCPKG_LINE_INFO, static_cast<bool>(proto_pre_build_info));
@@ -1338,75 +1428,29 @@ namespace vcpkg
         abi_entries_from_pre_build_info(fs, grdk_cache, pre_build_info, abi_tag_entries);
 
         auto&& port_dir = action.source_control_file_and_location.value_or_exit(VCPKG_LINE_INFO).port_directory();
+        bool first_use_of_port_dir = uncached_port_dirs.erase(port_dir) != 0;
         const auto& port_dir_cache_entry = port_dir_cache.get_lazy(port_dir, [&]() {
-            PortDirAbiInfoCacheEntry port_dir_cache_entry;
+            first_use_of_port_dir = true;
+            return compute_port_dir_abi_info(paths, action);
+        });
 
-            std::string portfile_cmake_contents;
-            {
-                auto rel_port_files = fs.get_regular_files_recursive_lexically_proximate(port_dir, VCPKG_LINE_INFO);
-                Util::erase_remove_if(rel_port_files,
-                                      [](const Path& port_file) { return port_file.filename() == FileDotDsStore; });
-                // If there is an unusually large number of files in the port then
-                // something suspicious is going on.
-                constexpr int max_port_file_count = 100;
-                if (rel_port_files.size() > max_port_file_count)
-                {
-                    msg::println_warning(msgHashPortManyFiles,
-                                         msg::package_name = action.spec.name(),
-                                         msg::count = rel_port_files.size());
-                }
-                port_dir_cache_entry.files = std::move(rel_port_files);
-            }
-            const auto& rel_port_files = port_dir_cache_entry.files;
-            // Technically the pre_build_info is not part of the port_dir cache key, but a given port_dir is only going
-            // to be associated with 1 port
-            for (size_t i = 0; i < abi_info.pre_build_info->hash_additional_files.size(); ++i)
+        if (first_use_of_port_dir)
+        {
+            // The first action to use a port directory has always had the additional files hashed twice; keep
+            // doing so, as existing package ABIs depend on it
+            for (size_t i = 0; i < pre_build_info.hash_additional_files.size(); ++i)
             {
-                const auto& file = abi_info.pre_build_info->hash_additional_files[i];
+                const auto& file = pre_build_info.hash_additional_files[i];
                 if (file.is_relative() || !fs.is_regular_file(file))
                 {
                     Checks::msg_exit_with_message(
                         VCPKG_LINE_INFO, msgInvalidValueHashAdditionalFiles, msg::path = file);
                 }
-                abi_tag_entries.emplace_back(
-                    fmt::format("additional_file_{}", i),
-                    Hash::get_file_hash(fs, file, Hash::Algorithm::Sha256).value_or_exit(VCPKG_LINE_INFO));
-            }
-
-            for (const Path& rel_port_file : rel_port_files)
-            {
-                const Path abs_port_file = port_dir / rel_port_file;
 
-                if (rel_port_file.extension() == ".cmake")
-                {
-                    const auto contents = fs.read_contents(abs_port_file, VCPKG_LINE_INFO);
-                    portfile_cmake_contents += contents;
-                    port_dir_cache_entry.hashes.push_back(vcpkg::Hash::get_string_sha256(contents));
-                }
-                else
-                {
-                    port_dir_cache_entry.hashes.push_back(
-                        vcpkg::Hash::get_file_hash(fs, abs_port_file, Hash::Algorithm::Sha256)
-                            .value_or_exit(VCPKG_LINE_INFO));
-                }
-                port_dir_cache_entry.abi_entries.emplace_back(rel_port_file, port_dir_cache_entry.hashes.back());
-            }
-
-            auto& scf = action.source_control_file_and_location.value_or_exit(VCPKG_LINE_INFO).source_control_file;
-            port_dir_cache_entry.heuristic_resources =
-                run_resource_heuristics(portfile_cmake_contents, scf->core_paragraph->version.text);
-
-            auto& helpers = paths.get_cmake_script_hashes();
-            for (auto&& helper : helpers)
-            {
-                if (Strings::case_insensitive_ascii_contains(portfile_cmake_contents, helper.first))
-                {
-                    port_dir_cache_entry.abi_entries.emplace_back(helper.first, helper.second);
-                }
+                abi_tag_entries.emplace_back(fmt::format("additional_file_{}", i),
+                                             get_abi_file_hash(fs, abi_file_hashes, file));
             }
-
-            return port_dir_cache_entry;
-        });
+        }
 
         Util::Vectors::append(abi_tag_entries, port_dir_cache_entry.abi_entries);
 
@@ -1420,9 +1464,8 @@ namespace vcpkg
                     Checks::msg_exit_with_message(
                         VCPKG_LINE_INFO, msgInvalidValueHashAdditionalFiles, msg::path = file);
                 }
-                const auto hash =
-                    vcpkg::Hash::get_file_hash(fs, file, Hash::Algorithm::Sha256).value_or_exit(VCPKG_LINE_INFO);
-                abi_tag_entries.emplace_back(fmt::format("additional_file_{}", i++), hash);
+                abi_tag_entries.emplace_back(fmt::format("additional_file_{}", i++),
+                                             get_abi_file_hash(fs, abi_file_hashes, file));
             }
         }
 
@@ -1434,9 +1477,8 @@ namespace vcpkg
                 Checks::msg_exit_with_message(VCPKG_LINE_INFO, msgInvalidValuePostPortfileIncludes, msg::path = file);
             }
 
-            abi_tag_entries.emplace_back(
-                fmt::format("post_portfile_include_{}", i),
-                Hash::get_file_hash(fs, file, Hash::Algorithm::Sha256).value_or_exit(VCPKG_LINE_INFO));
+            abi_tag_entries.emplace_back(fmt::format("post_portfile_include_{}", i),
+                                         get_abi_file_hash(fs, abi_file_hashes, file));
         }
 
         abi_tag_entries.emplace_back(AbiTagCMake, paths.get_tool_version(Tools::CMAKE, out_sink));
@@ -1515,59 +1557,121 @@ namespace vcpkg
                           const StatusParagraphs& status_db,
                           PortDirAbiInfoCache& port_dir_cache)
     {
-        Cache<Path, Optional<std::string>> grdk_cache;
-        for (auto it = action_plan.install_actions.begin(); it != action_plan.install_actions.end(); ++it)
+        auto& fs = paths.get_filesystem();
+        auto& install_actions = action_plan.install_actions;
+
+        // First hash everything the ABI tags depend on which is expensive to read, in parallel. Port directories
+        // and files shared between actions are only hashed once.
+        std::vector<std::unique_ptr<PreBuildInfo>> pre_build_infos(install_actions.size());
+        std::vector<const InstallPlanAction*> port_dir_actions;
+        std::set<Path, std::less<>> uncached_port_dirs;
+        std::set<Path, std::less<>> abi_files;
+        for (size_t idx = 0; idx < install_actions.size(); ++idx)
         {
-            auto& action = *it;
+            auto& action = install_actions[idx];
             if (action.abi_info.has_value()) continue;
 
-            std::vector<AbiEntry> dependency_abis;
-            for (auto&& pspec : action.package_dependencies)
+            pre_build_infos[idx] = std::make_unique<PreBuildInfo>(
+                paths, action.spec.triplet(), var_provider.get_tag_vars(action.spec).value_or_exit(VCPKG_LINE_INFO));
+            if (action.use_head_version == UseHeadVersion::Yes || action.editable == Editable::Yes) continue;
+
+            auto&& port_dir = action.source_control_file_and_location.value_or_exit(VCPKG_LINE_INFO).port_directory();
+            if (!port_dir_cache.contains(port_dir) && uncached_port_dirs.insert(port_dir).second)
+            {
+                port_dir_actions.push_back(&action);
+            }
+
+            for (auto&& file : pre_build_infos[idx]->hash_additional_files)
             {
-                if (pspec == action.spec) continue;
+                if (!file.is_relative()) abi_files.insert(file);
+            }
+
+            for (auto&& file : pre_build_infos[idx]->post_portfile_includes)
+            {
+                if (!file.is_relative()) abi_files.insert(file);
+            }
+        }
+
+        // populate lazily computed state before the workers read it
+        paths.get_cmake_script_hashes();
+        std::vector<PortDirAbiInfoCacheEntry> port_dir_entries(port_dir_actions.size());
+        parallel_transform(port_dir_actions, port_dir_entries.begin(), [&](const InstallPlanAction* action) {
+            return compute_port_dir_abi_info(paths, *action);
+        });
+
+        for (size_t i = 0; i < port_dir_actions.size(); ++i)
+        {
+            auto&& port_dir =
+                port_dir_actions[i]->source_control_file_and_location.value_or_exit(VCPKG_LINE_INFO).port_directory();
+            port_dir_cache.get_lazy(port_dir, [&]() { return std::move(port_dir_entries[i]); });
+        }
+
+        const std::vector<Path> abi_file_list(abi_files.begin(), abi_files.end());
+        std::vector<std::string> abi_file_hash_list(abi_file_list.size());
+        parallel_transform(abi_file_list, abi_file_hash_list.begin(), [&](const Path& file) -> std::string {
+            // invalid files are diagnosed by populate_abi_tag
+            if (!fs.is_regular_file(file)) return std::string();
+            return Hash::get_file_hash(fs, file, Hash::Algorithm::Sha256).value_or(std::string());
+        });
 
-                auto pred = [&](const InstallPlanAction& ipa) { return ipa.spec == pspec; };
-                auto it2 = std::find_if(action_plan.install_actions.begin(), it, pred);
-                if (it2 == it)
+        AbiFileHashes abi_file_hashes;
+        for (size_t i = 0; i < abi_file_list.size(); ++i)
+        {
+            abi_file_hashes.emplace(abi_file_list[i], std::move(abi_file_hash_list[i]));
+        }
+
+        // Then assemble the tags in plan order, as each depends on the ABIs of the actions before it.
+        std::unordered_map<PackageSpec, const InstallPlanAction*> planned_actions;
+        Cache<Path, Optional<std::string>> grdk_cache;
+        for (size_t idx = 0; idx < install_actions.size(); ++idx)
+        {
+            auto& action = install_actions[idx];
+            if (pre_build_infos[idx])
+            {
+                std::vector<AbiEntry> dependency_abis;
+                for (auto&& pspec : action.package_dependencies)
                 {
-                    // Finally, look in current installed
-                    auto status_it = status_db.find(pspec);
-                    if (status_it == status_db.end())
+                    if (pspec == action.spec) continue;
+
+                    auto planned = planned_actions.find(pspec);
+                    if (planned == planned_actions.end())
                     {
-                        Checks::unreachable(
-                            VCPKG_LINE_INFO,
-                            fmt::format("Failed to find dependency abi for {} -> {}", action.spec, pspec));
-                    }
+                        // Finally, look in current installed
+                        auto status_it = status_db.find(pspec);
+                        if (status_it == status_db.end())
+                        {
+                            Checks::unreachable(
+                                VCPKG_LINE_INFO,
+                                fmt::format("Failed to find dependency abi for {} -> {}", action.spec, pspec));
+                        }
 
-                    dependency_abis.emplace_back(pspec.name(), status_it->get()->package.abi);
-                }
-                else
-                {
-                    dependency_abis.emplace_back(pspec.name(), it2->public_abi());
+                        dependency_abis.emplace_back(pspec.name(), status_it->get()->package.abi);
+                    }
+                    else
+                    {
+                        dependency_abis.emplace_back(pspec.name(), planned->second->public_abi());
+                    }
                 }
+
+                populate_abi_tag(paths,
+                                 action,
+                                 std::move(pre_build_infos[idx]),
+                                 dependency_abis,
+                                 port_dir_cache,
+                                 uncached_port_dirs,
+                                 abi_file_hashes,
+                                 grdk_cache);
             }
 
-            populate_abi_tag(
-                paths,
-                action,
-                std::make_unique<PreBuildInfo>(paths,
-                                               action.spec.triplet(),
-                                               var_provider.get_tag_vars(action.spec).value_or_exit(VCPKG_LINE_INFO)),
-                dependency_abis,
-                port_dir_cache,
-                grdk_cache);
+            // the first action for a spec wins, as it did when dependencies were found by searching the plan
+            planned_actions.emplace(action.spec, &action);
         }
     }
 
-    ExtendedBuildResult build_package(const VcpkgCmdArguments& args,
-                                      const VcpkgPaths& paths,
-                                      Triplet host_triplet,
-                                      const BuildPackageOptions& build_options,
-                                      const InstallPlanAction& action,
-                                      const IBuildLogsRecorder& build_logs_recorder,
-                                      const StatusParagraphs& status_db)
+    std::vector<FullPackageSpec> find_missing_build_dependencies(const BuildPackageOptions& build_options,
+                                                                 const InstallPlanAction& action,
+                                                                 const StatusParagraphs& status_db)
     {
-        auto& filesystem = paths.get_filesystem();
         auto& spec = action.spec;
         const std::string& name = action.source_control_file_and_location.value_or_exit(VCPKG_LINE_INFO).to_name();
 
@@ -1583,22 +1687,9 @@ namespace vcpkg
             }
         }
 
-        const bool all_dependencies_satisfied = missing_fspecs.empty();
-        if (build_options.only_downloads == OnlyDownloads::No)
+        if (build_options.only_downloads == OnlyDownloads::No && missing_fspecs.empty())
         {
-            if (!all_dependencies_satisfied)
-            {
-                return {BuildResult::CascadedDueToMissingDependencies,
-                        Util::fmap(std::move(missing_fspecs),
-                                   [](std::pair<PackageSpec, std::set<std::string>>&& missing_features) {
-                                       return FullPackageSpec{
-                                           std::move(missing_features.first),
-                                           InternalFeatureSet{std::make_move_iterator(missing_features.second.begin()),
-                                                              std::make_move_iterator(missing_features.second.end())}};
-                                   })};
-            }
-
-            // assert that all_dependencies_satisfied is accurate above by checking that they're all installed
+            // assert that the dependencies are accurate above by checking that they're all installed
             for (auto&& pspec : action.package_dependencies)
             {
                 if (pspec == spec)
@@ -1613,6 +1704,44 @@ namespace vcpkg
             }
         }
 
+        return Util::fmap(std::move(missing_fspecs),
+                          [](std::pair<PackageSpec, std::set<std::string>>&& missing_features) {
+                              return FullPackageSpec{
+                                  std::move(missing_features.first),
+                                  InternalFeatureSet{std::make_move_iterator(missing_features.second.begin()),
+                                                     std::make_move_iterator(missing_features.second.end())}};
+                          });
+    }
+
+    ExtendedBuildResult build_package(const VcpkgCmdArguments& args,
+                                      const VcpkgPaths& paths,
+                                      Triplet host_triplet,
+                                      const BuildPackageOptions& build_options,
+                                      const InstallPlanAction& action,
+                                      const IBuildLogsRecorder& build_logs_recorder,
+                                      const StatusParagraphs& status_db)
+    {
+        auto missing_dependencies = find_missing_build_dependencies(build_options, action, status_db);
+        const bool all_dependencies_satisfied = missing_dependencies.empty();
+        if (build_options.only_downloads == OnlyDownloads::No && !all_dependencies_satisfied)
+        {
+            return {BuildResult::CascadedDueToMissingDependencies, std::move(missing_dependencies)};
+        }
+
+        return build_package_with_checked_dependencies(
+            args, paths, host_triplet, build_options, action, build_logs_recorder, all_dependencies_satisfied);
+    }
+
+    ExtendedBuildResult build_package_with_checked_dependencies(const VcpkgCmdArguments& args,
+                                                                const VcpkgPaths& paths,
+                                                                Triplet host_triplet,
+                                                                const BuildPackageOptions& build_options,
+                                                                const InstallPlanAction& action,
+                                                                const IBuildLogsRecorder& build_logs_recorder,
+                                                                bool all_dependencies_satisfied)
+    {
+        auto& filesystem = paths.get_filesystem();
+        auto& spec = action.spec;
         auto& abi_info = action.abi_info.value_or_exit(VCPKG_LINE_INFO);
         ExtendedBuildResult result = do_build_package_and_clean_buildtrees(
             args, paths, host_triplet, build_options, action, all_dependencies_satisfied);
@@ -0,0 +1,80 @@
+#include <vcpkg/base/contractual-constants.h>
+#include <vcpkg/base/files.h>
+#include <vcpkg/base/json.h>
+#include <vcpkg/base/util.h>
+
+#include <vcpkg/ci-shards.h>
+#include <vcpkg/commands.ci-merge-shards.h>
+#include <vcpkg/vcpkgcmdarguments.h>
+#include <vcpkg/vcpkgpaths.h>
+#include <vcpkg/xunitwriter.h>
+
+using namespace vcpkg;
+
+namespace
+{
+    constexpr CommandSetting MERGE_SHARDS_SETTINGS[] = {
+        {SwitchXResultsJson, msgCISettingsOptResultsJson},
+        {SwitchXXUnit, msgCISettingsOptXUnit},
+    };
+}
+
+namespace vcpkg
+{
+    constexpr CommandMetadata CommandCiMergeShardsMetadata{
+        "x-ci-merge-shards",
+        msgCmdCiMergeShardsSynopsis,
+        {"vcpkg x-ci-merge-shards --triplet=x64-windows --x-xunit=merged.xml shard-1.json shard-2.json"},
+        Undocumented,
+        AutocompletePriority::Internal,
+        1,
+        SIZE_MAX,
+        {{}, MERGE_SHARDS_SETTINGS},
+        nullptr,
+    };
+
+    void command_ci_merge_shards_and_exit(const VcpkgCmdArguments& args,
+                                          const VcpkgPaths& paths,
+                                          Triplet target_triplet,
+                                          Triplet /*host_triplet*/)
+    {
+        const ParsedArguments options = args.parse_arguments(CommandCiMergeShardsMetadata);
+        auto& fs = paths.get_filesystem();
+        const auto& settings = options.settings;
+
+        std::vector<std::vector<CiResult>> shard_results;
+        for (auto&& shard_results_file : options.command_arguments)
+        {
+            const Path shard_results_path = paths.original_cwd / shard_results_file;
+            auto parsed_json = Json::parse_file(VCPKG_LINE_INFO, fs, shard_results_path).value;
+            shard_results.push_back(
+                parse_ci_results(parsed_json, shard_results_path).value_or_exit(VCPKG_LINE_INFO));
+        }
+
+        const auto merged = merge_ci_results(shard_results);
+        auto it_results_json = settings.find(SwitchXResultsJson);
+        if (it_results_json != settings.end())
+        {
+            fs.write_contents(paths.original_cwd / it_results_json->second,
+                              Json::stringify(serialize_ci_results(merged)),
+                              VCPKG_LINE_INFO);
+        }
+
+        auto it_xunit = settings.find(SwitchXXUnit);
+        if (it_xunit != settings.end())
+        {
+            XunitWriter xunitTestResults;
+            for (auto&& result : merged)
+            {
+                xunitTestResults.add_test_results(
+                    result.spec, result.result, result.elapsed, result.start_time, result.abi, result.features);
+            }
+
+            fs.write_contents(
+                paths.original_cwd / it_xunit->second, xunitTestResults.build_xml(target_triplet), VCPKG_LINE_INFO);
+        }
+
+        msg::println(msgCiMergedShardResults, msg::count = shard_results.size());
+        Checks::exit_success(VCPKG_LINE_INFO);
+    }
+}
@@ -9,6 +9,7 @@
 
 #include <vcpkg/binarycaching.h>
 #include <vcpkg/ci-baseline.h>
+#include <vcpkg/ci-shards.h>
 #include <vcpkg/cmakevars.h>
 #include <vcpkg/commands.build.h>
 #include <vcpkg/commands.ci.h>
@@ -26,6 +27,7 @@
 #include <vcpkg/xunitwriter.h>
 
 #include <random>
+#include <thread>
 
 using namespace vcpkg;
 
@@ -40,6 +42,11 @@ namespace
         {SwitchOutputHashes, msgCISettingsOptOutputHashes},
         {SwitchParentHashes, msgCISettingsOptParentHashes},
         {SwitchKnownFailuresFrom, msgCISettingsOptKnownFailuresFrom},
+        {SwitchXResultsJson, msgCISettingsOptResultsJson},
+        {SwitchXShard, msgCISettingsOptShard},
+        {SwitchXShardHistory, msgCISettingsOptShardHistory},
+        {SwitchXShardStatus, msgCISettingsOptShardStatus},
+        {SwitchXShardTimeout, msgCISettingsOptShardTimeout},
     };
 
     constexpr CommandSwitch CI_SWITCHES[] = {
@@ -100,12 +107,7 @@ namespace
 
         var_provider.load_dep_info_vars(packages_with_qualified_deps, serialize_options.host_triplet);
 
-        const auto applicable_specs = Util::filter(specs, [&](auto& spec) -> bool {
-            PackagesDirAssigner this_packages_dir_not_used{""};
-            return create_feature_install_plan(
-                       provider, var_provider, {&spec, 1}, {}, this_packages_dir_not_used, serialize_options)
-                .unsupported_features.empty();
-        });
+        const auto applicable_specs = filter_supported_specs(provider, var_provider, specs, serialize_options);
 
         auto action_plan = create_feature_install_plan(
             provider, var_provider, applicable_specs, {}, packages_dir_assigner, serialize_options);
@@ -206,6 +208,192 @@ namespace
         });
     }
 
+    // Splits the plan of a shard into the plans of its waves.
+    std::vector<ActionPlan> split_shard_waves(ActionPlan&& action_plan, const CiShardPlan& shard_plan)
+    {
+        std::vector<ActionPlan> waves(std::max<size_t>(shard_plan.wave_count, 1));
+        for (auto&& action : action_plan.install_actions)
+        {
+            auto it = shard_plan.waves.find(action.spec);
+            waves[it == shard_plan.waves.end() ? 0 : it->second].install_actions.push_back(std::move(action));
+        }
+
+        action_plan.install_actions.clear();
+        return waves;
+    }
+
+    // A shard reports each of its ports which fails in the status directory shared by the shards, keyed by the ABI
+    // which the shards depending on it wait for.
+    Path ci_shard_failure_path(const Path& status_dir, StringView abi)
+    {
+        return status_dir / fmt::format("{}.failed", abi);
+    }
+
+    // Observes the ports which other shards build through the binary cache, and the failures they report in the status
+    // directory, if any.
+    struct CiShardCacheObserver final : ICiShardObserver
+    {
+        CiShardCacheObserver(const Filesystem& fs, const Optional<Path>& status_dir, BinaryCache& binary_cache)
+            : fs(fs), status_dir(status_dir), binary_cache(binary_cache)
+        {
+        }
+
+        std::vector<CiShardPortState> poll(View<const InstallPlanAction*> actions) override
+        {
+            const auto availability = binary_cache.precheck(actions);
+            std::vector<CiShardPortState> states;
+            for (size_t i = 0; i < actions.size(); ++i)
+            {
+                auto& action = *actions[i];
+                if (availability[i] == CacheAvailability::available)
+                {
+                    states.push_back(CiShardPortState::Available);
+                    continue;
+                }
+
+                auto dir = status_dir.get();
+                auto abi = action.package_abi().get();
+                if (dir && abi && fs.exists(ci_shard_failure_path(*dir, *abi), IgnoreErrors{}))
+                {
+                    states.push_back(CiShardPortState::Failed);
+                    continue;
+                }
+
+                // the next precheck asks the providers again
+                binary_cache.mark_unknown(action);
+                states.push_back(CiShardPortState::Pending);
+            }
+
+            return states;
+        }
+
+        void pause() override { std::this_thread::sleep_for(std::chrono::seconds(10)); }
+
+        std::chrono::seconds elapsed() const override { return timer.elapsed().as<std::chrono::seconds>(); }
+
+    private:
+        const Filesystem& fs;
+        const Optional<Path>& status_dir;
+        BinaryCache& binary_cache;
+        const ElapsedTimer timer;
+    };
+
+    // Reports the ports of this shard which fail to build as soon as they do.
+    struct CiShardFailureRecorder final : IBuildLogsRecorder
+    {
+        CiShardFailureRecorder(const IBuildLogsRecorder& inner,
+                               const Filesystem& fs,
+                               const Path& status_dir,
+                               std::map<PackageSpec, std::string>&& abis)
+            : inner(inner), fs(fs), status_dir(status_dir), abis(std::move(abis))
+        {
+        }
+
+        void record_build_result(const VcpkgPaths& paths, const PackageSpec& spec, BuildResult result) const override
+        {
+            inner.record_build_result(paths, spec, result);
+            if (result != BuildResult::Succeeded)
+            {
+                publish(spec, result);
+            }
+        }
+
+        void publish(const PackageSpec& spec, BuildResult result) const
+        {
+            auto it_abi = abis.find(spec);
+            if (it_abi != abis.end())
+            {
+                fs.write_contents_and_dirs(ci_shard_failure_path(status_dir, it_abi->second),
+                                           fmt::format("{}: {}\n", spec, to_string_locale_invariant(result)),
+                                           VCPKG_LINE_INFO);
+            }
+        }
+
+    private:
+        const IBuildLogsRecorder& inner;
+        const Filesystem& fs;
+        const Path& status_dir;
+        std::map<PackageSpec, std::string> abis;
+    };
+
+    // Installs the waves of a shard in order, after the packages each needs from other shards are built. The results
+    // of those packages are left to the shards which build them.
+    InstallSummary install_shard_waves(const VcpkgCmdArguments& args,
+                                       const VcpkgPaths& paths,
+                                       Triplet host_triplet,
+                                       const BuildPackageOptions& build_options,
+                                       std::vector<ActionPlan>& waves,
+                                       const CiShardPlan& shard_plan,
+                                       const std::map<PackageSpec, CiShardTarget>& shard_targets,
+                                       const Optional<Path>& status_dir,
+                                       std::chrono::seconds timeout,
+                                       StatusParagraphs& status_db,
+                                       BinaryCache& binary_cache,
+                                       const IBuildLogsRecorder& build_logs_recorder)
+    {
+        const ElapsedTimer timer;
+        Optional<CiShardFailureRecorder> failure_recorder;
+        const IBuildLogsRecorder* wave_logs_recorder = &build_logs_recorder;
+        if (auto dir = status_dir.get())
+        {
+            std::map<PackageSpec, std::string> abis;
+            for (auto&& wave : waves)
+            {
+                for (auto&& action : wave.install_actions)
+                {
+                    auto abi = action.package_abi().get();
+                    if (abi && !Util::Sets::contains(shard_plan.built_elsewhere, action.spec))
+                    {
+                        abis.emplace(action.spec, *abi);
+                    }
+                }
+            }
+
+            wave_logs_recorder =
+                &failure_recorder.emplace(build_logs_recorder, paths.get_filesystem(), *dir, std::move(abis));
+        }
+
+        CiShardCacheObserver observer(paths.get_filesystem(), status_dir, binary_cache);
+        CiShardWaiter waiter(shard_targets, timeout);
+        InstallSummary summary;
+        for (auto&& wave : waves)
+        {
+            waiter.wait(wave.install_actions, shard_plan.built_elsewhere, observer);
+            if (wave.install_actions.empty())
+            {
+                continue;
+            }
+
+            binary_cache.fetch(wave.install_actions);
+            auto wave_summary = install_execute_plan(
+                args, paths, host_triplet, build_options, wave, status_db, binary_cache, *wave_logs_recorder);
+            summary.failed = summary.failed || wave_summary.failed;
+            for (auto&& result : wave_summary.results)
+            {
+                if (Util::Sets::contains(shard_plan.built_elsewhere, result.get_spec()))
+                {
+                    continue;
+                }
+
+                // failures other than builds, such as cascades, are reported too
+                const auto code = result.build_result.value_or_exit(VCPKG_LINE_INFO).code;
+                if (code != BuildResult::Succeeded)
+                {
+                    waiter.record_failure(result.get_spec());
+                    if (auto recorder = failure_recorder.get())
+                    {
+                        recorder->publish(result.get_spec(), code);
+                    }
+                }
+
+                summary.results.push_back(std::move(result));
+            }
+        }
+
+        summary.elapsed = timer.elapsed();
+        return summary;
+    }
+
     void parse_exclusions(const std::map<StringLiteral, std::string, std::less<>>& settings,
                           StringLiteral opt,
                           Triplet triplet,
@@ -334,6 +522,37 @@ namespace vcpkg
             known_failures.insert(lines.begin(), lines.end());
         }
 
+        Optional<CiShard> shard;
+        auto it_shard = settings.find(SwitchXShard);
+        if (it_shard != settings.end())
+        {
+            shard = parse_ci_shard(it_shard->second);
+            if (!shard.has_value())
+            {
+                Checks::msg_exit_with_error(VCPKG_LINE_INFO, msgCiInvalidShard, msg::value = it_shard->second);
+            }
+        }
+
+        Optional<Path> shard_status_dir;
+        if (auto shard_status_setting = Util::lookup_value(settings, SwitchXShardStatus).get())
+        {
+            shard_status_dir = paths.original_cwd / *shard_status_setting;
+        }
+
+        std::chrono::seconds shard_timeout{1800};
+        if (auto shard_timeout_setting = Util::lookup_value(settings, SwitchXShardTimeout).get())
+        {
+            auto maybe_parsed = Strings::strto<int>(*shard_timeout_setting);
+            auto parsed = maybe_parsed.get();
+            if (!parsed || *parsed <= 0)
+            {
+                Checks::msg_exit_with_error(
+                    VCPKG_LINE_INFO, msgOptionMustBePositiveInteger, msg::option = SwitchXShardTimeout);
+            }
+
+            shard_timeout = std::chrono::seconds(*parsed);
+        }
+
         const auto is_dry_run = Util::Sets::contains(options.switches, SwitchDryRun);
 
         const IBuildLogsRecorder* build_logs_recorder = &null_build_logs_recorder;
@@ -396,6 +615,12 @@ namespace vcpkg
         const auto precheck_results = binary_cache.precheck(install_actions);
         auto split_specs =
             compute_action_statuses(ExclusionPredicate{&exclusions_map}, precheck_results, known_failures, action_plan);
+        std::map<PackageSpec, StringLiteral> action_states;
+        for (size_t i = 0; i < action_plan.install_actions.size(); ++i)
+        {
+            action_states.emplace(action_plan.install_actions[i].spec, split_specs->action_state_string[i]);
+        }
+
         LocalizedString not_supported_regressions;
         {
             std::string msg;
@@ -407,6 +632,7 @@ namespace vcpkg
                     split_specs->known.emplace(spec.package_spec,
                                                supp ? BuildResult::CascadedDueToMissingDependencies
                                                     : BuildResult::Excluded);
+                    action_states.emplace(spec.package_spec, supp ? StringLiteral{"cascade"} : StringLiteral{"skip"});
 
                     if (cidata.expected_failures.contains(spec.package_spec))
                     {
@@ -466,7 +692,32 @@ namespace vcpkg
             });
         }
 
+        // Shards are assigned before removing the cached ports, since machines may check the cache at different times
+        std::map<PackageSpec, CiShardTarget> shard_targets;
+        if (auto selected_shard = shard.get())
+        {
+            std::map<PackageSpec, double> build_seconds;
+            auto it_shard_history = settings.find(SwitchXShardHistory);
+            if (it_shard_history != settings.end())
+            {
+                const Path shard_history_path = paths.original_cwd / it_shard_history->second;
+                auto parsed_json = Json::parse_file(VCPKG_LINE_INFO, fs, shard_history_path).value;
+                build_seconds = get_ci_build_seconds(
+                    parse_ci_results(parsed_json, shard_history_path).value_or_exit(VCPKG_LINE_INFO));
+            }
+
+            shard_targets = assign_ci_shards(action_plan, split_specs->known, build_seconds, selected_shard->count);
+        }
+
         reduce_action_plan(action_plan, split_specs->known, parent_hashes);
+        Optional<CiShardPlan> shard_plan;
+        if (auto selected_shard = shard.get())
+        {
+            shard_plan = shard_action_plan(action_plan, split_specs->known, shard_targets, *selected_shard);
+            msg::println(msgCiShardAssigned,
+                         msg::value = it_shard->second,
+                         msg::count = action_plan.install_actions.size());
+        }
 
         msg::println(msgElapsedTimeForChecks, msg::elapsed = timer.elapsed());
 
@@ -498,10 +749,37 @@ namespace vcpkg
             }
 
             install_preclear_plan_packages(paths, action_plan);
-            binary_cache.fetch(action_plan.install_actions);
+            InstallSummary summary;
+            std::vector<ActionPlan> shard_waves;
+            if (auto selected_shard_plan = shard_plan.get())
+            {
+                shard_waves = split_shard_waves(std::move(action_plan), *selected_shard_plan);
+                summary = install_shard_waves(args,
+                                              paths,
+                                              host_triplet,
+                                              build_options,
+                                              shard_waves,
+                                              *selected_shard_plan,
+                                              shard_targets,
+                                              shard_status_dir,
+                                              shard_timeout,
+                                              status_db,
+                                              binary_cache,
+                                              *build_logs_recorder);
+            }
+            else
+            {
+                binary_cache.fetch(action_plan.install_actions);
+                summary = install_execute_plan(args,
+                                               paths,
+                                               host_triplet,
+                                               build_options,
+                                               action_plan,
+                                               status_db,
+                                               binary_cache,
+                                               *build_logs_recorder);
+            }
 
-            auto summary = install_execute_plan(
-                args, paths, host_triplet, build_options, action_plan, status_db, binary_cache, *build_logs_recorder);
             msg::println(msgTotalInstallTime, msg::elapsed = summary.elapsed);
             for (auto&& result : summary.results)
             {
@@ -555,6 +833,46 @@ namespace vcpkg
                 fs.write_contents(it_xunit->second, xunitTestResults.build_xml(target_triplet), VCPKG_LINE_INFO);
             }
 
+            auto it_results_json = settings.find(SwitchXResultsJson);
+            if (it_results_json != settings.end())
+            {
+                const auto to_ci_result = [&](const PackageSpec& spec,
+                                              BuildResult result,
+                                              const ElapsedTime& elapsed,
+                                              std::chrono::system_clock::time_point start_time) {
+                    auto it_abi = split_specs->abi_map.find(spec);
+                    auto it_features = split_specs->features.find(spec);
+                    auto it_state = action_states.find(spec);
+                    return CiResult{spec,
+                                    it_state == action_states.end() ? "*" : it_state->second.to_string(),
+                                    result,
+                                    it_abi == split_specs->abi_map.end() ? std::string() : it_abi->second,
+                                    it_features == split_specs->features.end() ? std::vector<std::string>()
+                                                                                : it_features->second,
+                                    elapsed,
+                                    start_time};
+                };
+
+                std::vector<CiResult> ci_results;
+                for (auto&& result : summary.results)
+                {
+                    ci_results.push_back(to_ci_result(result.get_spec(),
+                                                      result.build_result.value_or_exit(VCPKG_LINE_INFO).code,
+                                                      result.timing,
+                                                      result.start_time));
+                }
+
+                for (auto&& port : split_specs->known)
+                {
+                    ci_results.push_back(
+                        to_ci_result(port.first, port.second, ElapsedTime{}, std::chrono::system_clock::time_point{}));
+                }
+
+                fs.write_contents(paths.original_cwd / it_results_json->second,
+                                  Json::stringify(serialize_ci_results(ci_results)),
+                                  VCPKG_LINE_INFO);
+            }
+
             if (any_regressions)
             {
                 Checks::exit_fail(VCPKG_LINE_INFO);
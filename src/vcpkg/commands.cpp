@@ -9,6 +9,7 @@
 #include <vcpkg/commands.build.h>
 #include <vcpkg/commands.check-support.h>
 #include <vcpkg/commands.ci-clean.h>
+#include <vcpkg/commands.ci-merge-shards.h>
 #include <vcpkg/commands.ci-verify-versions.h>
 #include <vcpkg/commands.ci.h>
 #include <vcpkg/commands.contact.h>
@@ -121,6 +122,7 @@ namespace vcpkg
         {CommandBuildExternalMetadata, command_build_external_and_exit},
         {CommandCheckSupportMetadata, command_check_support_and_exit},
         {CommandCiMetadata, command_ci_and_exit},
+        {CommandCiMergeShardsMetadata, command_ci_merge_shards_and_exit},
         {CommandDependInfoMetadata, command_depend_info_and_exit},
         {CommandEnvMetadata, command_env_and_exit},
         {CommandExportMetadata, command_export_and_exit},
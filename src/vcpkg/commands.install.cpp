@@ -4,6 +4,7 @@
 #include <vcpkg/base/files.h>
 #include <vcpkg/base/hash.h>
 #include <vcpkg/base/messages.h>
+#include <vcpkg/base/parallel-algorithms.h>
 #include <vcpkg/base/system.debug.h>
 #include <vcpkg/base/system.h>
 #include <vcpkg/base/util.h>
@@ -12,6 +13,7 @@
 #include <vcpkg/cmakevars.h>
 #include <vcpkg/commands.build.h>
 #include <vcpkg/commands.install.h>
+#include <vcpkg/commands.install.test.h>
 #include <vcpkg/commands.remove.h>
 #include <vcpkg/commands.set-installed.h>
 #include <vcpkg/configuration.h>
@@ -28,7 +30,10 @@
 #include <vcpkg/vcpkgpaths.h>
 #include <vcpkg/xunitwriter.h>
 
+#include <condition_variable>
 #include <iterator>
+#include <mutex>
+#include <thread>
 
 namespace vcpkg
 {
@@ -57,6 +62,19 @@ namespace vcpkg
         Util::erase_remove_if(files, [](Path& path) { return path.filename() == FileDotDsStore; });
         install_files_and_write_listfile(fs, source_dir, files, destination_dir);
     }
+    namespace
+    {
+        struct InstallFileOutcome
+        {
+            FileType status = FileType::none;
+            bool skipped = false;
+            std::string suffix;
+            Optional<std::string> hard_link_error;
+            Optional<LocalizedString> warning;
+            Optional<LocalizedString> error;
+        };
+    }
+
     void install_files_and_write_listfile(const Filesystem& fs,
                                           const Path& source_dir,
                                           const std::vector<Path>& files,
@@ -73,74 +91,81 @@ namespace vcpkg
         const auto listfile_parent = listfile.parent_path();
         fs.create_directories(listfile_parent, VCPKG_LINE_INFO);
 
-        output.push_back(destination_subdirectory + "/");
-        for (auto&& file : files)
-        {
+        // Packages can contain tens of thousands of files, so files are linked or copied in parallel once the
+        // directory skeleton exists. Diagnostics are collected per file and printed in the original order.
+        std::vector<InstallFileOutcome> outcomes(files.size());
+        execute_in_parallel(files.size(), [&](size_t idx) {
+            auto& file = files[idx];
+            auto& outcome = outcomes[idx];
             std::error_code ec;
-            const auto status = fs.symlink_status(file, ec);
+            outcome.status = fs.symlink_status(file, ec);
             if (ec)
             {
-                msg::println_warning(format_filesystem_call_error(ec, "symlink_status", {file}));
-                continue;
+                outcome.warning = format_filesystem_call_error(ec, "symlink_status", {file});
+                outcome.skipped = true;
+                return;
             }
 
             const auto filename = file.filename();
-            if (vcpkg::is_regular_file(status) &&
+            if (vcpkg::is_regular_file(outcome.status) &&
                 (filename == FileControl || filename == FileVcpkgDotJson || filename == FileBuildInfo))
             {
                 // Do not copy the control file or manifest file
-                continue;
+                outcome.skipped = true;
+                return;
             }
 
-            const auto suffix = file.generic_u8string().substr(prefix_length + 1);
-            const auto target = destination / suffix;
+            outcome.suffix = file.generic_u8string().substr(prefix_length + 1);
+        });
 
-            bool use_hard_link = true;
-            auto this_output = Strings::concat(destination_subdirectory, "/", suffix);
-            switch (status)
+        for (size_t idx = 0; idx < files.size(); ++idx)
+        {
+            auto& outcome = outcomes[idx];
+            if (!outcome.skipped && outcome.status == FileType::directory)
             {
-                case FileType::directory:
+                const auto target = destination / outcome.suffix;
+                std::error_code ec;
+                fs.create_directory(target, ec);
+                if (ec)
                 {
-                    fs.create_directory(target, ec);
-                    if (ec)
-                    {
-                        msg::println_error(msgInstallFailed, msg::path = target, msg::error_msg = ec.message());
-                    }
-
-                    // Trailing backslash for directories
-                    this_output.push_back('/');
-                    output.push_back(std::move(this_output));
-                    break;
+                    outcome.error = msg::format(msgInstallFailed, msg::path = target, msg::error_msg = ec.message());
                 }
+            }
+        }
+
+        execute_in_parallel(files.size(), [&](size_t idx) {
+            auto& file = files[idx];
+            auto& outcome = outcomes[idx];
+            if (outcome.skipped)
+            {
+                return;
+            }
+
+            std::error_code ec;
+            const auto target = destination / outcome.suffix;
+            switch (outcome.status)
+            {
                 case FileType::regular:
                 {
                     if (fs.exists(target, IgnoreErrors{}))
                     {
-                        msg::println_warning(msgOverwritingFile, msg::path = target);
+                        outcome.warning = msg::format(msgOverwritingFile, msg::path = target);
                         fs.remove_all(target, IgnoreErrors{});
                     }
-                    if (use_hard_link)
-                    {
-                        fs.create_hard_link(file, target, ec);
-                        if (ec)
-                        {
-                            Debug::println("Install from packages to installed: Fallback to copy "
-                                           "instead creating hard links because of: ",
-                                           ec.message());
-                            use_hard_link = false;
-                        }
-                    }
-                    if (!use_hard_link)
+
+                    fs.create_hard_link(file, target, ec);
+                    if (ec)
                     {
+                        outcome.hard_link_error = ec.message();
                         fs.copy_file(file, target, CopyOptions::overwrite_existing, ec);
                     }
 
                     if (ec)
                     {
-                        msg::println_error(msgInstallFailed, msg::path = target, msg::error_msg = ec.message());
+                        outcome.error =
+                            msg::format(msgInstallFailed, msg::path = target, msg::error_msg = ec.message());
                     }
 
-                    output.push_back(std::move(this_output));
                     break;
                 }
                 case FileType::symlink:
@@ -148,51 +173,65 @@ namespace vcpkg
                 {
                     if (fs.exists(target, IgnoreErrors{}))
                     {
-                        msg::println_warning(msgOverwritingFile, msg::path = target);
+                        outcome.warning = msg::format(msgOverwritingFile, msg::path = target);
                     }
 
                     fs.copy_symlink(file, target, ec);
                     if (ec)
                     {
-                        msg::println_error(msgInstallFailed, msg::path = target, msg::error_msg = ec.message());
+                        outcome.error =
+                            msg::format(msgInstallFailed, msg::path = target, msg::error_msg = ec.message());
                     }
 
-                    output.push_back(std::move(this_output));
                     break;
                 }
-                default: msg::println_error(msgInvalidFileType, msg::path = file); break;
+                default: break;
             }
-        }
-
-        std::sort(output.begin(), output.end());
-        fs.write_lines(listfile, output, VCPKG_LINE_INFO);
-    }
+        });
 
-    static std::vector<file_pack> extract_files_in_triplet(
-        const std::vector<StatusParagraphAndAssociatedFiles>& pgh_and_files,
-        Triplet triplet,
-        const size_t remove_chars = 0)
-    {
-        std::vector<file_pack> output;
-        for (const StatusParagraphAndAssociatedFiles& t : pgh_and_files)
+        output.push_back(destination_subdirectory + "/");
+        for (size_t idx = 0; idx < files.size(); ++idx)
         {
-            if (t.pgh.package.spec.triplet() != triplet)
+            auto& outcome = outcomes[idx];
+            if (auto hard_link_error = outcome.hard_link_error.get())
             {
-                continue;
+                Debug::println("Install from packages to installed: Fallback to copy "
+                               "instead creating hard links because of: ",
+                               *hard_link_error);
             }
 
-            const std::string name = t.pgh.package.display_name();
+            if (auto warning = outcome.warning.get())
+            {
+                msg::println_warning(*warning);
+            }
 
-            for (const std::string& file : t.files)
+            if (auto error = outcome.error.get())
             {
-                output.emplace_back(file_pack{std::string(file, remove_chars), name});
+                msg::println_error(*error);
+            }
+
+            if (outcome.skipped)
+            {
+                continue;
+            }
+
+            auto this_output = Strings::concat(destination_subdirectory, "/", outcome.suffix);
+            switch (outcome.status)
+            {
+                case FileType::directory:
+                    // Trailing backslash for directories
+                    this_output.push_back('/');
+                    output.push_back(std::move(this_output));
+                    break;
+                case FileType::regular:
+                case FileType::symlink:
+                case FileType::junction: output.push_back(std::move(this_output)); break;
+                default: msg::println_error(msgInvalidFileType, msg::path = files[idx]); break;
             }
         }
 
-        std::sort(output.begin(), output.end(), [](const file_pack& lhs, const file_pack& rhs) {
-            return lhs.first < rhs.first;
-        });
-        return output;
+        std::sort(output.begin(), output.end());
+        fs.write_lines(listfile, output, VCPKG_LINE_INFO);
     }
 
     static SortedVector<std::string> build_list_of_package_files(const ReadOnlyFilesystem& fs, const Path& package_dir)
@@ -207,54 +246,18 @@ namespace vcpkg
         return SortedVector<std::string>(std::move(package_files));
     }
 
-    static SortedVector<file_pack> build_list_of_installed_files(
-        const std::vector<StatusParagraphAndAssociatedFiles>& pgh_and_files, Triplet triplet)
-    {
-        const size_t installed_remove_char_count = triplet.canonical_name().size() + 1; // +1 for the slash
-        std::vector<file_pack> installed_files =
-            extract_files_in_triplet(pgh_and_files, triplet, installed_remove_char_count);
-
-        return SortedVector<file_pack>(std::move(installed_files));
-    }
-
     static InstallResult install_package(const VcpkgPaths& paths,
                                          const Path& package_dir,
                                          const BinaryControlFile& bcf,
-                                         StatusParagraphs* status_db)
+                                         StatusParagraphs* status_db,
+                                         InstalledFilesIndex& files_index)
     {
         auto& fs = paths.get_filesystem();
         const auto& installed = paths.installed();
         Triplet triplet = bcf.core_paragraph.spec.triplet();
-        const std::vector<StatusParagraphAndAssociatedFiles> pgh_and_files =
-            get_installed_files_and_upgrade(fs, installed, *status_db);
 
         const SortedVector<std::string> package_files = build_list_of_package_files(fs, package_dir);
-        const SortedVector<file_pack> installed_files = build_list_of_installed_files(pgh_and_files, triplet);
-
-        struct intersection_compare
-        {
-            bool operator()(const std::string& lhs, const file_pack& rhs) const
-            {
-                return Strings::case_insensitive_ascii_less(lhs, rhs.first);
-            }
-            bool operator()(const file_pack& lhs, const std::string& rhs) const
-            {
-                return Strings::case_insensitive_ascii_less(lhs.first, rhs);
-            }
-        };
-
-        std::vector<file_pack> intersection;
-
-        std::set_intersection(installed_files.begin(),
-                              installed_files.end(),
-                              package_files.begin(),
-                              package_files.end(),
-                              std::back_inserter(intersection),
-                              intersection_compare());
-
-        std::sort(intersection.begin(), intersection.end(), [](const file_pack& lhs, const file_pack& rhs) {
-            return lhs.second < rhs.second;
-        });
+        const std::vector<file_pack> intersection = files_index.find_conflicts(triplet, package_files);
 
         if (!intersection.empty())
         {
@@ -302,6 +305,7 @@ namespace vcpkg
             InstallDir::from_destination_root(paths.installed(), triplet, bcf.core_paragraph);
 
         install_package_and_write_listfile(fs, package_dir, install_dir);
+        files_index.add_package(fs, installed, bcf.core_paragraph);
 
         source_paragraph.status.state = InstallState::INSTALLED;
         write_update(fs, installed, source_paragraph);
@@ -317,12 +321,105 @@ namespace vcpkg
         return InstallResult::SUCCESS;
     }
 
+    // Installs the package produced by building or restoring `action` into the installed tree.
+    static ExtendedBuildResult install_built_package(const VcpkgPaths& paths,
+                                                     const BuildPackageOptions& build_options,
+                                                     const InstallPlanAction& action,
+                                                     std::unique_ptr<BinaryControlFile>&& bcf,
+                                                     bool all_dependencies_satisfied,
+                                                     StatusParagraphs& status_db,
+                                                     InstalledFilesIndex& files_index,
+                                                     BinaryCache& binary_cache)
+    {
+        auto& fs = paths.get_filesystem();
+        // Build or restore succeeded and `bcf` is populated with the control file.
+        Checks::check_exit(VCPKG_LINE_INFO, bcf != nullptr);
+        BuildResult code;
+        if (all_dependencies_satisfied)
+        {
+            const auto install_result = install_package(
+                paths, action.package_dir.value_or_exit(VCPKG_LINE_INFO), *bcf, &status_db, files_index);
+            switch (install_result)
+            {
+                case InstallResult::SUCCESS: code = BuildResult::Succeeded; break;
+                case InstallResult::FILE_CONFLICTS: code = BuildResult::FileConflicts; break;
+                default: Checks::unreachable(VCPKG_LINE_INFO);
+            }
+            binary_cache.push_success(build_options.clean_packages, action);
+        }
+        else
+        {
+            Checks::check_exit(VCPKG_LINE_INFO, build_options.only_downloads == OnlyDownloads::Yes);
+            code = BuildResult::Downloaded;
+        }
+
+        if (build_options.clean_downloads == CleanDownloads::Yes)
+        {
+            for (auto& p : fs.get_regular_files_non_recursive(paths.downloads, IgnoreErrors{}))
+            {
+                fs.remove(p, VCPKG_LINE_INFO);
+            }
+        }
+
+        return {code, std::move(bcf)};
+    }
+
+    // Reports the outcome of building `action` and, if the build succeeded, installs it.
+    static ExtendedBuildResult handle_build_result(const VcpkgPaths& paths,
+                                                   const BuildPackageOptions& build_options,
+                                                   const InstallPlanAction& action,
+                                                   ExtendedBuildResult&& result,
+                                                   StatusParagraphs& status_db,
+                                                   InstalledFilesIndex& files_index,
+                                                   BinaryCache& binary_cache)
+    {
+        if (BuildResult::Downloaded == result.code)
+        {
+            msg::println(Color::success, msgDownloadedSources, msg::spec = action.display_name());
+            return std::move(result);
+        }
+
+        const bool all_dependencies_satisfied = result.unmet_dependencies.empty();
+        if (result.code != BuildResult::Succeeded)
+        {
+            LocalizedString warnings;
+            for (auto&& msg : action.build_failure_messages)
+            {
+                warnings.append(msg).append_raw('\n');
+            }
+
+            if (!warnings.data().empty())
+            {
+                msg::print(Color::warning, warnings);
+            }
+
+            msg::println_error(create_error_message(result, action.spec));
+            return std::move(result);
+        }
+
+        return install_built_package(paths,
+                                     build_options,
+                                     action,
+                                     std::move(result.binary_control_file),
+                                     all_dependencies_satisfied,
+                                     status_db,
+                                     files_index,
+                                     binary_cache);
+    }
+
+    static void print_building_package(const InstallPlanAction& action)
+    {
+        msg::println(action.use_head_version == UseHeadVersion::Yes ? msgBuildingFromHead : msgBuildingPackage,
+                     msg::spec = action.display_name());
+    }
+
     static ExtendedBuildResult perform_install_plan_action(const VcpkgCmdArguments& args,
                                                            const VcpkgPaths& paths,
                                                            Triplet host_triplet,
                                                            const BuildPackageOptions& build_options,
                                                            const InstallPlanAction& action,
                                                            StatusParagraphs& status_db,
+                                                           InstalledFilesIndex& files_index,
                                                            BinaryCache& binary_cache,
                                                            const IBuildLogsRecorder& build_logs_recorder)
     {
@@ -333,85 +430,33 @@ namespace vcpkg
             return ExtendedBuildResult{BuildResult::Succeeded};
         }
 
-        bool all_dependencies_satisfied;
         if (plan_type == InstallPlanType::BUILD_AND_INSTALL)
         {
-            std::unique_ptr<BinaryControlFile> bcf;
             if (binary_cache.is_restored(action))
             {
                 auto maybe_bcf = Paragraphs::try_load_cached_package(
                     fs, action.package_dir.value_or_exit(VCPKG_LINE_INFO), action.spec);
-                bcf = std::make_unique<BinaryControlFile>(std::move(maybe_bcf).value_or_exit(VCPKG_LINE_INFO));
-                all_dependencies_satisfied = true;
-            }
-            else if (build_options.build_missing == BuildMissing::No)
-            {
-                return ExtendedBuildResult{BuildResult::CacheMissing};
-            }
-            else
-            {
-                msg::println(action.use_head_version == UseHeadVersion::Yes ? msgBuildingFromHead : msgBuildingPackage,
-                             msg::spec = action.display_name());
-
-                auto result =
-                    build_package(args, paths, host_triplet, build_options, action, build_logs_recorder, status_db);
-
-                if (BuildResult::Downloaded == result.code)
-                {
-                    msg::println(Color::success, msgDownloadedSources, msg::spec = action.display_name());
-                    return result;
-                }
-
-                all_dependencies_satisfied = result.unmet_dependencies.empty();
-                if (result.code != BuildResult::Succeeded)
-                {
-                    LocalizedString warnings;
-                    for (auto&& msg : action.build_failure_messages)
-                    {
-                        warnings.append(msg).append_raw('\n');
-                    }
-
-                    if (!warnings.data().empty())
-                    {
-                        msg::print(Color::warning, warnings);
-                    }
-
-                    msg::println_error(create_error_message(result, action.spec));
-                    return result;
-                }
-
-                bcf = std::move(result.binary_control_file);
-            }
-            // Build or restore succeeded and `bcf` is populated with the control file.
-            Checks::check_exit(VCPKG_LINE_INFO, bcf != nullptr);
-            BuildResult code;
-            if (all_dependencies_satisfied)
-            {
-                const auto install_result =
-                    install_package(paths, action.package_dir.value_or_exit(VCPKG_LINE_INFO), *bcf, &status_db);
-                switch (install_result)
-                {
-                    case InstallResult::SUCCESS: code = BuildResult::Succeeded; break;
-                    case InstallResult::FILE_CONFLICTS: code = BuildResult::FileConflicts; break;
-                    default: Checks::unreachable(VCPKG_LINE_INFO);
-                }
-                binary_cache.push_success(build_options.clean_packages, action);
-            }
-            else
-            {
-                Checks::check_exit(VCPKG_LINE_INFO, build_options.only_downloads == OnlyDownloads::Yes);
-                code = BuildResult::Downloaded;
+                return install_built_package(
+                    paths,
+                    build_options,
+                    action,
+                    std::make_unique<BinaryControlFile>(std::move(maybe_bcf).value_or_exit(VCPKG_LINE_INFO)),
+                    true,
+                    status_db,
+                    files_index,
+                    binary_cache);
             }
 
-            if (build_options.clean_downloads == CleanDownloads::Yes)
+            if (build_options.build_missing == BuildMissing::No)
             {
-                for (auto& p : fs.get_regular_files_non_recursive(paths.downloads, IgnoreErrors{}))
-                {
-                    fs.remove(p, VCPKG_LINE_INFO);
-                }
+                return ExtendedBuildResult{BuildResult::CacheMissing};
             }
 
-            return {code, std::move(bcf)};
+            print_building_package(action);
+            auto result =
+                build_package(args, paths, host_triplet, build_options, action, build_logs_recorder, status_db);
+            return handle_build_result(
+                paths, build_options, action, std::move(result), status_db, files_index, binary_cache);
         }
 
         if (plan_type == InstallPlanType::EXCLUDED)
@@ -556,6 +601,390 @@ namespace vcpkg
         }
     }
 
+    static bool is_failing_build_result(BuildResult code)
+    {
+        switch (code)
+        {
+            case BuildResult::Succeeded:
+            case BuildResult::Removed:
+            case BuildResult::Downloaded:
+            case BuildResult::Excluded: return false;
+            case BuildResult::BuildFailed:
+            case BuildResult::PostBuildChecksFailed:
+            case BuildResult::FileConflicts:
+            case BuildResult::CascadedDueToMissingDependencies:
+            case BuildResult::CacheMissing: return true;
+            default: Checks::unreachable(VCPKG_LINE_INFO);
+        }
+    }
+
+    [[noreturn]] static void exit_after_failed_action(const VcpkgCmdArguments& args,
+                                                      const VcpkgPaths& paths,
+                                                      const InstallPlanAction& action,
+                                                      const ExtendedBuildResult& result,
+                                                      BinaryCache& binary_cache,
+                                                      bool include_manifest_in_github_issue)
+    {
+        print_user_troubleshooting_message(
+            action,
+            args.detected_ci(),
+            paths,
+            result.error_logs,
+            result.stdoutlog.then([&](auto&) -> Optional<Path> {
+                auto issue_body_path = paths.installed().root() / FileVcpkg / FileIssueBodyMD;
+                paths.get_filesystem().write_contents(
+                    issue_body_path,
+                    create_github_issue(args, result, paths, action, include_manifest_in_github_issue),
+                    VCPKG_LINE_INFO);
+                return issue_body_path;
+            }));
+        binary_cache.wait_for_async_complete_and_join();
+        Checks::exit_fail(VCPKG_LINE_INFO);
+    }
+
+    namespace
+    {
+        struct CompletedBuild
+        {
+            size_t install_index;
+            ExtendedBuildResult result;
+        };
+
+        // Hands the results of ports built on background threads to the thread which installs them.
+        struct CompletedBuilds
+        {
+            // May be called from any thread.
+            void record(size_t install_index, ExtendedBuildResult&& result)
+            {
+                std::lock_guard<std::mutex> lock(m_mtx);
+                m_completed.push_back(CompletedBuild{install_index, std::move(result)});
+                m_cv.notify_one();
+            }
+
+            // Blocks until at least one build has completed, then returns every result recorded since the last call.
+            std::vector<CompletedBuild> wait_for_completed()
+            {
+                std::vector<CompletedBuild> result;
+                std::unique_lock<std::mutex> lock(m_mtx);
+                m_cv.wait(lock, [this]() { return !m_completed.empty(); });
+                swap(result, m_completed);
+                return result;
+            }
+
+        private:
+            std::mutex m_mtx;
+            std::condition_variable m_cv;
+            std::vector<CompletedBuild> m_completed;
+        };
+
+        // Only the port builds themselves run on background threads; restores, installs into installed/ and status
+        // database updates all happen on the calling thread, in completion order.
+        struct ParallelInstallScheduler
+        {
+            ParallelInstallScheduler(View<InstallPlanAction> install_actions,
+                                     size_t parallel_ports,
+                                     KeepGoing keep_going,
+                                     IParallelInstallSteps& steps)
+                : install_actions(install_actions)
+                , parallel_ports(parallel_ports)
+                , keep_going(keep_going)
+                , steps(steps)
+                , remaining_dependencies(install_actions.size())
+                , dependents(install_actions.size())
+                , workers(install_actions.size())
+            {
+                std::map<PackageSpec, size_t> install_index;
+                for (size_t idx = 0; idx < install_actions.size(); ++idx)
+                {
+                    auto& action = install_actions[idx];
+                    for (auto&& dependency : action.package_dependencies)
+                    {
+                        if (dependency == action.spec) continue;
+                        // install_actions are topologically sorted, so dependencies in the plan are already indexed
+                        auto it = install_index.find(dependency);
+                        if (it != install_index.end())
+                        {
+                            ++remaining_dependencies[idx];
+                            dependents[it->second].push_back(idx);
+                        }
+                    }
+
+                    install_index.emplace(action.spec, idx);
+                    if (remaining_dependencies[idx] == 0)
+                    {
+                        ready.insert(idx);
+                    }
+                }
+            }
+
+            Optional<size_t> run()
+            {
+                while (!ready.empty() || running_count != 0)
+                {
+                    start_ready_actions();
+                    if (running_count == 0)
+                    {
+                        // with nothing running, actions are only left waiting after a KeepGoing::No failure
+                        break;
+                    }
+
+                    for (auto&& completed : completed_builds.wait_for_completed())
+                    {
+                        --running_count;
+                        workers[completed.install_index].join();
+                        running_ports.erase(install_actions[completed.install_index].spec.name());
+                        finish_action(completed.install_index,
+                                      steps.finish_build(completed.install_index, std::move(completed.result)));
+                    }
+                }
+
+                return first_failure;
+            }
+
+        private:
+            void start_ready_actions()
+            {
+                auto it = ready.begin();
+                while (it != ready.end() && !first_failure.has_value())
+                {
+                    const size_t idx = *it;
+                    auto& action = install_actions[idx];
+                    const bool needs_build = steps.needs_build(idx);
+                    // Builds of the same port for different triplets share a buildtrees directory
+                    if (needs_build && (running_count >= parallel_ports ||
+                                        Util::Sets::contains(running_ports, action.spec.name())))
+                    {
+                        ++it;
+                        continue;
+                    }
+
+                    it = ready.erase(it);
+                    steps.start(idx);
+                    if (!needs_build)
+                    {
+                        finish_action(idx, steps.install(idx));
+                        // finishing may have made earlier actions ready
+                        it = ready.begin();
+                        continue;
+                    }
+
+                    auto maybe_result = steps.check_build(idx);
+                    if (auto result = maybe_result.get())
+                    {
+                        finish_action(idx, std::move(*result));
+                        it = ready.begin();
+                        continue;
+                    }
+
+                    running_ports.insert(action.spec.name());
+                    ++running_count;
+                    workers[idx] = std::thread([this, idx]() { completed_builds.record(idx, steps.build(idx)); });
+                }
+            }
+
+            void finish_action(size_t idx, ExtendedBuildResult&& result)
+            {
+                const bool stops = result.code != BuildResult::Succeeded && keep_going == KeepGoing::No;
+                steps.finish(idx, std::move(result));
+                if (stops)
+                {
+                    if (!first_failure.has_value())
+                    {
+                        first_failure.emplace(idx);
+                    }
+
+                    return;
+                }
+
+                for (auto&& dependent : dependents[idx])
+                {
+                    if (--remaining_dependencies[dependent] == 0)
+                    {
+                        ready.insert(dependent);
+                    }
+                }
+            }
+
+            View<InstallPlanAction> install_actions;
+            size_t parallel_ports;
+            KeepGoing keep_going;
+            IParallelInstallSteps& steps;
+
+            std::vector<size_t> remaining_dependencies;
+            std::vector<std::vector<size_t>> dependents;
+            // ordered so that, all else being equal, actions start in plan order
+            std::set<size_t> ready;
+            std::set<std::string> running_ports;
+            size_t running_count = 0;
+            std::vector<std::thread> workers;
+            Optional<size_t> first_failure;
+            CompletedBuilds completed_builds;
+        };
+
+        // Installs the actions of a plan as scheduled by --x-parallel-ports.
+        struct PlanInstallSteps final : IParallelInstallSteps
+        {
+            PlanInstallSteps(const VcpkgCmdArguments& args,
+                             const VcpkgPaths& paths,
+                             Triplet host_triplet,
+                             const BuildPackageOptions& build_options,
+                             const std::vector<InstallPlanAction>& install_actions,
+                             StatusParagraphs& status_db,
+                             InstalledFilesIndex& files_index,
+                             BinaryCache& binary_cache,
+                             const IBuildLogsRecorder& build_logs_recorder,
+                             size_t& action_index,
+                             size_t action_count,
+                             std::vector<SpecSummary>& results)
+                : args(args)
+                , paths(paths)
+                , host_triplet(host_triplet)
+                , build_options(build_options)
+                , install_actions(install_actions)
+                , status_db(status_db)
+                , files_index(files_index)
+                , binary_cache(binary_cache)
+                , build_logs_recorder(build_logs_recorder)
+                , action_index(action_index)
+                , action_count(action_count)
+                , results(results)
+                , guards(install_actions.size())
+                , summaries(install_actions.size())
+                , all_dependencies_satisfied(install_actions.size())
+            {
+            }
+
+            // The caches behind tool lookup and build environments are filled lazily and are not synchronized, so
+            // populate them before any background build can consult them. Only actions which will build need an
+            // environment, so this waits for the restores of the others to finish.
+            void prepare_shared_state()
+            {
+                paths.get_tool_exe(Tools::CMAKE, out_sink);
+                paths.get_tool_exe(Tools::GIT, out_sink);
+                for (size_t install_index = 0; install_index < install_actions.size(); ++install_index)
+                {
+                    if (!needs_build(install_index))
+                    {
+                        continue;
+                    }
+
+                    auto& abi_info = install_actions[install_index].abi_info.value_or_exit(VCPKG_LINE_INFO);
+                    paths.get_action_env(*abi_info.pre_build_info, abi_info.toolset.value_or_exit(VCPKG_LINE_INFO));
+                }
+            }
+
+            const ExtendedBuildResult& result(size_t install_index) const
+            {
+                return summaries[install_index]->build_result.value_or_exit(VCPKG_LINE_INFO);
+            }
+
+            bool needs_build(size_t install_index) const override
+            {
+                auto& action = install_actions[install_index];
+                return action.plan_type == InstallPlanType::BUILD_AND_INSTALL &&
+                       build_options.build_missing == BuildMissing::Yes && !binary_cache.is_restored(action);
+            }
+
+            void start(size_t install_index) override
+            {
+                binary_cache.print_updates();
+                guards[install_index] = std::make_unique<TrackedPackageInstallGuard>(
+                    action_index++, action_count, results, install_actions[install_index]);
+                summaries[install_index] = &guards[install_index]->current_summary;
+            }
+
+            ExtendedBuildResult install(size_t install_index) override
+            {
+                return perform_install_plan_action(args,
+                                                   paths,
+                                                   host_triplet,
+                                                   build_options,
+                                                   install_actions[install_index],
+                                                   status_db,
+                                                   files_index,
+                                                   binary_cache,
+                                                   build_logs_recorder);
+            }
+
+            Optional<ExtendedBuildResult> check_build(size_t install_index) override
+            {
+                auto& action = install_actions[install_index];
+                auto missing_dependencies = find_missing_build_dependencies(build_options, action, status_db);
+                all_dependencies_satisfied[install_index] = missing_dependencies.empty();
+                if (build_options.only_downloads == OnlyDownloads::No && !missing_dependencies.empty())
+                {
+                    return handle_build_result(
+                        paths,
+                        build_options,
+                        action,
+                        ExtendedBuildResult{BuildResult::CascadedDueToMissingDependencies,
+                                            std::move(missing_dependencies)},
+                        status_db,
+                        files_index,
+                        binary_cache);
+                }
+
+                print_building_package(action);
+                return nullopt;
+            }
+
+            ExtendedBuildResult build(size_t install_index) override
+            {
+                return build_package_with_checked_dependencies(args,
+                                                               paths,
+                                                               host_triplet,
+                                                               build_options,
+                                                               install_actions[install_index],
+                                                               build_logs_recorder,
+                                                               all_dependencies_satisfied[install_index] != 0);
+            }
+
+            ExtendedBuildResult finish_build(size_t install_index, ExtendedBuildResult&& result) override
+            {
+                return handle_build_result(paths,
+                                           build_options,
+                                           install_actions[install_index],
+                                           std::move(result),
+                                           status_db,
+                                           files_index,
+                                           binary_cache);
+            }
+
+            void finish(size_t install_index, ExtendedBuildResult&& result) override
+            {
+                summaries[install_index]->build_result.emplace(std::move(result));
+                guards[install_index].reset();
+            }
+
+        private:
+            const VcpkgCmdArguments& args;
+            const VcpkgPaths& paths;
+            Triplet host_triplet;
+            const BuildPackageOptions& build_options;
+            const std::vector<InstallPlanAction>& install_actions;
+            StatusParagraphs& status_db;
+            InstalledFilesIndex& files_index;
+            BinaryCache& binary_cache;
+            const IBuildLogsRecorder& build_logs_recorder;
+            size_t& action_index;
+            size_t action_count;
+            std::vector<SpecSummary>& results;
+
+            std::vector<std::unique_ptr<TrackedPackageInstallGuard>> guards;
+            std::vector<SpecSummary*> summaries;
+            // written before each build starts, so the background thread reads it safely
+            std::vector<char> all_dependencies_satisfied;
+        };
+    }
+
+    Optional<size_t> run_parallel_install(View<InstallPlanAction> install_actions,
+                                          size_t parallel_ports,
+                                          KeepGoing keep_going,
+                                          IParallelInstallSteps& steps)
+    {
+        return ParallelInstallScheduler(install_actions, parallel_ports, keep_going, steps).run();
+    }
+
     InstallSummary install_execute_plan(const VcpkgCmdArguments& args,
                                         const VcpkgPaths& paths,
                                         Triplet host_triplet,
@@ -570,63 +999,93 @@ namespace vcpkg
         InstallSummary summary;
         const size_t action_count = action_plan.remove_actions.size() + action_plan.install_actions.size();
         size_t action_index = 1;
+        // TrackedPackageInstallGuard refers into results, so it must not reallocate while actions are in flight
+        summary.results.reserve(action_count + action_plan.already_installed.size());
 
         auto& fs = paths.get_filesystem();
+        auto files_index = load_installed_files_index_and_upgrade(fs, paths.installed(), status_db);
         for (auto&& action : action_plan.remove_actions)
         {
             TrackedPackageInstallGuard this_install(action_index++, action_count, summary.results, action);
-            remove_package(fs, paths.installed(), action.spec, status_db);
+            remove_package(fs, paths.installed(), action.spec, status_db, files_index);
             summary.results.back().build_result.emplace(BuildResult::Removed);
         }
 
         for (auto&& action : action_plan.already_installed)
         {
-            summary.results.emplace_back(action).build_result.emplace(perform_install_plan_action(
-                args, paths, host_triplet, build_options, action, status_db, binary_cache, build_logs_recorder));
+            summary.results.emplace_back(action).build_result.emplace(
+                perform_install_plan_action(args,
+                                            paths,
+                                            host_triplet,
+                                            build_options,
+                                            action,
+                                            status_db,
+                                            files_index,
+                                            binary_cache,
+                                            build_logs_recorder));
         }
 
-        for (auto&& action : action_plan.install_actions)
+        if (build_options.parallel_ports > 1)
         {
-            binary_cache.print_updates();
-            TrackedPackageInstallGuard this_install(action_index++, action_count, summary.results, action);
-            auto result = perform_install_plan_action(
-                args, paths, host_triplet, build_options, action, status_db, binary_cache, build_logs_recorder);
-            if (result.code != BuildResult::Succeeded && build_options.keep_going == KeepGoing::No)
+            PlanInstallSteps steps(args,
+                                   paths,
+                                   host_triplet,
+                                   build_options,
+                                   action_plan.install_actions,
+                                   status_db,
+                                   files_index,
+                                   binary_cache,
+                                   build_logs_recorder,
+                                   action_index,
+                                   action_count,
+                                   summary.results);
+            steps.prepare_shared_state();
+            auto maybe_failed_index = run_parallel_install(
+                action_plan.install_actions, build_options.parallel_ports, build_options.keep_going, steps);
+            if (auto failed_index = maybe_failed_index.get())
             {
-                this_install.print_elapsed_time();
-                print_user_troubleshooting_message(
-                    action,
-                    args.detected_ci(),
-                    paths,
-                    result.error_logs,
-                    result.stdoutlog.then([&](auto&) -> Optional<Path> {
-                        auto issue_body_path = paths.installed().root() / FileVcpkg / FileIssueBodyMD;
-                        paths.get_filesystem().write_contents(
-                            issue_body_path,
-                            create_github_issue(args, result, paths, action, include_manifest_in_github_issue),
-                            VCPKG_LINE_INFO);
-                        return issue_body_path;
-                    }));
-                binary_cache.wait_for_async_complete_and_join();
-                Checks::exit_fail(VCPKG_LINE_INFO);
+                save_installed_files_index(fs, paths.installed(), files_index);
+                exit_after_failed_action(args,
+                                         paths,
+                                         action_plan.install_actions[*failed_index],
+                                         steps.result(*failed_index),
+                                         binary_cache,
+                                         include_manifest_in_github_issue);
             }
 
-            switch (result.code)
+            summary.failed = Util::any_of(summary.results, [](const SpecSummary& result) {
+                return is_failing_build_result(result.build_result.value_or_exit(VCPKG_LINE_INFO).code);
+            });
+        }
+        else
+        {
+            for (auto&& action : action_plan.install_actions)
             {
-                case BuildResult::Succeeded:
-                case BuildResult::Removed:
-                case BuildResult::Downloaded:
-                case BuildResult::Excluded: break;
-                case BuildResult::BuildFailed:
-                case BuildResult::PostBuildChecksFailed:
-                case BuildResult::FileConflicts:
-                case BuildResult::CascadedDueToMissingDependencies:
-                case BuildResult::CacheMissing: summary.failed = true; break;
-                default: Checks::unreachable(VCPKG_LINE_INFO);
+                binary_cache.print_updates();
+                TrackedPackageInstallGuard this_install(action_index++, action_count, summary.results, action);
+                auto result = perform_install_plan_action(args,
+                                                          paths,
+                                                          host_triplet,
+                                                          build_options,
+                                                          action,
+                                                          status_db,
+                                                          files_index,
+                                                          binary_cache,
+                                                          build_logs_recorder);
+                if (result.code != BuildResult::Succeeded && build_options.keep_going == KeepGoing::No)
+                {
+                    this_install.print_elapsed_time();
+                    save_installed_files_index(fs, paths.installed(), files_index);
+                    exit_after_failed_action(
+                        args, paths, action, result, binary_cache, include_manifest_in_github_issue);
+                }
+
+                summary.failed |= is_failing_build_result(result.code);
+                this_install.current_summary.build_result.emplace(std::move(result));
             }
-            this_install.current_summary.build_result.emplace(std::move(result));
         }
 
+        save_installed_files_index(fs, paths.installed(), files_index);
         database_load_collapse(fs, paths.installed());
         summary.elapsed = timer.elapsed();
         return summary;
@@ -655,6 +1114,7 @@ namespace vcpkg
     static constexpr CommandSetting INSTALL_SETTINGS[] = {
         {SwitchXXUnit, {}}, // internal use
         {SwitchXWriteNuGetPackagesConfig, msgHelpTxtOptWritePkgConfig},
+        {SwitchXParallelPorts, msgHelpTxtOptParallelPorts},
     };
 
     static constexpr CommandMultiSetting INSTALL_MULTISETTINGS[] = {
@@ -1062,6 +1522,19 @@ namespace vcpkg
                                                  ? UnsupportedPortAction::Warn
                                                  : UnsupportedPortAction::Error;
         const bool print_cmake_usage = !Util::Sets::contains(options.switches, SwitchNoPrintUsage);
+        size_t parallel_ports = 1;
+        if (auto parallel_ports_setting = Util::lookup_value(options.settings, SwitchXParallelPorts).get())
+        {
+            auto maybe_parsed = Strings::strto<int>(*parallel_ports_setting);
+            auto parsed = maybe_parsed.get();
+            if (!parsed || *parsed <= 0)
+            {
+                Checks::msg_exit_with_error(
+                    VCPKG_LINE_INFO, msgOptionMustBePositiveInteger, msg::option = SwitchXParallelPorts);
+            }
+
+            parallel_ports = static_cast<size_t>(*parsed);
+        }
 
         get_global_metrics_collector().track_bool(BoolMetric::InstallManifestMode, manifest);
 
@@ -1127,6 +1600,7 @@ namespace vcpkg
             Util::Enum::to_enum<CleanDownloads>(clean_after_build || clean_downloads_after_build),
             prohibit_backcompat_features ? BackcompatFeatures::Prohibit : BackcompatFeatures::Allow,
             keep_going,
+            parallel_ports,
         };
 
         PackagesDirAssigner packages_dir_assigner{paths.packages()};
@@ -15,19 +15,27 @@ namespace
                      const std::string& file_substr,
                      const StatusParagraphs& status_db)
     {
-        const auto installed_files = get_installed_files(fs, installed, status_db);
-        for (auto&& pgh_and_file : installed_files)
+        // List the packages in status database order, as the listfiles were once read in that order
+        std::map<std::string, size_t> package_order;
+        for (auto&& pgh : status_db)
         {
-            const StatusParagraph& pgh = pgh_and_file.pgh;
-
-            for (const std::string& file : pgh_and_file.files)
+            if (pgh->is_installed() && !pgh->package.is_feature())
             {
-                if (file.find(file_substr) != std::string::npos)
-                {
-                    msg::write_unlocalized_text(Color::none, fmt::format("{}: {}\n", pgh.package.display_name(), file));
-                }
+                package_order.emplace(pgh->package.display_name(), package_order.size());
             }
         }
+
+        const auto files_index = load_installed_files_index(fs, installed, status_db);
+        auto matches = files_index.search(file_substr);
+        std::stable_sort(matches.begin(), matches.end(), [&](const auto& lhs, const auto& rhs) {
+            return package_order[lhs.first] < package_order[rhs.first];
+        });
+
+        for (auto&& package_and_file : matches)
+        {
+            msg::write_unlocalized_text(Color::none,
+                                        fmt::format("{}: {}\n", package_and_file.first, package_and_file.second));
+        }
     }
 } // unnamed namespace
 
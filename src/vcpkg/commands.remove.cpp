@@ -18,7 +18,8 @@ namespace vcpkg
     void remove_package(const Filesystem& fs,
                         const InstalledPaths& installed,
                         const PackageSpec& spec,
-                        StatusParagraphs& status_db)
+                        StatusParagraphs& status_db,
+                        InstalledFilesIndex& files_index)
     {
         auto maybe_ipv = status_db.get_installed_package_view(spec);
 
@@ -94,6 +95,8 @@ namespace vcpkg
             fs.remove(installed.listfile_path(ipv.core->package), VCPKG_LINE_INFO);
         }
 
+        files_index.remove_package(installed, ipv.core->package);
+
         for (auto&& spgh : spghs)
         {
             spgh.status.state = InstallState::NOT_INSTALLED;
@@ -289,6 +292,7 @@ namespace vcpkg
             }
         }
 
+        auto files_index = load_installed_files_index_and_upgrade(fs, paths.installed(), status_db);
         for (std::size_t idx = 0; idx < plan.remove.size(); ++idx)
         {
             const RemovePlanAction& action = plan.remove[idx];
@@ -296,13 +300,14 @@ namespace vcpkg
                          msg::action_index = idx + 1,
                          msg::count = plan.remove.size(),
                          msg::spec = action.spec);
-            remove_package(fs, paths.installed(), action.spec, status_db);
+            remove_package(fs, paths.installed(), action.spec, status_db, files_index);
             if (purge == Purge::YES)
             {
                 all_spec_dirs.push_back(action.spec.dir());
             }
         }
 
+        save_installed_files_index(fs, paths.installed(), files_index);
         purge_packages_dirs(paths, all_spec_dirs);
         database_load_collapse(fs, paths.installed());
         Checks::exit_success(VCPKG_LINE_INFO);
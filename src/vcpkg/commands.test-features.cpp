@@ -4,6 +4,7 @@
 #include <vcpkg/base/fmt.h>
 #include <vcpkg/base/git.h>
 #include <vcpkg/base/graphs.h>
+#include <vcpkg/base/parallel-algorithms.h>
 #include <vcpkg/base/sortedvector.h>
 #include <vcpkg/base/span.h>
 #include <vcpkg/base/strings.h>
@@ -30,6 +31,9 @@
 #include <vcpkg/vcpkglib.h>
 #include <vcpkg/vcpkgpaths.h>
 
+#include <condition_variable>
+#include <mutex>
+
 using namespace vcpkg;
 
 namespace
@@ -346,6 +350,43 @@ namespace
         }
     }
 
+    // An installed tree in which feature tests run one after another.
+    struct FeatureTestWorker
+    {
+        const VcpkgPaths* paths;
+        BinaryCache* binary_cache;
+        StatusParagraphs status_db;
+    };
+
+    // Places the package restored in `source` into `destination` without copying its contents, so that the
+    // installed trees of every worker share the files of one restore.
+    void link_restored_package(const Filesystem& fs, const Path& source, const Path& destination)
+    {
+        fs.remove_all(destination, VCPKG_LINE_INFO);
+        fs.create_directories(destination, VCPKG_LINE_INFO);
+        for (auto&& file : fs.get_files_recursive(source, VCPKG_LINE_INFO))
+        {
+            const auto target = destination / file.generic_u8string().substr(source.generic_u8string().size() + 1);
+            switch (fs.symlink_status(file, VCPKG_LINE_INFO))
+            {
+                case FileType::directory: fs.create_directories(target, VCPKG_LINE_INFO); break;
+                case FileType::symlink:
+                case FileType::junction: fs.copy_symlink(file, target, VCPKG_LINE_INFO); break;
+                default:
+                {
+                    std::error_code ec;
+                    fs.create_hard_link(file, target, ec);
+                    if (ec)
+                    {
+                        fs.copy_file(file, target, CopyOptions::none, VCPKG_LINE_INFO);
+                    }
+
+                    break;
+                }
+            }
+        }
+    }
+
     void handle_pass_feature_test_result(std::vector<DiagnosticLine>& diagnostics,
                                          const FullPackageSpec& spec,
                                          const std::string* ci_feature_baseline_file_name,
@@ -422,6 +463,7 @@ namespace vcpkg
         {SwitchFailingAbiLog, msgCmdTestFeaturesFailingAbis},
         {SwitchFailureLogs, msgCISettingsOptFailureLogs},
         {SwitchForMergeWith, msgCmdOptForMergeWith},
+        {SwitchXParallelTests, msgCmdTestFeaturesParallelTests},
     };
 
     constexpr CommandMetadata CommandTestFeaturesMetadata = {
@@ -450,6 +492,19 @@ namespace vcpkg
         const auto test_feature_core = !Util::Sets::contains(options.switches, SwitchNoCore);
         const auto test_features_combined = !Util::Sets::contains(options.switches, SwitchNoCombined);
         const auto test_features_separately = !Util::Sets::contains(options.switches, SwitchNoSeparated);
+        size_t parallel_tests = 1;
+        if (auto parallel_tests_setting = Util::lookup_value(settings, SwitchXParallelTests).get())
+        {
+            auto maybe_parsed = Strings::strto<int>(*parallel_tests_setting);
+            auto parsed = maybe_parsed.get();
+            if (!parsed || *parsed <= 0)
+            {
+                Checks::msg_exit_with_error(
+                    VCPKG_LINE_INFO, msgOptionMustBePositiveInteger, msg::option = SwitchXParallelTests);
+            }
+
+            parallel_tests = static_cast<size_t>(*parsed);
+        }
 
         BinaryCache binary_cache(fs);
         if (!binary_cache.install_providers(args, paths, out_sink))
@@ -543,7 +598,7 @@ namespace vcpkg
         PackagesDirAssigner packages_dir_assigner{paths.packages()};
         CreateInstallPlanOptions install_plan_options{
             nullptr, host_triplet, UnsupportedPortAction::Warn, UseHeadVersion::No, Editable::No};
-        static constexpr BuildPackageOptions build_options{
+        const BuildPackageOptions build_options{
             BuildMissing::Yes,
             AllowDownloads::Yes,
             OnlyDownloads::No,
@@ -714,12 +769,56 @@ namespace vcpkg
 
         // test port features
         std::unordered_set<std::string> known_failures;
-        std::vector<DiagnosticLine> diagnostics;
+        std::vector<std::vector<DiagnosticLine>> test_diagnostics(specs_to_test.size());
+        // guards known_failures, restoring_abis, restored_abis, and binary_cache while tests run in parallel
+        std::mutex shared_mutex;
+        // signaled when a worker finishes restoring dependencies
+        std::condition_variable restores_finished;
+
+        // Dependencies are restored once per ABI into restored_packages_root and linked from there into the packages
+        // directory of every test which needs them. Packages which one test removes from an installed tree are then
+        // added back by a later test without downloading or extracting them again. Each worker restores, outside
+        // shared_mutex, the dependencies no other worker is restoring, and waits for the others.
+        const auto feature_tests_root = paths.buildtrees() / "_test-features";
+        const auto restored_packages_root = feature_tests_root / "restored";
+        std::set<std::string> restoring_abis;
+        std::set<std::string> restored_abis;
+
+        // With --x-parallel-tests, every worker installs into its own installed, packages, and buildtrees
+        // directories.
+        std::vector<std::unique_ptr<VcpkgPaths>> isolated_paths;
+        std::vector<std::unique_ptr<BinaryCache>> isolated_binary_caches;
+        std::vector<FeatureTestWorker> workers;
+        BuildPackageOptions worker_build_options = build_options;
+        if (parallel_tests > 1)
+        {
+            const auto& workers_root = feature_tests_root;
+            msg::println(msgFeatureTestsInParallel, msg::count = parallel_tests, msg::path = workers_root);
+            worker_build_options.concurrent_plans = parallel_tests;
+            for (size_t worker_index = 0; worker_index < parallel_tests; ++worker_index)
+            {
+                auto& worker_paths = *isolated_paths.emplace_back(
+                    paths.make_isolated(args, workers_root / fmt::format("worker-{}", worker_index)));
+                auto& worker_binary_cache = *isolated_binary_caches.emplace_back(std::make_unique<BinaryCache>(fs));
+                if (!worker_binary_cache.install_providers(args, worker_paths, out_sink))
+                {
+                    Checks::exit_fail(VCPKG_LINE_INFO);
+                }
 
-        for (std::size_t i = 0; i < specs_to_test.size(); ++i)
+                workers.push_back(FeatureTestWorker{
+                    &worker_paths, &worker_binary_cache, database_load_collapse(fs, worker_paths.installed())});
+            }
+        }
+        else
         {
+            workers.push_back(FeatureTestWorker{&paths, &binary_cache, std::move(status_db)});
+        }
+
+        const auto run_feature_test = [&](std::size_t i, FeatureTestWorker& worker) {
             auto& spec = specs_to_test[i];
             auto& install_plan = spec.plan;
+            auto& diagnostics = test_diagnostics[i];
+            const auto& worker_paths = *worker.paths;
             msg::println(msgStartingFeatureTest,
                          msg::value = fmt::format("{}/{}", i + 1, specs_to_test.size()),
                          msg::feature_spec = spec);
@@ -742,41 +841,53 @@ namespace vcpkg
                                .append_raw('\n'));
                 handle_cascade_feature_test_result(
                     diagnostics, all_ports, spec, ci_feature_baseline_file_name, baseline, Strings::join(", ", out));
-                continue;
+                return;
             }
 
-            if (auto iter = Util::find_if(install_plan.install_actions,
-                                          [&known_failures](const auto& install_action) {
-                                              return Util::Sets::contains(
-                                                  known_failures,
-                                                  install_action.package_abi().value_or_exit(VCPKG_LINE_INFO));
-                                          });
-                iter != install_plan.install_actions.end())
             {
-                msg::println(msgDependencyWillFail, msg::feature_spec = iter->display_name());
-                handle_cascade_feature_test_result(
-                    diagnostics, all_ports, spec, ci_feature_baseline_file_name, baseline, iter->display_name());
-                continue;
+                std::lock_guard<std::mutex> lock(shared_mutex);
+                if (auto iter = Util::find_if(install_plan.install_actions,
+                                              [&known_failures](const auto& install_action) {
+                                                  return Util::Sets::contains(
+                                                      known_failures,
+                                                      install_action.package_abi().value_or_exit(VCPKG_LINE_INFO));
+                                              });
+                    iter != install_plan.install_actions.end())
+                {
+                    msg::println(msgDependencyWillFail, msg::feature_spec = iter->display_name());
+                    handle_cascade_feature_test_result(
+                        diagnostics, all_ports, spec, ci_feature_baseline_file_name, baseline, iter->display_name());
+                    return;
+                }
+            }
+
+            // only install the absolute minimum: packages whose ABI is in the plan stay installed, and only the others
+            // are removed
+            const auto kept_specs = adjust_action_plan_to_status_db(install_plan, worker.status_db);
+            if (!kept_specs.empty() || !install_plan.remove_actions.empty())
+            {
+                msg::println(msgFeatureTestKeepingInstalled,
+                             msg::count = kept_specs.size(),
+                             msg::value = install_plan.remove_actions.size());
             }
 
-            // only install the absolute minimum
-            adjust_action_plan_to_status_db(install_plan, status_db);
             if (install_plan.install_actions.empty()) // already installed
             {
                 msg::println(msgAlreadyInstalled, msg::spec = spec);
                 handle_pass_feature_test_result(diagnostics, spec, ci_feature_baseline_file_name, baseline);
-                continue;
+                return;
             }
 
             {
                 const InstallPlanAction* action = &install_plan.install_actions.back();
+                std::lock_guard<std::mutex> lock(shared_mutex);
                 if (binary_cache.precheck(View<const InstallPlanAction*>(&action, 1)).front() ==
                     CacheAvailability::available)
                 {
                     msg::println(msgSkipTestingOfPortAlreadyInBinaryCache,
                                  msg::sha = action->package_abi().value_or_exit(VCPKG_LINE_INFO));
                     handle_pass_feature_test_result(diagnostics, spec, ci_feature_baseline_file_name, baseline);
-                    continue;
+                    return;
                 }
             }
 
@@ -790,18 +901,112 @@ namespace vcpkg
                 build_logs_recorder = &(feature_build_logs_recorder_storage.emplace(logs_dir, fs.file_time_now()));
             }
 
-            install_clear_installed_packages(paths, install_plan.install_actions);
-            binary_cache.fetch(install_plan.install_actions);
+            auto& actions = install_plan.install_actions;
+            for (auto& action : actions)
+            {
+                action.package_dir =
+                    worker_paths.packages() / action.package_dir.value_or_exit(VCPKG_LINE_INFO).filename();
+            }
+
+            install_clear_installed_packages(worker_paths, actions);
+
+            // Every action but the last, which is the one under test, is a dependency that other tests likely
+            // share, so it is restored only once and linked into the packages directory of each test.
+            const auto dependency_count = actions.size() - 1;
+            const auto dependency_abi = [&](std::size_t idx) -> const std::string& {
+                return actions[idx].package_abi().value_or_exit(VCPKG_LINE_INFO);
+            };
+
+            std::vector<std::size_t> claimed;
+            {
+                std::lock_guard<std::mutex> lock(shared_mutex);
+                for (std::size_t idx = 0; idx < dependency_count; ++idx)
+                {
+                    const auto& abi = dependency_abi(idx);
+                    if (!Util::Sets::contains(restored_abis, abi) && restoring_abis.insert(abi).second)
+                    {
+                        claimed.push_back(idx);
+                    }
+                }
+            }
+
+            // the claimed actions are moved out of the plan so that only they are fetched, into restored_packages_root
+            std::vector<InstallPlanAction> to_restore;
+            std::vector<Path> worker_package_dirs;
+            for (auto idx : claimed)
+            {
+                auto& action = to_restore.emplace_back(std::move(actions[idx]));
+                worker_package_dirs.push_back(std::move(*action.package_dir.get()));
+                action.package_dir = restored_packages_root / action.package_abi().value_or_exit(VCPKG_LINE_INFO);
+            }
+
+            std::vector<bool> restored_claimed(claimed.size());
+            if (!to_restore.empty())
+            {
+                worker.binary_cache->fetch(to_restore);
+                for (std::size_t k = 0; k < to_restore.size(); ++k)
+                {
+                    restored_claimed[k] = worker.binary_cache->is_restored(to_restore[k]);
+                }
+
+                // the packages restored are marked restored again once linked into the packages directory below
+                worker.binary_cache->mark_all_unrestored();
+            }
+
+            for (std::size_t k = 0; k < claimed.size(); ++k)
+            {
+                auto& action = actions[claimed[k]];
+                action = std::move(to_restore[k]);
+                action.package_dir = std::move(worker_package_dirs[k]);
+            }
+
+            std::vector<bool> restored(dependency_count);
+            {
+                std::unique_lock<std::mutex> lock(shared_mutex);
+                for (std::size_t k = 0; k < claimed.size(); ++k)
+                {
+                    // packages which couldn't be restored aren't recorded, so later tests try them again
+                    const auto& abi = dependency_abi(claimed[k]);
+                    restoring_abis.erase(abi);
+                    if (restored_claimed[k])
+                    {
+                        restored_abis.insert(abi);
+                    }
+                }
+
+                if (!claimed.empty())
+                {
+                    restores_finished.notify_all();
+                }
+
+                for (std::size_t idx = 0; idx < dependency_count; ++idx)
+                {
+                    const auto& abi = dependency_abi(idx);
+                    restores_finished.wait(lock, [&] { return !Util::Sets::contains(restoring_abis, abi); });
+                    restored[idx] = Util::Sets::contains(restored_abis, abi);
+                }
+            }
+
+            for (std::size_t idx = 0; idx < dependency_count; ++idx)
+            {
+                auto& action = actions[idx];
+                if (restored[idx])
+                {
+                    link_restored_package(fs, restored_packages_root / dependency_abi(idx), *action.package_dir.get());
+                    worker.binary_cache->mark_restored(action);
+                }
+            }
+
             const auto summary = install_execute_plan(args,
-                                                      paths,
+                                                      worker_paths,
                                                       host_triplet,
-                                                      build_options,
+                                                      worker_build_options,
                                                       install_plan,
-                                                      status_db,
-                                                      binary_cache,
+                                                      worker.status_db,
+                                                      *worker.binary_cache,
                                                       *build_logs_recorder,
                                                       false);
-            binary_cache.mark_all_unrestored();
+            worker.binary_cache->mark_all_unrestored();
             for (const auto& result : summary.results)
             {
                 auto& build_result = result.build_result.value_or_exit(VCPKG_LINE_INFO);
@@ -815,7 +1020,7 @@ namespace vcpkg
                                 issue_body_path,
                                 create_github_issue(args,
                                                     build_result,
-                                                    paths,
+                                                    worker_paths,
                                                     result.get_install_plan_action().value_or_exit(VCPKG_LINE_INFO),
                                                     false),
                                 VCPKG_LINE_INFO);
@@ -823,8 +1028,11 @@ namespace vcpkg
 
                         [[fallthrough]];
                     case BuildResult::PostBuildChecksFailed:
+                    {
+                        std::lock_guard<std::mutex> lock(shared_mutex);
                         known_failures.insert(result.get_abi().value_or_exit(VCPKG_LINE_INFO));
                         break;
+                    }
                     default: break;
                 }
             }
@@ -860,6 +1068,7 @@ namespace vcpkg
                 case BuildResult::CacheMissing:
                     if (auto abi = summary.results.back().get_abi().get())
                     {
+                        std::lock_guard<std::mutex> lock(shared_mutex);
                         known_failures.insert(*abi);
                     }
 
@@ -877,6 +1086,29 @@ namespace vcpkg
             }
 
             msg::println();
+        };
+
+        // Each worker takes the next test as soon as it finishes one, so the tests start in the same order as they
+        // would one at a time
+        std::atomic<std::size_t> next_test{0};
+        execute_in_parallel(workers.size(), workers.size(), [&](std::size_t worker_index) {
+            for (auto i = next_test++; i < specs_to_test.size(); i = next_test++)
+            {
+                run_feature_test(i, workers[worker_index]);
+            }
+        });
+
+        for (auto&& worker_binary_cache : isolated_binary_caches)
+        {
+            worker_binary_cache->wait_for_async_complete_and_join();
+        }
+
+        fs.remove_all(restored_packages_root, VCPKG_LINE_INFO);
+
+        std::vector<DiagnosticLine> diagnostics;
+        for (auto&& diagnostics_of_test : test_diagnostics)
+        {
+            Util::Vectors::append(diagnostics, std::move(diagnostics_of_test));
         }
 
         int exit_code;
@@ -44,9 +44,10 @@ namespace
 
         if (auto acquired_artifacts = pparsed->get(JsonIdAcquiredArtifacts))
         {
-            if (auto maybe_acquired_string = acquired_artifacts->maybe_string())
+            auto maybe_acquired_string = acquired_artifacts->maybe_string();
+            if (auto acquired_string = maybe_acquired_string.get())
             {
-                get_global_metrics_collector().track_string(StringMetric::AcquiredArtifacts, *maybe_acquired_string);
+                get_global_metrics_collector().track_string(StringMetric::AcquiredArtifacts, *acquired_string);
             }
             else
             {
@@ -60,9 +61,10 @@ namespace
 
         if (auto activated_artifacts = pparsed->get(JsonIdActivatedArtifacts))
         {
-            if (auto maybe_activated_string = activated_artifacts->maybe_string())
+            auto maybe_activated_string = activated_artifacts->maybe_string();
+            if (auto activated_string = maybe_activated_string.get())
             {
-                get_global_metrics_collector().track_string(StringMetric::ActivatedArtifacts, *maybe_activated_string);
+                get_global_metrics_collector().track_string(StringMetric::ActivatedArtifacts, *activated_string);
             }
             else
             {
@@ -778,6 +778,228 @@ namespace vcpkg
             options.randomizer, options.use_head_version_if_user_requested, options.editable_if_user_requested);
     }
 
+    std::vector<FullPackageSpec> filter_supported_specs(const PortFileProvider& port_provider,
+                                                        const CMakeVars::CMakeVarProvider& var_provider,
+                                                        View<FullPackageSpec> specs,
+                                                        const CreateInstallPlanOptions& options)
+    {
+        // Each FeatureSpec reachable from any of specs is a node, with edges to the FeatureSpecs it pulls into an
+        // install plan. A node is unsupported if its own supports expression is false, or if it reaches such a
+        // node, so rather than building one plan per spec, the union of their graphs is walked once and the
+        // unsupported status is propagated backwards along the edges.
+        struct SupportsNode
+        {
+            FeatureSpec fspec;
+            std::vector<size_t> dependents;
+            bool deferred = false;
+            bool unsupported = false;
+        };
+
+        std::map<FeatureSpec, size_t> node_ids;
+        std::vector<SupportsNode> nodes;
+        std::vector<size_t> pending;
+        std::vector<size_t> deferred;
+        std::vector<size_t> directly_unsupported;
+        const auto get_node = [&](const FeatureSpec& fspec) {
+            auto it = node_ids.find(fspec);
+            if (it == node_ids.end())
+            {
+                it = node_ids.emplace(fspec, nodes.size()).first;
+                nodes.push_back(SupportsNode{fspec, {}});
+                pending.push_back(it->second);
+            }
+
+            return it->second;
+        };
+
+        const auto add_edge = [&](size_t from, const FeatureSpec& to) {
+            const size_t to_idx = get_node(to);
+            nodes[to_idx].dependents.push_back(from);
+        };
+
+        for (const FullPackageSpec& spec : specs)
+        {
+            for (auto&& feature : spec.features)
+            {
+                get_node(FeatureSpec{spec.package_spec, feature});
+            }
+        }
+
+        while (!pending.empty())
+        {
+            while (!pending.empty())
+            {
+                const size_t idx = pending.back();
+                pending.pop_back();
+                const FeatureSpec fspec = nodes[idx].fspec;
+                const PackageSpec& spec = fspec.spec();
+                auto maybe_scfl = port_provider.get_control_file(spec.name());
+                auto scfl = maybe_scfl.get();
+                if (!scfl)
+                {
+                    Checks::msg_exit_with_error(VCPKG_LINE_INFO,
+                                                msg::format(msgWhileLookingForSpec, msg::spec = spec)
+                                                    .append_raw('\n')
+                                                    .append_raw(maybe_scfl.error()));
+                }
+
+                const auto& core_paragraph = *scfl->source_control_file->core_paragraph;
+                if (fspec.feature() == FeatureNameStar)
+                {
+                    for (auto&& fpgh : scfl->source_control_file->feature_paragraphs)
+                    {
+                        add_edge(idx, FeatureSpec{spec, fpgh->name});
+                    }
+
+                    continue;
+                }
+
+                const PlatformExpression::Expr* supports_expression = nullptr;
+                const std::vector<Dependency>* dependencies = nullptr;
+                bool needs_vars;
+                if (fspec.feature() == FeatureNameDefault)
+                {
+                    needs_vars = Util::any_of(core_paragraph.default_features,
+                                              [](const DependencyRequestedFeature& feature) {
+                                                  return !feature.platform.is_empty();
+                                              });
+                }
+                else
+                {
+                    if (fspec.feature() == FeatureNameCore)
+                    {
+                        supports_expression = &core_paragraph.supports_expression;
+                        dependencies = &core_paragraph.dependencies;
+                    }
+                    else
+                    {
+                        auto maybe_paragraph = scfl->source_control_file->find_feature(fspec.feature());
+                        Checks::msg_check_maybe_upgrade(VCPKG_LINE_INFO,
+                                                        maybe_paragraph.has_value(),
+                                                        msgFailedToFindPortFeature,
+                                                        msg::feature = fspec.feature(),
+                                                        msg::package_name = fspec.port());
+                        supports_expression = &maybe_paragraph.get()->supports_expression;
+                        dependencies = &maybe_paragraph.get()->dependencies;
+                    }
+
+                    needs_vars = !supports_expression->is_empty() ||
+                                 Util::any_of(*dependencies,
+                                              [](const Dependency& dep) { return dep.has_platform_expressions(); });
+                }
+
+                auto maybe_vars = var_provider.get_dep_info_vars(spec);
+                auto vars = maybe_vars.get();
+                if (needs_vars && !vars)
+                {
+                    // Resolve qualified dependencies in batches, as in PackageGraph::install
+                    Checks::check_exit(VCPKG_LINE_INFO, !nodes[idx].deferred);
+                    nodes[idx].deferred = true;
+                    deferred.push_back(idx);
+                    continue;
+                }
+
+                if (!dependencies)
+                {
+                    for (auto&& feature : core_paragraph.default_features)
+                    {
+                        if (!vars || feature.platform.evaluate(*vars))
+                        {
+                            add_edge(idx, FeatureSpec{spec, feature.name});
+                        }
+                    }
+
+                    continue;
+                }
+
+                if (vars && !supports_expression->evaluate(*vars))
+                {
+                    directly_unsupported.push_back(idx);
+                }
+
+                // Installing any feature of a port that was not requested by the user also installs its defaults
+                add_edge(idx, FeatureSpec{spec, FeatureNameDefault});
+                std::vector<FeatureSpec> dep_list;
+                for (auto&& dep : *dependencies)
+                {
+                    if (vars && !dep.platform.evaluate(*vars))
+                    {
+                        continue;
+                    }
+
+                    std::vector<std::string> features;
+                    for (const auto& f : dep.features)
+                    {
+                        if (!vars || f.platform.evaluate(*vars))
+                        {
+                            features.push_back(f.name);
+                        }
+                    }
+
+                    dep.to_full_spec(features, spec.triplet(), options.host_triplet).expand_fspecs_to(dep_list);
+                }
+
+                for (auto&& dep_fspec : dep_list)
+                {
+                    add_edge(idx, dep_fspec);
+                }
+            }
+
+            if (!deferred.empty())
+            {
+                auto deferred_specs = Util::fmap(deferred, [&](size_t idx) { return nodes[idx].fspec.spec(); });
+                Util::sort_unique_erase(deferred_specs);
+                var_provider.load_dep_info_vars(deferred_specs, options.host_triplet);
+                pending.swap(deferred);
+            }
+        }
+
+        while (!directly_unsupported.empty())
+        {
+            const size_t idx = directly_unsupported.back();
+            directly_unsupported.pop_back();
+            if (nodes[idx].unsupported)
+            {
+                continue;
+            }
+
+            nodes[idx].unsupported = true;
+            Util::Vectors::append(directly_unsupported, nodes[idx].dependents);
+        }
+
+        std::vector<FullPackageSpec> supported;
+        for (const FullPackageSpec& spec : specs)
+        {
+            bool is_supported;
+            if (Util::contains(spec.features, FeatureNameDefault))
+            {
+                is_supported = Util::all_of(spec.features, [&](const std::string& feature) {
+                    return !nodes[node_ids.at(FeatureSpec{spec.package_spec, feature})].unsupported;
+                });
+            }
+            else
+            {
+                // The requested port itself only gets its default features when asked to, which the shared graph
+                // doesn't model, so fall back to building its plan.
+                PackagesDirAssigner packages_dir_not_used{""};
+                is_supported = create_feature_install_plan(port_provider,
+                                                           var_provider,
+                                                           {&spec, 1},
+                                                           StatusParagraphs{},
+                                                           packages_dir_not_used,
+                                                           options)
+                                   .unsupported_features.empty();
+            }
+
+            if (is_supported)
+            {
+                supported.push_back(spec);
+            }
+        }
+
+        return supported;
+    }
+
     void PackageGraph::mark_for_reinstall(const PackageSpec& first_remove_spec,
                                           std::vector<FeatureSpec>& out_reinstall_requirements) const
     {
@@ -21,7 +21,6 @@
 #include <utility>
 
 #if defined(_WIN32)
-#pragma comment(lib, "version")
 #pragma comment(lib, "winhttp")
 #endif
 
@@ -51,38 +50,6 @@ namespace
             target = position->second.first;
         }
     }
-
-    std::string get_os_version_string()
-    {
-#if defined(_WIN32)
-        std::wstring path;
-        path.resize(MAX_PATH);
-        const auto n = GetSystemDirectoryW(path.data(), static_cast<UINT>(path.size()));
-        path.resize(n);
-        path += L"\\kernel32.dll";
-
-        const auto versz = GetFileVersionInfoSizeW(path.c_str(), nullptr);
-        if (versz == 0) return {};
-
-        std::vector<char> verbuf;
-        verbuf.resize(versz);
-
-        if (!GetFileVersionInfoW(path.c_str(), 0, static_cast<DWORD>(verbuf.size()), verbuf.data())) return {};
-
-        void* rootblock;
-        UINT rootblocksize;
-        if (!VerQueryValueW(verbuf.data(), L"\\", &rootblock, &rootblocksize)) return {};
-
-        auto rootblock_ffi = static_cast<VS_FIXEDFILEINFO*>(rootblock);
-
-        return fmt::format("{}.{}.{}",
-                           static_cast<int>(HIWORD(rootblock_ffi->dwProductVersionMS)),
-                           static_cast<int>(LOWORD(rootblock_ffi->dwProductVersionMS)),
-                           static_cast<int>(HIWORD(rootblock_ffi->dwProductVersionLS)));
-#else
-        return "unknown";
-#endif
-    }
 }
 
 namespace vcpkg
@@ -374,7 +341,11 @@ namespace vcpkg
 
         result.os_version.assign(os_name.data(), os_name.size());
         result.os_version.push_back('-');
-        result.os_version.append(get_os_version_string());
+#if defined(_WIN32)
+        result.os_version.append(get_host_os_version());
+#else
+        result.os_version.append("unknown");
+#endif
 
         result.session_id = generate_random_UUID();
 
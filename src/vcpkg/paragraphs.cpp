@@ -4,6 +4,7 @@
 #include <vcpkg/base/contractual-constants.h>
 #include <vcpkg/base/files.h>
 #include <vcpkg/base/messages.h>
+#include <vcpkg/base/parallel-algorithms.h>
 #include <vcpkg/base/parse.h>
 #include <vcpkg/base/system.debug.h>
 #include <vcpkg/base/util.h>
@@ -550,36 +551,62 @@ namespace vcpkg::Paragraphs
 
     LoadResults try_load_all_registry_ports(const RegistrySet& registries)
     {
-        LoadResults ret;
         std::vector<std::string> ports = registries.get_all_reachable_port_names().value_or_exit(VCPKG_LINE_INFO);
-        for (const auto& port_name : ports)
-        {
+        // Ports are loaded concurrently into per port slots, then collected in the (sorted) order of `ports` so that
+        // the results and errors are deterministic.
+        std::vector<Optional<LocalizedString>> baseline_errors(ports.size());
+        std::vector<Optional<ExpectedL<SourceControlFileAndLocation>>> loaded_ports(ports.size());
+        execute_in_parallel(ports.size(), [&](size_t offset) {
+            const auto& port_name = ports[offset];
             const auto impl = registries.registry_for_port(port_name);
             if (!impl)
             {
                 // this is a port for which no registry is set
                 // this can happen when there's no default registry,
                 // and a registry has a port definition which it doesn't own the name of.
-                continue;
+                return;
+            }
+
+            auto maybe_maybe_baseline_version = impl->get_baseline_version(port_name);
+            auto maybe_baseline_version = maybe_maybe_baseline_version.get();
+            if (!maybe_baseline_version)
+            {
+                baseline_errors[offset] = std::move(maybe_maybe_baseline_version).error();
+                return;
             }
 
-            auto maybe_baseline_version = impl->get_baseline_version(port_name).value_or_exit(VCPKG_LINE_INFO);
-            auto baseline_version = maybe_baseline_version.get();
-            if (!baseline_version) continue; // port is attributed to this registry, but it is not in the baseline
+            auto baseline_version = maybe_baseline_version->get();
+            if (!baseline_version) return; // port is attributed to this registry, but it is not in the baseline
             auto maybe_port_entry = impl->get_port_entry(port_name);
             const auto port_entry = maybe_port_entry.get();
-            if (!port_entry) continue;  // port is attributed to this registry, but loading it failed
-            if (!*port_entry) continue; // port is attributed to this registry, but doesn't exist in this registry
-            auto maybe_scfl = (*port_entry)->try_load_port(*baseline_version);
-            if (const auto scfl = maybe_scfl.get())
+            if (!port_entry) return;  // port is attributed to this registry, but loading it failed
+            if (!*port_entry) return; // port is attributed to this registry, but doesn't exist in this registry
+            loaded_ports[offset] = (*port_entry)->try_load_port(*baseline_version);
+        });
+
+        LoadResults ret;
+        for (size_t offset = 0; offset < ports.size(); ++offset)
+        {
+            if (auto baseline_error = baseline_errors[offset].get())
+            {
+                Checks::msg_exit_with_message(VCPKG_LINE_INFO, *baseline_error);
+            }
+
+            auto maybe_scfl = loaded_ports[offset].get();
+            if (!maybe_scfl)
+            {
+                continue;
+            }
+
+            if (const auto scfl = maybe_scfl->get())
             {
                 ret.paragraphs.push_back(std::move(*scfl));
             }
             else
             {
                 ret.errors.emplace_back(std::piecewise_construct,
-                                        std::forward_as_tuple(port_name.data(), port_name.size()),
-                                        std::forward_as_tuple(std::move(maybe_scfl).error()));
+                                        std::forward_as_tuple(ports[offset]),
+                                        std::forward_as_tuple(std::move(*maybe_scfl).error()));
             }
         }
 
@@ -1,4 +1,3 @@
-#include <vcpkg/base/cache.h>
 #include <vcpkg/base/contractual-constants.h>
 #include <vcpkg/base/delayed-init.h>
 #include <vcpkg/base/files.h>
@@ -6,7 +5,9 @@
 #include <vcpkg/base/json.h>
 #include <vcpkg/base/jsonreader.h>
 #include <vcpkg/base/messages.h>
+#include <vcpkg/base/parallel-algorithms.h>
 #include <vcpkg/base/strings.h>
+#include <vcpkg/base/system.h>
 #include <vcpkg/base/util.h>
 
 #include <vcpkg/documentation.h>
@@ -18,9 +19,13 @@
 #include <vcpkg/versiondeserializers.h>
 #include <vcpkg/versions.h>
 
+#include <limits.h>
+#include <stdint.h>
+
 #include <algorithm>
 #include <iterator>
 #include <map>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -28,6 +33,9 @@ namespace
 {
     using namespace vcpkg;
 
+    // Guards the lock file, whose entries are shared by every git registry, when ports are loaded concurrently.
+    std::mutex g_lock_file_mutex;
+
     struct GitTreeStringDeserializer : Json::StringDeserializer
     {
         LocalizedString type_name() const override { return msg::format(msgAGitObjectSha); }
@@ -168,15 +176,26 @@ namespace
                 return maybe_entry.error();
             }
 
-            if (!entry->stale())
+            Optional<std::string> maybe_stale_commit_id;
+            {
+                std::lock_guard<std::mutex> lock(g_lock_file_mutex);
+                if (entry->stale())
+                {
+                    maybe_stale_commit_id = entry->commit_id();
+                }
+            }
+
+            auto stale_commit_id = maybe_stale_commit_id.get();
+            if (!stale_commit_id)
             {
                 return get_unstale_stale_versions_tree_path();
             }
 
+            std::lock_guard<std::mutex> lock(m_stale_versions_tree_mtx);
             if (!m_stale_versions_tree.has_value())
             {
                 auto maybe_tree =
-                    m_paths.git_find_object_id_for_remote_registry_path(entry->commit_id(), FileVersions.to_string());
+                    m_paths.git_find_object_id_for_remote_registry_path(*stale_commit_id, FileVersions.to_string());
                 auto tree = maybe_tree.get();
                 if (!tree)
                 {
@@ -198,15 +217,98 @@ namespace
             return VersionsTreePathResult{m_stale_versions_tree.value_or_exit(VCPKG_LINE_INFO), true};
         }
 
+        // Versions trees are extracted to directories named after their git tree SHA, which keys their indexes.
+        Path versions_index_path(const Path& versions_tree) const
+        {
+            return m_paths.registries_cache() / FileVersionsIndex / versions_tree.filename();
+        }
+
+        const GitVersionsIndex* try_get_versions_index(const Path& versions_tree) const
+        {
+            std::lock_guard<std::mutex> lock(m_versions_indexes_mtx);
+            auto tree = versions_tree.filename();
+            auto it = m_versions_indexes.find(tree);
+            if (it == m_versions_indexes.end())
+            {
+                Optional<GitVersionsIndex> index;
+                std::error_code ec;
+                auto contents = m_paths.get_filesystem().read_contents(versions_index_path(versions_tree), ec);
+                if (!ec)
+                {
+                    index = GitVersionsIndex::parse(std::move(contents));
+                }
+
+                it = m_versions_indexes.emplace(tree.to_string(), std::move(index)).first;
+            }
+
+            return it->second.get();
+        }
+
+        void build_versions_index(const Path& versions_tree) const
+        {
+            if (try_get_versions_index(versions_tree))
+            {
+                return;
+            }
+
+            const auto& fs = m_paths.get_filesystem();
+            auto maybe_db = load_all_git_versions_files(fs, versions_tree);
+            auto db = maybe_db.get();
+            if (!db)
+            {
+                return;
+            }
+
+            auto maybe_serialized = GitVersionsIndex::serialize(db->cache());
+            auto serialized = maybe_serialized.get();
+            if (!serialized)
+            {
+                // leave reporting broken versions files to the callers that need them
+                return;
+            }
+
+            // other vcpkg processes may be reading or writing the same index
+            std::error_code ec;
+            const auto tree = versions_tree.filename();
+            const auto index_dir = m_paths.registries_cache() / FileVersionsIndex;
+            const auto temp_path = index_dir / fmt::format("{}.{}", tree, get_process_id());
+            fs.write_contents_and_dirs(temp_path, *serialized, ec);
+            if (!ec)
+            {
+                fs.rename(temp_path, index_dir / tree, ec);
+            }
+
+            std::lock_guard<std::mutex> lock(m_versions_indexes_mtx);
+            auto& index = m_versions_indexes[tree.to_string()];
+            if (!index.has_value())
+            {
+                index = GitVersionsIndex::parse(std::move(*serialized));
+            }
+        }
+
+        ExpectedL<Optional<std::vector<GitVersionDbEntry>>> load_versions_file(const Path& versions_tree,
+                                                                              StringView port_name) const
+        {
+            if (auto index = try_get_versions_index(versions_tree))
+            {
+                return index->lookup(port_name);
+            }
+
+            return load_git_versions_file(m_paths.get_filesystem(), versions_tree, port_name).entries;
+        }
+
         const VcpkgPaths& m_paths;
 
         std::string m_repo;
         std::string m_reference;
         std::string m_baseline_identifier;
         DelayedInit<ExpectedL<LockFile::Entry>> m_lock_entry;
+        mutable std::mutex m_stale_versions_tree_mtx;
         mutable Optional<Path> m_stale_versions_tree;
         DelayedInit<ExpectedL<Path>> m_versions_tree;
         DelayedInit<ExpectedL<Baseline>> m_baseline;
+        mutable std::mutex m_versions_indexes_mtx;
+        mutable std::map<std::string, Optional<GitVersionsIndex>, std::less<>> m_versions_indexes;
     };
 
     struct BuiltinPortTreeRegistryEntry final : RegistryEntry
@@ -286,15 +388,27 @@ namespace
         const ExpectedL<SourceControlFileAndLocation>& get_scfl(StringView port_name) const
         {
             auto path = m_builtin_ports_directory / port_name;
-            return m_scfls.get_lazy(path, [&, this]() {
-                return Paragraphs::try_load_builtin_port_required(m_fs, port_name, m_builtin_ports_directory)
-                    .maybe_scfl;
-            });
+            {
+                std::lock_guard<std::mutex> lock(m_scfls_mtx);
+                auto it = m_scfls.find(path);
+                if (it != m_scfls.end())
+                {
+                    return it->second;
+                }
+            }
+
+            // load outside the lock so that different ports load concurrently; if another thread won the race to
+            // load the same port, its result is kept
+            auto maybe_scfl =
+                Paragraphs::try_load_builtin_port_required(m_fs, port_name, m_builtin_ports_directory).maybe_scfl;
+            std::lock_guard<std::mutex> lock(m_scfls_mtx);
+            return m_scfls.emplace(std::move(path), std::move(maybe_scfl)).first->second;
         }
 
         const ReadOnlyFilesystem& m_fs;
         const Path m_builtin_ports_directory;
-        Cache<Path, ExpectedL<SourceControlFileAndLocation>> m_scfls;
+        mutable std::mutex m_scfls_mtx;
+        mutable std::map<Path, ExpectedL<SourceControlFileAndLocation>, std::less<>> m_scfls;
     };
 
     // This registry implementation is a builtin registry with a provided
@@ -679,8 +793,7 @@ namespace
 
         {
             // try to load using "stale" version database
-            auto maybe_maybe_version_entries =
-                load_git_versions_file(m_paths.get_filesystem(), stale_vtp->p, port_name).entries;
+            auto maybe_maybe_version_entries = load_versions_file(stale_vtp->p, port_name);
             auto maybe_version_entries = maybe_maybe_version_entries.get();
             if (!maybe_version_entries)
             {
@@ -702,9 +815,9 @@ namespace
         }
 
         return get_versions_tree_path().then([this, &port_name](const Path& live_vcb) {
-            return load_git_versions_file(m_paths.get_filesystem(), live_vcb, port_name)
-                .entries.then([this, &port_name](Optional<std::vector<GitVersionDbEntry>>&& maybe_version_entries)
-                                  -> ExpectedL<std::unique_ptr<RegistryEntry>> {
+            return load_versions_file(live_vcb, port_name)
+                .then([this, &port_name](Optional<std::vector<GitVersionDbEntry>>&& maybe_version_entries)
+                          -> ExpectedL<std::unique_ptr<RegistryEntry>> {
                     auto version_entries = maybe_version_entries.get();
                     if (!version_entries)
                     {
@@ -816,7 +929,14 @@ namespace
         auto maybe_versions_path = get_stale_versions_tree_path();
         if (auto versions_path = maybe_versions_path.get())
         {
-            return load_all_port_names_from_registry_versions(out, m_paths.get_filesystem(), versions_path->p);
+            auto result = load_all_port_names_from_registry_versions(out, m_paths.get_filesystem(), versions_path->p);
+            if (result)
+            {
+                // callers enumerating every port usually go on to look all of them up
+                build_versions_index(versions_path->p);
+            }
+
+            return result;
         }
 
         return std::move(maybe_versions_path).error();
@@ -920,8 +1040,7 @@ namespace
                 return std::move(maybe_live_vdb).error();
             }
 
-            auto maybe_maybe_version_entries =
-                load_git_versions_file(parent.m_paths.get_filesystem(), *live_vdb, port_name).entries;
+            auto maybe_maybe_version_entries = parent.load_versions_file(*live_vdb, port_name);
             auto maybe_version_entries = maybe_maybe_version_entries.get();
             if (!maybe_version_entries)
             {
@@ -1018,11 +1137,17 @@ namespace
 
     ExpectedL<Baseline> parse_baseline_versions(StringView contents, StringView baseline, StringView origin)
     {
-        auto maybe_object = Json::parse_object(contents, origin);
-        auto object = maybe_object.get();
+        auto maybe_document = Json::parse_document(contents.to_string(), origin);
+        auto document = maybe_document.get();
+        if (!document)
+        {
+            return std::move(maybe_document).error();
+        }
+
+        auto object = document->value.maybe_object();
         if (!object)
         {
-            return std::move(maybe_object).error();
+            return msg::format(msgJsonErrorMustBeAnObject, msg::path = origin);
         }
 
         auto real_baseline = baseline.size() == 0 ? StringView{JsonIdDefault} : baseline;
@@ -1064,6 +1189,7 @@ namespace vcpkg
 {
     ExpectedL<LockFile::Entry> LockFile::get_or_fetch(const VcpkgPaths& paths, StringView repo, StringView reference)
     {
+        std::lock_guard<std::mutex> lock(g_lock_file_mutex);
         auto range = lockdata.equal_range(repo);
         auto it = std::find_if(range.first, range.second, [&reference](const LockDataType::value_type& repo2entry) {
             return repo2entry.second.reference == reference;
@@ -1088,6 +1214,7 @@ namespace vcpkg
     }
     ExpectedL<Unit> LockFile::Entry::ensure_up_to_date(const VcpkgPaths& paths) const
     {
+        std::lock_guard<std::mutex> lock(g_lock_file_mutex);
         if (data->second.stale)
         {
             StringView repo(data->first);
@@ -1310,9 +1437,15 @@ namespace
             return format_filesystem_call_error(ec, "read_contents", {versions_file_path});
         }
 
-        return Json::parse_object(contents, versions_file_path)
-            .then([&](Json::Object&& versions_json) -> ExpectedL<Optional<std::vector<GitVersionDbEntry>>> {
-                auto maybe_versions_array = versions_json.get(JsonIdVersions);
+        return Json::parse_document(std::move(contents), versions_file_path)
+            .then([&](Json::Document&& versions_document) -> ExpectedL<Optional<std::vector<GitVersionDbEntry>>> {
+                auto versions_json = versions_document.value.maybe_object();
+                if (!versions_json)
+                {
+                    return msg::format(msgJsonErrorMustBeAnObject, msg::path = versions_file_path);
+                }
+
+                auto maybe_versions_array = versions_json->get(JsonIdVersions);
                 if (!maybe_versions_array || !maybe_versions_array->is_array())
                 {
                     return msg::format_error(msgFailedToParseNoVersionsArray, msg::path = versions_file_path);
@@ -1346,9 +1479,15 @@ namespace
             return format_filesystem_call_error(ec, "read_contents", {versions_file_path});
         }
 
-        return Json::parse_object(contents, versions_file_path)
-            .then([&](Json::Object&& versions_json) -> ExpectedL<Optional<std::vector<FilesystemVersionDbEntry>>> {
-                auto maybe_versions_array = versions_json.get(JsonIdVersions);
+        return Json::parse_document(std::move(contents), versions_file_path)
+            .then([&](Json::Document&& document) -> ExpectedL<Optional<std::vector<FilesystemVersionDbEntry>>> {
+                auto versions_json = document.value.maybe_object();
+                if (!versions_json)
+                {
+                    return msg::format(msgJsonErrorMustBeAnObject, msg::path = versions_file_path);
+                }
+
+                auto maybe_versions_array = versions_json->get(JsonIdVersions);
                 if (!maybe_versions_array || !maybe_versions_array->is_array())
                 {
                     return msg::format_error(msgFailedToParseNoVersionsArray, msg::path = versions_file_path);
@@ -1366,6 +1505,103 @@ namespace
                 return db_entries;
             });
     }
+
+    constexpr StringLiteral GitVersionsIndexMagic = "VCPKGVI1";
+    // magic, port count
+    constexpr std::size_t GitVersionsIndexHeaderSize = 8 + 4;
+    // name offset, name size, records offset, record count
+    constexpr std::size_t GitVersionsIndexPortSize = 4 * 4;
+
+    void store_index_u32(char* target, std::uint32_t value) noexcept
+    {
+        for (int i = 0; i < 4; ++i)
+        {
+            target[i] = static_cast<char>((value >> (8 * i)) & 0xFFu);
+        }
+    }
+
+    void append_index_u32(std::string& out, std::uint32_t value)
+    {
+        char buffer[4];
+        store_index_u32(buffer, value);
+        out.append(buffer, 4);
+    }
+
+    void append_index_string(std::string& out, StringView value)
+    {
+        append_index_u32(out, static_cast<std::uint32_t>(value.size()));
+        out.append(value.data(), value.size());
+    }
+
+    std::uint32_t load_index_u32(const char* source) noexcept
+    {
+        std::uint32_t value = 0;
+        for (int i = 3; i >= 0; --i)
+        {
+            value = (value << 8) | static_cast<unsigned char>(source[i]);
+        }
+
+        return value;
+    }
+
+    struct GitVersionsIndexReader
+    {
+        const char* first;
+        const char* last;
+
+        bool read_u32(std::uint32_t& value) noexcept
+        {
+            if (last - first < 4)
+            {
+                return false;
+            }
+
+            value = load_index_u32(first);
+            first += 4;
+            return true;
+        }
+
+        bool read_string(StringView& value) noexcept
+        {
+            std::uint32_t size;
+            if (!read_u32(size) || static_cast<std::size_t>(last - first) < size)
+            {
+                return false;
+            }
+
+            value = StringView{first, size};
+            first += size;
+            return true;
+        }
+
+        // If `out` is nullptr, only checks that a well formed record is present
+        bool read_record(GitVersionDbEntry* out)
+        {
+            if (first == last)
+            {
+                return false;
+            }
+
+            const auto scheme = static_cast<unsigned char>(*first++);
+            std::uint32_t port_version;
+            StringView text;
+            StringView git_tree;
+            if (scheme > static_cast<unsigned char>(VersionScheme::String) || !read_u32(port_version) ||
+                port_version > static_cast<std::uint32_t>(INT_MAX) || !read_string(text) || !read_string(git_tree))
+            {
+                return false;
+            }
+
+            if (out)
+            {
+                out->version = SchemedVersion{static_cast<VersionScheme>(scheme),
+                                              Version{text.to_string(), static_cast<int>(port_version)}};
+                out->git_tree = git_tree.to_string();
+            }
+
+            return true;
+        }
+    };
 } // unnamed namespace
 
 namespace vcpkg
@@ -1425,41 +1661,190 @@ namespace vcpkg
             return std::move(maybe_letter_directories).error();
         }
 
-        std::map<std::string, GitVersionsLoadResult, std::less<>> initial_result;
+        static constexpr StringLiteral dot_json = ".json";
+        std::vector<Path> versions_files;
         for (auto&& letter_directory : *letter_directories)
         {
-            auto maybe_versions_files = fs.try_get_files_non_recursive(letter_directory);
-            auto versions_files = maybe_versions_files.get();
-            if (!versions_files)
+            auto maybe_letter_versions_files = fs.try_get_files_non_recursive(letter_directory);
+            auto letter_versions_files = maybe_letter_versions_files.get();
+            if (!letter_versions_files)
+            {
+                return std::move(maybe_letter_versions_files).error();
+            }
+
+            for (auto&& versions_file : *letter_versions_files)
+            {
+                if (versions_file.filename().ends_with(dot_json))
+                {
+                    versions_files.push_back(std::move(versions_file));
+                }
+            }
+        }
+
+        // reading and parsing the files dominates, so do that in parallel and assemble the map afterwards
+        std::vector<Optional<ExpectedL<Optional<std::vector<GitVersionDbEntry>>>>> loaded(versions_files.size());
+        parallel_transform(versions_files, loaded.begin(), [&](const Path& versions_file) {
+            return Optional<ExpectedL<Optional<std::vector<GitVersionDbEntry>>>>{
+                load_git_versions_file_impl(fs, versions_file)};
+        });
+
+        std::map<std::string, GitVersionsLoadResult, std::less<>> initial_result;
+        for (std::size_t i = 0; i < versions_files.size(); ++i)
+        {
+            auto& versions_file = versions_files[i];
+            auto port_name_json = versions_file.filename();
+            StringView port_name{port_name_json.data(), port_name_json.size() - dot_json.size()};
+            auto& maybe_port_versions = loaded[i].value_or_exit(VCPKG_LINE_INFO);
+            if (!maybe_port_versions)
+            {
+                maybe_port_versions.error()
+                    .append_raw('\n')
+                    .append_raw(NotePrefix)
+                    .append(msgWhileParsingVersionsForPort, msg::package_name = port_name, msg::path = versions_file);
+            }
+
+            initial_result.emplace(port_name, GitVersionsLoadResult{std::move(maybe_port_versions), versions_file});
+        }
+
+        return FullGitVersionsDatabase{fs, registry_versions, std::move(initial_result)};
+    }
+
+    GitVersionsIndex::GitVersionsIndex(std::string&& contents, std::size_t port_count)
+        : m_contents(std::move(contents)), m_port_count(port_count)
+    {
+    }
+
+    Optional<GitVersionsIndex> GitVersionsIndex::parse(std::string&& contents)
+    {
+        if (contents.size() < GitVersionsIndexHeaderSize || !StringView{contents}.starts_with(GitVersionsIndexMagic))
+        {
+            return nullopt;
+        }
+
+        const char* const data = contents.data();
+        const char* const last = data + contents.size();
+        const std::size_t port_count = load_index_u32(data + GitVersionsIndexMagic.size());
+        if ((contents.size() - GitVersionsIndexHeaderSize) / GitVersionsIndexPortSize < port_count)
+        {
+            return nullopt;
+        }
+
+        // check everything up front so that lookup() can trust offsets and records
+        StringView previous_name;
+        for (std::size_t i = 0; i < port_count; ++i)
+        {
+            const char* const port = data + GitVersionsIndexHeaderSize + i * GitVersionsIndexPortSize;
+            const std::size_t name_offset = load_index_u32(port);
+            const std::size_t name_size = load_index_u32(port + 4);
+            const std::size_t records_offset = load_index_u32(port + 8);
+            const std::uint32_t record_count = load_index_u32(port + 12);
+            if (name_offset > contents.size() || contents.size() - name_offset < name_size ||
+                records_offset > contents.size())
+            {
+                return nullopt;
+            }
+
+            StringView name{data + name_offset, name_size};
+            if (i != 0 && !(previous_name < name))
             {
-                return std::move(maybe_versions_files).error();
+                return nullopt;
             }
 
-            for (auto&& versions_file : *versions_files)
+            GitVersionsIndexReader reader{data + records_offset, last};
+            for (std::uint32_t record = 0; record < record_count; ++record)
             {
-                auto port_name_json = versions_file.filename();
-                static constexpr StringLiteral dot_json = ".json";
-                if (!port_name_json.ends_with(dot_json))
+                if (!reader.read_record(nullptr))
                 {
-                    continue;
+                    return nullopt;
                 }
+            }
+
+            previous_name = name;
+        }
+
+        return GitVersionsIndex{std::move(contents), port_count};
+    }
+
+    Optional<std::string> GitVersionsIndex::serialize(
+        const std::map<std::string, GitVersionsLoadResult, std::less<>>& db)
+    {
+        std::string out;
+        out.append(GitVersionsIndexMagic.data(), GitVersionsIndexMagic.size());
+        append_index_u32(out, static_cast<std::uint32_t>(db.size()));
+        out.resize(GitVersionsIndexHeaderSize + db.size() * GitVersionsIndexPortSize);
+        std::size_t port = GitVersionsIndexHeaderSize;
+        for (auto&& db_entry : db)
+        {
+            auto maybe_entries = db_entry.second.entries.get();
+            if (!maybe_entries)
+            {
+                return nullopt;
+            }
+
+            auto entries = maybe_entries->get();
+            if (!entries)
+            {
+                return nullopt;
+            }
+
+            const auto name_offset = out.size();
+            out.append(db_entry.first);
+            const auto records_offset = out.size();
+            for (auto&& entry : *entries)
+            {
+                out.push_back(static_cast<char>(entry.version.scheme));
+                append_index_u32(out, static_cast<std::uint32_t>(entry.version.version.port_version));
+                append_index_string(out, entry.version.version.text);
+                append_index_string(out, entry.git_tree);
+            }
+
+            if (out.size() > UINT32_MAX)
+            {
+                return nullopt;
+            }
+
+            store_index_u32(&out[port], static_cast<std::uint32_t>(name_offset));
+            store_index_u32(&out[port + 4], static_cast<std::uint32_t>(db_entry.first.size()));
+            store_index_u32(&out[port + 8], static_cast<std::uint32_t>(records_offset));
+            store_index_u32(&out[port + 12], static_cast<std::uint32_t>(entries->size()));
+            port += GitVersionsIndexPortSize;
+        }
+
+        return out;
+    }
 
-                StringView port_name{port_name_json.data(), port_name_json.size() - dot_json.size()};
-                auto maybe_port_versions = load_git_versions_file_impl(fs, versions_file);
-                if (!maybe_port_versions)
+    Optional<std::vector<GitVersionDbEntry>> GitVersionsIndex::lookup(StringView port_name) const
+    {
+        const char* const data = m_contents.data();
+        std::size_t lo = 0;
+        std::size_t hi = m_port_count;
+        while (lo < hi)
+        {
+            const auto mid = lo + (hi - lo) / 2;
+            const char* const port = data + GitVersionsIndexHeaderSize + mid * GitVersionsIndexPortSize;
+            StringView name{data + load_index_u32(port), load_index_u32(port + 4)};
+            if (name < port_name)
+            {
+                lo = mid + 1;
+            }
+            else if (port_name < name)
+            {
+                hi = mid;
+            }
+            else
+            {
+                std::vector<GitVersionDbEntry> entries(load_index_u32(port + 12));
+                GitVersionsIndexReader reader{data + load_index_u32(port + 8), data + m_contents.size()};
+                for (auto&& entry : entries)
                 {
-                    maybe_port_versions.error()
-                        .append_raw('\n')
-                        .append_raw(NotePrefix)
-                        .append(
-                            msgWhileParsingVersionsForPort, msg::package_name = port_name, msg::path = versions_file);
+                    Checks::check_exit(VCPKG_LINE_INFO, reader.read_record(&entry));
                 }
 
-                initial_result.emplace(port_name, GitVersionsLoadResult{std::move(maybe_port_versions), versions_file});
+                return entries;
             }
         }
 
-        return FullGitVersionsDatabase{fs, registry_versions, std::move(initial_result)};
+        return nullopt;
     }
 
     ExpectedL<Optional<std::vector<FilesystemVersionDbEntry>>> load_filesystem_versions_file(
@@ -5,27 +5,87 @@
 #include <vcpkg/installedpaths.h>
 #include <vcpkg/statusparagraphs.h>
 
+#include <algorithm>
+#include <functional>
+
 namespace vcpkg
 {
+    static size_t hash_package(const std::string& name, Triplet triplet)
+    {
+        return std::hash<std::string>()(name) * 31 + std::hash<Triplet>()(triplet);
+    }
+
+    static size_t hash_feature(const std::string& name, Triplet triplet, const std::string& feature)
+    {
+        return hash_package(name, triplet) * 31 + std::hash<std::string>()(feature);
+    }
+
     StatusParagraphs::StatusParagraphs(std::vector<std::unique_ptr<StatusParagraph>>&& ps) : paragraphs(std::move(ps))
     {
+        feature_index.reserve(paragraphs.size());
+        package_index.reserve(paragraphs.size());
+        for (size_t position = 0; position < paragraphs.size(); ++position)
+        {
+            index_paragraph(position);
+        }
+    }
+
+    void StatusParagraphs::index_paragraph(size_t position)
+    {
+        const BinaryParagraph& package = paragraphs[position]->package;
+        feature_index.emplace(hash_feature(package.spec.name(), package.spec.triplet(), package.feature), position);
+        package_index.emplace(hash_package(package.spec.name(), package.spec.triplet()), position);
+    }
+
+    size_t StatusParagraphs::find_position(const std::string& name, Triplet triplet, const std::string& feature) const
+    {
+        // when there are duplicates, the last paragraph wins, as it is the first one visited by iteration
+        size_t result = paragraphs.size();
+        const auto candidates = feature_index.equal_range(hash_feature(name, triplet, feature));
+        for (auto it = candidates.first; it != candidates.second; ++it)
+        {
+            const BinaryParagraph& package = paragraphs[it->second]->package;
+            if (package.spec.name() == name && package.spec.triplet() == triplet && package.feature == feature &&
+                (result == paragraphs.size() || it->second > result))
+            {
+                result = it->second;
+            }
+        }
+
+        return result;
+    }
+
+    std::vector<size_t> StatusParagraphs::find_positions(const std::string& name, Triplet triplet) const
+    {
+        std::vector<size_t> positions;
+        const auto candidates = package_index.equal_range(hash_package(name, triplet));
+        for (auto it = candidates.first; it != candidates.second; ++it)
+        {
+            const PackageSpec& spec = paragraphs[it->second]->package.spec;
+            if (spec.name() == name && spec.triplet() == triplet)
+            {
+                positions.push_back(it->second);
+            }
+        }
+
+        // in iteration order
+        std::sort(positions.begin(), positions.end(), std::greater<>());
+        return positions;
     }
 
     std::vector<std::unique_ptr<StatusParagraph>*> StatusParagraphs::find_all(const std::string& name, Triplet triplet)
     {
         std::vector<std::unique_ptr<StatusParagraph>*> spghs;
-        for (auto&& p : *this)
+        for (auto position : find_positions(name, triplet))
         {
-            if (p->package.spec.name() == name && p->package.spec.triplet() == triplet)
+            auto& p = paragraphs[position];
+            if (p->package.is_feature())
             {
-                if (p->package.is_feature())
-                {
-                    spghs.emplace_back(&p);
-                }
-                else
-                {
-                    spghs.emplace(spghs.begin(), &p);
-                }
+                spghs.emplace_back(&p);
+            }
+            else
+            {
+                spghs.emplace(spghs.begin(), &p);
             }
         }
 
@@ -35,10 +95,10 @@ namespace vcpkg
     Optional<InstalledPackageView> StatusParagraphs::get_installed_package_view(const PackageSpec& spec) const
     {
         InstalledPackageView ipv;
-        for (auto&& p : *this)
+        for (auto position : find_positions(spec.name(), spec.triplet()))
         {
-            if (p->package.spec.name() == spec.name() && p->package.spec.triplet() == spec.triplet() &&
-                p->is_installed())
+            auto& p = paragraphs[position];
+            if (p->is_installed())
             {
                 if (p->package.is_feature())
                 {
@@ -69,10 +129,9 @@ namespace vcpkg
             // The core feature maps to .feature is empty
             return find(name, triplet, {});
         }
-        return std::find_if(begin(), end(), [&](const std::unique_ptr<StatusParagraph>& pgh) {
-            const PackageSpec& spec = pgh->package.spec;
-            return spec.name() == name && spec.triplet() == triplet && pgh->package.feature == feature;
-        });
+
+        const auto position = find_position(name, triplet, feature);
+        return position == paragraphs.size() ? end() : iterator_at(position);
     }
 
     StatusParagraphs::const_iterator StatusParagraphs::find(const std::string& name,
@@ -85,10 +144,8 @@ namespace vcpkg
             return find(name, triplet, "");
         }
 
-        return std::find_if(begin(), end(), [&](const std::unique_ptr<StatusParagraph>& pgh) {
-            const PackageSpec& spec = pgh->package.spec;
-            return spec.name() == name && spec.triplet() == triplet && pgh->package.feature == feature;
-        });
+        const auto position = find_position(name, triplet, feature);
+        return position == paragraphs.size() ? end() : iterator_at(position);
     }
 
     StatusParagraphs::const_iterator StatusParagraphs::find_installed(const PackageSpec& spec) const
@@ -137,6 +194,7 @@ namespace vcpkg
         if (ptr == end())
         {
             paragraphs.push_back(std::move(pgh));
+            index_paragraph(paragraphs.size() - 1);
             return paragraphs.rbegin();
         }
 
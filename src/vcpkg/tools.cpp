@@ -22,6 +22,11 @@
 
 #include <fmt/ranges.h>
 
+#include <algorithm>
+#include <atomic>
+#include <iterator>
+#include <mutex>
+
 namespace
 {
     using namespace vcpkg;
@@ -741,6 +746,122 @@ namespace vcpkg
         }
     };
 
+    constexpr StringLiteral ToolVersionProbeSize = "size";
+    constexpr StringLiteral ToolVersionProbeLastWriteTime = "last-write-time";
+
+    // Whether the file at `path`, after following symlinks, is an ELF, Mach-O or PE executable. The version reported
+    // by a script, such as the shims of pyenv or asdf or the launchers of az and gsutil, comes from other files.
+    static bool is_native_executable(const ReadOnlyFilesystem& fs, const Path& path)
+    {
+        std::error_code ec;
+        auto file = fs.open_for_read(path, ec);
+        unsigned char magic[4] = {};
+        if (ec || file.read(magic, 1, sizeof(magic)) != sizeof(magic))
+        {
+            return false;
+        }
+
+        static constexpr unsigned char native_magics[][4] = {
+            {0x7F, 'E', 'L', 'F'},
+            {0xFE, 0xED, 0xFA, 0xCE},
+            {0xFE, 0xED, 0xFA, 0xCF},
+            {0xCE, 0xFA, 0xED, 0xFE},
+            {0xCF, 0xFA, 0xED, 0xFE},
+            {0xCA, 0xFE, 0xBA, 0xBE},
+        };
+
+        if (magic[0] == 'M' && magic[1] == 'Z')
+        {
+            return true;
+        }
+
+        return std::any_of(std::begin(native_magics), std::end(native_magics), [&](const unsigned char(&native)[4]) {
+            return std::equal(magic, magic + 4, native);
+        });
+    }
+
+    ToolVersionProbeCache::ToolVersionProbeCache(const Filesystem& fs, Path cache_path)
+        : m_fs(fs), m_cache_path(std::move(cache_path))
+    {
+    }
+
+    Json::Object& ToolVersionProbeCache::probes()
+    {
+        if (!m_probes.has_value())
+        {
+            Json::Object probes;
+            std::error_code ec;
+            auto contents = m_fs.read_contents(m_cache_path, ec);
+            if (!ec)
+            {
+                // a damaged cache is only a lost cache
+                auto maybe_probes = Json::parse_object(contents, m_cache_path);
+                if (auto parsed_probes = maybe_probes.get())
+                {
+                    probes = std::move(*parsed_probes);
+                }
+            }
+
+            m_probes = std::move(probes);
+        }
+
+        return *m_probes.get();
+    }
+
+    ExpectedL<std::string> ToolVersionProbeCache::get_version(StringView tool_name,
+                                                              const Path& exe_path,
+                                                              const std::function<ExpectedL<std::string>()>& probe)
+    {
+        std::error_code ec;
+        const auto size = static_cast<int64_t>(m_fs.file_size(exe_path, ec));
+        const auto last_write_time = ec ? 0 : m_fs.last_write_time(exe_path, ec);
+        if (ec || !is_native_executable(m_fs, exe_path))
+        {
+            return probe();
+        }
+
+        auto& all_probes = probes();
+        const auto key = fmt::format("{}:{}", tool_name, exe_path);
+        if (auto cached = all_probes.get(key))
+        {
+            if (auto cached_object = cached->maybe_object())
+            {
+                auto cached_size = cached_object->get(ToolVersionProbeSize);
+                auto cached_last_write_time = cached_object->get(ToolVersionProbeLastWriteTime);
+                auto cached_version = cached_object->get(JsonIdVersion);
+                if (cached_size && cached_size->is_integer() && cached_size->integer(VCPKG_LINE_INFO) == size &&
+                    cached_last_write_time && cached_last_write_time->is_integer() &&
+                    cached_last_write_time->integer(VCPKG_LINE_INFO) == last_write_time && cached_version &&
+                    cached_version->is_string())
+                {
+                    return cached_version->string(VCPKG_LINE_INFO).to_string();
+                }
+            }
+        }
+
+        auto maybe_version = probe();
+        if (auto version = maybe_version.get())
+        {
+            Json::Object entry;
+            entry.insert(ToolVersionProbeSize, Json::Value::integer(size));
+            entry.insert(ToolVersionProbeLastWriteTime, Json::Value::integer(last_write_time));
+            entry.insert(JsonIdVersion, *version);
+            all_probes.insert_or_replace(key, std::move(entry));
+
+            // other vcpkg processes, or other tool caches of this one, may be updating the cache too; losing their
+            // entries only costs a probe
+            static std::atomic<int> write_id = 0;
+            const auto temp_path = Path(fmt::format("{}.{}.{}", m_cache_path, get_process_id(), ++write_id));
+            m_fs.write_contents_and_dirs(temp_path, Json::stringify(all_probes), ec);
+            if (!ec)
+            {
+                m_fs.rename(temp_path, m_cache_path, ec);
+            }
+        }
+
+        return maybe_version;
+    }
+
     struct ToolCacheImpl final : ToolCache
     {
         const Filesystem& fs;
@@ -750,8 +871,12 @@ namespace vcpkg
         const Path tools;
         const RequireExactVersions abiToolVersionHandling;
 
+        // recursive because finding some tools (e.g. nuget through mono) looks up others
+        mutable std::recursive_mutex path_version_mutex;
         vcpkg::Cache<std::string, PathAndVersion> path_version_cache;
         vcpkg::Lazy<std::vector<ToolDataEntry>> m_tool_data_cache;
+        // Probing a version spawns the candidate tool, so results are remembered across vcpkg invocations
+        mutable ToolVersionProbeCache version_probes;
 
         ToolCacheImpl(const Filesystem& fs,
                       const AssetCachingSettings& asset_cache_settings,
@@ -765,7 +890,17 @@ namespace vcpkg
             , config_path(std::move(config_path))
             , tools(std::move(tools))
             , abiToolVersionHandling(abiToolVersionHandling)
+            , version_probes(fs, this->tools / FileToolVersionsCacheDotJson)
+        {
+        }
+
+        ExpectedL<std::string> get_version_cached(const ToolProvider& tool_provider,
+                                                  MessageSink& status_sink,
+                                                  const Path& exe_path) const
         {
+            return version_probes.get_version(tool_provider.tool_data_name(), exe_path, [&]() {
+                return tool_provider.get_version(*this, status_sink, exe_path);
+            });
         }
 
         /**
@@ -784,7 +919,7 @@ namespace vcpkg
             {
                 if (!fs.exists(candidate, IgnoreErrors{})) continue;
                 if (!tool_provider.cheap_is_acceptable(candidate)) continue;
-                auto maybe_version = tool_provider.get_version(*this, status_sink, candidate);
+                auto maybe_version = get_version_cached(tool_provider, status_sink, candidate);
                 log_candidate(candidate, maybe_version);
                 const auto version = maybe_version.get();
                 if (!version) continue;
@@ -977,7 +1112,7 @@ namespace vcpkg
                 {
                     auto downloaded_path = download_tool(*tool_data, status_sink);
                     auto downloaded_version =
-                        tool.get_version(*this, status_sink, downloaded_path).value_or_exit(VCPKG_LINE_INFO);
+                        get_version_cached(tool, status_sink, downloaded_path).value_or_exit(VCPKG_LINE_INFO);
                     return {std::move(downloaded_path), std::move(downloaded_version)};
                 }
             }
@@ -1010,6 +1145,7 @@ namespace vcpkg
 
         const PathAndVersion& get_tool_pathversion(StringView tool, MessageSink& status_sink) const
         {
+            std::lock_guard<std::recursive_mutex> lock(path_version_mutex);
             return path_version_cache.get_lazy(tool, [&]() -> PathAndVersion {
                 // First deal with specially handled tools.
                 // For these we may look in locations like Program Files, the PATH etc as well as the auto-downloaded
@@ -397,6 +397,14 @@ namespace vcpkg
                         msg::env_var = format_environment_variable(EnvironmentVariableOverlayTriplets)));
         args.parser.parse_multi_option(
             SwitchBinarysource, StabilityTag::Standard, args.cli_binary_sources, msg::format(msgBinarySourcesArg));
+        args.parser.parse_option(SwitchBinaryCachePushThreads,
+                                 StabilityTag::Experimental,
+                                 args.binary_cache_push_threads,
+                                 msg::format(msgBinaryCachePushThreadsArg));
+        args.parser.parse_option(SwitchBinaryCacheReadThreads,
+                                 StabilityTag::Experimental,
+                                 args.binary_cache_read_threads,
+                                 msg::format(msgBinaryCacheReadThreadsArg));
         args.parser.parse_multi_option(SwitchCMakeArgs, StabilityTag::Standard, args.cmake_args);
 
         std::vector<std::string> feature_flags;
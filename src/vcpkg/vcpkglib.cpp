@@ -10,15 +10,256 @@
 
 namespace vcpkg
 {
-    static StatusParagraphs load_current_database(const ReadOnlyFilesystem& fs, const Path& vcpkg_dir_status_file)
+    static void append_serialized_integer(std::string& out, std::uint64_t value)
     {
-        auto pghs = Paragraphs::get_paragraphs(fs, vcpkg_dir_status_file).value_or_exit(VCPKG_LINE_INFO);
+        for (int i = 0; i < 8; ++i)
+        {
+            out.push_back(static_cast<char>(value >> (8 * i)));
+        }
+    }
+
+    static void append_serialized_string(std::string& out, StringView value)
+    {
+        append_serialized_integer(out, value.size());
+        out.append(value.data(), value.size());
+    }
+
+    namespace
+    {
+        struct SerializedReader
+        {
+            explicit SerializedReader(StringView data) : m_data(data) { }
+
+            bool read_integer(std::uint64_t& value)
+            {
+                if (m_data.size() < 8)
+                {
+                    return false;
+                }
+
+                value = 0;
+                for (int i = 0; i < 8; ++i)
+                {
+                    value |= std::uint64_t{static_cast<unsigned char>(m_data[i])} << (8 * i);
+                }
+
+                m_data = m_data.substr(8);
+                return true;
+            }
+
+            bool read_string(std::string& value)
+            {
+                std::uint64_t size;
+                if (!read_integer(size) || size > m_data.size())
+                {
+                    return false;
+                }
+
+                value.assign(m_data.data(), static_cast<size_t>(size));
+                m_data = m_data.substr(static_cast<size_t>(size));
+                return true;
+            }
+
+            bool at_end() const noexcept { return m_data.empty(); }
+
+        private:
+            StringView m_data;
+        };
+    }
+
+    static void stat_file(const ReadOnlyFilesystem& fs, const Path& path, std::uint64_t& size, std::int64_t& write_time)
+    {
+        std::error_code ec;
+        size = fs.file_size(path, ec);
+        if (ec)
+        {
+            size = 0;
+        }
+
+        write_time = fs.last_write_time(path, ec);
+        if (ec)
+        {
+            write_time = 0;
+        }
+    }
+
+    static constexpr StringLiteral STATUS_SNAPSHOT_SIGNATURE = "vcpkg status snapshot v1\n";
+
+    static void append_serialized_strings(std::string& out, const std::vector<std::string>& values)
+    {
+        append_serialized_integer(out, values.size());
+        for (auto&& value : values)
+        {
+            append_serialized_string(out, value);
+        }
+    }
+
+    static bool read_serialized_strings(SerializedReader& reader, std::vector<std::string>& values)
+    {
+        std::uint64_t count;
+        if (!reader.read_integer(count))
+        {
+            return false;
+        }
+
+        for (std::uint64_t i = 0; i < count; ++i)
+        {
+            if (!reader.read_string(values.emplace_back()))
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    static bool read_serialized_spec(SerializedReader& reader, PackageSpec& spec)
+    {
+        std::string name;
+        std::string triplet;
+        if (!reader.read_string(name) || !reader.read_string(triplet))
+        {
+            return false;
+        }
+
+        spec = PackageSpec(std::move(name), Triplet::from_canonical_name(std::move(triplet)));
+        return true;
+    }
+
+    static std::string serialize_status_snapshot(const StatusParagraphs& status_db,
+                                                 std::uint64_t status_size,
+                                                 std::int64_t status_write_time)
+    {
+        std::string result = STATUS_SNAPSHOT_SIGNATURE.to_string();
+        append_serialized_integer(result, status_size);
+        append_serialized_integer(result, static_cast<std::uint64_t>(status_write_time));
+        // StatusParagraphs iterates in reverse
+        std::vector<const StatusParagraph*> pghs;
+        for (auto&& pgh : status_db)
+        {
+            pghs.push_back(pgh.get());
+        }
+
+        append_serialized_integer(result, pghs.size());
+        for (auto it = pghs.rbegin(); it != pghs.rend(); ++it)
+        {
+            const BinaryParagraph& package = (*it)->package;
+            append_serialized_string(result, package.spec.name());
+            append_serialized_string(result, package.spec.triplet().canonical_name());
+            append_serialized_string(result, package.version.text);
+            append_serialized_integer(result, static_cast<std::uint64_t>(package.version.port_version));
+            append_serialized_strings(result, package.description);
+            append_serialized_strings(result, package.maintainers);
+            append_serialized_string(result, package.feature);
+            append_serialized_strings(result, package.default_features);
+            append_serialized_integer(result, package.dependencies.size());
+            for (auto&& dependency : package.dependencies)
+            {
+                append_serialized_string(result, dependency.name());
+                append_serialized_string(result, dependency.triplet().canonical_name());
+            }
+
+            append_serialized_string(result, package.abi);
+            append_serialized_integer(result, static_cast<std::uint64_t>((*it)->status.want));
+            append_serialized_integer(result, static_cast<std::uint64_t>((*it)->status.state));
+        }
+
+        return result;
+    }
+
+    // Returns the status database in the snapshot if it was taken of a status file with the given size and write time
+    static Optional<StatusParagraphs> deserialize_status_snapshot(StringView data,
+                                                                  std::uint64_t status_size,
+                                                                  std::int64_t status_write_time)
+    {
+        if (!Strings::starts_with(data, STATUS_SNAPSHOT_SIGNATURE))
+        {
+            return nullopt;
+        }
+
+        SerializedReader reader(data.substr(STATUS_SNAPSHOT_SIGNATURE.size()));
+        std::uint64_t size;
+        std::uint64_t write_time;
+        std::uint64_t count;
+        if (!reader.read_integer(size) || !reader.read_integer(write_time) || size != status_size ||
+            static_cast<std::int64_t>(write_time) != status_write_time || !reader.read_integer(count))
+        {
+            return nullopt;
+        }
+
+        std::vector<std::unique_ptr<StatusParagraph>> status_pghs;
+        for (std::uint64_t i = 0; i < count; ++i)
+        {
+            auto& pgh = status_pghs.emplace_back(std::make_unique<StatusParagraph>());
+            BinaryParagraph& package = pgh->package;
+            std::uint64_t port_version;
+            std::uint64_t dependency_count;
+            if (!read_serialized_spec(reader, package.spec) || !reader.read_string(package.version.text) ||
+                !reader.read_integer(port_version) || !read_serialized_strings(reader, package.description) ||
+                !read_serialized_strings(reader, package.maintainers) || !reader.read_string(package.feature) ||
+                !read_serialized_strings(reader, package.default_features) || !reader.read_integer(dependency_count))
+            {
+                return nullopt;
+            }
+
+            package.version.port_version = static_cast<int>(port_version);
+            for (std::uint64_t j = 0; j < dependency_count; ++j)
+            {
+                if (!read_serialized_spec(reader, package.dependencies.emplace_back()))
+                {
+                    return nullopt;
+                }
+            }
+
+            std::uint64_t want;
+            std::uint64_t state;
+            if (!reader.read_string(package.abi) || !reader.read_integer(want) || !reader.read_integer(state) ||
+                want > static_cast<std::uint64_t>(Want::PURGE) ||
+                state > static_cast<std::uint64_t>(InstallState::INSTALLED))
+            {
+                return nullopt;
+            }
+
+            pgh->status.want = static_cast<Want>(want);
+            pgh->status.state = static_cast<InstallState>(state);
+        }
+
+        if (!reader.at_end())
+        {
+            return nullopt;
+        }
+
+        return StatusParagraphs(std::move(status_pghs));
+    }
+
+    static StatusParagraphs load_current_database(const ReadOnlyFilesystem& fs,
+                                                  const InstalledPaths& installed,
+                                                  bool& from_snapshot)
+    {
+        const auto status_file = installed.vcpkg_dir_status_file();
+        std::error_code ec;
+        const auto snapshot = fs.read_contents(installed.vcpkg_dir_status_snapshot(), ec);
+        if (!ec)
+        {
+            std::uint64_t status_size;
+            std::int64_t status_write_time;
+            stat_file(fs, status_file, status_size, status_write_time);
+            auto maybe_status_db = deserialize_status_snapshot(snapshot, status_size, status_write_time);
+            if (auto status_db = maybe_status_db.get())
+            {
+                from_snapshot = true;
+                return std::move(*status_db);
+            }
+        }
+
+        from_snapshot = false;
+        auto pghs = Paragraphs::get_paragraphs(fs, status_file).value_or_exit(VCPKG_LINE_INFO);
 
         std::vector<std::unique_ptr<StatusParagraph>> status_pghs;
         status_pghs.reserve(pghs.size());
         for (auto&& p : pghs)
         {
-            status_pghs.push_back(std::make_unique<StatusParagraph>(vcpkg_dir_status_file, std::move(p)));
+            status_pghs.push_back(std::make_unique<StatusParagraph>(status_file, std::move(p)));
         }
 
         return StatusParagraphs(std::move(status_pghs));
@@ -47,9 +288,23 @@ namespace vcpkg
         return update_files;
     }
 
+    static void write_status_snapshot(const Filesystem& fs,
+                                      const InstalledPaths& installed,
+                                      const StatusParagraphs& current_status_db)
+    {
+        std::uint64_t status_size;
+        std::int64_t status_write_time;
+        stat_file(fs, installed.vcpkg_dir_status_file(), status_size, status_write_time);
+        fs.write_rename_contents(installed.vcpkg_dir_status_snapshot(),
+                                 FileStatusSnapshotNew,
+                                 serialize_status_snapshot(current_status_db, status_size, status_write_time),
+                                 VCPKG_LINE_INFO);
+    }
+
     static void apply_database_updates_on_disk(const Filesystem& fs,
                                                const InstalledPaths& installed,
-                                               StatusParagraphs& current_status_db)
+                                               StatusParagraphs& current_status_db,
+                                               bool snapshot_is_current)
     {
         auto update_files = apply_database_updates(fs, current_status_db, installed.vcpkg_dir_updates());
         if (!update_files.empty())
@@ -58,11 +313,17 @@ namespace vcpkg
             const auto status_file_new = Path(status_file.parent_path()) / FileStatusNew;
             fs.write_contents(status_file_new, Strings::serialize(current_status_db), VCPKG_LINE_INFO);
             fs.rename(status_file_new, status_file, VCPKG_LINE_INFO);
+            snapshot_is_current = false;
             for (auto&& file : update_files)
             {
                 fs.remove(file, VCPKG_LINE_INFO);
             }
         }
+
+        if (!snapshot_is_current && fs.exists(installed.vcpkg_dir_status_file(), IgnoreErrors{}))
+        {
+            write_status_snapshot(fs, installed, current_status_db);
+        }
     }
 
     StatusParagraphs database_load(const ReadOnlyFilesystem& fs, const InstalledPaths& installed)
@@ -76,7 +337,8 @@ namespace vcpkg
             return current_status_db;
         }
 
-        StatusParagraphs current_status_db = load_current_database(fs, maybe_status_file);
+        bool from_snapshot;
+        StatusParagraphs current_status_db = load_current_database(fs, installed, from_snapshot);
         (void)apply_database_updates(fs, current_status_db, installed.vcpkg_dir_updates());
         return current_status_db;
     }
@@ -95,12 +357,13 @@ namespace vcpkg
         {
             // no status file, use empty db
             StatusParagraphs current_status_db;
-            apply_database_updates_on_disk(fs, installed, current_status_db);
+            apply_database_updates_on_disk(fs, installed, current_status_db, false);
             return current_status_db;
         }
 
-        StatusParagraphs current_status_db = load_current_database(fs, status_file);
-        apply_database_updates_on_disk(fs, installed, current_status_db);
+        bool from_snapshot;
+        StatusParagraphs current_status_db = load_current_database(fs, installed, from_snapshot);
+        apply_database_updates_on_disk(fs, installed, current_status_db, from_snapshot);
         return current_status_db;
     }
 
@@ -245,18 +508,333 @@ namespace vcpkg
         return installed_files;
     }
 
-    std::vector<StatusParagraphAndAssociatedFiles> get_installed_files(const ReadOnlyFilesystem& fs,
-                                                                       const InstalledPaths& installed,
-                                                                       const StatusParagraphs& status_db)
+    static constexpr StringLiteral FILES_INDEX_SIGNATURE = "vcpkg files index v1\n";
+
+    namespace
     {
-        return get_installed_files_impl<false>(fs, installed, status_db);
+        struct FileEntryPathLess
+        {
+            template<class FileEntry>
+            bool operator()(const FileEntry& lhs, const FileEntry& rhs) const
+            {
+                if (Strings::case_insensitive_ascii_less(lhs.path, rhs.path)) return true;
+                if (Strings::case_insensitive_ascii_less(rhs.path, lhs.path)) return false;
+                return lhs.path < rhs.path;
+            }
+
+            template<class FileEntry>
+            bool operator()(const FileEntry& lhs, StringView rhs) const
+            {
+                return Strings::case_insensitive_ascii_less(lhs.path, rhs);
+            }
+        };
     }
 
-    std::vector<StatusParagraphAndAssociatedFiles> get_installed_files_and_upgrade(const Filesystem& fs,
-                                                                                   const InstalledPaths& installed,
-                                                                                   const StatusParagraphs& status_db)
+    InstalledFilesIndex InstalledFilesIndex::from_installed_files(
+        const ReadOnlyFilesystem& fs,
+        const InstalledPaths& installed,
+        const std::vector<StatusParagraphAndAssociatedFiles>& files)
     {
-        return get_installed_files_impl<true>(fs, installed, status_db);
+        InstalledFilesIndex index;
+        for (auto&& pgh_and_files : files)
+        {
+            const auto listfile_path = installed.listfile_path(pgh_and_files.pgh.package);
+            const size_t package = index.m_packages.size();
+            auto& entry = index.m_packages.emplace_back();
+            entry.display_name = pgh_and_files.pgh.package.display_name();
+            entry.listfile = listfile_path.filename().to_string();
+            stat_file(fs, listfile_path, entry.listfile_size, entry.listfile_write_time);
+            for (auto&& file : pgh_and_files.files)
+            {
+                index.m_files.push_back(FileEntry{file, package});
+            }
+        }
+
+        Util::sort(index.m_files, FileEntryPathLess{});
+        index.m_modified = true;
+        return index;
+    }
+
+    Optional<InstalledFilesIndex> InstalledFilesIndex::deserialize(StringView data)
+    {
+        if (!Strings::starts_with(data, FILES_INDEX_SIGNATURE))
+        {
+            return nullopt;
+        }
+
+        SerializedReader reader(data.substr(FILES_INDEX_SIGNATURE.size()));
+        InstalledFilesIndex index;
+        std::uint64_t package_count;
+        if (!reader.read_integer(package_count))
+        {
+            return nullopt;
+        }
+
+        for (std::uint64_t i = 0; i < package_count; ++i)
+        {
+            auto& entry = index.m_packages.emplace_back();
+            std::uint64_t write_time;
+            if (!reader.read_string(entry.display_name) || !reader.read_string(entry.listfile) ||
+                !reader.read_integer(entry.listfile_size) || !reader.read_integer(write_time))
+            {
+                return nullopt;
+            }
+
+            entry.listfile_write_time = static_cast<std::int64_t>(write_time);
+        }
+
+        std::uint64_t file_count;
+        if (!reader.read_integer(file_count))
+        {
+            return nullopt;
+        }
+
+        for (std::uint64_t i = 0; i < file_count; ++i)
+        {
+            auto& entry = index.m_files.emplace_back();
+            std::uint64_t package;
+            if (!reader.read_integer(package) || package >= package_count || !reader.read_string(entry.path))
+            {
+                return nullopt;
+            }
+
+            entry.package = static_cast<size_t>(package);
+        }
+
+        if (!reader.at_end() || !std::is_sorted(index.m_files.begin(), index.m_files.end(), FileEntryPathLess{}))
+        {
+            return nullopt;
+        }
+
+        return index;
+    }
+
+    std::string InstalledFilesIndex::serialize() const
+    {
+        std::string result = FILES_INDEX_SIGNATURE.to_string();
+        append_serialized_integer(result, m_packages.size());
+        for (auto&& package : m_packages)
+        {
+            append_serialized_string(result, package.display_name);
+            append_serialized_string(result, package.listfile);
+            append_serialized_integer(result, package.listfile_size);
+            append_serialized_integer(result, static_cast<std::uint64_t>(package.listfile_write_time));
+        }
+
+        append_serialized_integer(result, m_files.size());
+        for (auto&& file : m_files)
+        {
+            append_serialized_integer(result, file.package);
+            append_serialized_string(result, file.path);
+        }
+
+        return result;
+    }
+
+    bool InstalledFilesIndex::is_current(const ReadOnlyFilesystem& fs,
+                                         const InstalledPaths& installed,
+                                         const StatusParagraphs& status_db) const
+    {
+        std::vector<const PackageEntry*> packages_by_listfile =
+            Util::fmap(m_packages, [](const PackageEntry& package) { return &package; });
+        Util::sort(packages_by_listfile,
+                   [](const PackageEntry* lhs, const PackageEntry* rhs) { return lhs->listfile < rhs->listfile; });
+
+        size_t installed_packages = 0;
+        for (const std::unique_ptr<StatusParagraph>& pgh : status_db)
+        {
+            if (!pgh->is_installed() || pgh->package.is_feature())
+            {
+                continue;
+            }
+
+            ++installed_packages;
+            const auto listfile_path = installed.listfile_path(pgh->package);
+            const auto listfile = listfile_path.filename();
+            auto it = std::lower_bound(packages_by_listfile.begin(),
+                                       packages_by_listfile.end(),
+                                       listfile,
+                                       [](const PackageEntry* lhs, StringView rhs) { return lhs->listfile < rhs; });
+            if (it == packages_by_listfile.end() || (*it)->listfile != listfile ||
+                (*it)->display_name != pgh->package.display_name())
+            {
+                return false;
+            }
+
+            std::uint64_t size;
+            std::int64_t write_time;
+            stat_file(fs, listfile_path, size, write_time);
+            if ((*it)->listfile_size != size || (*it)->listfile_write_time != write_time)
+            {
+                return false;
+            }
+        }
+
+        return installed_packages == m_packages.size();
+    }
+
+    std::vector<std::pair<std::string, std::string>> InstalledFilesIndex::find_conflicts(
+        Triplet triplet, const SortedVector<std::string>& package_files) const
+    {
+        std::vector<std::pair<std::string, std::string>> conflicts;
+        const auto prefix = Strings::concat(triplet.canonical_name(), '/');
+        std::string installed_file;
+        for (auto&& package_file : package_files)
+        {
+            installed_file.assign(prefix);
+            installed_file.append(package_file);
+            auto it = std::lower_bound(m_files.begin(), m_files.end(), installed_file, FileEntryPathLess{});
+            for (; it != m_files.end() && Strings::case_insensitive_ascii_equals(it->path, installed_file); ++it)
+            {
+                conflicts.emplace_back(it->path.substr(prefix.size()), m_packages[it->package].display_name);
+            }
+        }
+
+        std::stable_sort(conflicts.begin(), conflicts.end(), [](const auto& lhs, const auto& rhs) {
+            return lhs.second < rhs.second;
+        });
+        return conflicts;
+    }
+
+    Optional<const std::string&> InstalledFilesIndex::find_owner(StringView file) const
+    {
+        auto it = std::lower_bound(m_files.begin(), m_files.end(), file, FileEntryPathLess{});
+        for (; it != m_files.end() && Strings::case_insensitive_ascii_equals(it->path, file); ++it)
+        {
+            if (it->path == file)
+            {
+                return m_packages[it->package].display_name;
+            }
+        }
+
+        return nullopt;
+    }
+
+    std::vector<std::pair<std::string, std::string>> InstalledFilesIndex::search(StringView file_substr) const
+    {
+        std::vector<const FileEntry*> matches;
+        for (auto&& file : m_files)
+        {
+            if (file.path.find(file_substr.data(), 0, file_substr.size()) != std::string::npos)
+            {
+                matches.push_back(&file);
+            }
+        }
+
+        Util::sort(matches, [](const FileEntry* lhs, const FileEntry* rhs) {
+            return lhs->package < rhs->package || (lhs->package == rhs->package && lhs->path < rhs->path);
+        });
+        return Util::fmap(matches, [this](const FileEntry* file) {
+            return std::make_pair(m_packages[file->package].display_name, file->path);
+        });
+    }
+
+    void InstalledFilesIndex::add_package(const ReadOnlyFilesystem& fs,
+                                          const InstalledPaths& installed,
+                                          const BinaryParagraph& core)
+    {
+        remove_package(installed, core);
+
+        const auto listfile_path = installed.listfile_path(core);
+        std::vector<std::string> files = fs.read_lines(listfile_path).value_or_exit(VCPKG_LINE_INFO);
+        Strings::inplace_trim_all_and_remove_whitespace_strings(files);
+        Util::erase_remove_if(files, [](const std::string& file) { return file.back() == '/'; });
+
+        PackageEntry package{core.display_name(), listfile_path.filename().to_string(), 0, 0};
+        stat_file(fs, listfile_path, package.listfile_size, package.listfile_write_time);
+        add_package_files(std::move(package), std::move(files));
+    }
+
+    void InstalledFilesIndex::add_package_files(PackageEntry&& package, std::vector<std::string>&& files)
+    {
+        const size_t package_index = m_packages.size();
+        m_packages.push_back(std::move(package));
+
+        const auto old_size = static_cast<std::ptrdiff_t>(m_files.size());
+        for (auto&& file : files)
+        {
+            m_files.push_back(FileEntry{std::move(file), package_index});
+        }
+
+        const auto middle = m_files.begin() + old_size;
+        std::sort(middle, m_files.end(), FileEntryPathLess{});
+        std::inplace_merge(m_files.begin(), middle, m_files.end(), FileEntryPathLess{});
+        m_modified = true;
+    }
+
+    void InstalledFilesIndex::remove_package(const InstalledPaths& installed, const BinaryParagraph& core)
+    {
+        const auto listfile_path = installed.listfile_path(core);
+        const auto listfile = listfile_path.filename();
+        auto it = std::find_if(m_packages.begin(), m_packages.end(), [listfile](const PackageEntry& package) {
+            return package.listfile == listfile;
+        });
+        if (it == m_packages.end())
+        {
+            return;
+        }
+
+        const auto package_index = static_cast<size_t>(it - m_packages.begin());
+        m_packages.erase(it);
+        Util::erase_remove_if(m_files,
+                              [package_index](const FileEntry& file) { return file.package == package_index; });
+        for (auto&& file : m_files)
+        {
+            if (file.package > package_index)
+            {
+                --file.package;
+            }
+        }
+
+        m_modified = true;
+    }
+
+    template<bool AndUpdate, class FilesystemLike>
+    static InstalledFilesIndex load_installed_files_index_impl(const FilesystemLike& fs,
+                                                               const InstalledPaths& installed,
+                                                               const StatusParagraphs& status_db)
+    {
+        std::error_code ec;
+        const auto contents = fs.read_contents(installed.vcpkg_dir_files_index(), ec);
+        if (!ec)
+        {
+            auto maybe_index = InstalledFilesIndex::deserialize(contents);
+            if (auto index = maybe_index.get())
+            {
+                if (index->is_current(fs, installed, status_db))
+                {
+                    return std::move(*index);
+                }
+            }
+        }
+
+        return InstalledFilesIndex::from_installed_files(
+            fs, installed, get_installed_files_impl<AndUpdate>(fs, installed, status_db));
+    }
+
+    InstalledFilesIndex load_installed_files_index(const ReadOnlyFilesystem& fs,
+                                                   const InstalledPaths& installed,
+                                                   const StatusParagraphs& status_db)
+    {
+        return load_installed_files_index_impl<false>(fs, installed, status_db);
+    }
+
+    InstalledFilesIndex load_installed_files_index_and_upgrade(const Filesystem& fs,
+                                                               const InstalledPaths& installed,
+                                                               const StatusParagraphs& status_db)
+    {
+        return load_installed_files_index_impl<true>(fs, installed, status_db);
+    }
+
+    void save_installed_files_index(const Filesystem& fs,
+                                    const InstalledPaths& installed,
+                                    const InstalledFilesIndex& index)
+    {
+        if (index.is_modified())
+        {
+            fs.write_rename_contents(
+                installed.vcpkg_dir_files_index(), FileFilesIndexNew, index.serialize(), VCPKG_LINE_INFO);
+        }
     }
 
     std::string shorten_text(StringView desc, const size_t length)
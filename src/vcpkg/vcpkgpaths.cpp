@@ -34,6 +34,8 @@
 #include <vcpkg/vcpkgpaths.h>
 #include <vcpkg/visualstudio.h>
 
+#include <mutex>
+
 namespace
 {
     using namespace vcpkg;
@@ -477,7 +479,8 @@ namespace
                 {
                     auto reference = reference_to_commit.first;
                     const auto& commit = reference_to_commit.second;
-                    if (auto commit_string = commit.maybe_string())
+                    auto maybe_commit_string = commit.maybe_string();
+                    if (auto commit_string = maybe_commit_string.get())
                     {
                         if (!is_git_sha(*commit_string))
                         {
@@ -485,7 +488,8 @@ namespace
                             return ret;
                         }
 
-                        ret.emplace(repo.to_string(), LockFile::EntryData{reference.to_string(), *commit_string, true});
+                        ret.emplace(repo.to_string(),
+                                    LockFile::EntryData{reference.to_string(), commit_string->to_string(), true});
                         continue;
                     }
 
@@ -647,12 +651,15 @@ namespace vcpkg
         const Path m_registries_work_tree_dir;
         const Path m_registries_dot_git_dir;
         const Path m_registries_git_trees;
+        // serializes fetches into the shared registries repository from concurrent port loads
+        std::mutex m_registries_fetch_mutex;
         const Path downloads;
         const Path tools;
         const Optional<InstalledPaths> m_installed;
         const Optional<Path> buildtrees;
         const Optional<Path> packages;
-        const std::unique_ptr<ToolCache> m_tool_cache;
+        // shared with the isolated paths made from these, so that each tool is acquired once
+        std::shared_ptr<ToolCache> m_tool_cache;
         EnvCache m_env_cache;
         std::vector<Path> triplets_dirs;
         const Path m_artifacts_dir;
@@ -720,6 +727,20 @@ namespace vcpkg
 
     VcpkgPaths::~VcpkgPaths() = default;
 
+    std::unique_ptr<VcpkgPaths> VcpkgPaths::make_isolated(const VcpkgCmdArguments& args,
+                                                          const Path& isolated_root) const
+    {
+        auto isolated_args = args;
+        isolated_args.install_root_dir = (isolated_root / "installed").native();
+        isolated_args.packages_root_dir = (isolated_root / "packages").native();
+        isolated_args.buildtrees_root_dir = (isolated_root / "buildtrees").native();
+        isolated_args.do_not_take_lock = true;
+        auto isolated = std::make_unique<VcpkgPaths>(m_pimpl->m_fs, isolated_args, m_pimpl->m_bundle);
+        // two tool caches would download and extract the same tool into the same directory at the same time
+        isolated->m_pimpl->m_tool_cache = m_pimpl->m_tool_cache;
+        return isolated;
+    }
+
     Path VcpkgPaths::package_dir(const PackageSpec& spec) const { return this->packages() / spec.dir(); }
     Path VcpkgPaths::build_dir(const PackageSpec& spec) const { return this->buildtrees() / spec.name(); }
     Path VcpkgPaths::build_dir(StringView package_name) const { return this->buildtrees() / package_name.to_string(); }
@@ -924,9 +945,16 @@ namespace vcpkg
             return {*sha, expected_left_tag};
         }
 
+        const auto dot_git_dir = this->root / ".git";
+        auto maybe_sha = git_try_rev_parse(get_filesystem(), dot_git_dir, "HEAD");
+        if (auto sha = maybe_sha.get())
+        {
+            return std::move(*sha);
+        }
+
         return flatten_out(
                    cmd_execute_and_capture_output(
-                       git_cmd_builder(this->root / ".git", this->root).string_arg("rev-parse").string_arg("HEAD")),
+                       git_cmd_builder(dot_git_dir, this->root).string_arg("rev-parse").string_arg("HEAD")),
                    Tools::GIT)
             .map([](std::string&& output) {
                 Strings::inplace_trim(output);
@@ -986,6 +1014,12 @@ namespace vcpkg
 
     ExpectedL<std::string> VcpkgPaths::git_show(StringView treeish, const Path& dot_git_dir) const
     {
+        auto maybe_contents = git_try_read_blob(get_filesystem(), dot_git_dir, treeish);
+        if (auto contents = maybe_contents.get())
+        {
+            return std::move(*contents);
+        }
+
         // All git commands are run with: --git-dir={dot_git_dir} --work-tree={work_tree_temp}
         // git clone --no-checkout --local {vcpkg_root} {dot_git_dir}
         return flatten_out(cmd_execute_and_capture_output(
@@ -1028,6 +1062,7 @@ namespace vcpkg
 
     ExpectedL<std::string> VcpkgPaths::git_fetch_from_remote_registry(StringView repo, StringView treeish) const
     {
+        std::lock_guard<std::mutex> fetch_lock(m_pimpl->m_registries_fetch_mutex);
         auto& fs = get_filesystem();
 
         const auto& work_tree = m_pimpl->m_registries_work_tree_dir;
@@ -1053,6 +1088,7 @@ namespace vcpkg
                                  .string_arg(repo)
                                  .string_arg(treeish);
 
+        git_release_object_database(dot_git_dir);
         auto maybe_fetch_output = flatten(cmd_execute_and_capture_output(fetch_git_ref), Tools::GIT);
         if (!maybe_fetch_output)
         {
@@ -1075,6 +1111,7 @@ namespace vcpkg
 
     ExpectedL<Unit> VcpkgPaths::git_fetch(StringView repo, StringView treeish) const
     {
+        std::lock_guard<std::mutex> fetch_lock(m_pimpl->m_registries_fetch_mutex);
         auto& fs = get_filesystem();
 
         const auto& work_tree = m_pimpl->m_registries_work_tree_dir;
@@ -1104,6 +1141,7 @@ namespace vcpkg
                                  .string_arg(repo)
                                  .string_arg(treeish);
 
+        git_release_object_database(dot_git_dir);
         auto maybe_fetch_output = flatten(cmd_execute_and_capture_output(fetch_git_ref), Tools::GIT);
         if (!maybe_fetch_output)
         {
@@ -1122,6 +1160,12 @@ namespace vcpkg
     ExpectedL<std::string> VcpkgPaths::git_show_from_remote_registry(StringView hash, const Path& relative_path) const
     {
         auto revision = fmt::format("{}:{}", hash, relative_path.generic_u8string());
+        auto maybe_contents = git_try_read_blob(get_filesystem(), m_pimpl->m_registries_dot_git_dir, revision);
+        if (auto contents = maybe_contents.get())
+        {
+            return std::move(*contents);
+        }
+
         return flatten_out(cmd_execute_and_capture_output(
                                git_cmd_builder(m_pimpl->m_registries_dot_git_dir, m_pimpl->m_registries_work_tree_dir)
                                    .string_arg("show")
@@ -1132,6 +1176,12 @@ namespace vcpkg
                                                                                    const Path& relative_path) const
     {
         auto revision = fmt::format("{}:{}", hash, relative_path.generic_u8string());
+        auto maybe_object_id = git_try_rev_parse(get_filesystem(), m_pimpl->m_registries_dot_git_dir, revision);
+        if (auto object_id = maybe_object_id.get())
+        {
+            return std::move(*object_id);
+        }
+
         return flatten_out(cmd_execute_and_capture_output(
                                git_cmd_builder(m_pimpl->m_registries_dot_git_dir, m_pimpl->m_registries_work_tree_dir)
                                    .string_arg("rev-parse")